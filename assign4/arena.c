@@ -0,0 +1,203 @@
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+#define ARENA_ALIGN 16 // Alignment of every allocation, enough for any value type
+
+/**
+ * Allocates a chunk and puts it in front of the arena's chunk list.
+ *
+ * @param arena Arena the chunk is for
+ * @param size Bytes of data the chunk needs at least
+ * @return The new chunk, or NULL if memory ran out
+ */
+static ArenaChunk *addChunk(Arena *arena, size_t size)
+{
+    size_t header = (sizeof(ArenaChunk) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (size < arena->chunkSize)
+        size = arena->chunkSize;
+
+    ArenaChunk *chunk = malloc(header + size);
+    if (chunk == NULL)
+        return NULL;
+    chunk->data = (char *)chunk + header;
+    chunk->size = size;
+    chunk->used = 0;
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    return chunk;
+}
+
+/**
+ * Creates an arena.
+ *
+ * @param arena Set to the new arena
+ * @param chunkSize Size of the chunks the arena takes from malloc, or 0 for
+ *        ARENA_DEFAULT_CHUNK
+ * @return RC_OK, or RC_MEMORY_ALLOCATION_ERROR
+ *
+ * An arena hands out memory from large chunks and never frees single
+ * allocations: everything is released at once by resetArena or freeArena, or
+ * back to an earlier point by arenaRelease. That makes it a fit for values and
+ * records that live for one row, one batch or one scan. An arena is not
+ * thread-safe; each thread uses its own.
+ */
+RC createArena(Arena **arena, size_t chunkSize)
+{
+    if (arena == NULL)
+        return RC_INVALID_PARAMETER;
+
+    Arena *a = malloc(sizeof(Arena));
+    if (a == NULL)
+        return RC_MEMORY_ALLOCATION_ERROR;
+    a->chunks = NULL;
+    a->chunkSize = (chunkSize > 0) ? chunkSize : ARENA_DEFAULT_CHUNK;
+    a->allocated = 0;
+    if (addChunk(a, a->chunkSize) == NULL)
+    {
+        free(a);
+        return RC_MEMORY_ALLOCATION_ERROR;
+    }
+
+    *arena = a;
+    return RC_OK;
+}
+
+/**
+ * Frees an arena and everything allocated from it.
+ *
+ * @param arena Arena to free, or NULL
+ * @return RC_OK
+ */
+RC freeArena(Arena *arena)
+{
+    if (arena == NULL)
+        return RC_OK;
+
+    ArenaChunk *chunk = arena->chunks;
+    while (chunk != NULL)
+    {
+        ArenaChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(arena);
+    return RC_OK;
+}
+
+/**
+ * Allocates memory from an arena.
+ *
+ * @param arena Arena to allocate from
+ * @param size Bytes needed
+ * @return Memory aligned to ARENA_ALIGN, or NULL if memory ran out
+ *
+ * Most allocations only move a pointer in the current chunk. A request that
+ * does not fit starts a new chunk, as large as the request if need be.
+ */
+void *arenaAlloc(Arena *arena, size_t size)
+{
+    ArenaChunk *chunk = arena->chunks;
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    if (chunk == NULL || chunk->size - chunk->used < size)
+    {
+        chunk = addChunk(arena, size);
+        if (chunk == NULL)
+            return NULL;
+    }
+
+    void *memory = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->allocated += size;
+    return memory;
+}
+
+/**
+ * Allocates memory from an arena, or with malloc when there is no arena.
+ *
+ * @param arena Arena to allocate from, or NULL
+ * @param size Bytes needed
+ * @return The memory, or NULL if memory ran out
+ *
+ * Lets one function serve callers with and without an arena: memory from
+ * malloc is freed by the caller, memory from an arena never is.
+ */
+void *allocFromArena(Arena *arena, size_t size)
+{
+    return (arena != NULL) ? arenaAlloc(arena, size) : malloc(size);
+}
+
+/**
+ * Copies a string into an arena.
+ *
+ * @param arena Arena to allocate from
+ * @param s String to copy
+ * @return The copy, or NULL if memory ran out
+ */
+char *arenaStrdup(Arena *arena, const char *s)
+{
+    size_t length = strlen(s) + 1;
+    char *copy = arenaAlloc(arena, length);
+    if (copy != NULL)
+        memcpy(copy, s, length);
+    return copy;
+}
+
+/**
+ * Returns the current position of an arena.
+ *
+ * @param arena Arena to mark
+ * @return Mark to pass to arenaRelease
+ */
+ArenaMark arenaMark(Arena *arena)
+{
+    ArenaMark mark;
+    mark.chunk = arena->chunks;
+    mark.used = (mark.chunk != NULL) ? mark.chunk->used : 0;
+    return mark;
+}
+
+/**
+ * Releases everything allocated from an arena since a mark.
+ *
+ * @param arena Arena to release memory of
+ * @param mark Mark taken by arenaMark on the same arena
+ *
+ * Chunks started after the mark are freed, and the chunk current at the mark
+ * is rewound. Memory allocated before the mark stays valid, so a loop can
+ * release what each iteration allocated.
+ */
+void arenaRelease(Arena *arena, ArenaMark mark)
+{
+    while (arena->chunks != mark.chunk && arena->chunks != NULL)
+    {
+        ArenaChunk *chunk = arena->chunks;
+        arena->chunks = chunk->next;
+        arena->allocated -= chunk->used;
+        free(chunk);
+    }
+    if (mark.chunk != NULL)
+    {
+        arena->allocated -= mark.chunk->used - mark.used;
+        mark.chunk->used = mark.used;
+    }
+}
+
+/**
+ * Releases everything allocated from an arena, keeping one chunk for reuse.
+ *
+ * @param arena Arena to reset
+ */
+void resetArena(Arena *arena)
+{
+    while (arena->chunks != NULL && arena->chunks->next != NULL)
+    {
+        ArenaChunk *chunk = arena->chunks;
+        arena->chunks = chunk->next;
+        free(chunk);
+    }
+    if (arena->chunks != NULL)
+        arena->chunks->used = 0;
+    arena->allocated = 0;
+}
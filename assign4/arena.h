@@ -0,0 +1,39 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include "dberror.h"
+
+// One block of memory an arena hands out allocations from
+typedef struct ArenaChunk {
+	struct ArenaChunk *next; // chunk allocated before this one
+	size_t size;             // bytes of data the chunk has
+	size_t used;             // bytes of data handed out
+	char *data;              // the memory, right behind the chunk header
+} ArenaChunk;
+
+// Region allocator: allocations are only ever released together
+typedef struct Arena {
+	ArenaChunk *chunks; // newest chunk first
+	size_t chunkSize;   // size of a regular chunk
+	size_t allocated;   // bytes handed out since creation or the last reset
+} Arena;
+
+// Position in an arena that later allocations can be released back to
+typedef struct ArenaMark {
+	ArenaChunk *chunk;
+	size_t used;
+} ArenaMark;
+
+#define ARENA_DEFAULT_CHUNK 8192
+
+extern RC createArena (Arena **arena, size_t chunkSize);
+extern RC freeArena (Arena *arena);
+extern void *arenaAlloc (Arena *arena, size_t size);
+extern void *allocFromArena (Arena *arena, size_t size);
+extern char *arenaStrdup (Arena *arena, const char *s);
+extern ArenaMark arenaMark (Arena *arena);
+extern void arenaRelease (Arena *arena, ArenaMark mark);
+extern void resetArena (Arena *arena);
+
+#endif // ARENA_H
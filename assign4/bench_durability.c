@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * File: bench_durability.c
+ * Measures the write throughput of the storage manager's durability modes.
+ *
+ * Every mode writes the same sequence of random pages into a fresh page file
+ * and reports pages per second, so the cost of syncing can be weighed when
+ * choosing the mode of a table. Checkpoint mode checkpoints every
+ * CHECKPOINT_EVERY writes, which is roughly what a buffer pool flush does.
+ *
+ * Usage: ./bench_durability [writes] [group commit interval in ms]
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "storage_mgr.h"
+#include "dberror.h"
+
+#define BENCH_FILE "bench_durability.bin"
+#define BENCH_PAGES 256         // Pages in the benchmark file
+#define CHECKPOINT_EVERY 100    // Writes between two checkpoints in checkpoint mode
+
+static double elapsed_seconds(struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * Runs the write workload under one durability mode.
+ *
+ * @return Seconds spent writing, or a negative value on failure
+ */
+static double run_mode(SM_Durability mode, int writes, int groupCommitMs)
+{
+    SM_FileOptions options = {.pageSize = PAGE_SIZE, .durability = mode, .groupCommitMs = groupCommitMs};
+    SM_FileHandle fh;
+    struct timespec start;
+    RC rc;
+
+    if (createPageFileWithOptions(BENCH_FILE, &options) != RC_OK ||
+        openPageFile(BENCH_FILE, &fh) != RC_OK)
+        return -1;
+
+    char *page = malloc(PAGE_SIZE);
+    rc = (page != NULL) ? ensureCapacity(BENCH_PAGES, &fh) : RC_WRITE_FAILED;
+    if (rc == RC_OK)
+        rc = checkpointPageFile(&fh);
+
+    // Same page sequence for every mode
+    srand(42);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < writes && rc == RC_OK; i++)
+    {
+        memset(page, 'a' + i % 26, PAGE_SIZE);
+        rc = writeBlock(rand() % BENCH_PAGES, &fh, page);
+        if (rc == RC_OK && mode == SM_DURABILITY_CHECKPOINT && (i + 1) % CHECKPOINT_EVERY == 0)
+            rc = checkpointPageFile(&fh);
+    }
+    // Closing syncs whatever the mode left pending
+    if (closePageFile(&fh) != RC_OK)
+        rc = RC_WRITE_FAILED;
+    double seconds = elapsed_seconds(&start);
+
+    free(page);
+    destroyPageFile(BENCH_FILE);
+    return (rc == RC_OK) ? seconds : -1;
+}
+
+int main(int argc, char *argv[])
+{
+    int writes = (argc > 1) ? atoi(argv[1]) : 2000;
+    int groupCommitMs = (argc > 2) ? atoi(argv[2]) : 10;
+    const char *names[] = {"none", "checkpoint", "every-write", "group-commit"};
+
+    if (writes <= 0 || groupCommitMs <= 0)
+    {
+        fprintf(stderr, "usage: %s [writes] [group commit interval in ms]\n", argv[0]);
+        return 1;
+    }
+
+    initStorageManager();
+    printf("%d random %d-byte page writes over %d pages\n", writes, PAGE_SIZE, BENCH_PAGES);
+    printf("%-14s %10s %14s\n", "mode", "seconds", "pages/sec");
+
+    for (int mode = SM_DURABILITY_NONE; mode <= SM_DURABILITY_GROUP_COMMIT; mode++)
+    {
+        double seconds = run_mode((SM_Durability)mode, writes, groupCommitMs);
+        if (seconds < 0)
+        {
+            fprintf(stderr, "%s: benchmark failed\n", names[mode]);
+            return 1;
+        }
+        printf("%-14s %10.3f %14.0f\n", names[mode], seconds, writes / seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * File: bench_filter.c
+ * Measures the filter kernels that compare a column with a constant.
+ *
+ * Values are laid out at the uneven strides of records on a data page, and
+ * every kernel the processor supports compares them with a constant, once for
+ * ints and once for floats. Values per second are reported for each kernel,
+ * along with the number of matches as a check that the kernels agree.
+ *
+ * Usage: ./bench_filter [values] [rounds]
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "filter.h"
+#include "dberror.h"
+
+static double elapsed_seconds(struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * Runs one kernel over the values.
+ *
+ * @return Seconds spent filtering
+ */
+static double run_kernel(FilterKernel kernel, char *data, int *offsets, int numValues, int rounds,
+                         DataType dt, Value *constant, unsigned char *mask, long *matches)
+{
+    struct timespec start;
+
+    *matches = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int round = 0; round < rounds; round++)
+        filterColumnWith(kernel, data, offsets, numValues, dt, FILTER_SMALLER, constant, mask);
+    double seconds = elapsed_seconds(&start);
+
+    for (int i = 0; i < numValues; i++)
+        *matches += (mask[i >> 3] >> (i & 7)) & 1;
+    return seconds;
+}
+
+int main(int argc, char *argv[])
+{
+    int numValues = (argc > 1) ? atoi(argv[1]) : 4096;
+    int rounds = (argc > 2) ? atoi(argv[2]) : 20000;
+
+    if (numValues <= 0 || rounds <= 0)
+    {
+        fprintf(stderr, "usage: %s [values] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    // Records of 20 to 35 bytes, as on a page of short variable-length rows
+    int *offsets = malloc(sizeof(int) * numValues);
+    unsigned char *mask = malloc((numValues + 7) / 8);
+    char *data = malloc((size_t)numValues * 36 + 4);
+    if (offsets == NULL || mask == NULL || data == NULL)
+    {
+        fprintf(stderr, "cannot set up the benchmark\n");
+        return 1;
+    }
+    srand(42);
+    for (int i = 0, offset = 0; i < numValues; i++, offset += 20 + i % 16)
+        offsets[i] = offset;
+
+    printf("%d values, %d rounds, value < constant matching about half\n", numValues, rounds);
+    printf("%-8s %-8s %10s %14s %10s\n", "type", "kernel", "seconds", "values/sec", "matches");
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        DataType dt = (pass == 0) ? DT_INT : DT_FLOAT;
+        Value constant;
+        constant.dt = dt;
+        for (int i = 0; i < numValues; i++)
+        {
+            int v = rand() % 1000;
+            float f = v;
+            if (dt == DT_INT)
+                memcpy(data + offsets[i], &v, sizeof(int));
+            else
+                memcpy(data + offsets[i], &f, sizeof(float));
+        }
+        if (dt == DT_INT)
+            constant.v.intV = 500;
+        else
+            constant.v.floatV = 500.0f;
+
+        for (int kernel = FILTER_KERNEL_SCALAR; kernel <= bestFilterKernel(); kernel++)
+        {
+            long matches;
+            double seconds = run_kernel((FilterKernel)kernel, data, offsets, numValues, rounds,
+                                        dt, &constant, mask, &matches);
+            printf("%-8s %-8s %10.3f %14.0f %10ld\n", (dt == DT_INT) ? "int" : "float",
+                   filterKernelName((FilterKernel)kernel), seconds, (double)numValues * rounds / seconds, matches);
+        }
+    }
+
+    free(offsets);
+    free(mask);
+    free(data);
+    return 0;
+}
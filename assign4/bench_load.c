@@ -0,0 +1,162 @@
+/*******************************************************************************
+ * File: bench_load.c
+ * Measures how fast the record manager loads rows into a table.
+ *
+ * The same generated rows are loaded three ways into a fresh table each: one
+ * insertRecord call per row, insertRecords with the whole set as one batch, and
+ * loadTableFromCSV from a CSV file holding the rows. Rows per second are
+ * reported for each, so the cost of the per-row page handling can be compared
+ * with the batched path.
+ *
+ * Usage: ./bench_load [rows]
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "record_mgr.h"
+#include "expr.h"
+#include "dberror.h"
+
+#define BENCH_TABLE "bench_load_table"
+#define BENCH_CSV "bench_load.csv"
+#define NAME_LENGTH 32 // Width of the string attribute
+
+static double elapsed_seconds(struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * Builds the benchmark schema: an id, a short name of varying length and a score.
+ */
+static Schema *bench_schema(void)
+{
+    char **names = malloc(sizeof(char *) * 3);
+    DataType *types = malloc(sizeof(DataType) * 3);
+    int *sizes = malloc(sizeof(int) * 3);
+    int *keys = malloc(sizeof(int));
+
+    names[0] = strdup("id");
+    names[1] = strdup("name");
+    names[2] = strdup("score");
+    types[0] = DT_INT;
+    types[1] = DT_STRING;
+    types[2] = DT_FLOAT;
+    sizes[0] = 0;
+    sizes[1] = NAME_LENGTH;
+    sizes[2] = 0;
+    keys[0] = 0;
+    return createSchema(3, names, types, sizes, 1, keys);
+}
+
+/**
+ * Sets the attributes of row i, and writes the same row to the CSV file if one is given.
+ */
+static void make_row(Schema *schema, Record *record, int i, FILE *csv)
+{
+    char name[NAME_LENGTH];
+    Value *value;
+
+    snprintf(name, sizeof(name), "row-%d-%.*s", i, i % 16, "abcdefghijklmnop");
+    MAKE_VALUE(value, DT_INT, i);
+    setAttr(record, schema, 0, value);
+    freeVal(value);
+    MAKE_STRING_VALUE(value, name);
+    setAttr(record, schema, 1, value);
+    freeVal(value);
+    MAKE_VALUE(value, DT_FLOAT, i * 0.5f);
+    setAttr(record, schema, 2, value);
+    freeVal(value);
+
+    if (csv != NULL)
+        fprintf(csv, "%d,%s,%g\n", i, name, i * 0.5f);
+}
+
+/**
+ * Loads the rows with the given method into a fresh table.
+ *
+ * @return Seconds spent loading, or a negative value on failure
+ */
+static double run_method(int method, Schema *schema, Record **rows, int numRows)
+{
+    RM_TableData table;
+    struct timespec start;
+    RC rc = RC_OK;
+    int loaded = 0;
+
+    if (createTable(BENCH_TABLE, schema) != RC_OK || openTable(&table, BENCH_TABLE) != RC_OK)
+        return -1;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (method == 0)
+    {
+        for (int i = 0; i < numRows && rc == RC_OK; i++)
+            rc = insertRecord(&table, rows[i]);
+    }
+    else if (method == 1)
+        rc = insertRecords(&table, rows, numRows, NULL);
+    else
+        rc = loadTableFromCSV(&table, BENCH_CSV, &loaded);
+    // Closing flushes the pages the load left in the buffer pool
+    if (closeTable(&table) != RC_OK)
+        rc = RC_WRITE_FAILED;
+    double seconds = elapsed_seconds(&start);
+
+    freeSchema(table.schema);
+    deleteTable(BENCH_TABLE);
+    return (rc == RC_OK) ? seconds : -1;
+}
+
+int main(int argc, char *argv[])
+{
+    int numRows = (argc > 1) ? atoi(argv[1]) : 200000;
+    const char *names[] = {"insertRecord", "insertRecords", "csv"};
+
+    if (numRows <= 0)
+    {
+        fprintf(stderr, "usage: %s [rows]\n", argv[0]);
+        return 1;
+    }
+
+    initRecordManager(NULL);
+    Schema *schema = bench_schema();
+    Record **rows = malloc(sizeof(Record *) * numRows);
+    FILE *csv = fopen(BENCH_CSV, "w");
+    if (rows == NULL || csv == NULL)
+    {
+        fprintf(stderr, "cannot set up the benchmark\n");
+        return 1;
+    }
+    for (int i = 0; i < numRows; i++)
+    {
+        createRecord(&rows[i], schema);
+        make_row(schema, rows[i], i, csv);
+    }
+    fclose(csv);
+
+    printf("%d rows of (int, string(%d), float)\n", numRows, NAME_LENGTH);
+    printf("%-14s %10s %14s\n", "method", "seconds", "rows/sec");
+
+    for (int method = 0; method < 3; method++)
+    {
+        double seconds = run_method(method, schema, rows, numRows);
+        if (seconds < 0)
+        {
+            fprintf(stderr, "%s: benchmark failed\n", names[method]);
+            return 1;
+        }
+        printf("%-14s %10.3f %14.0f\n", names[method], seconds, numRows / seconds);
+    }
+
+    for (int i = 0; i < numRows; i++)
+        freeRecord(rows[i]);
+    free(rows);
+    remove(BENCH_CSV);
+    shutdownRecordManager();
+    return 0;
+}
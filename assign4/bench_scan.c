@@ -0,0 +1,227 @@
+/*******************************************************************************
+ * File: bench_scan.c
+ * Measures how fast the record manager scans a table.
+ *
+ * A table of generated rows is scanned in full four ways: one record per call
+ * to next, one view per call to nextView, BATCH_ROWS rows per call to
+ * nextBatch, and parallelScan on the given number of threads. Every row is
+ * touched by reading its first attribute, and rows per second are reported for
+ * each way of scanning.
+ *
+ * Usage: ./bench_scan [rows] [scans] [threads]
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "record_mgr.h"
+#include "expr.h"
+#include "dberror.h"
+
+#define BENCH_TABLE "bench_scan_table"
+#define NAME_LENGTH 32 // Width of the string attribute
+#define BATCH_ROWS 1024 // Rows nextBatch returns per call
+
+static double elapsed_seconds(struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * Builds the benchmark schema: an id, a short name of varying length and a score.
+ */
+static Schema *bench_schema(void)
+{
+    char **names = malloc(sizeof(char *) * 3);
+    DataType *types = malloc(sizeof(DataType) * 3);
+    int *sizes = malloc(sizeof(int) * 3);
+    int *keys = malloc(sizeof(int));
+
+    names[0] = strdup("id");
+    names[1] = strdup("name");
+    names[2] = strdup("score");
+    types[0] = DT_INT;
+    types[1] = DT_STRING;
+    types[2] = DT_FLOAT;
+    sizes[0] = 0;
+    sizes[1] = NAME_LENGTH;
+    sizes[2] = 0;
+    keys[0] = 0;
+    return createSchema(3, names, types, sizes, 1, keys);
+}
+
+/**
+ * Fills the table with numRows generated rows.
+ */
+static RC load_rows(RM_TableData *table, Schema *schema, int numRows)
+{
+    Record *record;
+    Value *value;
+    char name[NAME_LENGTH];
+    RC rc = createRecord(&record, schema);
+
+    for (int i = 0; i < numRows && rc == RC_OK; i++)
+    {
+        snprintf(name, sizeof(name), "row-%d-%.*s", i, i % 16, "abcdefghijklmnop");
+        MAKE_VALUE(value, DT_INT, i);
+        setAttr(record, schema, 0, value);
+        freeVal(value);
+        MAKE_STRING_VALUE(value, name);
+        setAttr(record, schema, 1, value);
+        freeVal(value);
+        MAKE_VALUE(value, DT_FLOAT, i * 0.5f);
+        setAttr(record, schema, 2, value);
+        freeVal(value);
+        rc = insertRecord(table, record);
+    }
+    freeRecord(record);
+    return rc;
+}
+
+// Totals of a parallel scan, added to from every thread
+typedef struct ParallelTotals
+{
+    long rows;
+    long sum;
+} ParallelTotals;
+
+static RC count_row(Record *record, void *context)
+{
+    ParallelTotals *totals = context;
+    int id;
+
+    memcpy(&id, record->data + 1, sizeof(int));
+    __sync_fetch_and_add(&totals->sum, id);
+    __sync_fetch_and_add(&totals->rows, 1);
+    return RC_OK;
+}
+
+/**
+ * Scans the whole table with the given method, adding up the first attribute.
+ *
+ * @return Seconds spent scanning, or a negative value on failure
+ */
+static double run_method(int method, RM_TableData *table, Expr *cond, int scans, int threads, long *rows)
+{
+    RM_ScanHandle scan;
+    struct timespec start;
+    RC rc = RC_OK;
+    long sum = 0;
+    int id;
+
+    *rows = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int s = 0; s < scans && rc == RC_OK; s++)
+    {
+        if (method == 3)
+        {
+            ParallelTotals totals = {0, 0};
+            rc = parallelScan(table, cond, threads, count_row, &totals);
+            sum += totals.sum;
+            *rows += totals.rows;
+            continue;
+        }
+        if (startScan(table, &scan, cond) != RC_OK)
+            return -1;
+
+        if (method == 0)
+        {
+            Record *record;
+            createRecord(&record, table->schema);
+            while ((rc = next(&scan, record)) == RC_OK)
+            {
+                memcpy(&id, record->data + 1, sizeof(int));
+                sum += id;
+                (*rows)++;
+            }
+            freeRecord(record);
+        }
+        else if (method == 1)
+        {
+            RM_RecordView view;
+            while ((rc = nextView(&scan, &view)) == RC_OK && getIntAttr(&view, 0, &id) == RC_OK)
+            {
+                sum += id;
+                (*rows)++;
+            }
+        }
+        else
+        {
+            RecordBatch *batch;
+            createRecordBatch(&batch, table->schema, BATCH_ROWS);
+            while ((rc = nextBatch(&scan, batch, BATCH_ROWS)) == RC_OK)
+            {
+                for (int i = 0; i < batch->numRows; i++)
+                {
+                    memcpy(&id, batch->data + i * batch->recordSize + 1, sizeof(int));
+                    sum += id;
+                }
+                *rows += batch->numRows;
+            }
+            freeRecordBatch(batch);
+        }
+
+        if (closeScan(&scan) != RC_OK || rc != RC_RM_NO_MORE_TUPLES)
+            return -1;
+        rc = RC_OK;
+    }
+    double seconds = elapsed_seconds(&start);
+
+    // Keep the sum alive so the reads are not optimised away
+    if (sum == -1)
+        printf("%ld\n", sum);
+    return seconds;
+}
+
+int main(int argc, char *argv[])
+{
+    int numRows = (argc > 1) ? atoi(argv[1]) : 100000;
+    int scans = (argc > 2) ? atoi(argv[2]) : 5;
+    int threads = (argc > 3) ? atoi(argv[3]) : 4;
+    const char *names[] = {"next", "nextView", "nextBatch", "parallelScan"};
+    RM_TableData table;
+    Expr *cond;
+
+    if (numRows <= 0 || scans <= 0 || threads <= 0)
+    {
+        fprintf(stderr, "usage: %s [rows] [scans] [threads]\n", argv[0]);
+        return 1;
+    }
+
+    initRecordManager(NULL);
+    Schema *schema = bench_schema();
+    if (createTable(BENCH_TABLE, schema) != RC_OK || openTable(&table, BENCH_TABLE) != RC_OK ||
+        load_rows(&table, schema, numRows) != RC_OK)
+    {
+        fprintf(stderr, "cannot set up the benchmark\n");
+        return 1;
+    }
+    // Every row matches, so the scan itself is measured
+    MAKE_CONS(cond, stringToValue("bt"));
+
+    printf("%d rows of (int, string(%d), float), %d scans, %d threads\n", numRows, NAME_LENGTH, scans, threads);
+    printf("%-14s %10s %14s\n", "method", "seconds", "rows/sec");
+
+    for (int method = 0; method < 4; method++)
+    {
+        long rows;
+        double seconds = run_method(method, &table, cond, scans, threads, &rows);
+        if (seconds < 0 || rows != (long)numRows * scans)
+        {
+            fprintf(stderr, "%s: benchmark failed\n", names[method]);
+            return 1;
+        }
+        printf("%-14s %10.3f %14.0f\n", names[method], seconds, rows / seconds);
+    }
+
+    freeExpr(cond);
+    closeTable(&table);
+    deleteTable(BENCH_TABLE);
+    freeSchema(schema);
+    shutdownRecordManager();
+    return 0;
+}
@@ -113,6 +113,41 @@ RC handlePagePinning(BM_BufferPool *bm, BM_PageHandle *page, int pageNum, bool s
     return RC_OK;
 }
 
+/**
+ * Allocates the page of a new last node through the storage manager
+ * @param bm Buffer manager pool
+ * @return RC_OK on success, otherwise error code
+ */
+RC allocateNodePage(BM_BufferPool *bm)
+{
+    PageNumber pageNum;
+    RC rc = allocatePoolPage(bm, &pageNum);
+    if (rc != RC_OK)
+    {
+        return rc;
+    }
+
+    // Nodes are found by page number, so they must stay on consecutive pages
+    if (pageNum != lastPage + 1)
+    {
+        freePoolPage(bm, pageNum);
+        return RC_ERROR;
+    }
+
+    lastPage = pageNum;
+    return RC_OK;
+}
+
+/**
+ * Releases the page of the node that followed the last node
+ * @param bm Buffer manager pool
+ * @return RC_OK on success, otherwise error code
+ */
+RC releaseNodePage(BM_BufferPool *bm)
+{
+    return freePoolPage(bm, lastPage + 1);
+}
+
 // ************************************** init and shutdown index manager ************************************
 /**
  * Initializes the index manager
@@ -135,13 +170,28 @@ extern RC shutdownIndexManager()
 
 // ******************************** create, destroy, open, and close an btree index *******************************
 /**
- * Creates a new B-tree index
+ * Creates a new B-tree index with the default page size
  * @param idxId Index identifier (filename)
  * @param keyType Type of keys in the index
  * @param n Order of the B-tree
  * @return RC_OK on success, otherwise error code
  */
 extern RC createBtree(char *idxId, DataType keyType, int n)
+{
+    return createBtreeWithPageSize(idxId, keyType, n, PAGE_SIZE);
+}
+
+/**
+ * Creates a new B-tree index whose file uses the given page size
+ * Nodes are fixed two-key nodes, one per page, whatever the order; n is only
+ * stored in the metadata page. A larger page size does not raise the fanout.
+ * @param idxId Index identifier (filename)
+ * @param keyType Type of keys in the index
+ * @param n Order of the B-tree
+ * @param pageSize Page size of the index file (SM_MIN_PAGE_SIZE to SM_MAX_PAGE_SIZE)
+ * @return RC_OK on success, otherwise error code
+ */
+extern RC createBtreeWithPageSize(char *idxId, DataType keyType, int n, int pageSize)
 {
     // Verify that the key type is integer
     RC result = checkDataType(keyType);
@@ -151,7 +201,8 @@ extern RC createBtree(char *idxId, DataType keyType, int n)
     }
 
     // Create a new page file for the B-tree
-    result = createPageFile(idxId);
+    SM_FileOptions options = {.pageSize = pageSize};
+    result = createPageFileWithOptions(idxId, &options);
     if (result != RC_OK)
     {
         return result;
@@ -174,7 +225,7 @@ extern RC createBtree(char *idxId, DataType keyType, int n)
     }
 
     // Allocate memory for the page
-    SM_PageHandle ph = malloc(PAGE_SIZE * sizeof(char));
+    SM_PageHandle ph = calloc(fh.pageSize, sizeof(char));
     if (ph == NULL)
     {
         closePageFile(&fh);
@@ -234,8 +285,8 @@ extern RC openBtree(BTreeHandle **tree, char *idxId)
         return result;
     }
 
-    // Pin the first page to read B-tree metadata
-    result = pinPage((*trInfo).bm, (*trInfo).page, 1);
+    // Pin the metadata page written by createBtree
+    result = pinPage((*trInfo).bm, (*trInfo).page, 0);
     if (result != RC_OK)
     {
         shutdownBufferPool((*trInfo).bm);
@@ -287,16 +338,26 @@ extern RC openBtree(BTreeHandle **tree, char *idxId)
  */
 extern RC closeBtree(BTreeHandle *tree)
 {
+    TreeInfo *trInfo = (TreeInfo *)((*tree).mgmtData);
+    RC rc = RC_OK;
+
+    // openBtree starts with an empty tree, so release the node pages for reuse
+    while (lastPage > 0 && rc == RC_OK)
+    {
+        lastPage -= 1;
+        rc = releaseNodePage((*trInfo).bm);
+    }
+
     // Reset global variables
     lastPage = 0;
     scanCount = 0;
     
     // Free allocated memory
     free(tree);
-    free(((TreeInfo *)(tree->mgmtData))->page);
-    shutdownBufferPool(((TreeInfo *)(tree->mgmtData))->bm);
+    free((*trInfo).page);
+    shutdownBufferPool((*trInfo).bm);
 
-    return RC_OK;
+    return rc;
 }
 
 /**
@@ -479,7 +540,11 @@ extern RC insertKey(BTreeHandle *tree, Value *key, RID rid)
     {
     case 0:
         // Case: This is the first key being inserted into an empty tree
-        lastPage = 1;
+        rc = allocateNodePage((*trInfo).bm);
+        if (rc != RC_OK)
+        {
+            return rc;
+        }
         (*trInfo).root = 1;
 
         // Pin the first page and mark it as dirty (will be modified)
@@ -521,8 +586,6 @@ extern RC insertKey(BTreeHandle *tree, Value *key, RID rid)
         if ((*(bool *)(*trInfo).page->data) == true)
         {
             // Case: The current page is full, need to create a new page
-            lastPage += 1;
-
             // Unpin the current page
             rc = unpinPage((*trInfo).bm, (*trInfo).page);
             if (rc != RC_OK)
@@ -530,6 +593,12 @@ extern RC insertKey(BTreeHandle *tree, Value *key, RID rid)
                 return rc;
             }
 
+            rc = allocateNodePage((*trInfo).bm);
+            if (rc != RC_OK)
+            {
+                return rc;
+            }
+
             // Pin the new page
             rc = handlePagePinning((*trInfo).bm, (*trInfo).page, lastPage, true);
             if (rc != RC_OK)
@@ -604,6 +673,7 @@ extern RC deleteKey(BTreeHandle *tree, Value *key)
     int valueNum = 0;      // Position of the key in the node (1 or 2)
     RID moveRID;           // RID to move during reorganization
     int moveValue;         // Key value to move during reorganization
+    bool emptied = false;  // Whether the last node lost its only value
     RC rc;
 
     // Search through all pages to find the key
@@ -652,6 +722,13 @@ extern RC deleteKey(BTreeHandle *tree, Value *key)
     }
     else
     {
+        // Unpin the page holding the key, it is pinned again when modified
+        rc = unpinPage((*trInfo).bm, (*trInfo).page);
+        if (rc != RC_OK)
+        {
+            return rc;
+        }
+
         // Key exists - pin the last page for deletion and reorganization
         rc = handlePagePinning((*trInfo).bm, (*trInfo).page, lastPage, true);
         if (rc != RC_OK)
@@ -700,6 +777,7 @@ extern RC deleteKey(BTreeHandle *tree, Value *key)
                         (*node).left = INIT_RID;    // Clear the left RID
                         (*node).value1 = -1;        // Clear the first value
                         lastPage -= 1;              // Reduce page count
+                        emptied = true;
                     }
                     break;
                 }
@@ -710,6 +788,16 @@ extern RC deleteKey(BTreeHandle *tree, Value *key)
                 {
                     return rc;
                 }
+
+                // Release the page of a node that lost its only value
+                if (emptied)
+                {
+                    rc = releaseNodePage((*trInfo).bm);
+                    if (rc != RC_OK)
+                    {
+                        return rc;
+                    }
+                }
             }
             else
             {
@@ -782,12 +870,17 @@ extern RC deleteKey(BTreeHandle *tree, Value *key)
                     (*node).value1 = -1;
                     lastPage -= 1;  // Reduce page count
 
-                    // Unpin the last page
+                    // Unpin the last page and release it
                     rc = unpinPage((*trInfo).bm, (*trInfo).page);
                     if (rc != RC_OK)
                     {
                         return rc;
                     }
+                    rc = releaseNodePage((*trInfo).bm);
+                    if (rc != RC_OK)
+                    {
+                        return rc;
+                    }
 
                     // Pin the page where deletion occurs
                     rc = handlePagePinning((*trInfo).bm, (*trInfo).page, i, true);
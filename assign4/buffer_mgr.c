@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
+#include <pthread.h>
 #include "buffer_mgr.h"
 #include "storage_mgr.h"
 #include <string.h>
@@ -32,6 +34,9 @@ typedef struct BufferPoolMetadata
     int writeCount;    // Number of disk writes performed
     int clockHand;     // Current position for CLOCK algorithm
     int globalTimer;   // Global counter for timestamps
+    SM_FileHandle fileHandle; // Page file handle, kept open for the pool's lifetime
+    bool fileOpen;     // True once fileHandle has been opened
+    pthread_mutex_t lock; // Held by every pool operation, so threads can share the pool
 } BufferPoolMetadata;
 
 /**
@@ -73,6 +78,29 @@ static DLNode *findPage(BufferPoolMetadata *metadata, PageNumber pageNum)
     return NULL;
 }
 
+/**
+ * Returns the pool's page file handle, opening the file on first use.
+ *
+ * The file is opened lazily because a pool may be initialized before its
+ * page file is created. Keeping it open avoids re-reading file metadata
+ * (such as the page-offset map of compressed files) on every I/O.
+ */
+static RC getPoolFile(BM_BufferPool *const bm, SM_FileHandle **fh)
+{
+    BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
+
+    if (!metadata->fileOpen)
+    {
+        RC rc = openPageFile(bm->pageFile, &metadata->fileHandle);
+        if (rc != RC_OK)
+            return rc;
+        metadata->fileOpen = true;
+    }
+
+    *fh = &metadata->fileHandle;
+    return RC_OK;
+}
+
 /**
  * Implements FIFO page replacement strategy
  */
@@ -253,6 +281,10 @@ static DLNode *replaceCLOCK(BufferPoolMetadata *metadata)
  * Allocates and initializes the buffer pool metadata including the frame list,
  * counters, and strategy-specific data. Sets up tracking for page replacements
  * and statistics. The buffer pool starts empty with no frames used.
+ *
+ * The pool may be shared by several threads: every operation on it holds the
+ * pool's lock. The lock is recursive because operations call one another, such
+ * as shutdownBufferPool flushing the pool.
  */
 extern RC initBufferPool(BM_BufferPool *const bm, const char *const pageFileName,
                   const int numPages, ReplacementStrategy strategy, void *stratData)
@@ -268,6 +300,14 @@ extern RC initBufferPool(BM_BufferPool *const bm, const char *const pageFileName
     metadata->writeCount = 0;
     metadata->clockHand = 0;
     metadata->globalTimer = 0;
+    metadata->fileOpen = false;
+
+    // Recursive lock guarding the frames and counters
+    pthread_mutexattr_t lockAttr;
+    pthread_mutexattr_init(&lockAttr);
+    pthread_mutexattr_settype(&lockAttr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&metadata->lock, &lockAttr);
+    pthread_mutexattr_destroy(&lockAttr);
 
     // Initialize buffer pool handle
     bm->pageFile = (char *)pageFileName;
@@ -282,18 +322,27 @@ extern RC initBufferPool(BM_BufferPool *const bm, const char *const pageFileName
  * Shuts down an existing buffer pool and releases all resources.
  *
  * @param bm Buffer pool handle to shut down
- * @return RC_OK on success, RC_PINNED_PAGES_IN_BUFFER if pages still pinned
+ * @return RC_OK on success, RC_PINNED_PAGES_IN_BUFFER if pages still pinned,
+ *         or the error of writing back a dirty page
  *
  * Forces all dirty pages to disk, verifies no pages are pinned, and frees
  * all allocated memory. Checks for pinned pages before shutdown to prevent
- * data loss. Releases both page frames and metadata structures.
+ * data loss. Releases both page frames and metadata structures. A pool
+ * whose dirty pages could not be written is left open, like one with
+ * pinned pages, so the pages are not dropped.
  */
 RC shutdownBufferPool(BM_BufferPool *const bm)
 {
     BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
+    pthread_mutex_lock(&metadata->lock);
 
     // Write all dirty pages to disk
-    forceFlushPool(bm);
+    RC rc = forceFlushPool(bm);
+    if (rc != RC_OK)
+    {
+        pthread_mutex_unlock(&metadata->lock);
+        return rc;
+    }
 
     // Free all allocated memory
     DLNode *current = metadata->head;
@@ -301,7 +350,10 @@ RC shutdownBufferPool(BM_BufferPool *const bm)
     {
         // Check for pinned pages
         if (current->pinCount > 0)
+        {
+            pthread_mutex_unlock(&metadata->lock);
             return RC_PINNED_PAGES_IN_BUFFER;
+        }
 
         // Free node and its data
         DLNode *temp = current;
@@ -310,23 +362,22 @@ RC shutdownBufferPool(BM_BufferPool *const bm)
         free(temp);
     }
 
+    // Release the page file
+    if (metadata->fileOpen)
+        rc = closePageFile(&metadata->fileHandle);
+
     // Free metadata structure
+    pthread_mutex_unlock(&metadata->lock);
+    pthread_mutex_destroy(&metadata->lock);
     free(metadata);
     bm->mgmtData = NULL;
-    return RC_OK;
+    return rc;
 }
 
 /**
- * Writes all dirty pages from buffer pool to disk.
- *
- * @param bm Buffer pool handle containing pages to flush
- * @return RC_OK on successful flush
- *
- * Iterates through all pages in the buffer pool and writes dirty, unpinned
- * pages to disk. Updates write statistics and marks flushed pages as clean.
- * Skips pinned pages even if dirty to maintain consistency.
+ * Body of forceFlushPool, run with the pool's lock held.
  */
-RC forceFlushPool(BM_BufferPool *const bm)
+static RC forceFlushPoolLocked(BM_BufferPool *const bm)
 {
     BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
     DLNode *current = metadata->head;
@@ -337,30 +388,51 @@ RC forceFlushPool(BM_BufferPool *const bm)
         // Write dirty and unpinned pages to disk
         if (current->isDirty && current->pinCount == 0)
         {
-            SM_FileHandle fh;
-            openPageFile(bm->pageFile, &fh);
-            writeBlock(current->pageNum, &fh, current->data);
+            SM_FileHandle *fh;
+            RC rc = getPoolFile(bm, &fh);
+            if (rc != RC_OK)
+                return rc;
+            // A failed write or sync leaves the frame dirty
+            rc = writeBlock(current->pageNum, fh, current->data);
+            if (rc != RC_OK)
+                return rc;
             current->isDirty = false;
             metadata->writeCount++;
-            closePageFile(&fh);
         }
         current = current->next;
     }
+
+    // A full flush is the pool's checkpoint
+    if (metadata->fileOpen)
+        return checkpointPageFile(&metadata->fileHandle);
     return RC_OK;
 }
 
 /**
- * Marks a page in the buffer pool as dirty.
+ * Writes all dirty pages from buffer pool to disk.
  *
- * @param bm Buffer pool handle
- * @param page Page handle of page to mark
- * @return RC_OK if page found and marked, RC_ERROR if page not in pool
+ * @param bm Buffer pool handle containing pages to flush
+ * @return RC_OK on successful flush, or the error of the first write that failed
  *
- * Sets the dirty flag for the specified page indicating it needs to be
- * written to disk before replacement. Essential for maintaining data
- * consistency between memory and disk.
+ * Iterates through all pages in the buffer pool and writes dirty, unpinned
+ * pages to disk. Updates write statistics and marks flushed pages as clean.
+ * Skips pinned pages even if dirty to maintain consistency. Finishes with a
+ * checkpoint of the page file so the flushed pages honour its durability mode.
+ * A page whose write or sync fails stays dirty and the flush stops there.
  */
-RC markDirty(BM_BufferPool *const bm, BM_PageHandle *const page)
+RC forceFlushPool(BM_BufferPool *const bm)
+{
+    BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
+    pthread_mutex_lock(&metadata->lock);
+    RC rc = forceFlushPoolLocked(bm);
+    pthread_mutex_unlock(&metadata->lock);
+    return rc;
+}
+
+/**
+ * Body of markDirty, run with the pool's lock held.
+ */
+static RC markDirtyLocked(BM_BufferPool *const bm, BM_PageHandle *const page)
 {
     // Get metadata structure
     BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
@@ -378,17 +450,29 @@ RC markDirty(BM_BufferPool *const bm, BM_PageHandle *const page)
 }
 
 /**
- * Decrements the pin count of a page.
+ * Marks a page in the buffer pool as dirty.
  *
  * @param bm Buffer pool handle
- * @param page Page handle of page to unpin
- * @return RC_OK on success, RC_ERROR if page not found or already unpinned
+ * @param page Page handle of page to mark
+ * @return RC_OK if page found and marked, RC_ERROR if page not in pool
  *
- * Reduces pin count indicating one fewer client is using the page.
- * Pages with zero pin count become candidates for replacement.
- * Prevents unpinning already unpinned pages.
+ * Sets the dirty flag for the specified page indicating it needs to be
+ * written to disk before replacement. Essential for maintaining data
+ * consistency between memory and disk.
  */
-RC unpinPage(BM_BufferPool *const bm, BM_PageHandle *const page)
+RC markDirty(BM_BufferPool *const bm, BM_PageHandle *const page)
+{
+    BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
+    pthread_mutex_lock(&metadata->lock);
+    RC rc = markDirtyLocked(bm, page);
+    pthread_mutex_unlock(&metadata->lock);
+    return rc;
+}
+
+/**
+ * Body of unpinPage, run with the pool's lock held.
+ */
+static RC unpinPageLocked(BM_BufferPool *const bm, BM_PageHandle *const page)
 {
     // Get metadata structure
     BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
@@ -406,17 +490,34 @@ RC unpinPage(BM_BufferPool *const bm, BM_PageHandle *const page)
 }
 
 /**
- * Immediately writes a page to disk.
+ * Decrements the pin count of a page.
  *
  * @param bm Buffer pool handle
- * @param page Page handle of page to force
- * @return RC_OK on successful write, RC_ERROR if page not found
+ * @param page Page handle of page to unpin
+ * @return RC_OK on success, RC_ERROR if page not found or already unpinned
  *
- * Opens the page file, writes the page content regardless of dirty flag,
- * and updates write statistics. Useful for immediate persistence of
- * critical data changes.
+ * Reduces pin count indicating one fewer client is using the page.
+ * Pages with zero pin count become candidates for replacement.
+ * Prevents unpinning already unpinned pages. Writes a group commit left
+ * unsynced are synced once its interval has passed (see syncOverdueWrites).
  */
-RC forcePage(BM_BufferPool *const bm, BM_PageHandle *const page)
+RC unpinPage(BM_BufferPool *const bm, BM_PageHandle *const page)
+{
+    BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
+    pthread_mutex_lock(&metadata->lock);
+    RC rc = unpinPageLocked(bm, page);
+
+    // Unpins keep a group commit's interval even when no write follows
+    if (rc == RC_OK && metadata->fileOpen)
+        rc = syncOverdueWrites(&metadata->fileHandle);
+    pthread_mutex_unlock(&metadata->lock);
+    return rc;
+}
+
+/**
+ * Body of forcePage, run with the pool's lock held.
+ */
+static RC forcePageLocked(BM_BufferPool *const bm, BM_PageHandle *const page)
 {
     // Get metadata structure
     BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
@@ -426,11 +527,14 @@ RC forcePage(BM_BufferPool *const bm, BM_PageHandle *const page)
 
     if (node != NULL)
     {
-        // Open file and write page
-        SM_FileHandle fh;
-        openPageFile(bm->pageFile, &fh);
-        writeBlock(node->pageNum, &fh, node->data);
-        closePageFile(&fh);
+        // Write page through the pool's file handle
+        SM_FileHandle *fh;
+        RC rc = getPoolFile(bm, &fh);
+        if (rc != RC_OK)
+            return rc;
+        rc = writeBlock(node->pageNum, fh, node->data);
+        if (rc != RC_OK)
+            return rc; // The frame stays dirty
 
         // Update page and statistics
         node->isDirty = false;
@@ -441,19 +545,30 @@ RC forcePage(BM_BufferPool *const bm, BM_PageHandle *const page)
 }
 
 /**
- * Pins a page into the buffer pool, loading it from disk if necessary.
+ * Immediately writes a page to disk.
  *
  * @param bm Buffer pool handle
- * @param page Page handle to store the requested page
- * @param pageNum Page number to be pinned
- * @return RC_OK on success, RC_ERROR on failure
+ * @param page Page handle of page to force
+ * @return RC_OK on successful write, RC_ERROR if page not found, or the
+ *         error of the write, which leaves the page dirty
  *
- * This function first checks if the page is already in the buffer pool.
- * If present, it increments the pin count and updates metadata.
- * If not, it loads the page from disk into an available frame or
- * replaces a page based on the chosen replacement strategy.
+ * Writes the page content to the page file regardless of dirty flag,
+ * and updates write statistics. Useful for immediate persistence of
+ * critical data changes.
  */
-RC pinPage(BM_BufferPool *const bm, BM_PageHandle *const page,
+RC forcePage(BM_BufferPool *const bm, BM_PageHandle *const page)
+{
+    BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
+    pthread_mutex_lock(&metadata->lock);
+    RC rc = forcePageLocked(bm, page);
+    pthread_mutex_unlock(&metadata->lock);
+    return rc;
+}
+
+/**
+ * Body of pinPage, run with the pool's lock held.
+ */
+static RC pinPageLocked(BM_BufferPool *const bm, BM_PageHandle *const page,
            const PageNumber pageNum)
 {
     // Retrieve buffer pool metadata
@@ -480,35 +595,33 @@ RC pinPage(BM_BufferPool *const bm, BM_PageHandle *const page,
     // Check if there is space in the buffer pool
     if (metadata->numFramesUsed < metadata->totalFrames)
     {
-        SM_FileHandle fh;
-        RC rc = openPageFile(bm->pageFile, &fh);
+        SM_FileHandle *fh;
+        RC rc = getPoolFile(bm, &fh);
         if (rc != RC_OK)
             return rc;
 
-        // Allocate memory for the new page
-        SM_PageHandle newData = (SM_PageHandle)malloc(PAGE_SIZE);
+        // Allocate memory for the new page, sized by the file's page size
+        SM_PageHandle newData = (SM_PageHandle)malloc(fh->pageSize);
         if (newData == NULL)
         {
-            closePageFile(&fh);
             return RC_ERROR;
         }
 
         // Initialize the page memory with zeros
-        memset(newData, 0, PAGE_SIZE);
+        memset(newData, 0, fh->pageSize);
 
         // Ensure the file has enough pages
-        rc = ensureCapacity(pageNum + 1, &fh);
+        rc = ensureCapacity(pageNum + 1, fh);
         if (rc != RC_OK)
         {
             free(newData);
-            closePageFile(&fh);
             return rc;
         }
 
         // Read the page from disk if it exists
-        if (pageNum < fh.totalNumPages)
+        if (pageNum < fh->totalNumPages)
         {
-            rc = readBlock(pageNum, &fh, newData);
+            rc = readBlock(pageNum, fh, newData);
             if (rc != RC_OK)
             {
                 // If read fails, initialize with default content
@@ -521,8 +634,6 @@ RC pinPage(BM_BufferPool *const bm, BM_PageHandle *const page,
             sprintf(newData, "Page-%i", pageNum);
         }
 
-        closePageFile(&fh);
-
         // Create a new node for this page
         DLNode *newNode = createNode(newData, pageNum);
         metadata->globalTimer++;
@@ -585,39 +696,34 @@ RC pinPage(BM_BufferPool *const bm, BM_PageHandle *const page,
         return RC_ERROR;
 
     // If the victim page is dirty, write it to disk before replacing
+    SM_FileHandle *fh;
+    RC rc = getPoolFile(bm, &fh);
+    if (rc != RC_OK)
+        return rc;
+
     if (victim->isDirty)
     {
-        SM_FileHandle fh;
-        RC rc = openPageFile(bm->pageFile, &fh);
+        // Keep the victim if its page did not reach the file
+        rc = writeBlock(victim->pageNum, fh, victim->data);
         if (rc != RC_OK)
             return rc;
-
-        writeBlock(victim->pageNum, &fh, victim->data);
-        closePageFile(&fh);
         metadata->writeCount++;
     }
 
     // Reset the victim's memory for new data
-    memset(victim->data, 0, PAGE_SIZE);
-
-    // Open the page file again for reading
-    SM_FileHandle fh;
-    RC rc = openPageFile(bm->pageFile, &fh);
-    if (rc != RC_OK)
-        return rc;
+    memset(victim->data, 0, fh->pageSize);
 
     // Ensure sufficient capacity before reading
-    rc = ensureCapacity(pageNum + 1, &fh);
+    rc = ensureCapacity(pageNum + 1, fh);
     if (rc != RC_OK)
     {
-        closePageFile(&fh);
         return rc;
     }
 
     // Read or initialize the new page content
-    if (pageNum < fh.totalNumPages)
+    if (pageNum < fh->totalNumPages)
     {
-        rc = readBlock(pageNum, &fh, victim->data);
+        rc = readBlock(pageNum, fh, victim->data);
         if (rc != RC_OK)
         {
             sprintf(victim->data, "Page-%i", pageNum);
@@ -628,8 +734,6 @@ RC pinPage(BM_BufferPool *const bm, BM_PageHandle *const page,
         sprintf(victim->data, "Page-%i", pageNum);
     }
 
-    closePageFile(&fh);
-
     // Update the victim node with the new page details
     victim->pageNum = pageNum;
     victim->isDirty = false;
@@ -646,6 +750,100 @@ RC pinPage(BM_BufferPool *const bm, BM_PageHandle *const page,
     return RC_OK;
 }
 
+/**
+ * Pins a page into the buffer pool, loading it from disk if necessary.
+ *
+ * @param bm Buffer pool handle
+ * @param page Page handle to store the requested page
+ * @param pageNum Page number to be pinned
+ * @return RC_OK on success, RC_ERROR on failure
+ *
+ * This function first checks if the page is already in the buffer pool.
+ * If present, it increments the pin count and updates metadata.
+ * If not, it loads the page from disk into an available frame or
+ * replaces a page based on the chosen replacement strategy.
+ */
+RC pinPage(BM_BufferPool *const bm, BM_PageHandle *const page,
+           const PageNumber pageNum)
+{
+    BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
+    pthread_mutex_lock(&metadata->lock);
+    RC rc = pinPageLocked(bm, page, pageNum);
+    pthread_mutex_unlock(&metadata->lock);
+    return rc;
+}
+
+/**
+ * Allocates a page of the pool's page file.
+ *
+ * @param bm Buffer pool handle
+ * @param pageNum Set to the number of the allocated page
+ * @return RC_OK if successful, error code of the storage manager otherwise
+ *
+ * Reuses a page released by freePoolPage before growing the file. The page
+ * reads back zero-filled, including a frame that cached the released page;
+ * it is not pinned.
+ */
+RC allocatePoolPage(BM_BufferPool *const bm, PageNumber *pageNum)
+{
+    BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
+    SM_FileHandle *fh;
+
+    pthread_mutex_lock(&metadata->lock);
+    RC rc = getPoolFile(bm, &fh);
+    if (rc == RC_OK)
+        rc = allocatePage(fh, pageNum);
+    if (rc == RC_OK)
+    {
+        DLNode *node = findPage(metadata, *pageNum);
+        if (node != NULL)
+        {
+            memset(node->data, 0, fh->pageSize);
+            node->isDirty = false;
+        }
+    }
+    pthread_mutex_unlock(&metadata->lock);
+    return rc;
+}
+
+/**
+ * Releases a page of the pool's page file for reuse by allocatePoolPage.
+ *
+ * @param bm Buffer pool handle
+ * @param pageNum Page to release
+ * @return RC_OK if successful, RC_PINNED_PAGES_IN_BUFFER if the page is
+ *         pinned, error code of the storage manager otherwise
+ *
+ * A dirty frame of the page is written back and then dropped, so the page
+ * reads back as it was left until it is reallocated.
+ */
+RC freePoolPage(BM_BufferPool *const bm, const PageNumber pageNum)
+{
+    BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
+    SM_FileHandle *fh;
+
+    pthread_mutex_lock(&metadata->lock);
+    DLNode *node = findPage(metadata, pageNum);
+    RC rc = (node != NULL && node->pinCount > 0) ? RC_PINNED_PAGES_IN_BUFFER
+                                                 : getPoolFile(bm, &fh);
+    if (rc == RC_OK && node != NULL && node->isDirty)
+    {
+        rc = writeBlock(node->pageNum, fh, node->data);
+        if (rc == RC_OK)
+            metadata->writeCount++;
+    }
+    if (rc == RC_OK)
+        rc = freePage(fh, pageNum);
+    if (rc == RC_OK && node != NULL)
+    {
+        // Leave an empty frame for the replacement strategy to reuse
+        node->pageNum = NO_PAGE;
+        node->isDirty = false;
+    }
+    pthread_mutex_unlock(&metadata->lock);
+    return rc;
+}
+
 /**
  * Retrieves the page numbers stored in each frame.
  *
@@ -660,6 +858,7 @@ PageNumber *getFrameContents(BM_BufferPool *const bm)
 {
     // Get metadata structure
     BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
+    pthread_mutex_lock(&metadata->lock);
 
     // Allocate array for frame contents
     PageNumber *frameContents = malloc(sizeof(PageNumber) * metadata->totalFrames);
@@ -677,6 +876,7 @@ PageNumber *getFrameContents(BM_BufferPool *const bm)
         current = current->next;
     }
 
+    pthread_mutex_unlock(&metadata->lock);
     return frameContents;
 }
 
@@ -694,6 +894,7 @@ bool *getDirtyFlags(BM_BufferPool *const bm)
 {
     // Get metadata structure
     BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
+    pthread_mutex_lock(&metadata->lock);
 
     // Allocate array for dirty flags
     bool *dirtyFlags = malloc(sizeof(bool) * metadata->totalFrames);
@@ -711,6 +912,7 @@ bool *getDirtyFlags(BM_BufferPool *const bm)
         current = current->next;
     }
 
+    pthread_mutex_unlock(&metadata->lock);
     return dirtyFlags;
 }
 
@@ -728,6 +930,7 @@ int *getFixCounts(BM_BufferPool *const bm)
 {
     // Get metadata structure
     BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
+    pthread_mutex_lock(&metadata->lock);
 
     // Allocate array for fix counts
     int *fixCounts = malloc(sizeof(int) * metadata->totalFrames);
@@ -745,6 +948,7 @@ int *getFixCounts(BM_BufferPool *const bm)
         current = current->next;
     }
 
+    pthread_mutex_unlock(&metadata->lock);
     return fixCounts;
 }
 
@@ -764,6 +968,50 @@ int getNumReadIO(BM_BufferPool *const bm)
     return metadata->readCount;
 }
 
+/**
+ * Returns the page size of the pool's page file.
+ *
+ * @param bm Buffer pool handle
+ * @return Page size in bytes, or -1 if the page file cannot be opened
+ *
+ * Every frame of the pool holds one page of this size. Opens the page file
+ * if no page has been pinned yet.
+ */
+int getPoolPageSize(BM_BufferPool *const bm)
+{
+    BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
+    SM_FileHandle *fh;
+    int pageSize = -1;
+
+    pthread_mutex_lock(&metadata->lock);
+    if (getPoolFile(bm, &fh) == RC_OK)
+        pageSize = fh->pageSize;
+    pthread_mutex_unlock(&metadata->lock);
+    return pageSize;
+}
+
+/**
+ * Returns the number of pages in the pool's page file.
+ *
+ * @param bm Buffer pool handle
+ * @return Number of pages, or -1 if the page file cannot be opened
+ *
+ * Pages appended by pinning past the end of the file are included, whether
+ * or not they have been written back yet.
+ */
+int getPoolNumPages(BM_BufferPool *const bm)
+{
+    BufferPoolMetadata *metadata = (BufferPoolMetadata *)bm->mgmtData;
+    SM_FileHandle *fh;
+    int numPages = -1;
+
+    pthread_mutex_lock(&metadata->lock);
+    if (getPoolFile(bm, &fh) == RC_OK)
+        numPages = fh->totalNumPages;
+    pthread_mutex_unlock(&metadata->lock);
+    return numPages;
+}
+
 /**
  * Returns total number of pages written to disk.
  *
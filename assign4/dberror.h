@@ -4,7 +4,7 @@
 #include "stdio.h"
 
 /* module wide constants */
-#define PAGE_SIZE 4096
+#define PAGE_SIZE 4096 // default page size of new page files
 
 /* return code definitions */
 typedef int RC;
@@ -42,6 +42,15 @@ typedef int RC;
 // Added new definitions for Record Manager
 #define RC_RM_NO_TUPLE_WITH_GIVEN_RID 600
 #define RC_SCAN_CONDITION_NOT_FOUND 601
+#define RC_RM_BAD_CSV_LINE 602
+
+// Added new definitions for Storage Manager
+#define RC_PAGE_DECOMPRESSION_FAILED 700
+#define RC_INVALID_PAGE_SIZE 701
+#define RC_PAGE_ALREADY_FREE 702
+#define RC_FORMAT_NOT_SUPPORTED 703
+#define RC_INVALID_DURABILITY 704
+#define RC_INVALID_SEGMENT_SIZE 705
 
 /* holder for error messages */
 extern char *RC_message;
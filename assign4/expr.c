@@ -50,6 +50,7 @@ valueSmaller (Value *left, Value *right, Value *result)
 		break;
 	case DT_BOOL:
 		result->v.boolV = (left->v.boolV < right->v.boolV);
+		break;
 	case DT_STRING:
 		result->v.boolV = (strcmp(left->v.stringV, right->v.stringV) < 0);
 		break;
@@ -74,6 +75,7 @@ boolAnd (Value *left, Value *right, Value *result)
 {
 	if (left->dt != DT_BOOL || right->dt != DT_BOOL)
 		THROW(RC_RM_BOOLEAN_EXPR_ARG_IS_NOT_BOOLEAN, "boolean AND requires boolean inputs");
+	result->dt = DT_BOOL;
 	result->v.boolV = (left->v.boolV && right->v.boolV);
 
 	return RC_OK;
@@ -84,107 +86,1072 @@ boolOr (Value *left, Value *right, Value *result)
 {
 	if (left->dt != DT_BOOL || right->dt != DT_BOOL)
 		THROW(RC_RM_BOOLEAN_EXPR_ARG_IS_NOT_BOOLEAN, "boolean OR requires boolean inputs");
+	result->dt = DT_BOOL;
 	result->v.boolV = (left->v.boolV || right->v.boolV);
 
 	return RC_OK;
 }
 
-RC
-evalExpr (Record *record, Schema *schema, Expr *expr, Value **result)
+/* Allocates a value from the arena, or with malloc without one. */
+static Value *
+newValue (Arena *arena)
+{
+	return (Value *) allocFromArena(arena, sizeof(Value));
+}
+
+/* Frees an intermediate value, unless the arena it came from does that. */
+static void
+dropValue (Value *value, Arena *arena)
+{
+	if (arena == NULL)
+		freeVal(value);
+}
+
+/*
+ * Orders two values of the same datatype: order is -1, 0 or 1 as left is
+ * smaller, equal or greater, and 2 for floats that do not compare (NaN).
+ */
+static RC
+compareValues (Value *left, Value *right, int *order)
+{
+	int c;
+
+	if(left->dt != right->dt)
+		THROW(RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE, "comparison only supported for values of the same datatype");
+
+	switch(left->dt) {
+	case DT_INT:
+		*order = (left->v.intV > right->v.intV) - (left->v.intV < right->v.intV);
+		break;
+	case DT_FLOAT:
+		*order = (left->v.floatV < right->v.floatV) ? -1 : (left->v.floatV > right->v.floatV) ? 1
+				: (left->v.floatV == right->v.floatV) ? 0 : 2;
+		break;
+	case DT_BOOL:
+		*order = (left->v.boolV > right->v.boolV) - (left->v.boolV < right->v.boolV);
+		break;
+	case DT_STRING:
+		c = strcmp(left->v.stringV, right->v.stringV);
+		*order = (c > 0) - (c < 0);
+		break;
+	}
+
+	return RC_OK;
+}
+
+/* Whether an order found by compareValues satisfies a comparison operator. */
+static bool
+orderMatches (OpType type, int order)
+{
+	switch(type)
+	{
+	case OP_COMP_EQUAL:
+		return order == 0;
+	case OP_COMP_SMALLER:
+		return order == -1;
+	case OP_COMP_SMALLER_EQUAL:
+		return order == -1 || order == 0;
+	case OP_COMP_GREATER:
+		return order == 1;
+	case OP_COMP_GREATER_EQUAL:
+		return order == 1 || order == 0;
+	case OP_COMP_NOT_EQUAL:
+		return order != 0;
+	default:
+		return FALSE;
+	}
+}
+
+/*
+ * Evaluates an operator into result. Operands are only evaluated as far as
+ * the result needs them: AND stops at a FALSE left side and OR at a TRUE
+ * one, BETWEEN reads the upper bound only if the lower bound holds, and IN
+ * stops at the first value that matches.
+ */
+static RC
+evalOperator (Record *record, Schema *schema, Operator *op, Value *result, Arena *arena)
 {
 	Value *lIn;
 	Value *rIn;
-	MAKE_VALUE(*result, DT_INT, -1);
+	int order = 0, i;
+	RC rc = RC_OK;
+
+	rc = evalExprWithArena(record, schema, op->args[0], &lIn, arena);
+	if (rc != RC_OK)
+		return rc;
+
+	switch(op->type)
+	{
+	case OP_BOOL_NOT:
+		rc = boolNot(lIn, result);
+		break;
+	case OP_BOOL_AND:
+	case OP_BOOL_OR:
+		// FALSE decides an AND and TRUE an OR without the right side
+		if (lIn->dt == DT_BOOL && lIn->v.boolV == (op->type == OP_BOOL_OR))
+		{
+			result->dt = DT_BOOL;
+			result->v.boolV = lIn->v.boolV;
+			break;
+		}
+		rc = evalExprWithArena(record, schema, op->args[1], &rIn, arena);
+		if (rc != RC_OK)
+			break;
+		rc = (op->type == OP_BOOL_AND) ? boolAnd(lIn, rIn, result) : boolOr(lIn, rIn, result);
+		dropValue(rIn, arena);
+		break;
+	case OP_COMP_BETWEEN:
+	case OP_COMP_IN:
+		result->dt = DT_BOOL;
+		result->v.boolV = FALSE;
+		for (i = 1; i < op->numArgs; i++)
+		{
+			rc = evalExprWithArena(record, schema, op->args[i], &rIn, arena);
+			if (rc != RC_OK)
+				break;
+			rc = compareValues(lIn, rIn, &order);
+			dropValue(rIn, arena);
+			if (rc != RC_OK)
+				break;
+			if (op->type == OP_COMP_IN && order == 0)
+			{
+				result->v.boolV = TRUE;
+				break;
+			}
+			if (op->type == OP_COMP_BETWEEN
+					&& !orderMatches((i == 1) ? OP_COMP_GREATER_EQUAL : OP_COMP_SMALLER_EQUAL, order))
+				break;
+			if (op->type == OP_COMP_BETWEEN && i == 2)
+				result->v.boolV = TRUE;
+		}
+		break;
+	default:
+		rc = evalExprWithArena(record, schema, op->args[1], &rIn, arena);
+		if (rc != RC_OK)
+			break;
+		if (op->type == OP_COMP_EQUAL)
+			rc = valueEquals(lIn, rIn, result);
+		else if (op->type == OP_COMP_SMALLER)
+			rc = valueSmaller(lIn, rIn, result);
+		else
+		{
+			rc = compareValues(lIn, rIn, &order);
+			result->dt = DT_BOOL;
+			result->v.boolV = orderMatches(op->type, order);
+		}
+		dropValue(rIn, arena);
+		break;
+	}
+
+	// cleanup, left to the arena if there is one
+	dropValue(lIn, arena);
+	return rc;
+}
+
+RC
+evalExpr (Record *record, Schema *schema, Expr *expr, Value **result)
+{
+	return evalExprWithArena(record, schema, expr, result, NULL);
+}
+
+/*
+ * Evaluates an expression like evalExpr, but takes the result and every
+ * intermediate value from an arena. Nothing is freed one by one; the values
+ * stay valid until the arena is reset or released past them.
+ */
+RC
+evalExprWithArena (Record *record, Schema *schema, Expr *expr, Value **result, Arena *arena)
+{
+	RC rc = RC_OK;
+
+	*result = newValue(arena);
+	(*result)->dt = DT_INT;
+	(*result)->v.intV = -1;
+
+	switch(expr->type)
+	{
+	case EXPR_OP:
+		rc = evalOperator(record, schema, expr->expr.op, *result, arena);
+		break;
+	case EXPR_CONST:
+		if (arena != NULL && expr->expr.cons->dt == DT_STRING)
+		{
+			(*result)->dt = DT_STRING;
+			(*result)->v.stringV = arenaStrdup(arena, expr->expr.cons->v.stringV);
+		}
+		else
+			CPVAL(*result,expr->expr.cons);
+		break;
+	case EXPR_ATTRREF:
+		if (arena == NULL)
+			free(*result);
+		*result = NULL; // set by getAttr, and left NULL if it fails
+		rc = getAttrWithArena(record, schema, expr->expr.attrRef, result, arena);
+		break;
+	}
+
+	// errors reach the caller, which gets no value with them
+	if (rc != RC_OK && *result != NULL)
+	{
+		dropValue(*result, arena);
+		*result = NULL;
+	}
+	return rc;
+}
+
+RC
+freeExpr (Expr *expr)
+{
+	int i;
 
 	switch(expr->type)
 	{
 	case EXPR_OP:
 	{
 		Operator *op = expr->expr.op;
-		bool twoArgs = (op->type != OP_BOOL_NOT);
-		//      lIn = (Value *) malloc(sizeof(Value));
-		//    rIn = (Value *) malloc(sizeof(Value));
+		for (i = 0; i < op->numArgs; i++)
+			freeExpr(op->args[i]);
+		free(op->args);
+		free(op);
+	}
+	break;
+	case EXPR_CONST:
+		freeVal(expr->expr.cons);
+		break;
+	case EXPR_ATTRREF:
+		break;
+	}
+	free(expr);
+
+	return RC_OK;
+}
+
+void 
+freeVal (Value *val)
+{
+	if (val->dt == DT_STRING)
+		free(val->v.stringV);
+	free(val);
+}
+
+
+// optimizing conditions
+
+/*
+ * Copies an expression with its constants.
+ */
+static Expr *
+copyExpr (Expr *expr)
+{
+	Expr *copy = (Expr *) malloc(sizeof(Expr));
+	Operator *op;
+	int i;
+
+	copy->type = expr->type;
+	switch(expr->type)
+	{
+	case EXPR_OP:
+		op = (Operator *) malloc(sizeof(Operator));
+		op->type = expr->expr.op->type;
+		op->numArgs = expr->expr.op->numArgs;
+		op->args = (Expr **) malloc(op->numArgs * sizeof(Expr*));
+		for (i = 0; i < op->numArgs; i++)
+			op->args[i] = copyExpr(expr->expr.op->args[i]);
+		copy->expr.op = op;
+		break;
+	case EXPR_CONST:
+		copy->expr.cons = (Value *) malloc(sizeof(Value));
+		CPVAL(copy->expr.cons, expr->expr.cons);
+		break;
+	case EXPR_ATTRREF:
+		copy->expr.attrRef = expr->expr.attrRef;
+		break;
+	}
+
+	return copy;
+}
+
+/*
+ * Returns the datatype an operand evaluates to, or -1 for an attribute the
+ * schema does not have.
+ */
+static int
+operandType (Expr *expr, Schema *schema)
+{
+	switch(expr->type)
+	{
+	case EXPR_CONST:
+		return expr->expr.cons->dt;
+	case EXPR_ATTRREF:
+		if (schema == NULL || expr->expr.attrRef < 0 || expr->expr.attrRef >= schema->numAttr)
+			return -1;
+		return schema->dataTypes[expr->expr.attrRef];
+	default:
+		// every operator that evaluates at all results in a boolean
+		return DT_BOOL;
+	}
+}
+
+/* Whether an operator compares its arguments rather than combining booleans. */
+static bool
+isComparison (OpType type)
+{
+	return type >= OP_COMP_EQUAL;
+}
+
+/* Frees an operator node, leaving its arguments alone. */
+static void
+freeOperatorNode (Expr *expr)
+{
+	free(expr->expr.op->args);
+	free(expr->expr.op);
+	free(expr);
+}
+
+/* Replaces an expression by a boolean constant. */
+static Expr *
+boolConstant (Expr *expr, bool value)
+{
+	Expr *result;
+
+	freeExpr(expr);
+	MAKE_CONS(result, (Value *) malloc(sizeof(Value)));
+	result->expr.cons->dt = DT_BOOL;
+	result->expr.cons->v.boolV = value;
+	return result;
+}
+
+/*
+ * Folds the constant parts of an expression. Operators on constants are
+ * evaluated once, and an AND or OR with a constant side is decided by it or
+ * reduced to its other side. Operators whose constants do not have the
+ * types they need are left for evalExpr to report.
+ */
+static Expr *
+foldExpr (Expr *expr, Schema *schema)
+{
+	Operator *op;
+	Value *result;
+	int i, dt;
+	bool constant = TRUE;
 
-		CHECK(evalExpr(record, schema, op->args[0], &lIn));
-		if (twoArgs)
-			CHECK(evalExpr(record, schema, op->args[1], &rIn));
+	if (expr->type != EXPR_OP)
+		return expr;
+
+	op = expr->expr.op;
+	dt = isComparison(op->type) ? operandType(op->args[0], schema) : DT_BOOL;
+	for (i = 0; i < op->numArgs; i++)
+	{
+		op->args[i] = foldExpr(op->args[i], schema);
+		if (op->args[i]->type != EXPR_CONST || op->args[i]->expr.cons->dt != dt)
+			constant = FALSE;
+	}
+
+	if (constant)
+	{
+		evalExpr(NULL, schema, expr, &result);
+		expr = boolConstant(expr, result->v.boolV);
+		freeVal(result);
+		return expr;
+	}
+
+	if (op->type == OP_BOOL_AND || op->type == OP_BOOL_OR)
+	{
+		for (i = 0; i < 2; i++)
+		{
+			Expr *side = op->args[i];
+			Expr *other = op->args[1 - i];
+			if (side->type != EXPR_CONST || side->expr.cons->dt != DT_BOOL)
+				continue;
+			// FALSE decides an AND and TRUE an OR
+			if (side->expr.cons->v.boolV == (op->type == OP_BOOL_OR))
+				return boolConstant(expr, side->expr.cons->v.boolV);
+			// otherwise the other side is the result, if it is a boolean
+			if (operandType(other, schema) == DT_BOOL)
+			{
+				freeExpr(side);
+				freeOperatorNode(expr);
+				return other;
+			}
+		}
+	}
 
+	return expr;
+}
+
+/*
+ * Returns the comparison that is true exactly when the given one is false,
+ * or -1 if there is none. Orderings of floats have none, since a NaN fails
+ * a comparison and its opposite alike.
+ */
+static int
+negatedComparison (Operator *op, Schema *schema)
+{
+	int left = operandType(op->args[0], schema);
+	int right = (op->numArgs > 1) ? operandType(op->args[1], schema) : -1;
+	bool floats = (left == DT_FLOAT || right == DT_FLOAT || left == -1 || right == -1);
+
+	switch(op->type)
+	{
+	case OP_COMP_EQUAL:
+		return OP_COMP_NOT_EQUAL;
+	case OP_COMP_NOT_EQUAL:
+		return OP_COMP_EQUAL;
+	case OP_COMP_SMALLER:
+		return floats ? -1 : OP_COMP_GREATER_EQUAL;
+	case OP_COMP_SMALLER_EQUAL:
+		return floats ? -1 : OP_COMP_GREATER;
+	case OP_COMP_GREATER:
+		return floats ? -1 : OP_COMP_SMALLER_EQUAL;
+	case OP_COMP_GREATER_EQUAL:
+		return floats ? -1 : OP_COMP_SMALLER;
+	default:
+		return -1;
+	}
+}
+
+/*
+ * Returns an expression for NOT expr, pushing the NOT as far down as it
+ * goes: NOT NOT x is x, NOT of an AND or OR follows De Morgan, and NOT of a
+ * comparison becomes the opposite comparison. Takes expr over.
+ */
+static Expr *
+negateExpr (Expr *expr, Schema *schema)
+{
+	Operator *op;
+	Expr *result;
+	int negated;
+
+	if (expr->type == EXPR_CONST && expr->expr.cons->dt == DT_BOOL)
+	{
+		expr->expr.cons->v.boolV = !expr->expr.cons->v.boolV;
+		return expr;
+	}
+	if (expr->type == EXPR_OP)
+	{
+		op = expr->expr.op;
 		switch(op->type)
 		{
 		case OP_BOOL_NOT:
-			CHECK(boolNot(lIn, *result));
-			break;
+			result = op->args[0];
+			freeOperatorNode(expr);
+			return result;
 		case OP_BOOL_AND:
-			CHECK(boolAnd(lIn, rIn, *result));
-			break;
 		case OP_BOOL_OR:
-			CHECK(boolOr(lIn, rIn, *result));
-			break;
-		case OP_COMP_EQUAL:
-			CHECK(valueEquals(lIn, rIn, *result));
-			break;
-		case OP_COMP_SMALLER:
-			CHECK(valueSmaller(lIn, rIn, *result));
-			break;
+			op->type = (op->type == OP_BOOL_AND) ? OP_BOOL_OR : OP_BOOL_AND;
+			op->args[0] = negateExpr(op->args[0], schema);
+			op->args[1] = negateExpr(op->args[1], schema);
+			return expr;
 		default:
+			negated = negatedComparison(op, schema);
+			if (negated != -1)
+			{
+				op->type = negated;
+				return expr;
+			}
 			break;
 		}
+	}
 
-		// cleanup
-		freeVal(lIn);
-		if (twoArgs)
-			freeVal(rIn);
+	MAKE_UNOP_EXPR(result, expr, OP_BOOL_NOT);
+	return result;
+}
+
+/*
+ * Pushes every NOT of an expression down, see negateExpr.
+ */
+static Expr *
+pushNots (Expr *expr, Schema *schema)
+{
+	Operator *op;
+	Expr *arg;
+	int i;
+
+	if (expr->type != EXPR_OP)
+		return expr;
+
+	op = expr->expr.op;
+	for (i = 0; i < op->numArgs; i++)
+		op->args[i] = pushNots(op->args[i], schema);
+	if (op->type != OP_BOOL_NOT || (arg = op->args[0])->type != EXPR_OP)
+		return expr;
+
+	// a NOT that cannot be pushed further stays
+	if (arg->expr.op->type != OP_BOOL_NOT && arg->expr.op->type != OP_BOOL_AND
+			&& arg->expr.op->type != OP_BOOL_OR && negatedComparison(arg->expr.op, schema) == -1)
+		return expr;
+	freeOperatorNode(expr);
+	return negateExpr(arg, schema);
+}
+
+/*
+ * Rewrites comparisons of a constant with an attribute as comparisons of the
+ * attribute with the constant, turning the operator around.
+ */
+static void
+canonicalizeExpr (Expr *expr)
+{
+	Operator *op;
+	Expr *swap;
+	int i;
+
+	if (expr->type != EXPR_OP)
+		return;
+
+	op = expr->expr.op;
+	for (i = 0; i < op->numArgs; i++)
+		canonicalizeExpr(op->args[i]);
+	if (!isComparison(op->type) || op->numArgs != 2
+			|| op->args[0]->type != EXPR_CONST || op->args[1]->type != EXPR_ATTRREF)
+		return;
+
+	swap = op->args[0];
+	op->args[0] = op->args[1];
+	op->args[1] = swap;
+	switch(op->type)
+	{
+	case OP_COMP_SMALLER:
+		op->type = OP_COMP_GREATER;
+		break;
+	case OP_COMP_SMALLER_EQUAL:
+		op->type = OP_COMP_GREATER_EQUAL;
+		break;
+	case OP_COMP_GREATER:
+		op->type = OP_COMP_SMALLER;
+		break;
+	case OP_COMP_GREATER_EQUAL:
+		op->type = OP_COMP_SMALLER_EQUAL;
+		break;
+	default:
+		break;
 	}
-	break;
+}
+
+/*
+ * Estimates how early a conjunct should run: lower ranks are cheaper or
+ * reject more records. Equality is the most selective comparison and
+ * inequality the least; strings cost more to compare than numbers, and
+ * operators of operators have an unknown cost.
+ */
+static int
+conjunctRank (Expr *expr, Schema *schema)
+{
+	Operator *op;
+	int rank;
+
+	if (expr->type != EXPR_OP)
+		return 1;
+
+	op = expr->expr.op;
+	switch(op->type)
+	{
+	case OP_COMP_EQUAL:
+		rank = 0;
+		break;
+	case OP_COMP_IN:
+		rank = 2 + op->numArgs / 8;
+		break;
+	case OP_COMP_BETWEEN:
+		rank = 4;
+		break;
+	case OP_COMP_SMALLER:
+	case OP_COMP_SMALLER_EQUAL:
+	case OP_COMP_GREATER:
+	case OP_COMP_GREATER_EQUAL:
+		rank = 6;
+		break;
+	case OP_COMP_NOT_EQUAL:
+		rank = 8;
+		break;
+	default:
+		return 10;
+	}
+	if (operandType(op->args[0], schema) == DT_STRING)
+		rank += 1;
+	return rank;
+}
+
+/* Counts the conjuncts of a chain of ANDs. */
+static int
+countConjuncts (Expr *expr)
+{
+	if (expr->type != EXPR_OP || expr->expr.op->type != OP_BOOL_AND)
+		return 1;
+	return countConjuncts(expr->expr.op->args[0]) + countConjuncts(expr->expr.op->args[1]);
+}
+
+/* Collects the conjuncts and the AND nodes of a chain of ANDs. */
+static void
+collectConjuncts (Expr *expr, Expr **conjuncts, int *numConjuncts, Expr **ands, int *numAnds)
+{
+	if (expr->type != EXPR_OP || expr->expr.op->type != OP_BOOL_AND)
+	{
+		conjuncts[(*numConjuncts)++] = expr;
+		return;
+	}
+	ands[(*numAnds)++] = expr;
+	collectConjuncts(expr->expr.op->args[0], conjuncts, numConjuncts, ands, numAnds);
+	collectConjuncts(expr->expr.op->args[1], conjuncts, numConjuncts, ands, numAnds);
+}
+
+/*
+ * Orders the conjuncts of every chain of ANDs by conjunctRank, keeping the
+ * written order among equals, and rebuilds the chain so that they are
+ * evaluated in that order and the cheapest, most selective one can stop the
+ * AND first.
+ */
+static Expr *
+orderConjuncts (Expr *expr, Schema *schema)
+{
+	Expr **conjuncts, **ands;
+	int numConjuncts = 0, numAnds = 0, i, j;
+
+	if (expr->type != EXPR_OP)
+		return expr;
+	if (expr->expr.op->type != OP_BOOL_AND)
+	{
+		for (i = 0; i < expr->expr.op->numArgs; i++)
+			expr->expr.op->args[i] = orderConjuncts(expr->expr.op->args[i], schema);
+		return expr;
+	}
+
+	i = countConjuncts(expr);
+	conjuncts = (Expr **) malloc(i * sizeof(Expr*));
+	ands = (Expr **) malloc(i * sizeof(Expr*));
+	if (conjuncts == NULL || ands == NULL)
+	{
+		free(conjuncts);
+		free(ands);
+		return expr;
+	}
+	collectConjuncts(expr, conjuncts, &numConjuncts, ands, &numAnds);
+
+	for (i = 0; i < numConjuncts; i++)
+		conjuncts[i] = orderConjuncts(conjuncts[i], schema);
+	for (i = 1; i < numConjuncts; i++)
+	{
+		Expr *c = conjuncts[i];
+		int rank = conjunctRank(c, schema);
+		for (j = i; j > 0 && conjunctRank(conjuncts[j - 1], schema) > rank; j--)
+			conjuncts[j] = conjuncts[j - 1];
+		conjuncts[j] = c;
+	}
+
+	// a left-deep chain evaluates the conjuncts from the first on
+	for (i = 0; i < numAnds; i++)
+	{
+		ands[i]->expr.op->args[0] = (i == 0) ? conjuncts[0] : ands[i - 1];
+		ands[i]->expr.op->args[1] = conjuncts[i + 1];
+	}
+	expr = ands[numAnds - 1];
+	free(conjuncts);
+	free(ands);
+	return expr;
+}
+
+/*
+ * Rewrites a condition for evaluation on records of the given schema, once
+ * before a scan. The result is a new expression, which the caller frees:
+ * constant parts are folded, NOTs are pushed down to the comparisons,
+ * comparisons are written attribute op constant, and the conjuncts of ANDs
+ * are ordered by estimated selectivity and cost. The result holds for a
+ * record exactly when the condition does; only errors of operands that no
+ * longer need to be evaluated disappear.
+ */
+RC
+optimizeExpr (Expr *expr, Schema *schema, Expr **result)
+{
+	Expr *optimized;
+
+	if (expr == NULL || result == NULL)
+		return RC_INVALID_PARAMETER;
+
+	optimized = copyExpr(expr);
+	optimized = foldExpr(optimized, schema);
+	optimized = pushNots(optimized, schema);
+	canonicalizeExpr(optimized);
+	optimized = foldExpr(optimized, schema);
+	optimized = orderConjuncts(optimized, schema);
+
+	*result = optimized;
+	return RC_OK;
+}
+
+// compiled conditions
+
+/*
+ * Compiles a comparison operand: an attribute is resolved to its offset in
+ * the record, a constant is copied into the program.
+ */
+static RC
+compileOperand (Expr *expr, Schema *schema, StepOperand *operand, DataType *dt)
+{
+	switch(expr->type)
+	{
 	case EXPR_CONST:
-		CPVAL(*result,expr->expr.cons);
+		operand->value = *expr->expr.cons;
+		if (operand->value.dt == DT_STRING)
+		{
+			operand->value.v.stringV = strdup(expr->expr.cons->v.stringV);
+			if (operand->value.v.stringV == NULL)
+				return RC_MEMORY_ALLOCATION_ERROR;
+		}
+		operand->offset = -1;
+		operand->length = 0;
+		*dt = operand->value.dt;
 		break;
 	case EXPR_ATTRREF:
-		free(*result);
-		CHECK(getAttr(record, schema, expr->expr.attrRef, result));
+		if (schema == NULL || schema->attrOffsets == NULL
+				|| expr->expr.attrRef < 0 || expr->expr.attrRef >= schema->numAttr)
+			return RC_INVALID_PARAMETER;
+		operand->offset = schema->attrOffsets[expr->expr.attrRef];
+		operand->length = schema->typeLength[expr->expr.attrRef];
+		operand->value.dt = schema->dataTypes[expr->expr.attrRef];
+		*dt = operand->value.dt;
 		break;
+	default:
+		// comparing the results of operators is left to evalExpr
+		return RC_INVALID_PARAMETER;
 	}
 
 	return RC_OK;
 }
 
-RC
-freeExpr (Expr *expr)
+/*
+ * Frees the string an operand holds as a constant.
+ */
+static void
+freeOperand (StepOperand *operand)
 {
+	if (operand->offset < 0 && operand->value.dt == DT_STRING)
+		free(operand->value.v.stringV);
+	operand->offset = 0;
+}
+
+/*
+ * Frees the constants the operands of a step hold.
+ */
+static void
+freeStepOperands (ExprStep *step)
+{
+	int i;
+
+	freeOperand(&step->left);
+	freeOperand(&step->right);
+	freeOperand(&step->high);
+	for (i = 0; i < step->listLength; i++)
+		freeOperand(&step->list[i]);
+	free(step->list);
+	step->list = NULL;
+	step->listLength = 0;
+}
+
+/*
+ * Compiles the operands of a comparison: args[0] into left, and the others
+ * into right and high, or into the list of an IN step. All of them must
+ * have the same datatype.
+ */
+static RC
+compileComparison (ExprStep *s, Operator *op, Schema *schema)
+{
+	DataType dt;
+	int i;
+	RC rc;
+
+	rc = compileOperand(op->args[0], schema, &s->left, &s->dt);
+	if (rc == RC_OK && s->type == STEP_IN)
+	{
+		s->list = (StepOperand *) calloc(op->numArgs - 1, sizeof(StepOperand));
+		if (s->list == NULL)
+			rc = RC_MEMORY_ALLOCATION_ERROR;
+	}
+	for (i = 1; i < op->numArgs && rc == RC_OK; i++)
+	{
+		StepOperand *operand = (s->type == STEP_IN) ? &s->list[s->listLength++]
+				: (i == 1) ? &s->right : &s->high;
+		rc = compileOperand(op->args[i], schema, operand, &dt);
+		if (rc == RC_OK && dt != s->dt)
+			rc = RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE;
+	}
+	return rc;
+}
+
+/* Adds a step to the program and sets step to its index. */
+static RC
+appendStep (CompiledExpr *program, ExprStep *s, int *step)
+{
+	if (program->numSteps == MAX_EXPR_STEPS)
+		return RC_INVALID_PARAMETER;
+	*step = program->numSteps;
+	program->steps[program->numSteps++] = *s;
+	return RC_OK;
+}
+
+/*
+ * Appends the steps computing expr to the program, its operands first, and
+ * sets step to the step holding its result. The left side of an AND or OR
+ * is followed by a skip step, so that evaluation jumps past the right side
+ * when the left one decides the result.
+ */
+static RC
+compileStep (CompiledExpr *program, Expr *expr, Schema *schema, int *step)
+{
+	ExprStep s, skip;
+	int skipStep;
+	RC rc;
+
+	memset(&s, 0, sizeof(ExprStep));
 	switch(expr->type)
 	{
+	case EXPR_CONST:
+		if (expr->expr.cons->dt != DT_BOOL)
+			return RC_RM_EXPR_RESULT_IS_NOT_BOOLEAN;
+		s.type = STEP_CONST;
+		s.value = expr->expr.cons->v.boolV;
+		break;
+	case EXPR_ATTRREF:
+		rc = compileOperand(expr, schema, &s.left, &s.dt);
+		if (rc != RC_OK)
+			return rc;
+		if (s.dt != DT_BOOL)
+			return RC_RM_EXPR_RESULT_IS_NOT_BOOLEAN;
+		s.type = STEP_ATTR;
+		break;
 	case EXPR_OP:
 	{
 		Operator *op = expr->expr.op;
 		switch(op->type)
 		{
+		case OP_COMP_EQUAL:
+		case OP_COMP_SMALLER:
+		case OP_COMP_SMALLER_EQUAL:
+		case OP_COMP_GREATER:
+		case OP_COMP_GREATER_EQUAL:
+		case OP_COMP_NOT_EQUAL:
+		case OP_COMP_BETWEEN:
+		case OP_COMP_IN:
+			s.type = STEP_EQUAL + (op->type - OP_COMP_EQUAL);
+			rc = compileComparison(&s, op, schema);
+			if (rc == RC_OK)
+				rc = appendStep(program, &s, step);
+			if (rc != RC_OK)
+				freeStepOperands(&s);
+			return rc;
 		case OP_BOOL_NOT:
-			freeExpr(op->args[0]);
+			s.type = STEP_NOT;
+			rc = compileStep(program, op->args[0], schema, &s.args[0]);
+			if (rc != RC_OK)
+				return rc;
 			break;
+		case OP_BOOL_AND:
+		case OP_BOOL_OR:
+			s.type = (op->type == OP_BOOL_AND) ? STEP_AND : STEP_OR;
+			rc = compileStep(program, op->args[0], schema, &s.args[0]);
+			if (rc != RC_OK)
+				return rc;
+			memset(&skip, 0, sizeof(ExprStep));
+			skip.type = (op->type == OP_BOOL_AND) ? STEP_SKIP_FALSE : STEP_SKIP_TRUE;
+			skip.args[0] = s.args[0];
+			rc = appendStep(program, &skip, &skipStep);
+			if (rc == RC_OK)
+				rc = compileStep(program, op->args[1], schema, &s.args[1]);
+			if (rc == RC_OK)
+				rc = appendStep(program, &s, step);
+			if (rc == RC_OK)
+				program->steps[skipStep].jump = *step;
+			return rc;
 		default:
-			freeExpr(op->args[0]);
-			freeExpr(op->args[1]);
-			break;
+			return RC_INVALID_PARAMETER;
 		}
-		free(op->args);
 	}
 	break;
-	case EXPR_CONST:
-		freeVal(expr->expr.cons);
-		break;
-	case EXPR_ATTRREF:
-		break;
 	}
-	free(expr);
 
+	return appendStep(program, &s, step);
+}
+
+/*
+ * Compiles a condition into a flat program for records of the given schema.
+ * Attributes are resolved to their offsets and constants are copied once, so
+ * evalCompiledExpr neither walks the tree nor allocates. Type errors that
+ * evalExpr reports per record are reported here instead. Comparisons of
+ * operator results and conditions of more than MAX_EXPR_STEPS steps are not
+ * compiled; callers fall back to evalExpr for those.
+ */
+RC
+compileExpr (Expr *expr, Schema *schema, CompiledExpr **result)
+{
+	CompiledExpr *program;
+	int step;
+	RC rc;
+
+	if (expr == NULL || result == NULL)
+		return RC_INVALID_PARAMETER;
+
+	program = (CompiledExpr *) malloc(sizeof(CompiledExpr));
+	if (program == NULL)
+		return RC_MEMORY_ALLOCATION_ERROR;
+	program->numSteps = 0;
+
+	rc = compileStep(program, expr, schema, &step);
+	if (rc != RC_OK)
+	{
+		freeCompiledExpr(program);
+		return rc;
+	}
+
+	*result = program;
 	return RC_OK;
 }
 
-void 
-freeVal (Value *val)
+/*
+ * Compares two operands of a comparison step on a record. Strings compare as
+ * getAttr returns them, cut at the length of their attribute.
+ *
+ * Returns -1, 0 or 1 as the left operand is smaller, equal or greater, and
+ * 2 for floats that do not compare (NaN).
+ */
+static int
+compareOperands (DataType dt, StepOperand *l, StepOperand *r, char *data)
 {
-	if (val->dt == DT_STRING)
-		free(val->v.stringV);
-	free(val);
+	switch(dt)
+	{
+	case DT_INT:
+	{
+		int lv = l->value.v.intV, rv = r->value.v.intV;
+		if (l->offset >= 0)
+			memcpy(&lv, data + l->offset, sizeof(int));
+		if (r->offset >= 0)
+			memcpy(&rv, data + r->offset, sizeof(int));
+		return (lv > rv) - (lv < rv);
+	}
+	case DT_FLOAT:
+	{
+		float lv = l->value.v.floatV, rv = r->value.v.floatV;
+		if (l->offset >= 0)
+			memcpy(&lv, data + l->offset, sizeof(float));
+		if (r->offset >= 0)
+			memcpy(&rv, data + r->offset, sizeof(float));
+		return (lv < rv) ? -1 : (lv > rv) ? 1 : (lv == rv) ? 0 : 2;
+	}
+	case DT_BOOL:
+	{
+		bool lv = l->value.v.boolV, rv = r->value.v.boolV;
+		if (l->offset >= 0)
+			memcpy(&lv, data + l->offset, sizeof(bool));
+		if (r->offset >= 0)
+			memcpy(&rv, data + r->offset, sizeof(bool));
+		return (lv > rv) - (lv < rv);
+	}
+	case DT_STRING:
+	{
+		char *ls = (l->offset >= 0) ? data + l->offset : l->value.v.stringV;
+		char *rs = (r->offset >= 0) ? data + r->offset : r->value.v.stringV;
+		int i;
+		for (i = 0; ; i++)
+		{
+			unsigned char lc = (l->offset >= 0 && i >= l->length) ? '\0' : ls[i];
+			unsigned char rc = (r->offset >= 0 && i >= r->length) ? '\0' : rs[i];
+			if (lc != rc || lc == '\0')
+				return (lc > rc) - (lc < rc);
+		}
+	}
+	}
+
+	return 0;
+}
+
+/*
+ * Evaluates a compiled condition on a record. The program is only read, so
+ * it may be evaluated by several threads at once.
+ */
+bool
+evalCompiledExpr (CompiledExpr *program, Record *record)
+{
+	bool results[MAX_EXPR_STEPS];
+	bool b;
+	int i, j, order;
+
+	for (i = 0; i < program->numSteps; i++)
+	{
+		ExprStep *step = &program->steps[i];
+		switch(step->type)
+		{
+		case STEP_CONST:
+			results[i] = step->value;
+			break;
+		case STEP_ATTR:
+			memcpy(&b, record->data + step->left.offset, sizeof(bool));
+			results[i] = b;
+			break;
+		case STEP_EQUAL:
+			results[i] = (compareOperands(step->dt, &step->left, &step->right, record->data) == 0);
+			break;
+		case STEP_SMALLER:
+			results[i] = (compareOperands(step->dt, &step->left, &step->right, record->data) < 0);
+			break;
+		case STEP_SMALLER_EQUAL:
+			order = compareOperands(step->dt, &step->left, &step->right, record->data);
+			results[i] = (order <= 0);
+			break;
+		case STEP_GREATER:
+			order = compareOperands(step->dt, &step->left, &step->right, record->data);
+			results[i] = (order > 0 && order != 2);
+			break;
+		case STEP_GREATER_EQUAL:
+			order = compareOperands(step->dt, &step->left, &step->right, record->data);
+			results[i] = (order >= 0 && order != 2);
+			break;
+		case STEP_NOT_EQUAL:
+			results[i] = (compareOperands(step->dt, &step->left, &step->right, record->data) != 0);
+			break;
+		case STEP_BETWEEN:
+			order = compareOperands(step->dt, &step->left, &step->right, record->data);
+			results[i] = (order >= 0 && order != 2)
+					&& compareOperands(step->dt, &step->left, &step->high, record->data) <= 0;
+			break;
+		case STEP_IN:
+			results[i] = FALSE;
+			for (j = 0; j < step->listLength && !results[i]; j++)
+				results[i] = (compareOperands(step->dt, &step->left, &step->list[j], record->data) == 0);
+			break;
+		case STEP_NOT:
+			results[i] = !results[step->args[0]];
+			break;
+		case STEP_AND:
+			results[i] = results[step->args[0]] && results[step->args[1]];
+			break;
+		case STEP_OR:
+			results[i] = results[step->args[0]] || results[step->args[1]];
+			break;
+		case STEP_SKIP_FALSE:
+		case STEP_SKIP_TRUE:
+			results[i] = results[step->args[0]];
+			if (results[i] == (step->type == STEP_SKIP_TRUE))
+			{
+				results[step->jump] = results[i];
+				i = step->jump;
+			}
+			break;
+		}
+	}
+
+	return results[program->numSteps - 1];
 }
 
+RC
+freeCompiledExpr (CompiledExpr *program)
+{
+	int i;
+
+	if (program == NULL)
+		return RC_OK;
+	for (i = 0; i < program->numSteps; i++)
+	{
+		if (program->steps[i].type >= STEP_EQUAL && program->steps[i].type <= STEP_IN)
+			freeStepOperands(&program->steps[i]);
+	}
+	free(program);
+
+	return RC_OK;
+}
@@ -3,6 +3,7 @@
 
 #include "dberror.h"
 #include "tables.h"
+#include "arena.h"
 
 // datatype for arguments of expressions used in conditions
 typedef enum ExprType {
@@ -26,14 +27,67 @@ typedef enum OpType {
   OP_BOOL_OR,
   OP_BOOL_NOT,
   OP_COMP_EQUAL,
-  OP_COMP_SMALLER
+  OP_COMP_SMALLER,
+  OP_COMP_SMALLER_EQUAL,
+  OP_COMP_GREATER,
+  OP_COMP_GREATER_EQUAL,
+  OP_COMP_NOT_EQUAL,
+  OP_COMP_BETWEEN,  // args[1] <= args[0] <= args[2]
+  OP_COMP_IN        // args[0] equals one of args[1] .. args[numArgs - 1]
 } OpType;
 
 typedef struct Operator {
   OpType type;
+  int numArgs;
   Expr **args;
 } Operator;
 
+// conditions compiled against a schema, evaluated without allocating
+#define MAX_EXPR_STEPS 64
+
+typedef enum StepType {
+  STEP_CONST,   // constant boolean
+  STEP_ATTR,    // boolean attribute
+  STEP_EQUAL,   // comparisons, in the order of their OpType
+  STEP_SMALLER,
+  STEP_SMALLER_EQUAL,
+  STEP_GREATER,
+  STEP_GREATER_EQUAL,
+  STEP_NOT_EQUAL,
+  STEP_BETWEEN, // right <= left <= high
+  STEP_IN,      // left equals one of list
+  STEP_NOT,     // boolean operators on the results of earlier steps
+  STEP_AND,
+  STEP_OR,
+  STEP_SKIP_FALSE, // if args[0] is false, so is step jump, and evaluation goes on behind it
+  STEP_SKIP_TRUE   // if args[0] is true, so is step jump, and evaluation goes on behind it
+} StepType;
+
+// operand of a comparison: an attribute of the record or a constant
+typedef struct StepOperand {
+  int offset;   // offset of the attribute in the record data, -1 for a constant
+  int length;   // length of a string attribute
+  Value value;  // the constant; a string is owned by the program
+} StepOperand;
+
+typedef struct ExprStep {
+  StepType type;
+  DataType dt;        // type of the compared operands
+  StepOperand left;
+  StepOperand right;
+  StepOperand high;   // upper bound of a BETWEEN step
+  StepOperand *list;  // values of an IN step, owned by the program
+  int listLength;
+  int args[2];        // steps whose results a boolean operator combines
+  int jump;           // step a skip step decides when it is taken
+  bool value;         // value of a constant step
+} ExprStep;
+
+typedef struct CompiledExpr {
+  int numSteps;
+  ExprStep steps[MAX_EXPR_STEPS]; // in evaluation order, the last one is the result
+} CompiledExpr;
+
 // expression evaluation methods
 extern RC valueEquals (Value *left, Value *right, Value *result);
 extern RC valueSmaller (Value *left, Value *right, Value *result);
@@ -41,9 +95,18 @@ extern RC boolNot (Value *input, Value *result);
 extern RC boolAnd (Value *left, Value *right, Value *result);
 extern RC boolOr (Value *left, Value *right, Value *result);
 extern RC evalExpr (Record *record, Schema *schema, Expr *expr, Value **result);
+extern RC evalExprWithArena (Record *record, Schema *schema, Expr *expr, Value **result, Arena *arena);
 extern RC freeExpr (Expr *expr);
 extern void freeVal(Value *val);
 
+// rewriting conditions before a scan
+extern RC optimizeExpr (Expr *expr, Schema *schema, Expr **result);
+
+// compiled conditions
+extern RC compileExpr (Expr *expr, Schema *schema, CompiledExpr **result);
+extern bool evalCompiledExpr (CompiledExpr *program, Record *record);
+extern RC freeCompiledExpr (CompiledExpr *program);
+
 
 #define CPVAL(_result,_input)						\
   do {									\
@@ -73,11 +136,42 @@ extern void freeVal(Value *val);
       _result->type = EXPR_OP;						\
       _result->expr.op = _op;						\
       _op->type = _optype;						\
+      _op->numArgs = 2;							\
       _op->args = (Expr **) malloc(2 * sizeof(Expr*));			\
       _op->args[0] = _left;						\
       _op->args[1] = _right;						\
     } while (0)
 
+#define MAKE_BETWEEN_EXPR(_result,_value,_low,_high)			\
+    do {								\
+      Operator *_op = (Operator *) malloc(sizeof(Operator));		\
+      _result = (Expr *) malloc(sizeof(Expr));				\
+      _result->type = EXPR_OP;						\
+      _result->expr.op = _op;						\
+      _op->type = OP_COMP_BETWEEN;					\
+      _op->numArgs = 3;							\
+      _op->args = (Expr **) malloc(3 * sizeof(Expr*));			\
+      _op->args[0] = _value;						\
+      _op->args[1] = _low;						\
+      _op->args[2] = _high;						\
+    } while (0)
+
+// _list is an array of _count expressions, which the new expression takes over
+#define MAKE_IN_EXPR(_result,_value,_list,_count)			\
+    do {								\
+      Operator *_op = (Operator *) malloc(sizeof(Operator));		\
+      int _i;								\
+      _result = (Expr *) malloc(sizeof(Expr));				\
+      _result->type = EXPR_OP;						\
+      _result->expr.op = _op;						\
+      _op->type = OP_COMP_IN;						\
+      _op->numArgs = (_count) + 1;					\
+      _op->args = (Expr **) malloc(((_count) + 1) * sizeof(Expr*));	\
+      _op->args[0] = _value;						\
+      for (_i = 0; _i < (_count); _i++)					\
+        _op->args[_i + 1] = (_list)[_i];				\
+    } while (0)
+
 #define MAKE_UNOP_EXPR(_result,_input,_optype)				\
   do {									\
     Operator *_op = (Operator *) malloc(sizeof(Operator));		\
@@ -85,6 +179,7 @@ extern void freeVal(Value *val);
     _result->type = EXPR_OP;						\
     _result->expr.op = _op;						\
     _op->type = _optype;						\
+    _op->numArgs = 1;							\
     _op->args = (Expr **) malloc(sizeof(Expr*));			\
     _op->args[0] = _input;						\
   } while (0)
@@ -0,0 +1,220 @@
+#include <string.h>
+#include "filter.h"
+
+// The vector kernels are built for x86 with GCC or Clang and chosen at run time
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FILTER_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * Compares one value with the constant.
+ *
+ * @param value Address of the value, which need not be aligned
+ * @param dt Type of the value, DT_INT or DT_FLOAT
+ * @param op Comparison
+ * @param constant Constant of the same type
+ * @return Whether value op constant holds
+ *
+ * Floats compare as in C, so NaN matches nothing.
+ */
+static bool filterOne(char *value, DataType dt, FilterOp op, Value *constant)
+{
+    if (dt == DT_INT)
+    {
+        int v;
+        memcpy(&v, value, sizeof(int));
+        int c = constant->v.intV;
+        return (op == FILTER_EQUAL) ? (v == c) : (op == FILTER_SMALLER) ? (v < c) : (v > c);
+    }
+
+    float v;
+    memcpy(&v, value, sizeof(float));
+    float c = constant->v.floatV;
+    return (op == FILTER_EQUAL) ? (v == c) : (op == FILTER_SMALLER) ? (v < c) : (v > c);
+}
+
+/**
+ * Scalar kernel, used where no vector kernel is available.
+ *
+ * @param base Start of the memory the offsets refer to
+ * @param offsets Offset of every value from base
+ * @param from First value to compare
+ * @param count Number of values
+ * @param dt Type of the values
+ * @param op Comparison
+ * @param constant Constant the values are compared with
+ * @param mask Selection bitmask, cleared by the caller
+ *
+ * Also finishes the values a vector kernel leaves over at the end.
+ */
+static void filterScalar(char *base, int *offsets, int from, int count, DataType dt,
+                         FilterOp op, Value *constant, unsigned char *mask)
+{
+    for (int i = from; i < count; i++)
+    {
+        mask[i >> 3] |= (unsigned char)(filterOne(base + offsets[i], dt, op, constant) << (i & 7));
+    }
+}
+
+#ifdef FILTER_X86
+/**
+ * SSE2 kernel: compares four values at a time.
+ *
+ * @return Number of values compared, a multiple of four
+ *
+ * SSE2 has no gather, so the values are loaded one by one into a vector and
+ * compared together. Each group of four sets half a byte of the mask.
+ */
+__attribute__((target("sse2")))
+static int filterSSE2(char *base, int *offsets, int count, DataType dt,
+                      FilterOp op, Value *constant, unsigned char *mask)
+{
+    int values[4];
+    int i;
+
+    for (i = 0; i + 4 <= count; i += 4)
+    {
+        for (int j = 0; j < 4; j++)
+            memcpy(&values[j], base + offsets[i + j], sizeof(int));
+
+        int bits;
+        if (dt == DT_INT)
+        {
+            __m128i v = _mm_loadu_si128((__m128i *)values);
+            __m128i c = _mm_set1_epi32(constant->v.intV);
+            __m128i r = (op == FILTER_EQUAL) ? _mm_cmpeq_epi32(v, c)
+                        : (op == FILTER_SMALLER) ? _mm_cmplt_epi32(v, c)
+                        : _mm_cmpgt_epi32(v, c);
+            bits = _mm_movemask_ps(_mm_castsi128_ps(r));
+        }
+        else
+        {
+            __m128 v = _mm_loadu_ps((float *)values);
+            __m128 c = _mm_set1_ps(constant->v.floatV);
+            __m128 r = (op == FILTER_EQUAL) ? _mm_cmpeq_ps(v, c)
+                       : (op == FILTER_SMALLER) ? _mm_cmplt_ps(v, c)
+                       : _mm_cmpgt_ps(v, c);
+            bits = _mm_movemask_ps(r);
+        }
+        mask[i >> 3] |= (unsigned char)(bits << (i & 4));
+    }
+    return i;
+}
+
+/**
+ * AVX2 kernel: gathers and compares eight values at a time.
+ *
+ * @return Number of values compared, a multiple of eight
+ *
+ * The offsets are loaded as a vector of indexes, and the values are gathered
+ * from base with a scale of one. Each group of eight fills one mask byte.
+ */
+__attribute__((target("avx2")))
+static int filterAVX2(char *base, int *offsets, int count, DataType dt,
+                      FilterOp op, Value *constant, unsigned char *mask)
+{
+    int i;
+
+    for (i = 0; i + 8 <= count; i += 8)
+    {
+        __m256i index = _mm256_loadu_si256((__m256i *)(offsets + i));
+        int bits;
+        if (dt == DT_INT)
+        {
+            __m256i v = _mm256_i32gather_epi32((int const *)base, index, 1);
+            __m256i c = _mm256_set1_epi32(constant->v.intV);
+            __m256i r = (op == FILTER_EQUAL) ? _mm256_cmpeq_epi32(v, c)
+                        : (op == FILTER_SMALLER) ? _mm256_cmpgt_epi32(c, v)
+                        : _mm256_cmpgt_epi32(v, c);
+            bits = _mm256_movemask_ps(_mm256_castsi256_ps(r));
+        }
+        else
+        {
+            __m256 v = _mm256_i32gather_ps((float const *)base, index, 1);
+            __m256 c = _mm256_set1_ps(constant->v.floatV);
+            __m256 r = (op == FILTER_EQUAL) ? _mm256_cmp_ps(v, c, _CMP_EQ_OQ)
+                       : (op == FILTER_SMALLER) ? _mm256_cmp_ps(v, c, _CMP_LT_OQ)
+                       : _mm256_cmp_ps(v, c, _CMP_GT_OQ);
+            bits = _mm256_movemask_ps(r);
+        }
+        mask[i >> 3] = (unsigned char)bits;
+    }
+    return i;
+}
+#endif
+
+/**
+ * Returns the fastest filter kernel the processor supports.
+ *
+ * @return FILTER_KERNEL_AVX2 or FILTER_KERNEL_SSE2 where available, else
+ *         FILTER_KERNEL_SCALAR
+ */
+FilterKernel bestFilterKernel(void)
+{
+#ifdef FILTER_X86
+    if (__builtin_cpu_supports("avx2"))
+        return FILTER_KERNEL_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return FILTER_KERNEL_SSE2;
+#endif
+    return FILTER_KERNEL_SCALAR;
+}
+
+/**
+ * Returns the name of a filter kernel, for reports.
+ */
+const char *filterKernelName(FilterKernel kernel)
+{
+    switch (kernel)
+    {
+    case FILTER_KERNEL_AVX2:
+        return "avx2";
+    case FILTER_KERNEL_SSE2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+/**
+ * Compares values with a constant using the given kernel.
+ *
+ * @param kernel Kernel to use; one the build or processor lacks falls back to
+ *        the scalar kernel
+ * @param base Start of the memory the offsets refer to
+ * @param offsets Offset of every value from base
+ * @param count Number of values
+ * @param dt Type of the values, DT_INT or DT_FLOAT
+ * @param op Comparison, value op constant
+ * @param constant Constant of the same type as the values
+ * @param mask Selection bitmask of (count + 7) / 8 bytes
+ *
+ * Bit i of the mask, bit i % 8 of byte i / 8, is set when value i matches and
+ * cleared otherwise. Values may sit at any offsets, aligned or not, so a kernel
+ * can test one attribute of every record on a page in a single call.
+ */
+void filterColumnWith(FilterKernel kernel, char *base, int *offsets, int count, DataType dt,
+                      FilterOp op, Value *constant, unsigned char *mask)
+{
+    int done = 0;
+
+    memset(mask, 0, (count + 7) / 8);
+#ifdef FILTER_X86
+    if (kernel == FILTER_KERNEL_AVX2 && __builtin_cpu_supports("avx2"))
+        done = filterAVX2(base, offsets, count, dt, op, constant, mask);
+    else if (kernel >= FILTER_KERNEL_SSE2 && __builtin_cpu_supports("sse2"))
+        done = filterSSE2(base, offsets, count, dt, op, constant, mask);
+#endif
+    filterScalar(base, offsets, done, count, dt, op, constant, mask);
+}
+
+/**
+ * Compares values with a constant using the fastest kernel, see
+ * filterColumnWith.
+ */
+void filterColumn(char *base, int *offsets, int count, DataType dt,
+                  FilterOp op, Value *constant, unsigned char *mask)
+{
+    filterColumnWith(bestFilterKernel(), base, offsets, count, dt, op, constant, mask);
+}
@@ -0,0 +1,30 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#include "dberror.h"
+#include "tables.h"
+
+// Comparisons a filter kernel evaluates, as value op constant
+typedef enum FilterOp {
+	FILTER_EQUAL = 0,
+	FILTER_SMALLER = 1,
+	FILTER_GREATER = 2
+} FilterOp;
+
+// Implementations of the filter kernels
+typedef enum FilterKernel {
+	FILTER_KERNEL_SCALAR = 0,
+	FILTER_KERNEL_SSE2 = 1,
+	FILTER_KERNEL_AVX2 = 2
+} FilterKernel;
+
+// choosing a kernel
+extern FilterKernel bestFilterKernel (void);
+extern const char *filterKernelName (FilterKernel kernel);
+
+// comparing DT_INT or DT_FLOAT values stored at base + offsets[i]; bit i of
+// mask is set for every value that matches
+extern void filterColumn (char *base, int *offsets, int count, DataType dt, FilterOp op, Value *constant, unsigned char *mask);
+extern void filterColumnWith (FilterKernel kernel, char *base, int *offsets, int count, DataType dt, FilterOp op, Value *constant, unsigned char *mask);
+
+#endif // FILTER_H
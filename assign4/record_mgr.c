@@ -1,877 +1,3972 @@
 #include <stdio.h>       // Standard input/output library
 #include <stdlib.h>      // Standard library functions like malloc and free
 #include <string.h>      // String manipulation functions
+#include <stddef.h>      // offsetof, to find the pool block of a record
+#include <errno.h>       // ERANGE from strtol and strtof on CSV fields
+#include <limits.h>      // INT_MIN and INT_MAX for CSV integers
+#include <math.h>        // INFINITY and isnan for the bounds of the zone map
+#include <pthread.h>     // Worker threads of parallel scans
 #include "record_mgr.h"  // Header file for record manager interface
 #include "buffer_mgr.h"  // Header file for buffer manager interface
 #include "storage_mgr.h" // Header file for storage manager interface
+#include "filter.h"      // Vector kernels filtering the records of a page
 
-// Data structure for table information
+// Data structure for table information, shared by all handles of one open table
 typedef struct TableInfo
 {
-    BM_PageHandle pageInfo; // Page handle for accessing the table's page in memory
     BM_BufferPool dataPool; // Buffer pool for managing table pages
-    RID recordID;           // Record ID for accessing a specific record
-    Expr *conditionExpr;    // Expression used for scan conditions
     int tupleCount;         // Number of tuples (records) in the table
-    int freePageIndex;      // Index of the first free page in the table
-    int scanIndex;          // Index used during scans
+    int freePageIndex;      // Lowest data page that may still have room for a record
+    int pageSize;           // Page size of the table's page file
+    int maxRecordBytes;     // Size of the longest encoded record, tag byte included
+    int slotWords;          // Words of the slot bitmap of every data page
+    char *name;             // Name of the table's page file, the registry key
+    int refCount;           // Number of RM_TableData handles using this entry
+    int zonePages;          // Pages the zone map has entries for
+    int zoneAttrs;          // Attributes of the table, bounds kept per page for each
+    int zoneFirstNew;       // First page appended since the table was opened, empty until written
+    bool zoneBroken;        // The zone map missed a write, so it no longer skips pages
+    char *zoneState;        // ZONE_UNKNOWN, ZONE_EMPTY or ZONE_KNOWN for every page
+    double *zoneBounds;     // Lowest and highest value of every attribute on every page
+    int writeCount;         // Changes made to data pages, so scans notice a page changed under them
+    struct TableInfo *next; // Next open table in the registry
 } TableInfo;
 
+// Comparison of one attribute with a constant, tested on all records of a page at once
+typedef struct PageFilter
+{
+    int attrNum;          // Attribute compared, of type DT_INT or DT_FLOAT
+    FilterOp op;          // Comparison, attribute op constant
+    Value constant;       // Constant the attribute is compared with
+    int fixedOffset;      // Offset of the attribute in encoded records, -1 if a string precedes it
+    FilterKernel kernel;  // Kernel evaluating the comparison
+    int capacity;         // Most slots a page can have
+    int *offsets;         // Offset of the value of every record tested, from the page start
+    int *slots;           // Slot of every record tested
+    unsigned char *mask;  // Selection bitmask the kernel fills, one bit per record tested
+    bool *matches;        // Whether each slot of the page passed the filter
+    int pageNum;          // Page the matches were found for, -1 before the first run
+    int slotCount;        // Slots that page had when the filter ran
+    int writeCount;       // Write count of the table when the filter ran
+} PageFilter;
+
+// Data structure for the state of one scan
+typedef struct ScanInfo
+{
+    BM_PageHandle pageInfo; // Page handle for the page the scan is on
+    RID recordID;           // Record ID of the current scan position
+    Expr *conditionExpr;    // Expression used for scan conditions, the optimized one if there is one
+    Expr *optimizedCond;    // Copy of the caller's condition rewritten by optimizeExpr, NULL if none
+    int scanIndex;          // Number of records the scan has visited
+    bool pagePinned;        // Whether pageInfo holds a pin on the current page
+    Record *scanRecord;     // Full record the condition is evaluated on when the caller's record is not one
+    bool *condAttrs;        // Attributes the condition reads
+    Schema *projection;     // Schema of the records next returns, NULL for full records
+    int *projAttrs;         // Table attribute behind every projected attribute
+    bool *wantedAttrs;      // Attributes a projected scan decodes: the projected ones and condAttrs
+    bool batchAtEnd;        // nextBatch reached the end while filling its last batch
+    int constantMatch;      // Result of a condition that reads no attribute, or -1 to evaluate it per record
+    CompiledExpr *compiledCond; // Condition compiled for the table's schema, NULL to evaluate it with evalExpr
+    PageFilter *filter;     // Filter run on every page the scan pins, NULL if the condition has none
+    Arena *arena;           // Arena the condition is evaluated in when it is not compiled, NULL for malloc
+} ScanInfo;
+
+// A RID of a getRecords request and the position it was asked for at
+typedef struct RidEntry
+{
+    RID id;       // RID to read
+    int position; // Index of the RID in the request
+} RidEntry;
+
+// Work shared by the threads of one parallel scan
+typedef struct ParallelScan
+{
+    RM_TableData *rel;        // Table being scanned
+    Expr *cond;               // Condition records must meet
+    CompiledExpr *compiled;   // cond compiled for the table, NULL to evaluate it with evalExpr
+    RM_ScanCallback callback; // Called for every matching record
+    void *context;            // Passed on to the callback
+    int numPages;             // Pages of the file when the scan started
+    int nextPage;             // First page of the next morsel to hand out
+    RC result;                // First error a worker met
+    pthread_mutex_t lock;     // Guards nextPage and result
+} ParallelScan;
+
+// Header at the start of every data page
+typedef struct DataPageHeader
+{
+    int slotCount; // Entries in the slot directory, used or free
+    int liveCount; // Used entries of the slot directory
+    int freeEnd;   // Offset where the record area starts, 0 on a fresh page
+    int usedBytes; // Bytes held by the records of used entries
+    int slotWords; // Words of the slot bitmap behind the header, 0 on a fresh page
+} DataPageHeader;
+
+// Entry of the slot directory, which follows the data page header
+typedef struct SlotEntry
+{
+    unsigned short offset; // Offset of the record in the page, 0 for a free entry
+    unsigned short length; // Bytes held by the record
+} SlotEntry;
+
 #define MAX_BUFFER_SIZE 100     // Maximum size of the buffer pool
 #define ATTR_NAME_MAX_LENGTH 15 // Maximum length of an attribute name
+#define FIRST_FSM_PAGE 1        // Page of the first free-space map page
+#define FIRST_DATA_PAGE 2       // First page that holds records
+#define RECORD_PLAIN '+'        // Tag of a record stored on its home page
+#define RECORD_FORWARD '>'      // Tag of a stub naming the page a record moved to
+#define RECORD_MOVED '<'        // Tag of a record stored away from its home page
+#define MORSEL_PAGES 4          // Pages a parallel scan worker takes at a time
+#define FORWARD_SIZE (1 + 2 * (int)sizeof(int)) // A tag followed by a RID
+#define CSV_BATCH_SIZE 1024     // Rows loadTableFromCSV hands to insertRecords at once
+#define RECORD_POOL_SIZES 8     // Record sizes a thread caches free records of
+#define RECORD_POOL_DEPTH 64    // Free records a thread caches of each size
+#define RECORD_POOL_MAGIC 0x52454350u // Marks a block made by takePooledRecord
+#define ZONE_UNKNOWN 0          // Zone map state of a page whose records were not summarized yet
+#define ZONE_EMPTY 1            // Zone map state of a page that received no record
+#define ZONE_KNOWN 2            // Zone map state of a page whose bounds cover all its records
+
+// Block holding a record and its data, recycled by the record pool
+typedef struct PooledRecord
+{
+    struct PooledRecord *next; // Next free block of the same size in a thread's cache
+    int dataSize;              // Bytes of data behind the record
+    unsigned int magic;        // RECORD_POOL_MAGIC while the record is handed out
+    Record record;             // Record handed out, whose data follows the block
+} PooledRecord;
+
+// Free record blocks a thread keeps for reuse, one list per record size
+typedef struct RecordCache
+{
+    int dataSize[RECORD_POOL_SIZES];          // Record size of each list, 0 for an unused list
+    int count[RECORD_POOL_SIZES];             // Blocks on each list
+    PooledRecord *freeList[RECORD_POOL_SIZES]; // Free blocks of each size
+} RecordCache;
+
+/*
+ * Free-space map: page 0 holds the table metadata, and the rest of the file is split
+ * into groups of one map page followed by the pageSize * 8 data pages it covers. A
+ * set bit marks a data page without room for the longest record of the table (a full
+ * page). Pages appended to the file are zero-filled, so new
+ * data pages and new map pages start out as "has room" without being initialized.
+ *
+ * Data pages are slotted: the header is followed by a bitmap of the used directory
+ * entries (set bit = used), then the slot directory, and records are packed from the
+ * end of the page towards it. The bitmap lets inserts find a free entry and scans the
+ * next record with __builtin_ctz instead of walking the directory entry by entry. A RID names a directory entry, so
+ * records can move within their page when it is compacted. Records are encoded with
+ * each string cut to its length behind a one-byte (two-byte for typeLength > 255)
+ * length prefix, and the tombstone byte becomes a tag:
+ *   '+' <attributes>             a record on its home page
+ *   '>' <page> <slot>            a forwarding stub left when an update outgrew the page
+ *   '<' <home page> <home slot> <attributes>   the moved record, found through its stub
+ * Every record holds at least FORWARD_SIZE bytes so it can always turn into a stub.
+ * A zero-filled page is an empty page.
+ */
 
-TableInfo *tableInfo; // Global pointer to TableInfo struct
+static TableInfo *openTables = NULL; // Registry of open tables, one entry per page file
+static __thread RecordCache *recordCache = NULL;  // Free records of the calling thread
+static pthread_key_t recordCacheKey;              // Frees a thread's cache when the thread ends
+static pthread_once_t recordCacheOnce = PTHREAD_ONCE_INIT; // Creates recordCacheKey once
+
+static void setAttributeOffsets(Schema *schema); // Defined with getAttributeOffset
+static void freeRecordCache(void *arg);          // Defined with the record pool
+static void createRecordCacheKey(void);          // Defined with the record pool
 
 /**
- * @details : Locates an empty slot within a page for record insertion by scanning through
- *            the page content and checking if a slot is available (not marked with '+').
+ * @details : Looks up an open table in the registry by the name of its page file.
  *
- * @param pageContent : Pointer to the content of the page being examined
- * @param recordSize : Size of each record in bytes
+ * @param name : Name of the table
  *
- * @return The index of the first empty slot found, or -1 if no empty slots are available
+ * @return The registry entry of the table, or NULL if the table is not open
  */
-int locateEmptySlot(char *pageContent, int recordSize)
+static TableInfo *findOpenTable(char *name)
 {
-    int slotIndex = 0;                     // Initialize the slot index
-    int maxSlots = PAGE_SIZE / recordSize; // Calculate the maximum number of slots in a page
+    TableInfo *entry = openTables; // Start at the head of the registry
 
-    while (slotIndex < maxSlots)
-    { // Loop through each slot in the page
-        if (pageContent[slotIndex * recordSize] != '+')
-        {                     // Check if the slot is not marked as occupied ('+')
-            return slotIndex; // Return the index of the empty slot
-        }
-        slotIndex += 1; // Increment the slot index
+    while (entry != NULL && strcmp((*entry).name, name) != 0)
+    {                             // Walk the registry until the name matches
+        entry = (*entry).next;    // Move to the next open table
     }
 
-    return -1; // Return -1 if no empty slots are found
+    return entry; // Return the match, or NULL at the end of the registry
 }
 
 /**
- * @details : The function initRecordManager initializes the record manager by setting up
- *            the storage manager for subsequent record operations.
+ * @details : Writes the tuple count and the free page index of an open table back to
+ *            its metadata page. Page 0 is only dirtied when a value changed, so tables
+ *            that were only read are not written.
  *
- * @param mgmtData : Pointer to management data (not used in this implementation)
+ * @param entry : Registry entry of the table
  *
- * @return RC_OK upon successful initialization
+ * @return RC_OK on success, or the error of the buffer manager
  */
-extern RC initRecordManager(void *mgmtData)
+static RC writeTableStats(TableInfo *entry)
 {
-    initStorageManager(); // Initialize the storage manager
-
-    return RC_OK; // Return RC_OK to indicate success
-}
+    BM_PageHandle metaPage; // Handle of the metadata page
+    RC result = pinPage(&(*entry).dataPool, &metaPage, 0); // Pin the metadata page
 
-/**
- * @details : Shuts down the record manager and releases any allocated resources,
- *            particularly freeing the table information structure.
- *
- * @return RC_OK upon successful shutdown
- */
-extern RC shutdownRecordManager()
-{
-    if (tableInfo == NULL)
-    {                    // Check if tableInfo is NULL (meaning it hasn't been initialized)
-        return RC_ERROR; // Return RC_ERROR if tableInfo is NULL
+    if (result != RC_OK)
+    {                  // Check if pinning failed
+        return result; // Return the error code
     }
 
-    free(tableInfo);  // Free the memory allocated for tableInfo
-    tableInfo = NULL; // Set tableInfo to NULL to prevent dangling pointer
+    int *stats = (int *)metaPage.data; // Tuple count followed by the free page index
+    if (stats[0] != (*entry).tupleCount || stats[1] != (*entry).freePageIndex)
+    {                                                     // Only write statistics that changed
+        stats[0] = (*entry).tupleCount;                   // Store the tuple count
+        stats[1] = (*entry).freePageIndex;                // Store the free page index
+        result = markDirty(&(*entry).dataPool, &metaPage); // Mark the page as dirty
+    }
 
-    return RC_OK; // Return RC_OK to indicate success
+    RC unpinResult = unpinPage(&(*entry).dataPool, &metaPage); // Unpin the metadata page
+    return (result != RC_OK) ? result : unpinResult;           // Report the first error
 }
 
 /**
- * @details : Creates a new table with the specified name and schema. The function
- *            initializes a buffer pool, sets up the table metadata page, and writes
- *            the schema information to the first page of the table file.
+ * @details : Removes a table from the registry, writes its statistics back to page 0,
+ *            shuts down its buffer pool and frees the entry. Entries that never made
+ *            it into the registry (a failed openTable) leave page 0 alone.
  *
- * @param name : Name of the table to be created
- * @param schema : Schema definition for the table
+ * @param entry : Registry entry of the table to release
  *
- * @return RC_OK on success, or an error code if any operation fails
+ * @return The result of writing the statistics or shutting down the table's buffer pool
  */
-extern RC createTable(char *name, Schema *schema)
+static RC releaseTable(TableInfo *entry)
 {
-    RC result; // Variable to store the result code of function calls
-
-    if (name == NULL || schema == NULL)
-    {                                // Check for invalid parameters
-        return RC_INVALID_PARAMETER; // Return an error code if parameters are invalid
-    }
+    TableInfo **link = &openTables; // Pointer to the link that references the entry
+    RC statsResult = RC_OK;         // Result of writing the statistics
 
-    tableInfo = (TableInfo *)malloc(sizeof(TableInfo)); // Allocate memory for the TableInfo structure
-    if (tableInfo == NULL)
-    {                                      // Check if memory allocation failed
-        return RC_MEMORY_ALLOCATION_ERROR; // Return an error code if memory allocation failed
+    while (*link != NULL && *link != entry)
+    {                               // Find the link pointing at the entry
+        link = &(**link).next;      // Move to the next link
     }
-
-    result = initBufferPool(&(*tableInfo).dataPool, name, MAX_BUFFER_SIZE, RS_LRU, NULL); // Initialize the buffer pool
-    if (result != RC_OK)
-    {                    // Check if buffer pool initialization failed
-        free(tableInfo); // Free the allocated memory for tableInfo
-        return result;   // Return the error code from buffer pool initialization
+    if (*link != NULL)
+    {                                     // Unlink the entry if it is registered
+        *link = (*entry).next;            // Bypass the entry
+        statsResult = writeTableStats(entry); // Persist the counters of the open table
     }
 
-    char pageData[PAGE_SIZE]; // Allocate a buffer for the first page data
-    char *dataPtr = pageData; // Create a pointer to the beginning of the page data
-    int attrIndex;            // Loop counter for iterating through attributes
-
-    // Record count (initially 0)
-    *(int *)dataPtr = 0;    // Write the initial record count (0) to the page data
-    dataPtr += sizeof(int); // Increment the data pointer
-
-    // First free page index (initially 1)
-    *(int *)dataPtr = 1;    // Write the initial free page index (1) to the page data
-    dataPtr += sizeof(int); // Increment the data pointer
-
-    // Number of attributes in schema
-    *(int *)dataPtr = (*schema).numAttr; // Write the number of attributes to the page data
-    dataPtr += sizeof(int);              // Increment the data pointer
-
-    // Key size information
-    *(int *)dataPtr = (*schema).keySize; // Write the key size to the page data
-    dataPtr += sizeof(int);              // Increment the data pointer
-
-    // Store attribute information
-    for (attrIndex = 0; attrIndex < (*schema).numAttr; attrIndex += 1)
-    {                                                                           // Iterate through each attribute in the schema
-        strncpy(dataPtr, (*schema).attrNames[attrIndex], ATTR_NAME_MAX_LENGTH); // Copy the attribute name to the page data
-        dataPtr += ATTR_NAME_MAX_LENGTH;                                        // Increment the data pointer
-
-        *(int *)dataPtr = (int)(*schema).dataTypes[attrIndex]; // Write the data type to the page data
-        dataPtr += sizeof(int);                                // Increment the data pointer
+    RC result = shutdownBufferPool(&(*entry).dataPool); // Flush and release the table's pool
+    result = (statsResult != RC_OK) ? statsResult : result; // Report the first error
+    free((*entry).zoneState);                            // Free the zone map
+    free((*entry).zoneBounds);
+    free((*entry).name);                                 // Free the registry key
+    free(entry);                                         // Free the entry itself
 
-        *(int *)dataPtr = (int)(*schema).typeLength[attrIndex]; // Write the type length to the page data
-        dataPtr += sizeof(int);                                 // Increment the data pointer
-    }
+    return result; // Return the first error, or RC_OK
+}
 
-    SM_FileHandle fileHandle; // File handle for accessing the page file
+/**
+ * @details : Returns the number of pages in one free-space map group, the map page
+ *            itself plus the data pages it covers.
+ *
+ * @param info : Table whose page size determines the group size
+ *
+ * @return The number of pages per group
+ */
+static int fsmGroupSpan(TableInfo *info)
+{
+    return (*info).pageSize * 8 + 1; // One bit per data page plus the map page
+}
 
-    // Create, open, write to, and close the page file with error handling
-    result = createPageFile(name);
-    if (result != RC_OK)
-    {
-        free(tableInfo); // Clean up allocated memory
-        return result;   // Return the error code if creation fails
-    }
+/**
+ * @details : Checks whether a page of the table is a free-space map page rather than
+ *            a data page.
+ *
+ * @param info : Table the page belongs to
+ * @param page : Page number to check
+ *
+ * @return true for map pages, false for data pages and the metadata page
+ */
+static bool isFsmPage(TableInfo *info, int page)
+{
+    return page >= FIRST_FSM_PAGE && (page - FIRST_FSM_PAGE) % fsmGroupSpan(info) == 0;
+}
 
-    result = openPageFile(name, &fileHandle);
-    if (result != RC_OK)
-    {
-        free(tableInfo); // Clean up allocated memory
-        return result;   // Return the error code if opening fails
-    }
+/**
+ * @details : Records in the free-space map whether a data page is full.
+ *
+ * @param info : Table the page belongs to
+ * @param page : Data page whose state changed
+ * @param full : true if the page has no free slot left
+ *
+ * @return RC_OK on success, or the error of the buffer manager
+ */
+static RC setPageFull(TableInfo *info, int page, bool full)
+{
+    BM_PageHandle mapPage;                                       // Handle of the map page
+    int span = fsmGroupSpan(info);                               // Pages per map group
+    int mapPageNum = page - (page - FIRST_FSM_PAGE) % span;      // Map page covering the page
+    int bit = page - mapPageNum - 1;                             // Bit of the page in the map
+    RC result = pinPage(&(*info).dataPool, &mapPage, mapPageNum); // Pin the map page
 
-    result = writeBlock(0, &fileHandle, pageData);
     if (result != RC_OK)
-    {
-        closePageFile(&fileHandle); // Try to close the file before returning
-        free(tableInfo);            // Clean up allocated memory
-        return result;              // Return the error code if writing fails
+    {                  // Check if pinning failed
+        return result; // Return the error code
     }
 
-    result = closePageFile(&fileHandle);
-    if (result != RC_OK)
-    {
-        free(tableInfo); // Clean up allocated memory
-        return result;   // Return the error code if closing fails
+    unsigned char *byte = (unsigned char *)mapPage.data + bit / 8; // Byte holding the bit
+    unsigned char mask = (unsigned char)(1 << (bit % 8));          // Mask of the bit
+    if (((*byte & mask) != 0) != full)
+    {                                                // Only dirty the map page on a real change
+        *byte = full ? (*byte | mask) : (*byte & ~mask); // Flip the bit
+        result = markDirty(&(*info).dataPool, &mapPage); // Mark the map page as dirty
     }
 
-    return RC_OK; // Return RC_OK to indicate success
+    RC unpinResult = unpinPage(&(*info).dataPool, &mapPage); // Unpin the map page
+    return (result != RC_OK) ? result : unpinResult;         // Report the first error
 }
 
 /**
- * @details : Opens an existing table with the specified name. The function reads the
- *            table metadata from the first page, reconstructs the schema, and prepares
- *            the table for record operations.
+ * @details : Finds the first data page with room for a record, starting at a given
+ *            page. Map pages are searched a byte at a time, so full pages are skipped
+ *            without pinning them.
  *
- * @param rel : Pointer to the RM_TableData structure to be populated
- * @param name : Name of the table to be opened
+ * @param info : Table to search
+ * @param start : Lowest page to consider, usually the table's freePageIndex hint
+ * @param page : Set to the data page with room, or -1 if no page of the file has room
  *
- * @return RC_OK on successful opening of the table
+ * @return RC_OK on success, or the error of the buffer manager
  */
-extern RC openTable(RM_TableData *rel, char *name)
+static RC findPageWithRoom(TableInfo *info, int start, int *page)
 {
-    if (rel == NULL || name == NULL)
-    {                                // Check for invalid parameters
-        return RC_INVALID_PARAMETER; // Return error if invalid parameters
-    }
+    BM_PageHandle mapPage;                              // Handle of the map page being searched
+    int span = fsmGroupSpan(info);                      // Pages per map group
+    int numPages = getPoolNumPages(&(*info).dataPool); // The search ends with the last page of the file
 
-    SM_PageHandle pageContent; // Pointer to hold the content of the page
-    int attrCount, i;          // Variables for attribute count and loop index
-    RC result;                 // Variable to store the result code
-
-    (*rel).mgmtData = tableInfo; // Set the management data of the relation
-    (*rel).name = name;          // Set the name of the relation
-
-    result = pinPage(&(*tableInfo).dataPool, &(*tableInfo).pageInfo, 0); // Pin the first page of the table
-    if (result != RC_OK)
-    {                  // Check for error
-        return result; // Return the error code
+    if (start < FIRST_DATA_PAGE)
+    {                              // Never start before the first data page
+        start = FIRST_DATA_PAGE;   // Clamp the hint
     }
-
-    pageContent = (char *)(*tableInfo).pageInfo.data; // Get the pointer to the page content
-
-    // Read tuple count
-    (*tableInfo).tupleCount = *(int *)pageContent; // Read the tuple count from the page content
-    pageContent += sizeof(int);                    // Increment the page content pointer
-
-    // Read free page index
-    (*tableInfo).freePageIndex = *(int *)pageContent; // Read the free page index from the page content
-    pageContent += sizeof(int);                       // Increment the page content pointer
-
-    // Read attribute count
-    attrCount = *(int *)pageContent; // Read the attribute count from the page content
-    pageContent += sizeof(int);      // Increment the page content pointer
-
-    // Create and populate schema structure
-    Schema *tableSchema = (Schema *)malloc(sizeof(Schema)); // Allocate memory for the schema
-    if (tableSchema == NULL)
-    {                                                              // Check for error
-        unpinPage(&(*tableInfo).dataPool, &(*tableInfo).pageInfo); // Unpin the page
-        return RC_MEMORY_ALLOCATION_ERROR;                         // Return memory allocation error
+    if (isFsmPage(info, start))
+    {                   // A hint may point at a map page
+        start += 1;     // Its first data page comes right after it
     }
 
-    (*tableSchema).numAttr = attrCount;                                     // Set the number of attributes in the schema
-    (*tableSchema).attrNames = (char **)malloc(sizeof(char *) * attrCount); // Allocate memory for attribute names
-    if ((*tableSchema).attrNames == NULL)
-    {                                                              // Check for error
-        free(tableSchema);                                         // Free the schema
-        unpinPage(&(*tableInfo).dataPool, &(*tableInfo).pageInfo); // Unpin the page
-        return RC_MEMORY_ALLOCATION_ERROR;                         // Return memory allocation error
-    }
+    int mapPageNum = start - (start - FIRST_FSM_PAGE) % span; // Map page covering the start
+    int bit = start - mapPageNum - 1;                          // First bit to look at
 
-    (*tableSchema).dataTypes = (DataType *)malloc(sizeof(DataType) * attrCount); // Allocate memory for data types
-    if ((*tableSchema).dataTypes == NULL)
-    {                                                              // Check for error
-        free((*tableSchema).attrNames);                            // Free the attribute names
-        free(tableSchema);                                         // Free the schema
-        unpinPage(&(*tableInfo).dataPool, &(*tableInfo).pageInfo); // Unpin the page
-        return RC_MEMORY_ALLOCATION_ERROR;                         // Return memory allocation error
-    }
+    while (mapPageNum < numPages)
+    {
+        RC result = pinPage(&(*info).dataPool, &mapPage, mapPageNum); // Pin the map page
+        if (result != RC_OK)
+        {                  // Check if pinning failed
+            return result; // Return the error code
+        }
 
-    (*tableSchema).typeLength = (int *)malloc(sizeof(int) * attrCount); // Allocate memory for type lengths
-    if ((*tableSchema).typeLength == NULL)
-    {                                                              // Check for error
-        free((*tableSchema).dataTypes);                            // Free the data types
-        free((*tableSchema).attrNames);                            // Free the attribute names
-        free(tableSchema);                                         // Free the schema
-        unpinPage(&(*tableInfo).dataPool, &(*tableInfo).pageInfo); // Unpin the page
-        return RC_MEMORY_ALLOCATION_ERROR;                         // Return memory allocation error
-    }
+        unsigned char *bits = (unsigned char *)mapPage.data; // Bitmap of the group
+        while (bit < span - 1 && bits[bit / 8] == 0xFF)
+        {                          // Skip bytes whose pages are all full
+            bit = (bit / 8 + 1) * 8; // Jump to the start of the next byte
+        }
+        while (bit < span - 1 && (bits[bit / 8] & (1 << (bit % 8))) != 0)
+        {              // Find the clear bit within the byte
+            bit += 1;  // Move to the next page
+        }
 
-    i = 0;
-    while (i < attrCount)
-    {                                                                       // Loop through the attributes
-        (*tableSchema).attrNames[i] = (char *)malloc(ATTR_NAME_MAX_LENGTH); // Allocate memory for each attribute name
-        if ((*tableSchema).attrNames[i] == NULL)
-        { // Check for error
-            // Free previously allocated memory
-            int j = 0;
-            while (j < i)
-            {                                      // Loop to free previously allocated memory
-                free((*tableSchema).attrNames[j]); // Free the attribute name
-                j += 1;
-            }
-            free((*tableSchema).typeLength);                           // Free the type length
-            free((*tableSchema).dataTypes);                            // Free the data types
-            free((*tableSchema).attrNames);                            // Free the attribute names
-            free(tableSchema);                                         // Free the schema
-            unpinPage(&(*tableInfo).dataPool, &(*tableInfo).pageInfo); // Unpin the page
-            return RC_MEMORY_ALLOCATION_ERROR;                         // Return memory allocation error
+        result = unpinPage(&(*info).dataPool, &mapPage); // Unpin the map page
+        if (result != RC_OK)
+        {                  // Check if unpinning failed
+            return result; // Return the error code
         }
-        i += 1;
+
+        if (bit < span - 1)
+        {                                                                      // A page of this group has room
+            *page = (mapPageNum + 1 + bit < numPages) ? mapPageNum + 1 + bit : -1; // Translate the bit to its data page
+            return RC_OK;                                                      // Return success
+        }
+
+        mapPageNum += span; // Continue with the next group
+        bit = 0;            // From its first data page
     }
 
-    // Read attribute details
-    i = 0;
-    while (i < (*tableSchema).numAttr)
-    {                                                                            // Loop through the attributes
-        strncpy((*tableSchema).attrNames[i], pageContent, ATTR_NAME_MAX_LENGTH); // Copy the attribute name from the page content
-        pageContent += ATTR_NAME_MAX_LENGTH;                                     // Increment the page content pointer
+    *page = -1;   // Every page of the file is full
+    return RC_OK; // Return success
+}
 
-        (*tableSchema).dataTypes[i] = *(int *)pageContent; // Read the data type from the page content
-        pageContent += sizeof(int);                        // Increment the page content pointer
+/**
+ * @details : Adds a data page to the table through the storage manager, which hands
+ *            out a page released by releaseEmptyPage before growing the file.
+ *
+ * @param info : Table to grow
+ * @param page : Set to the new data page, which reads as empty
+ *
+ * @return RC_OK on success, or the error of the buffer manager
+ */
+static RC allocateDataPage(TableInfo *info, int *page)
+{
+    RC result; // Variable to store the result code
 
-        (*tableSchema).typeLength[i] = *(int *)pageContent; // Read the type length from the page content
-        pageContent += sizeof(int);                         // Increment the page content pointer
+    do
+    {                                                       // Map pages are never released, so only growth lands on one
+        result = allocatePoolPage(&(*info).dataPool, page); // Allocate a page
+    } while (result == RC_OK && isFsmPage(info, *page));    // A new map page starts its group with every page free
 
-        i += 1;
-    }
+    return result; // Return RC_OK or the error code
+}
 
-    (*rel).schema = tableSchema; // Set the schema of the relation
+/**
+ * @details : Returns a data page whose last record was removed to the storage manager.
+ *            The page is marked full in the free-space map, so inserts only get it back
+ *            through allocateDataPage. A page still pinned, e.g. by a scan, is kept.
+ *
+ * @param info : Table the page belongs to
+ * @param pageNum : Empty, unpinned data page
+ *
+ * @return RC_OK on success, or the error of the buffer manager
+ */
+static RC releaseEmptyPage(TableInfo *info, int pageNum)
+{
+    RC result = freePoolPage(&(*info).dataPool, pageNum); // Release the page
 
-    result = unpinPage(&(*tableInfo).dataPool, &(*tableInfo).pageInfo); // Unpin the page
-    if (result != RC_OK)
-    {                  // Check for error
-        return result; // Return the error code
+    if (result == RC_PINNED_PAGES_IN_BUFFER)
+    {                 // Somebody still reads the page
+        return RC_OK; // It stays in the table as an empty page
     }
-
-    result = forcePage(&(*tableInfo).dataPool, &(*tableInfo).pageInfo); // Force the page to disk
     if (result != RC_OK)
-    {                  // Check for error
+    {                  // Check if releasing failed
         return result; // Return the error code
     }
-
-    return RC_OK; // Return RC_OK for success
+    return setPageFull(info, pageNum, true); // Keep the map search off the released page
 }
 
 /**
- * @details : Closes a table that was previously opened. This function releases
- *            buffer pool resources associated with the table.
+ * @details : Returns the number of bytes a string attribute's length prefix takes in
+ *            the encoded record.
  *
- * @param rel : Pointer to the RM_TableData structure of the table to be closed
+ * @param typeLength : Declared length of the string attribute
  *
- * @return RC_OK on successful closure of the table
+ * @return 1 for strings of up to 255 bytes, 2 for longer ones
  */
-extern RC closeTable(RM_TableData *rel)
+static int lengthPrefixSize(int typeLength)
 {
-    TableInfo *mgr = rel->mgmtData;     // Get the TableInfo struct from the RM_TableData
-    shutdownBufferPool(&mgr->dataPool); // Shutdown the buffer pool associated with the table
-    return RC_OK;                       // Return RC_OK to indicate success
+    return (typeLength > 255) ? 2 : 1; // One byte covers lengths up to 255
 }
 
 /**
- * @details : Deletes a table with the specified name by removing its underlying
- *            page file from the storage.
- *
- * @param name : Name of the table to be deleted
+ * @details : Works out the size of the longest encoded record of a schema, which is
+ *            the room a page must have left to accept one more record.
  *
- * @return RC_OK if the table is successfully deleted
+ * @param info : Table whose records follow the schema
+ * @param schema : Schema of the table
  */
-extern RC deleteTable(char *name)
+static void setRecordLayout(TableInfo *info, Schema *schema)
 {
-    if (name == NULL)
-    {                                // Check if the table name is NULL
-        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if name is NULL
-    }
-
-    RC result; // Variable to store the result of the destroyPageFile function
+    int size = 1; // The tag byte
+    int i;        // Attribute index
 
-    result = destroyPageFile(name); // Destroy the page file associated with the table name
-    if (result != RC_OK)
-    {                  // Check if destroying the page file was successful
-        return result; // Return the error code if destroying the page file failed
+    for (i = 0; i < (*schema).numAttr; i += 1)
+    {                                                                         // Add the widest form of every attribute
+        if ((*schema).dataTypes[i] == DT_STRING)
+        {                                                                     // Strings carry a length prefix
+            size += lengthPrefixSize((*schema).typeLength[i]) + (*schema).typeLength[i]; // Prefix and full length
+        }
+        else
+        {                                                                     // Fixed-size attributes keep their size
+            size += (*schema).dataTypes[i] == DT_BOOL ? sizeof(bool) : sizeof(int); // Ints and floats take four bytes
+        }
     }
 
-    return RC_OK; // Return RC_OK to indicate success
+    (*info).maxRecordBytes = (size < FORWARD_SIZE) ? FORWARD_SIZE : size; // Every record can become a stub
+
+    // A used entry holds at least a stub, which bounds the directory of a page
+    int maxSlots = ((*info).pageSize - (int)sizeof(DataPageHeader)) / ((int)sizeof(SlotEntry) + FORWARD_SIZE);
+    (*info).slotWords = (maxSlots + 31) / 32; // One bit per slot, in whole words
 }
 
 /**
- * @details : Returns the number of records (tuples) currently stored in the table.
+ * @details : Checks whether the longest record of the table, moved away from its home
+ *            page, fits on an empty data page.
  *
- * @param rel : Pointer to the RM_TableData structure of the table
+ * @param info : Table to check
  *
- * @return The number of tuples in the table
+ * @return true if records of the table can be stored
  */
-extern int getNumTuples(RM_TableData *rel)
+static bool recordsFitPage(TableInfo *info)
 {
-    if (rel == NULL)
-    {              // Check if the table relation is NULL
-        return -1; // Return -1 if the relation is NULL
-    }
-
-    TableInfo *mgr = (*rel).mgmtData; // Get the table management data from the relation
-    return (*mgr).tupleCount;         // Return the number of tuples from the table management data
+    int moved = (*info).maxRecordBytes + FORWARD_SIZE - 1; // Moved records also carry their home RID
+    int bitmap = (*info).slotWords * (int)sizeof(unsigned int);  // Slot bitmap of the page
+    return (int)(sizeof(DataPageHeader) + sizeof(SlotEntry)) + bitmap + moved <= (*info).pageSize;
 }
 
 /**
- * @details : Inserts a new record into the table. The function finds an available
- *            slot for the record, marks it as occupied ('+'), and copies the record
- *            data into the slot.
+ * @details : Encodes the attributes of an in-memory record into the compact page
+ *            format. Strings are cut at their first NUL byte and stored behind their
+ *            length; the other attributes are copied as they are.
  *
- * @param rel : Pointer to the RM_TableData structure of the target table
- * @param record : Pointer to the Record structure containing the data to be inserted
+ * @param schema : Schema of the record
+ * @param data : Record data in memory, starting with the tombstone byte
+ * @param out : Buffer receiving the encoded attributes, without the tag
+ *
+ * @return The number of bytes written
+ */
+static int encodeRecord(Schema *schema, char *data, char *out)
+{
+    char *src = data + 1; // Skip the tombstone byte
+    char *dst = out;      // Write position
+    int i;                // Attribute index
+
+    for (i = 0; i < (*schema).numAttr; i += 1)
+    {                                                    // Encode every attribute in schema order
+        if ((*schema).dataTypes[i] == DT_STRING)
+        {                                                // Variable-length string
+            int maxLen = (*schema).typeLength[i];        // Width of the string in memory
+            int len = (int)strnlen(src, maxLen);         // Bytes up to the terminator
+            *dst++ = (char)(len & 0xFF);                 // Low byte of the length
+            if (lengthPrefixSize(maxLen) == 2)
+            {                                            // Long strings need a second byte
+                *dst++ = (char)(len >> 8);               // High byte of the length
+            }
+            memcpy(dst, src, len);                       // Copy the characters only
+            dst += len;                                  // Move past the string
+            src += maxLen;                               // Move past the in-memory field
+        }
+        else
+        {                                                // Fixed-size attribute
+            int size = ((*schema).dataTypes[i] == DT_BOOL) ? sizeof(bool) : sizeof(int); // Size of the value
+            memcpy(dst, src, size);                      // Copy the value
+            dst += size;                                 // Move past it in the output
+            src += size;                                 // Move past it in the record
+        }
+    }
+
+    return (int)(dst - out); // Number of encoded bytes
+}
+
+/**
+ * @details : Decodes attributes stored in the compact page format into an in-memory
+ *            record. Strings are padded with NUL bytes to their full width, exactly as
+ *            setAttr leaves them. The tombstone byte of the record is not touched.
+ *            Attributes that are not wanted are skipped and left as they were.
+ *
+ * @param schema : Schema of the record
+ * @param in : Encoded attributes, without the tag
+ * @param data : Record data in memory, starting with the tombstone byte
+ * @param wanted : Attributes to decode, indexed by attribute number, or NULL for all
+ */
+static void decodeAttributes(Schema *schema, char *in, char *data, bool *wanted)
+{
+    unsigned char *src = (unsigned char *)in; // Read position
+    char *dst = data + 1;                      // Skip the tombstone byte
+    int i;                                     // Attribute index
+
+    for (i = 0; i < (*schema).numAttr; i += 1)
+    {                                                    // Decode every attribute in schema order
+        bool decode = (wanted == NULL || wanted[i]);     // Whether the caller needs attribute i
+        if ((*schema).dataTypes[i] == DT_STRING)
+        {                                                // Variable-length string
+            int maxLen = (*schema).typeLength[i];        // Width of the string in memory
+            int len = *src++;                            // Low byte of the length
+            if (lengthPrefixSize(maxLen) == 2)
+            {                                            // Long strings have a second byte
+                len |= *src++ << 8;                      // High byte of the length
+            }
+            if (decode)
+            {                                            // Copy the string out
+                memcpy(dst, src, len);                   // Copy the characters
+                memset(dst + len, 0, maxLen - len);      // Pad the field with NUL bytes
+            }
+            src += len;                                  // Move past the stored string
+            dst += maxLen;                               // Move past the in-memory field
+        }
+        else
+        {                                                // Fixed-size attribute
+            int size = ((*schema).dataTypes[i] == DT_BOOL) ? sizeof(bool) : sizeof(int); // Size of the value
+            if (decode)
+            {                                            // Copy the value out
+                memcpy(dst, src, size);                  // Copy the value
+            }
+            dst += size;                                 // Move past it in the record
+            src += size;                                 // Move past it in the input
+        }
+    }
+}
+
+/**
+ * @details : Decodes all attributes of a record stored in the compact page format,
+ *            see decodeAttributes.
+ *
+ * @param schema : Schema of the record
+ * @param in : Encoded attributes, without the tag
+ * @param data : Record data in memory, starting with the tombstone byte
+ */
+static void decodeRecord(Schema *schema, char *in, char *data)
+{
+    decodeAttributes(schema, in, data, NULL); // Decode every attribute
+}
+
+/**
+ * @details : Finds an attribute inside a record stored in the compact page format.
+ *            The attributes before it are skipped by their size, or for strings by
+ *            their stored length.
+ *
+ * @param schema : Schema of the record
+ * @param in : Encoded attributes, without the tag
+ * @param attrNum : The zero-based index of the attribute
+ * @param length : Set to the number of bytes the attribute's value takes
+ *
+ * @return Pointer to the value of the attribute, past any length prefix
+ */
+static char *encodedAttribute(Schema *schema, char *in, int attrNum, int *length)
+{
+    unsigned char *src = (unsigned char *)in; // Read position
+    int i;                                     // Attribute index
+
+    for (i = 0; i <= attrNum; i += 1)
+    {                                                    // Walk up to the attribute
+        int len;                                         // Stored size of attribute i
+        if ((*schema).dataTypes[i] == DT_STRING)
+        {                                                // Variable-length string
+            len = *src++;                                // Low byte of the length
+            if (lengthPrefixSize((*schema).typeLength[i]) == 2)
+            {                                            // Long strings have a second byte
+                len |= *src++ << 8;                      // High byte of the length
+            }
+        }
+        else
+        {                                                // Fixed-size attribute
+            len = ((*schema).dataTypes[i] == DT_BOOL) ? sizeof(bool) : sizeof(int); // Size of the value
+        }
+
+        if (i == attrNum)
+        {                        // Reached the attribute
+            *length = len;       // Report its size
+            return (char *)src;  // Return its value
+        }
+        src += len;              // Move past attribute i
+    }
+
+    return NULL; // Not reached for valid attribute numbers
+}
+
+/**
+ * @details : Returns the slot bitmap of a data page.
+ *
+ * @param page : Content of the data page
+ *
+ * @return Pointer to the first word of the bitmap
+ */
+static unsigned int *slotBitmap(char *page)
+{
+    return (unsigned int *)(page + sizeof(DataPageHeader)); // The bitmap follows the header
+}
+
+/**
+ * @details : Returns the slot directory of a data page.
+ *
+ * @param page : Content of the data page
+ *
+ * @return Pointer to the first directory entry
+ */
+static SlotEntry *slotDirectory(char *page)
+{
+    int words = (*(DataPageHeader *)page).slotWords;                    // Size of the bitmap
+    return (SlotEntry *)(page + sizeof(DataPageHeader) + words * sizeof(unsigned int)); // The directory follows the bitmap
+}
+
+/**
+ * @details : Marks a directory entry as used or free in the slot bitmap.
+ *
+ * @param page : Content of the data page
+ * @param slot : Slot number
+ * @param used : Whether the entry holds a record or a stub
+ */
+static void setSlotUsed(char *page, int slot, bool used)
+{
+    unsigned int bit = 1u << (slot % 32); // Bit of the slot in its word
+    if (used)
+    {
+        slotBitmap(page)[slot / 32] |= bit; // Set it
+    }
+    else
+    {
+        slotBitmap(page)[slot / 32] &= ~bit; // Clear it
+    }
+}
+
+/**
+ * @details : Finds the first free entry of a slot directory that has one.
+ *
+ * @param page : Content of the data page, with liveCount < slotCount
+ *
+ * @return The lowest free slot
+ */
+static int firstFreeSlot(char *page)
+{
+    unsigned int *bits = slotBitmap(page); // Used entries of the page
+    int w = 0;                             // Word looked at
+
+    while (bits[w] == ~0u)
+    {           // Skip words of used entries
+        w += 1; // A free entry below slotCount ends the loop
+    }
+    return w * 32 + __builtin_ctz(~bits[w]); // Lowest clear bit of the word
+}
+
+/**
+ * @details : Looks up the directory entry of a slot that holds a record or a stub.
+ *
+ * @param page : Content of the data page
+ * @param slot : Slot number to look up
+ *
+ * @return The entry of the slot, or NULL if the slot does not exist or is free
+ */
+static SlotEntry *usedSlot(char *page, int slot)
+{
+    DataPageHeader *header = (DataPageHeader *)page; // Header of the page
+
+    if (slot < 0 || slot >= (*header).slotCount || slotDirectory(page)[slot].offset == 0)
+    {                // Slots outside the directory or free entries hold nothing
+        return NULL; // Report the slot as free
+    }
+
+    return &slotDirectory(page)[slot]; // Entry of the used slot
+}
+
+/**
+ * @details : Returns the number of bytes a data page has left, counting the gaps that
+ *            compaction would reclaim.
+ *
+ * @param info : Table the page belongs to
+ * @param page : Content of the data page
+ *
+ * @return The free bytes of the page
+ */
+static int pageFreeBytes(TableInfo *info, char *page)
+{
+    DataPageHeader *header = (DataPageHeader *)page;                // Header of the page
+    int bitmap = (*info).slotWords * (int)sizeof(unsigned int);     // Reserved on fresh pages too
+    return (*info).pageSize - (int)sizeof(DataPageHeader) - bitmap - (*header).slotCount * (int)sizeof(SlotEntry) - (*header).usedBytes;
+}
+
+/**
+ * @details : Checks whether a record of the given size can be stored on a data page,
+ *            either in a free directory entry or in a new one.
+ *
+ * @param info : Table the page belongs to
+ * @param page : Content of the data page
+ * @param bytes : Size of the encoded record
+ *
+ * @return true if the record fits
+ */
+static bool pageHasRoom(TableInfo *info, char *page, int bytes)
+{
+    DataPageHeader *header = (DataPageHeader *)page;                                   // Header of the page
+    int entry = ((*header).liveCount < (*header).slotCount) ? 0 : (int)sizeof(SlotEntry); // A free entry can be reused
+    int size = (bytes < FORWARD_SIZE) ? FORWARD_SIZE : bytes;                            // Records are never smaller than a stub
+    return size + entry <= pageFreeBytes(info, page);                                   // Compare with the free bytes
+}
+
+/**
+ * @details : Moves the records of a data page together at the end of the page so the
+ *            gaps left by deleted and shrunk records become one free area. Slot numbers
+ *            do not change.
+ *
+ * @param info : Table the page belongs to
+ * @param page : Content of the data page
+ * @param scratch : Page-sized buffer of the caller the page is copied to
+ */
+static void compactPage(TableInfo *info, char *page, char *scratch)
+{
+    DataPageHeader *header = (DataPageHeader *)page; // Header of the page
+    SlotEntry *dir = slotDirectory(page);            // Slot directory of the page
+    int freeEnd = (*info).pageSize;                  // Records are packed from the end
+    int i;                                           // Slot index
+
+    memcpy(scratch, page, (*info).pageSize); // Work from a copy of the page
+    for (i = 0; i < (*header).slotCount; i += 1)
+    {                                                             // Repack every used slot
+        if (dir[i].offset != 0)
+        {                                                         // Free entries hold no bytes
+            freeEnd -= dir[i].length;                             // Room for the record
+            memcpy(page + freeEnd, scratch + dir[i].offset, dir[i].length); // Copy the record
+            dir[i].offset = (unsigned short)freeEnd;              // Point the entry at its new place
+        }
+    }
+    (*header).freeEnd = freeEnd; // The record area now starts here
+}
+
+/**
+ * @details : Stores an encoded record on a data page, compacting the page first if the
+ *            free bytes are scattered. The caller checks with pageHasRoom first.
+ *
+ * @param info : Table the page belongs to
+ * @param page : Content of the data page
+ * @param slot : Free slot to use, or -1 for the first free entry or a new one
+ * @param rec : Encoded record, tag included
+ * @param bytes : Size of the encoded record
+ * @param scratch : Page-sized buffer for compacting the page
+ *
+ * @return The slot the record was stored in
+ */
+static int placeRecord(TableInfo *info, char *page, int slot, char *rec, int bytes, char *scratch)
+{
+    DataPageHeader *header = (DataPageHeader *)page;          // Header of the page
+    int size = (bytes < FORWARD_SIZE) ? FORWARD_SIZE : bytes; // Room taken by the record
+
+    if ((*header).slotWords == 0)
+    {                                              // A fresh page, whose zero bitmap marks every slot free
+        (*header).slotWords = (*info).slotWords;   // Lay the directory out behind the bitmap
+    }
+    SlotEntry *dir = slotDirectory(page); // Slot directory of the page
+
+    if (slot == -1 && (*header).liveCount < (*header).slotCount)
+    {                               // Reuse the first free entry
+        slot = firstFreeSlot(page); // Found through the bitmap
+    }
+    int entries = (*header).slotCount + ((slot == -1) ? 1 : 0);                     // Directory size after the insert
+    int dirEnd = (int)((char *)(dir + entries) - page);                               // End of the directory
+    int freeEnd = ((*header).freeEnd == 0) ? (*info).pageSize : (*header).freeEnd;    // Start of the record area
+    if (freeEnd - dirEnd < size)
+    {                                // The free bytes are not in one piece
+        compactPage(info, page, scratch); // Close the gaps before the directory grows
+        freeEnd = (*header).freeEnd; // New start of the record area
+    }
+
+    if (slot == -1)
+    {                               // Append a new entry to the directory
+        slot = (*header).slotCount; // Next slot number
+        (*header).slotCount += 1;   // Grow the directory
+    }
+
+    freeEnd -= size;                          // Room for the record
+    memcpy(page + freeEnd, rec, bytes);       // Copy the encoded record
+    dir[slot].offset = (unsigned short)freeEnd; // Point the entry at the record
+    dir[slot].length = (unsigned short)size;  // Bytes held by the record
+    (*header).freeEnd = freeEnd;              // The record area grew
+    (*header).usedBytes += size;              // Count the bytes
+    (*header).liveCount += 1;                 // Count the entry
+    setSlotUsed(page, slot, true);            // Mark it in the bitmap
+
+    return slot; // Slot of the stored record
+}
+
+/**
+ * @details : Removes the record of a slot. The directory entry becomes free and its
+ *            bytes are reclaimed by the next compaction. Free entries at the end of
+ *            the directory are dropped when requested.
+ *
+ * @param page : Content of the data page
+ * @param slot : Used slot to clear
+ * @param trim : Whether to shrink the directory past trailing free entries
+ */
+static void removeRecord(char *page, int slot, bool trim)
+{
+    DataPageHeader *header = (DataPageHeader *)page; // Header of the page
+    SlotEntry *dir = slotDirectory(page);            // Slot directory of the page
+
+    (*header).usedBytes -= dir[slot].length; // Release the record's bytes
+    (*header).liveCount -= 1;                // One used entry less
+    dir[slot].offset = 0;                    // Free the entry
+    dir[slot].length = 0;                    // It holds no bytes
+    setSlotUsed(page, slot, false);          // Clear it in the bitmap
+
+    while (trim && (*header).slotCount > 0 && dir[(*header).slotCount - 1].offset == 0)
+    {                             // Trailing free entries only cost room
+        (*header).slotCount -= 1; // Drop the last entry
+    }
+}
+
+/**
+ * @details : Returns the next slot at or after a given slot that a scan visits: records
+ *            on their home page and moved records, but no forwarding stubs.
+ *
+ * @param page : Content of the data page
+ * @param from : First slot to consider
+ *
+ * @return The slot number found, or -1 if the page has no more records
+ */
+static int nextScanSlot(char *page, int from)
+{
+    DataPageHeader *header = (DataPageHeader *)page; // Header of the page
+
+    if ((*header).liveCount == 0 || from >= (*header).slotCount)
+    {              // Empty pages are passed over at once
+        return -1; // Report no slot
+    }
+
+    SlotEntry *dir = slotDirectory(page);               // Slot directory of the page
+    unsigned int *bits = slotBitmap(page);              // Used entries of the page
+    int words = ((*header).slotCount + 31) / 32;        // Words covering the directory
+    int w = from / 32;                                  // Word holding the first slot
+    unsigned int candidates = bits[w] & (~0u << (from % 32)); // Ignore slots before the start
+
+    while (1)
+    {
+        while (candidates == 0)
+        {                     // Skip words without a used entry
+            w += 1;           // Move to the next word
+            if (w >= words)
+            {                 // Reached the end of the directory
+                return -1;    // Report no slot
+            }
+            candidates = bits[w]; // Used entries of the word
+        }
+
+        int slot = w * 32 + __builtin_ctz(candidates); // Lowest used entry left
+        if (page[dir[slot].offset] != RECORD_FORWARD)
+        {                // Stubs are visited through their record
+            return slot; // Return the slot
+        }
+        candidates &= candidates - 1; // Pass over the stub
+    }
+}
+
+/**
+ * @details : Locates the record a scan visits at a slot. A moved record is reported
+ *            under its home RID rather than the slot it is stored in.
+ *
+ * @param page : Content of the data page
+ * @param pageNum : Number of the data page
+ * @param slot : Slot returned by nextScanSlot
+ * @param id : Set to the RID the record is known by
+ *
+ * @return The encoded attributes of the record, past its tag
+ */
+static char *scanSlotRecord(char *page, int pageNum, int slot, RID *id)
+{
+    char *rec = page + slotDirectory(page)[slot].offset; // Encoded record
+    (*id).page = pageNum;                                 // Set current page number
+    (*id).slot = slot;                                    // Set current slot number
+    if (*rec == RECORD_MOVED)
+    {                                      // Report a moved record under its home RID
+        memcpy(id, rec + 1, sizeof(RID));  // Read the home RID
+        rec += FORWARD_SIZE - 1;           // Skip the home RID
+    }
+    return rec + 1; // Encoded attributes past the tag
+}
+
+/**
+ * @details : Finds a comparison of a DT_INT or DT_FLOAT attribute with a constant
+ *            that a record must pass to match a compiled condition: the condition
+ *            itself, or a comparison among the operands of its ANDs.
+ *
+ * @param program : Compiled condition
+ * @param step : Step to look at, the last one for the whole condition
+ *
+ * @return The step of the comparison, or -1 if there is none
+ */
+static int findFilterStep(CompiledExpr *program, int step)
+{
+    ExprStep *s = &(*program).steps[step]; // Step looked at
+
+    if ((*s).type == STEP_AND)
+    {                                                       // Either operand must hold
+        int found = findFilterStep(program, (*s).args[0]);  // Look at the first operand
+        return (found != -1) ? found : findFilterStep(program, (*s).args[1]); // Or at the second
+    }
+    if (((*s).type == STEP_EQUAL || (*s).type == STEP_SMALLER || (*s).type == STEP_GREATER) &&
+        ((*s).dt == DT_INT || (*s).dt == DT_FLOAT) &&
+        (((*s).left.offset >= 0) != ((*s).right.offset >= 0)))
+    {                // One attribute and one constant
+        return step; // Return the comparison
+    }
+    return -1; // No comparison to filter on
+}
+
+/**
+ * @details : Frees a page filter.
+ *
+ * @param filter : Filter to free, or NULL
+ */
+static void freePageFilter(PageFilter *filter)
+{
+    if (filter == NULL)
+    {           // No filter
+        return; // Nothing to free
+    }
+    free((*filter).offsets);
+    free((*filter).slots);
+    free((*filter).mask);
+    free((*filter).matches);
+    free(filter);
+}
+
+/**
+ * @details : Creates the page filter of a compiled condition. Records failing the
+ *            filter cannot match, so a scan need not decode them; those that pass
+ *            are still checked against the whole condition.
+ *
+ * @param program : Compiled condition, or NULL
+ * @param schema : Schema of the table
+ * @param pageSize : Page size of the table
+ *
+ * @return The filter, or NULL if the condition has no comparison to filter on
+ */
+static PageFilter *createPageFilter(CompiledExpr *program, Schema *schema, int pageSize)
+{
+    int step = (program != NULL) ? findFilterStep(program, (*program).numSteps - 1) : -1; // Comparison to filter on
+    if (step == -1)
+    {                // Nothing to filter on
+        return NULL; // No filter
+    }
+
+    ExprStep *s = &(*program).steps[step];                     // The comparison
+    bool attrLeft = ((*s).left.offset >= 0);                   // Whether the attribute is the left operand
+    StepOperand *attr = attrLeft ? &(*s).left : &(*s).right;   // Attribute operand
+    PageFilter *filter = (PageFilter *)malloc(sizeof(PageFilter)); // The filter
+    if (filter == NULL)
+    {                // Filters only save work
+        return NULL; // Scan without one
+    }
+
+    int i;
+    (*filter).attrNum = 0;
+    (*filter).fixedOffset = 0; // Encoded records have no tombstone byte
+    for (i = 0; i < (*schema).numAttr && (*schema).attrOffsets[i] != (*attr).offset; i += 1)
+    {                                                         // Find the attribute at the operand's offset
+        if ((*schema).dataTypes[i] == DT_STRING)
+        {                                                     // Strings vary in length when encoded
+            (*filter).fixedOffset = -1;                       // Locate the attribute record by record
+        }
+        else if ((*filter).fixedOffset != -1)
+        {                                                     // Fixed-size attribute
+            (*filter).fixedOffset += ((*schema).dataTypes[i] == DT_BOOL) ? sizeof(bool) : sizeof(int); // Its encoded size
+        }
+    }
+    (*filter).attrNum = i;
+    (*filter).constant = attrLeft ? (*s).right.value : (*s).left.value; // Numbers own no memory
+    (*filter).op = ((*s).type == STEP_EQUAL) ? FILTER_EQUAL
+                   : (((*s).type == STEP_SMALLER) == attrLeft) ? FILTER_SMALLER : FILTER_GREATER; // constant < attribute is attribute > constant
+    (*filter).kernel = bestFilterKernel();
+    (*filter).pageNum = -1; // Not run yet
+    (*filter).capacity = pageSize / (int)sizeof(SlotEntry); // Bound on the slot directory
+    (*filter).offsets = (int *)malloc(sizeof(int) * (*filter).capacity);
+    (*filter).slots = (int *)malloc(sizeof(int) * (*filter).capacity);
+    (*filter).mask = (unsigned char *)malloc(((*filter).capacity + 7) / 8);
+    (*filter).matches = (bool *)malloc(sizeof(bool) * (*filter).capacity);
+    if (i == (*schema).numAttr || (*filter).offsets == NULL || (*filter).slots == NULL ||
+        (*filter).mask == NULL || (*filter).matches == NULL)
+    {                             // Attribute not found or allocation failed
+        freePageFilter(filter);   // Free what was allocated
+        return NULL;              // Scan without a filter
+    }
+    return filter; // Return the filter
+}
+
+
+/**
+ * @details : Runs a page filter over every record of a data page, filling its
+ *            matches for the slots of the page. The value of the attribute is found
+ *            in each record, and the filter kernel compares them all in one call.
+ *
+ * @param filter : Filter to run
+ * @param info : Table the page belongs to
+ * @param schema : Schema of the table
+ * @param pageNum : Number of the data page
+ * @param page : Content of the data page
+ */
+static void runPageFilter(PageFilter *filter, TableInfo *info, Schema *schema, int pageNum, char *page)
+{
+    int slotCount = (*(DataPageHeader *)page).slotCount; // Slots of the page
+    int count = 0;                                       // Records tested
+    int slot, i, length;
+    RID id;
+
+    for (slot = nextScanSlot(page, 0); slot != -1; slot = nextScanSlot(page, slot + 1))
+    {                                                      // Locate the attribute in every record
+        char *stored = scanSlotRecord(page, 0, slot, &id); // Encoded attributes of the record
+        char *value = ((*filter).fixedOffset >= 0) ? stored + (*filter).fixedOffset
+                                                   : encodedAttribute(schema, stored, (*filter).attrNum, &length);
+        (*filter).offsets[count] = (int)(value - page);    // Offset of the value on the page
+        (*filter).slots[count] = slot;                     // Slot it belongs to
+        count += 1;
+    }
+
+    filterColumnWith((*filter).kernel, page, (*filter).offsets, count, (*schema).dataTypes[(*filter).attrNum],
+                     (*filter).op, &(*filter).constant, (*filter).mask); // Compare them all at once
+    memset((*filter).matches, 0, sizeof(bool) * slotCount);               // No slot passed yet
+    for (i = 0; i < count; i += 1)
+    {                                                   // Map the mask back to slots
+        if ((*filter).mask[i >> 3] & (1 << (i & 7)))
+        {                                               // Record i passed
+            (*filter).matches[(*filter).slots[i]] = TRUE; // Mark its slot
+        }
+    }
+    (*filter).pageNum = pageNum;                // Remember what the matches describe
+    (*filter).slotCount = slotCount;
+    (*filter).writeCount = (*info).writeCount;
+}
+
+/**
+ * @details : Tells whether the matches of a page filter still describe a page. A
+ *            scan keeps its page pinned between calls, and the caller may insert,
+ *            update or delete records on it in the meantime.
+ *
+ * @param filter : Filter that was run
+ * @param info : Table the page belongs to
+ * @param pageNum : Number of the data page
+ * @param page : Content of the data page
+ *
+ * @return true if the filter ran on the page as it is now
+ */
+static bool pageFilterCurrent(PageFilter *filter, TableInfo *info, int pageNum, char *page)
+{
+    return (*filter).pageNum == pageNum && (*filter).writeCount == (*info).writeCount &&
+           (*filter).slotCount == (*(DataPageHeader *)page).slotCount;
+}
+
+/**
+ * @details : Makes sure the zone map has entries up to a page. Pages the file had when
+ *            the table was opened start out unknown, so a scan summarizes them before
+ *            relying on them; pages appended since start out empty. A map that cannot
+ *            grow is marked broken, since it would miss the records of the page.
+ *
+ * @param info : Table the zone map belongs to
+ * @param pageNum : Page that needs an entry
+ *
+ * @return true if the page has an entry
+ */
+static bool ensureZonePage(TableInfo *info, int pageNum)
+{
+    if (pageNum < (*info).zonePages)
+    {                // The entry exists
+        return TRUE; // Nothing to do
+    }
+    if ((*info).zoneBroken)
+    {                 // The map is no longer kept
+        return FALSE; // Report no entry
+    }
+
+    int pages = ((*info).zonePages > 0) ? (*info).zonePages : 64; // Grow the map by doubling
+    while (pages <= pageNum)
+    {                 // Until the page is covered
+        pages *= 2;   // Double the size
+    }
+
+    char *state = (char *)realloc((*info).zoneState, pages);
+    if (state != NULL)
+    {                             // Keep the grown array even if the bounds fail
+        (*info).zoneState = state;
+    }
+    double *bounds = (double *)realloc((*info).zoneBounds, sizeof(double) * 2 * (*info).zoneAttrs * pages);
+    if (bounds != NULL)
+    {                               // Keep the grown array even if the state failed
+        (*info).zoneBounds = bounds;
+    }
+    if (state == NULL || bounds == NULL)
+    {                                  // Writes to the new pages could not be tracked
+        (*info).zoneBroken = TRUE;     // Stop skipping pages for good
+        return FALSE;                  // Report no entry
+    }
+
+    int page, i;
+    for (page = (*info).zonePages; page < pages; page += 1)
+    {                                                                            // Set up the new entries
+        state[page] = (page >= (*info).zoneFirstNew) ? ZONE_EMPTY : ZONE_UNKNOWN; // Appended pages are empty
+        for (i = 0; i < (*info).zoneAttrs; i += 1)
+        {                                                              // Bounds that no value lies within
+            bounds[2 * ((*info).zoneAttrs * page + i)] = INFINITY;      // Lowest value
+            bounds[2 * ((*info).zoneAttrs * page + i) + 1] = -INFINITY; // Highest value
+        }
+    }
+    (*info).zonePages = pages;
+
+    return TRUE; // The page has an entry
+}
+
+/**
+ * @details : Widens the zone map bounds of a page to cover the DT_INT and DT_FLOAT
+ *            attributes of a record stored on it. A NaN float widens the bounds of its
+ *            attribute to everything, as it matches no range but does match <>. Pages
+ *            not summarized yet are left alone; their records are read when they are.
+ *
+ * @param info : Table the page belongs to
+ * @param schema : Schema of the table
+ * @param pageNum : Page the record is stored on
+ * @param rec : The record, in memory or encoded without its tag
+ * @param encoded : Whether rec is in the compact page format
+ */
+static void widenPageZone(TableInfo *info, Schema *schema, int pageNum, char *rec, bool encoded)
+{
+    if (!ensureZonePage(info, pageNum) || (*info).zoneState[pageNum] == ZONE_UNKNOWN)
+    {           // No bounds to widen
+        return; // Leave the page to be summarized
+    }
+
+    double *bounds = &(*info).zoneBounds[2 * (*info).zoneAttrs * pageNum]; // Bounds of the page
+    unsigned char *src = (unsigned char *)rec;                           // Read position in an encoded record
+    int i;                                                                // Attribute index
+
+    (*info).zoneState[pageNum] = ZONE_KNOWN; // The page holds a record
+    for (i = 0; i < (*schema).numAttr; i += 1)
+    {                                                    // Walk the attributes in schema order
+        int size;                                        // Stored size of attribute i
+        if ((*schema).dataTypes[i] == DT_STRING)
+        {                                                // Strings have no bounds
+            size = (*schema).typeLength[i];              // Width of the string in memory
+            if (encoded)
+            {                                            // Encoded strings carry their length
+                size = *src++;                           // Low byte of the length
+                if (lengthPrefixSize((*schema).typeLength[i]) == 2)
+                {                                        // Long strings have a second byte
+                    size |= *src++ << 8;                 // High byte of the length
+                }
+            }
+        }
+        else
+        {                                                // Fixed-size attribute
+            size = ((*schema).dataTypes[i] == DT_BOOL) ? sizeof(bool) : sizeof(int); // Size of the value
+        }
+
+        char *value = encoded ? (char *)src : rec + (*schema).attrOffsets[i]; // The value of attribute i
+        if ((*schema).dataTypes[i] == DT_INT || (*schema).dataTypes[i] == DT_FLOAT)
+        {                                                // Numbers are tracked as doubles, which hold both exactly
+            double v;
+            if ((*schema).dataTypes[i] == DT_INT)
+            {
+                int n;
+                memcpy(&n, value, sizeof(int));
+                v = n;
+            }
+            else
+            {
+                float f;
+                memcpy(&f, value, sizeof(float));
+                v = f;
+            }
+            if (isnan(v))
+            {                                // NaN lies outside any range
+                bounds[2 * i] = -INFINITY;   // Give up on the attribute's bounds
+                bounds[2 * i + 1] = INFINITY;
+            }
+            if (v < bounds[2 * i])
+            {                         // New lowest value
+                bounds[2 * i] = v;
+            }
+            if (v > bounds[2 * i + 1])
+            {                         // New highest value
+                bounds[2 * i + 1] = v;
+            }
+        }
+        src += size; // Move past attribute i of an encoded record
+    }
+}
+
+/**
+ * @details : Summarizes a page the zone map has no bounds for yet from the records
+ *            stored on it, moved records included. Each page has its own entry, so
+ *            the workers of a parallel scan can summarize different pages at once as
+ *            long as the map was grown before they started.
+ *
+ * @param info : Table the page belongs to
+ * @param schema : Schema of the table
+ * @param pageNum : Number of the data page
+ * @param page : Content of the data page
+ */
+static void summarizePageZone(TableInfo *info, Schema *schema, int pageNum, char *page)
+{
+    int slot;
+    RID id;
+
+    if (!ensureZonePage(info, pageNum) || (*info).zoneState[pageNum] != ZONE_UNKNOWN)
+    {           // Nothing to summarize
+        return; // Keep the bounds the page has
+    }
+
+    (*info).zoneState[pageNum] = ZONE_EMPTY; // Start from no records
+    for (slot = nextScanSlot(page, 0); slot != -1; slot = nextScanSlot(page, slot + 1))
+    {                                                                               // Add every record of the page
+        widenPageZone(info, schema, pageNum, scanSlotRecord(page, pageNum, slot, &id), TRUE);
+    }
+}
+
+/**
+ * @details : Finds the attribute a compiled operand refers to.
+ *
+ * @param schema : Schema of the table
+ * @param operand : Attribute operand of a step
+ *
+ * @return The attribute number, or -1 if no attribute is at the operand's offset
+ */
+static int operandAttribute(Schema *schema, StepOperand *operand)
+{
+    int i;
+
+    for (i = 0; i < (*schema).numAttr; i += 1)
+    {                                                       // Compare the offsets
+        if ((*schema).attrOffsets[i] == (*operand).offset)
+        {                                                   // Found the attribute
+            return i;
+        }
+    }
+    return -1; // Not found
+}
+
+/**
+ * @details : Returns a numeric constant of a compiled operand as a double.
+ *
+ * @param operand : Constant operand of type DT_INT or DT_FLOAT
+ *
+ * @return The constant
+ */
+static double operandNumber(StepOperand *operand)
+{
+    return ((*operand).value.dt == DT_INT) ? (double)(*operand).value.v.intV : (double)(*operand).value.v.floatV;
+}
+
+/**
+ * @details : Checks whether any record within a page's zone map bounds can meet a step
+ *            of a compiled condition. Comparisons of a DT_INT or DT_FLOAT attribute
+ *            with constants are tested against the attribute's bounds, ANDs and ORs
+ *            combine their operands, and every other step may match.
+ *
+ * @param program : Compiled condition
+ * @param step : Step to check, the last one for the whole condition
+ * @param schema : Schema of the table
+ * @param bounds : Bounds of the page, lowest and highest value per attribute
+ *
+ * @return false only if no record within the bounds meets the step
+ */
+static bool zoneMayMatch(CompiledExpr *program, int step, Schema *schema, double *bounds)
+{
+    ExprStep *s = &(*program).steps[step]; // Step looked at
+    StepType type = (*s).type;             // Comparison, turned around below if need be
+    StepOperand *attr = &(*s).left;        // Attribute operand
+    StepOperand *constant = &(*s).right;   // Constant operand
+    int i;
+
+    switch (type)
+    {
+    case STEP_CONST:
+        return (*s).value; // Constant conditions decide every page alike
+    case STEP_AND:
+        return zoneMayMatch(program, (*s).args[0], schema, bounds) && zoneMayMatch(program, (*s).args[1], schema, bounds);
+    case STEP_OR:
+        return zoneMayMatch(program, (*s).args[0], schema, bounds) || zoneMayMatch(program, (*s).args[1], schema, bounds);
+    case STEP_EQUAL:
+    case STEP_SMALLER:
+    case STEP_SMALLER_EQUAL:
+    case STEP_GREATER:
+    case STEP_GREATER_EQUAL:
+    case STEP_NOT_EQUAL:
+    case STEP_BETWEEN:
+    case STEP_IN:
+        break; // Comparisons are tested below
+    default:
+        return TRUE; // Negations and boolean attributes may match
+    }
+
+    if ((*s).dt != DT_INT && (*s).dt != DT_FLOAT)
+    {                // Only numbers have bounds
+        return TRUE; // May match
+    }
+    if ((*attr).offset < 0 && type < STEP_BETWEEN)
+    {                                 // constant op attribute is attribute op' constant
+        attr = &(*s).right;
+        constant = &(*s).left;
+        type = (type == STEP_SMALLER) ? STEP_GREATER : (type == STEP_GREATER) ? STEP_SMALLER
+               : (type == STEP_SMALLER_EQUAL) ? STEP_GREATER_EQUAL
+               : (type == STEP_GREATER_EQUAL) ? STEP_SMALLER_EQUAL : type;
+    }
+    int attrNum = ((*attr).offset >= 0) ? operandAttribute(schema, attr) : -1; // Attribute compared
+    if (attrNum == -1 || (type != STEP_IN && (*constant).offset >= 0) ||
+        (type == STEP_BETWEEN && (*s).high.offset >= 0))
+    {                // Not an attribute against constants
+        return TRUE; // May match
+    }
+
+    double low = bounds[2 * attrNum];      // Lowest value on the page
+    double high = bounds[2 * attrNum + 1]; // Highest value on the page
+    double c = (type != STEP_IN) ? operandNumber(constant) : 0;
+    switch (type)
+    {
+    case STEP_EQUAL:
+        return low <= c && c <= high;
+    case STEP_SMALLER:
+        return low < c;
+    case STEP_SMALLER_EQUAL:
+        return low <= c;
+    case STEP_GREATER:
+        return high > c;
+    case STEP_GREATER_EQUAL:
+        return high >= c;
+    case STEP_NOT_EQUAL:
+        return !(low == c && high == c); // Only a page holding nothing but c fails
+    case STEP_BETWEEN:
+        return high >= c && low <= operandNumber(&(*s).high);
+    default:
+        for (i = 0; i < (*s).listLength; i += 1)
+        {                                                  // Any listed value within the bounds
+            if ((*s).list[i].offset >= 0)
+            {                                              // An attribute in the list
+                return TRUE;                               // May match
+            }
+            c = operandNumber(&(*s).list[i]);
+            if (low <= c && c <= high)
+            {                                              // The value may be on the page
+                return TRUE;
+            }
+        }
+        return FALSE; // No listed value is on the page
+    }
+}
+
+/**
+ * @details : Checks the zone map of a page against a compiled condition before the
+ *            page is read. Pages the map has not summarized yet may always match.
+ *
+ * @param info : Table the page belongs to
+ * @param program : Compiled condition
+ * @param schema : Schema of the table
+ * @param pageNum : Page to check
+ *
+ * @return false if no record of the page can match, so the page can be skipped
+ */
+static bool pageMayMatch(TableInfo *info, CompiledExpr *program, Schema *schema, int pageNum)
+{
+    if ((*info).zoneBroken || pageNum >= (*info).zonePages || (*info).zoneState[pageNum] == ZONE_UNKNOWN)
+    {                // Nothing known about the page
+        return TRUE; // Read it
+    }
+    if ((*info).zoneState[pageNum] == ZONE_EMPTY)
+    {                 // No record was ever stored on the page
+        return FALSE; // Nothing to find
+    }
+    return zoneMayMatch(program, (*program).numSteps - 1, schema,
+                        &(*info).zoneBounds[2 * (*info).zoneAttrs * pageNum]);
+}
+
+/**
+ * @details : Updates the free-space map bit of a data page after its content changed.
+ *
+ * @param info : Table the page belongs to
+ * @param pageNum : Number of the data page
+ * @param page : Content of the data page
+ *
+ * @return RC_OK on success, or the error of the buffer manager
+ */
+static RC updatePageRoom(TableInfo *info, int pageNum, char *page)
+{
+    return setPageFull(info, pageNum, !pageHasRoom(info, page, (*info).maxRecordBytes)); // Full without room for the longest record
+}
+
+/**
+ * @details : Removes a moved record from the page it was moved to.
+ *
+ * @param info : Table the record belongs to
+ * @param target : RID the forwarding stub points at
+ *
+ * @return RC_OK on success, or the error of the buffer manager
+ */
+static RC dropMovedRecord(TableInfo *info, RID target)
+{
+    BM_PageHandle page; // Handle of the page holding the moved record
+    RC result = pinPage(&(*info).dataPool, &page, target.page); // Pin the page
+
+    if (result != RC_OK)
+    {                  // Check if pinning failed
+        return result; // Return the error code
+    }
+
+    bool empty = false; // Whether the page lost its last record
+    if (usedSlot(page.data, target.slot) != NULL)
+    {                                                  // A broken stub has nothing to remove
+        removeRecord(page.data, target.slot, true);    // Remove the moved record
+        empty = ((DataPageHeader *)page.data)->liveCount == 0; // Check for the last record
+        result = markDirty(&(*info).dataPool, &page);  // Mark the page as dirty
+        if (result == RC_OK)
+        {                                              // Only update the map for a stored change
+            result = updatePageRoom(info, target.page, page.data); // The page gained room
+        }
+    }
+
+    RC unpinResult = unpinPage(&(*info).dataPool, &page); // Unpin the page
+    if (target.page < (*info).freePageIndex)
+    {                                       // Inserts must not skip the page that gains room
+        (*info).freePageIndex = target.page; // Update free page index
+    }
+    result = (result != RC_OK) ? result : unpinResult; // Keep the first error
+    if (result == RC_OK && empty)
+    {                                                  // Hand the empty page back to the file
+        result = releaseEmptyPage(info, target.page); // Release the page
+    }
+    return result; // Report the first error
+}
+
+/**
+ * @details : Stores a record that no longer fits on its home page on another data
+ *            page, searching the free-space map from the freePageIndex hint.
+ *
+ * @param info : Table the record belongs to
+ * @param homePage : Home page of the record, which is not a candidate
+ * @param rec : Encoded moved record, tag and home RID included
+ * @param bytes : Size of the encoded record
+ * @param target : Set to the RID of the moved record
+ * @param scratch : Page-sized buffer for compacting the target page
+ *
+ * @return RC_OK on success, or the error of the buffer manager
+ */
+static RC storeMovedRecord(TableInfo *info, int homePage, char *rec, int bytes, RID *target, char *scratch)
+{
+    BM_PageHandle page;                 // Handle of the candidate page
+    int from = (*info).freePageIndex;   // Lowest page that may have room
+    RC result;                          // Variable to store the result code
+
+    while (true)
+    {                                                           // Loop until a page takes the record
+        result = findPageWithRoom(info, from, &(*target).page); // Look up a page with room
+        if (result == RC_OK && (*target).page == -1)
+        {                                                    // Every page of the file is full
+            result = allocateDataPage(info, &(*target).page); // Add a page
+        }
+        if (result != RC_OK)
+        {                  // Check if the map lookup failed
+            return result; // Return the error code
+        }
+        from = (*target).page + 1; // Continue behind this page if it does not fit
+
+        if ((*target).page == homePage)
+        {             // The record has just failed to fit there
+            continue; // Try the next page
+        }
+
+        result = pinPage(&(*info).dataPool, &page, (*target).page); // Pin the page
+        if (result != RC_OK)
+        {                  // Check if pinning failed
+            return result; // Return the error code
+        }
+
+        if (pageHasRoom(info, page.data, bytes))
+        {                                                                  // The moved record fits
+            (*target).slot = placeRecord(info, page.data, -1, rec, bytes, scratch); // Store it
+            result = markDirty(&(*info).dataPool, &page);                  // Mark the page as dirty
+            if (result == RC_OK)
+            {                                                              // Only update the map for a stored change
+                result = updatePageRoom(info, (*target).page, page.data);  // The page lost room
+            }
+            RC unpinResult = unpinPage(&(*info).dataPool, &page);          // Unpin the page
+            return (result != RC_OK) ? result : unpinResult;               // Report the first error
+        }
+
+        result = unpinPage(&(*info).dataPool, &page); // Unpin the page that is too full
+        if (result != RC_OK)
+        {                  // Check if unpinning failed
+            return result; // Return the error code
+        }
+    }
+}
+
+/**
+ * @details : Cleans up after openTable failed to allocate the schema. A table that was
+ *            being opened for the first time is released again.
+ *
+ * @param entry : Registry entry of the table being opened
+ * @param firstHandle : Whether openTable created the entry
+ *
+ * @return RC_MEMORY_ALLOCATION_ERROR, the error openTable reports
+ */
+static RC abortOpen(TableInfo *entry, bool firstHandle)
+{
+    if (firstHandle)
+    {                        // Only a new entry is owned by the failed open
+        releaseTable(entry); // Release the pool and the entry
+    }
+
+    return RC_MEMORY_ALLOCATION_ERROR; // Report the allocation failure
+}
+
+/**
+ * @details : The function initRecordManager initializes the record manager by setting up
+ *            the storage manager for subsequent record operations and starting with an
+ *            empty table registry. Tables left open by an earlier session are released.
+ *
+ * @param mgmtData : Pointer to management data (not used in this implementation)
+ *
+ * @return RC_OK upon successful initialization
+ */
+extern RC initRecordManager(void *mgmtData)
+{
+    initStorageManager(); // Initialize the storage manager
+
+    while (openTables != NULL)
+    {                             // Release tables an earlier session did not close
+        releaseTable(openTables); // Release the head of the registry
+    }
+
+    return RC_OK; // Return RC_OK to indicate success
+}
+
+/**
+ * @details : Shuts down the record manager and releases any allocated resources,
+ *            closing every table that is still registered as open.
+ *
+ * @return RC_OK upon successful shutdown, or the first error of a table shutdown
+ */
+extern RC shutdownRecordManager()
+{
+    RC result = RC_OK; // Result of the first failing table shutdown
+
+    freeRecordCache(recordCache); // Free the records this thread keeps for reuse
+    recordCache = NULL;           // Start a new cache on next use
+    if (pthread_once(&recordCacheOnce, createRecordCacheKey) == 0)
+    {                                             // The key exists
+        pthread_setspecific(recordCacheKey, NULL); // Nothing left to free at thread exit
+    }
+
+    while (openTables != NULL)
+    {                                        // Release every table still open
+        RC rc = releaseTable(openTables);    // Release the head of the registry
+        if (rc != RC_OK && result == RC_OK)
+        {                                    // Remember only the first failure
+            result = rc;                     // Keep the error code
+        }
+    }
+
+    return result; // Return RC_OK or the first error
+}
+
+/**
+ * @details : Creates a new table with the specified name and schema, using the
+ *            default page size (PAGE_SIZE) for its page file.
+ *
+ * @param name : Name of the table to be created
+ * @param schema : Schema definition for the table
+ *
+ * @return RC_OK on success, or an error code if any operation fails
+ */
+extern RC createTable(char *name, Schema *schema)
+{
+    return createTableWithPageSize(name, schema, PAGE_SIZE); // Delegate with the default page size
+}
+
+/**
+ * @details : Creates a new table with the specified name, schema and page size. The
+ *            function sets up the table metadata page and writes the schema information
+ *            to the first page of the table file. No buffer pool is needed until the
+ *            table is opened.
+ *            Larger pages hold more slots each, which suits scan-heavy tables.
+ *
+ * @param name : Name of the table to be created
+ * @param schema : Schema definition for the table
+ * @param pageSize : Page size of the table file (SM_MIN_PAGE_SIZE to SM_MAX_PAGE_SIZE)
+ *
+ * @return RC_OK on success, or an error code if any operation fails
+ */
+extern RC createTableWithPageSize(char *name, Schema *schema, int pageSize)
+{
+    RC result; // Variable to store the result code of function calls
+
+    if (name == NULL || schema == NULL)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Return an error code if parameters are invalid
+    }
+
+    char *pageData = (char *)calloc(1, pageSize); // Allocate a buffer for the first page data
+    if (pageData == NULL)
+    {                                      // Check if memory allocation failed
+        return RC_MEMORY_ALLOCATION_ERROR; // Return an error code if memory allocation failed
+    }
+    char *dataPtr = pageData; // Create a pointer to the beginning of the page data
+    int attrIndex;            // Loop counter for iterating through attributes
+
+    // Record count (initially 0)
+    *(int *)dataPtr = 0;    // Write the initial record count (0) to the page data
+    dataPtr += sizeof(int); // Increment the data pointer
+
+    // First free page index (initially the first data page)
+    *(int *)dataPtr = FIRST_DATA_PAGE; // Write the initial free page index to the page data
+    dataPtr += sizeof(int); // Increment the data pointer
+
+    // Number of attributes in schema
+    *(int *)dataPtr = (*schema).numAttr; // Write the number of attributes to the page data
+    dataPtr += sizeof(int);              // Increment the data pointer
+
+    // Key size information
+    *(int *)dataPtr = (*schema).keySize; // Write the key size to the page data
+    dataPtr += sizeof(int);              // Increment the data pointer
+
+    // Store attribute information
+    for (attrIndex = 0; attrIndex < (*schema).numAttr; attrIndex += 1)
+    {                                                                           // Iterate through each attribute in the schema
+        strncpy(dataPtr, (*schema).attrNames[attrIndex], ATTR_NAME_MAX_LENGTH); // Copy the attribute name to the page data
+        dataPtr += ATTR_NAME_MAX_LENGTH;                                        // Increment the data pointer
+
+        *(int *)dataPtr = (int)(*schema).dataTypes[attrIndex]; // Write the data type to the page data
+        dataPtr += sizeof(int);                                // Increment the data pointer
+
+        *(int *)dataPtr = (int)(*schema).typeLength[attrIndex]; // Write the type length to the page data
+        dataPtr += sizeof(int);                                 // Increment the data pointer
+    }
+
+    SM_FileHandle fileHandle;                    // File handle for accessing the page file
+    SM_FileOptions fileOptions = {.pageSize = pageSize}; // Plain page file with the requested page size
+
+    // Create, open, write to, and close the page file with error handling
+    result = createPageFileWithOptions(name, &fileOptions);
+    if (result != RC_OK)
+    {
+        free(pageData); // Clean up allocated memory
+        return result;  // Return the error code if creation fails
+    }
+
+    result = openPageFile(name, &fileHandle);
+    if (result != RC_OK)
+    {
+        free(pageData); // Clean up allocated memory
+        return result;  // Return the error code if opening fails
+    }
+
+    result = writeBlock(0, &fileHandle, pageData);
+    free(pageData); // The page has been handed to the storage manager
+    if (result != RC_OK)
+    {
+        closePageFile(&fileHandle); // Try to close the file before returning
+        return result;              // Return the error code if writing fails
+    }
+
+    return closePageFile(&fileHandle); // Return the result of closing the file
+}
+
+/**
+ * @details : Opens an existing table with the specified name. The function reads the
+ *            table metadata from the first page, reconstructs the schema, and prepares
+ *            the table for record operations. The first handle of a table registers it
+ *            with its own buffer pool; further handles of the same table share that
+ *            registry entry instead of creating another pool.
+ *
+ * @param rel : Pointer to the RM_TableData structure to be populated
+ * @param name : Name of the table to be opened
+ *
+ * @return RC_OK on successful opening of the table
+ */
+extern RC openTable(RM_TableData *rel, char *name)
+{
+    if (rel == NULL || name == NULL)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Return error if invalid parameters
+    }
+
+    SM_PageHandle pageContent;                // Pointer to hold the content of the page
+    BM_PageHandle metaPage;                   // Handle of the table's metadata page
+    int attrCount, i;                         // Variables for attribute count and loop index
+    RC result;                                // Variable to store the result code
+    TableInfo *tableInfo = findOpenTable(name); // Share the entry if the table is already open
+    bool firstHandle = (tableInfo == NULL);     // Whether this handle registers the table
+
+    if (firstHandle)
+    {                                                          // Set up the table's own state and buffer pool
+        tableInfo = (TableInfo *)calloc(1, sizeof(TableInfo)); // Allocate the registry entry
+        if (tableInfo == NULL)
+        {                                      // Check if memory allocation failed
+            return RC_MEMORY_ALLOCATION_ERROR; // Return memory allocation error
+        }
+
+        (*tableInfo).name = strdup(name); // Keep a private copy of the registry key
+        if ((*tableInfo).name == NULL)
+        {                                      // Check if memory allocation failed
+            free(tableInfo);                   // Free the entry
+            return RC_MEMORY_ALLOCATION_ERROR; // Return memory allocation error
+        }
+
+        result = initBufferPool(&(*tableInfo).dataPool, (*tableInfo).name, MAX_BUFFER_SIZE, RS_LRU, NULL); // Initialize the buffer pool
+        if (result != RC_OK)
+        {                           // Check if buffer pool initialization failed
+            free((*tableInfo).name); // Free the registry key
+            free(tableInfo);        // Free the entry
+            return result;          // Return the error code
+        }
+    }
+
+    result = pinPage(&(*tableInfo).dataPool, &metaPage, 0); // Pin the first page of the table
+    if (result != RC_OK)
+    {                              // Check for error
+        if (firstHandle)
+        {                          // Undo the setup of a table that never opened
+            releaseTable(tableInfo); // Release the pool and the entry
+        }
+        return result; // Return the error code
+    }
+
+    pageContent = (char *)metaPage.data; // Get the pointer to the page content
+
+    if (firstHandle)
+    {                                                                    // Later handles keep the live counters
+        (*tableInfo).pageSize = getPoolPageSize(&(*tableInfo).dataPool); // Page math follows the file's page size
+        (*tableInfo).tupleCount = *(int *)pageContent;                   // Read the tuple count from the page content
+        (*tableInfo).freePageIndex = *(int *)(pageContent + sizeof(int)); // Read the free page index
+    }
+    pageContent += 2 * sizeof(int); // Skip the tuple count and the free page index
+
+    // Read attribute count
+    attrCount = *(int *)pageContent; // Read the attribute count from the page content
+    pageContent += sizeof(int);      // Increment the page content pointer
+
+    // Read key size, written by createTable between the attribute count and the attributes
+    int keySize = *(int *)pageContent; // Read the key size from the page content
+    pageContent += sizeof(int);        // Increment the page content pointer
+
+    // Create and populate schema structure
+    Schema *tableSchema = (Schema *)malloc(sizeof(Schema)); // Allocate memory for the schema
+    if (tableSchema == NULL)
+    {                                                              // Check for error
+        unpinPage(&(*tableInfo).dataPool, &metaPage); // Unpin the page
+        return abortOpen(tableInfo, firstHandle);                  // Return memory allocation error
+    }
+
+    (*tableSchema).numAttr = attrCount;                                     // Set the number of attributes in the schema
+    (*tableSchema).keySize = keySize;                                       // Set the key size of the schema
+    (*tableSchema).keyAttrs = NULL;                                         // Key attributes are not stored
+    (*tableSchema).attrNames = (char **)malloc(sizeof(char *) * attrCount); // Allocate memory for attribute names
+    if ((*tableSchema).attrNames == NULL)
+    {                                                              // Check for error
+        free(tableSchema);                                         // Free the schema
+        unpinPage(&(*tableInfo).dataPool, &metaPage); // Unpin the page
+        return abortOpen(tableInfo, firstHandle);                  // Return memory allocation error
+    }
+
+    (*tableSchema).dataTypes = (DataType *)malloc(sizeof(DataType) * attrCount); // Allocate memory for data types
+    if ((*tableSchema).dataTypes == NULL)
+    {                                                              // Check for error
+        free((*tableSchema).attrNames);                            // Free the attribute names
+        free(tableSchema);                                         // Free the schema
+        unpinPage(&(*tableInfo).dataPool, &metaPage); // Unpin the page
+        return abortOpen(tableInfo, firstHandle);                  // Return memory allocation error
+    }
+
+    (*tableSchema).typeLength = (int *)malloc(sizeof(int) * attrCount); // Allocate memory for type lengths
+    if ((*tableSchema).typeLength == NULL)
+    {                                                              // Check for error
+        free((*tableSchema).dataTypes);                            // Free the data types
+        free((*tableSchema).attrNames);                            // Free the attribute names
+        free(tableSchema);                                         // Free the schema
+        unpinPage(&(*tableInfo).dataPool, &metaPage); // Unpin the page
+        return abortOpen(tableInfo, firstHandle);                  // Return memory allocation error
+    }
+
+    i = 0;
+    while (i < attrCount)
+    {                                                                       // Loop through the attributes
+        (*tableSchema).attrNames[i] = (char *)malloc(ATTR_NAME_MAX_LENGTH); // Allocate memory for each attribute name
+        if ((*tableSchema).attrNames[i] == NULL)
+        { // Check for error
+            // Free previously allocated memory
+            int j = 0;
+            while (j < i)
+            {                                      // Loop to free previously allocated memory
+                free((*tableSchema).attrNames[j]); // Free the attribute name
+                j += 1;
+            }
+            free((*tableSchema).typeLength);                           // Free the type length
+            free((*tableSchema).dataTypes);                            // Free the data types
+            free((*tableSchema).attrNames);                            // Free the attribute names
+            free(tableSchema);                                         // Free the schema
+            unpinPage(&(*tableInfo).dataPool, &metaPage); // Unpin the page
+            return abortOpen(tableInfo, firstHandle);                  // Return memory allocation error
+        }
+        i += 1;
+    }
+
+    // Read attribute details
+    i = 0;
+    while (i < (*tableSchema).numAttr)
+    {                                                                            // Loop through the attributes
+        strncpy((*tableSchema).attrNames[i], pageContent, ATTR_NAME_MAX_LENGTH); // Copy the attribute name from the page content
+        pageContent += ATTR_NAME_MAX_LENGTH;                                     // Increment the page content pointer
+
+        (*tableSchema).dataTypes[i] = *(int *)pageContent; // Read the data type from the page content
+        pageContent += sizeof(int);                        // Increment the page content pointer
+
+        (*tableSchema).typeLength[i] = *(int *)pageContent; // Read the type length from the page content
+        pageContent += sizeof(int);                         // Increment the page content pointer
+
+        i += 1;
+    }
+
+    (*rel).schema = tableSchema;            // Set the schema of the relation
+    setAttributeOffsets(tableSchema);       // Offsets of the attributes in a record
+    setRecordLayout(tableInfo, tableSchema); // Size of the longest encoded record
+    if (firstHandle)
+    {                                                                         // The zone map starts out knowing nothing
+        (*tableInfo).zoneAttrs = attrCount;                                   // Bounds for every attribute
+        (*tableInfo).zoneFirstNew = getPoolNumPages(&(*tableInfo).dataPool);  // Pages appended from here on are empty
+    }
+
+    result = unpinPage(&(*tableInfo).dataPool, &metaPage); // Unpin the page
+    if (result == RC_OK)
+    {                                                                       // Only force a page that was unpinned
+        result = forcePage(&(*tableInfo).dataPool, &metaPage); // Force the page to disk
+    }
+    if (result != RC_OK)
+    {                                  // Check for error
+        if (firstHandle)
+        {                              // Undo the setup of a table that never opened
+            releaseTable(tableInfo);   // Release the pool and the entry
+        }
+        return result; // Return the error code
+    }
+
+    if (firstHandle)
+    {                                     // Register the table for later handles
+        (*tableInfo).next = openTables;   // Link in front of the registry
+        openTables = tableInfo;           // Make the entry the new head
+    }
+    (*tableInfo).refCount += 1; // Count this handle
+
+    (*rel).mgmtData = tableInfo; // Set the management data of the relation
+    (*rel).name = name;          // Set the name of the relation
+
+    return RC_OK; // Return RC_OK for success
+}
+
+/**
+ * @details : Closes a table that was previously opened. The buffer pool of the table
+ *            is shut down and the table leaves the registry once its last handle is
+ *            closed.
+ *
+ * @param rel : Pointer to the RM_TableData structure of the table to be closed
+ *
+ * @return RC_OK on successful closure of the table
+ */
+extern RC closeTable(RM_TableData *rel)
+{
+    if (rel == NULL || rel->mgmtData == NULL)
+    {                                // Check for a handle that is not open
+        return RC_INVALID_PARAMETER; // Return error if invalid parameters
+    }
+
+    TableInfo *mgr = rel->mgmtData; // Get the TableInfo struct from the RM_TableData
+    rel->mgmtData = NULL;           // Detach the handle from the shared entry
+
+    mgr->refCount -= 1; // This handle no longer uses the table
+    if (mgr->refCount > 0)
+    {                 // Other handles still use the table and its pool
+        return RC_OK; // Keep the entry registered
+    }
+
+    return releaseTable(mgr); // Shut down the pool and drop the entry
+}
+
+/**
+ * @details : Deletes a table with the specified name by removing its underlying
+ *            page file from the storage.
+ *
+ * @param name : Name of the table to be deleted
+ *
+ * @return RC_OK if the table is successfully deleted
+ */
+extern RC deleteTable(char *name)
+{
+    if (name == NULL)
+    {                                // Check if the table name is NULL
+        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if name is NULL
+    }
+
+    RC result; // Variable to store the result of the destroyPageFile function
+
+    result = destroyPageFile(name); // Destroy the page file associated with the table name
+    if (result != RC_OK)
+    {                  // Check if destroying the page file was successful
+        return result; // Return the error code if destroying the page file failed
+    }
+
+    return RC_OK; // Return RC_OK to indicate success
+}
+
+/**
+ * @details : Returns the number of records (tuples) currently stored in the table.
+ *
+ * @param rel : Pointer to the RM_TableData structure of the table
+ *
+ * @return The number of tuples in the table
+ */
+extern int getNumTuples(RM_TableData *rel)
+{
+    if (rel == NULL)
+    {              // Check if the table relation is NULL
+        return -1; // Return -1 if the relation is NULL
+    }
+
+    TableInfo *mgr = (*rel).mgmtData; // Get the table management data from the relation
+    return (*mgr).tupleCount;         // Return the number of tuples from the table management data
+}
+
+/**
+ * @details : Inserts a new record into the table. The record is encoded into the
+ *            compact page format, and the free-space map names the first page with
+ *            room for it; the function stores it there and marks the page as full in
+ *            the map if it cannot take another record of the longest size.
+ *
+ * @param rel : Pointer to the RM_TableData structure of the target table
+ * @param record : Pointer to the Record structure containing the data to be inserted
+ *
+ * @return RC_OK on successful insertion
+ */
+extern RC insertRecord(RM_TableData *rel, Record *record)
+{
+    if (record == NULL)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if parameters are invalid
+    }
+
+    return insertRecords(rel, &record, 1, NULL); // A batch of one record
+}
+
+/**
+ * @details : Inserts a batch of records into the table. Pages are filled in order: a
+ *            page stays pinned while records go onto it and is marked dirty, entered
+ *            in the free-space map and unpinned once, when it is full or the batch
+ *            ends. The tuple count is updated once for the whole batch.
+ *
+ * @param rel : Pointer to the RM_TableData structure of the target table
+ * @param records : Records to insert; the id of each is set to its new RID
+ * @param numRecords : Number of records in the batch
+ * @param ids : Optional array receiving the RIDs in batch order, may be NULL
+ *
+ * @return RC_OK on successful insertion; on an error the records before the failing
+ *         one stay inserted
+ */
+extern RC insertRecords(RM_TableData *rel, Record **records, int numRecords, RID *ids)
+{
+    if (rel == NULL || (*rel).mgmtData == NULL || records == NULL || numRecords < 0)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if parameters are invalid
+    }
+
+    TableInfo *mgr = (*rel).mgmtData; // Get the table management data
+    BM_PageHandle page;               // Page the batch is stored on
+    int pageNum = -1;                 // Page pinned for the batch, -1 while none is
+    int inserted = 0;                 // Records stored so far
+    RC result = RC_OK;                // Variable to store the result code
+
+    if (!recordsFitPage(mgr))
+    {                           // The record does not fit on a page
+        return RC_INSERT_ERROR; // Return RC_INSERT_ERROR
+    }
+
+    char *scratch = (char *)malloc(2 * (*mgr).pageSize); // Encoding page, then compaction page, of this call
+    if (scratch == NULL)
+    {                                      // Check if allocation failed
+        return RC_MEMORY_ALLOCATION_ERROR; // Return memory allocation error
+    }
+    char *encoded = scratch + FORWARD_SIZE - 1; // Leave room for a moved record's RID
+    *encoded = RECORD_PLAIN;                    // Every new record is a plain record
+
+    while (inserted < numRecords && result == RC_OK)
+    {                                                                                     // Store the records in batch order
+        Record *record = records[inserted];                                               // Next record of the batch
+        int length = 1 + encodeRecord((*rel).schema, (*record).data, encoded + 1);       // Encode the attributes
+
+        if (pageNum != -1 && !pageHasRoom(mgr, page.data, length))
+        {                                                                    // The pinned page is full
+            result = markDirty(&(*mgr).dataPool, &page);          // Mark the page as dirty
+            if (result == RC_OK)
+            {                                                                // Only update the map for a stored change
+                result = updatePageRoom(mgr, pageNum, page.data); // Keep later inserts off the full page
+            }
+            RC unpinResult = unpinPage(&(*mgr).dataPool, &page);  // Unpin the page
+            result = (result != RC_OK) ? result : unpinResult;               // Keep the first error
+            (*mgr).freePageIndex = pageNum + 1;                              // No page up to this one has room
+            pageNum = -1;                                                    // No page pinned any more
+        }
+
+        // Let the free-space map pick the page, skipping full pages without reading them
+        while (pageNum == -1 && result == RC_OK)
+        {                                                                   // Loop until a page with room is pinned
+            result = findPageWithRoom(mgr, (*mgr).freePageIndex, &pageNum); // Look up a page with room
+            if (result == RC_OK && pageNum == -1)
+            {                                                                   // Every page of the file is full
+                result = allocateDataPage(mgr, &pageNum);                      // Add a page
+            }
+            if (result == RC_OK)
+            {                                                                   // Pin the page the map named
+                result = pinPage(&(*mgr).dataPool, &page, pageNum); // Pin the page
+            }
+            if (result != RC_OK)
+            {                 // Check if the lookup or the pin failed
+                pageNum = -1; // No page pinned
+                break;        // Report the error
+            }
+
+            if (!pageHasRoom(mgr, page.data, length))
+            {                                                           // The map was out of date
+                result = unpinPage(&(*mgr).dataPool, &page); // Unpin the page
+                if (result == RC_OK)
+                {                                              // Only update the map after a clean unpin
+                    result = setPageFull(mgr, pageNum, true);  // Mark the page as full and look again
+                }
+                pageNum = -1; // No page pinned
+            }
+        }
+
+        if (result == RC_OK)
+        {                                                                                // Store the record on the pinned page
+            (*record).id.page = pageNum;                                                 // Page of the new record
+            (*record).id.slot = placeRecord(mgr, page.data, -1, encoded, length, scratch + (*mgr).pageSize); // Slot of the new record
+            (*mgr).writeCount += 1;                                                      // Scans refilter the page
+            widenPageZone(mgr, (*rel).schema, pageNum, (*record).data, FALSE);          // The page's bounds cover it
+            if (ids != NULL)
+            {                                // Report the RID in batch order
+                ids[inserted] = (*record).id; // Copy the RID
+            }
+            inserted += 1; // One more record stored
+        }
+    }
+
+    if (pageNum != -1)
+    {                                                                    // Release the last page of the batch
+        RC dirtyResult = markDirty(&(*mgr).dataPool, &page);  // Mark the page as dirty
+        if (dirtyResult == RC_OK)
+        {                                                                     // Only update the map for a stored change
+            dirtyResult = updatePageRoom(mgr, pageNum, page.data); // Keep later inserts off a full page
+        }
+        RC unpinResult = unpinPage(&(*mgr).dataPool, &page); // Unpin the page
+        result = (result != RC_OK) ? result : ((dirtyResult != RC_OK) ? dirtyResult : unpinResult); // Keep the first error
+        (*mgr).freePageIndex = pageNum; // No page before this one has room
+    }
+
+    (*mgr).tupleCount += inserted; // Count the batch once
+    free(scratch);                 // Free the scratch pages
+
+    return result; // Return RC_OK or the first error
+}
+
+/**
+ * @details : Converts the text of a CSV field into a value of the attribute's type.
+ *            The whole field must be the value: integers are read with strtol and
+ *            must fit an int, floats with strtof and must not overflow, booleans
+ *            are true or false, and strings are taken as they are.
+ *
+ * @param text : Field text, terminated
+ * @param dataType : Type of the attribute the field belongs to
+ * @param value : Set to the value; a string value points into text
+ *
+ * @return RC_OK on success, or RC_RM_BAD_CSV_LINE for a malformed field
+ */
+static RC parseCSVField(char *text, DataType dataType, Value *value)
+{
+    char *end = NULL; // First character after the number
+
+    (*value).dt = dataType;
+    errno = 0; // strtol and strtof only set it on failure
+    switch (dataType)
+    {
+    case DT_INT:
+    {
+        long number = strtol(text, &end, 10); // Read the integer
+        if (end == text || *end != '\0' || errno == ERANGE || number < INT_MIN || number > INT_MAX)
+        {                               // Not an int, or trailing text
+            return RC_RM_BAD_CSV_LINE; // Report the malformed field
+        }
+        (*value).v.intV = (int)number;
+        return RC_OK;
+    }
+    case DT_FLOAT:
+        (*value).v.floatV = strtof(text, &end); // Read the float
+        if (end == text || *end != '\0' || (errno == ERANGE && isinf((*value).v.floatV)))
+        {                               // Not a float, trailing text, or out of range
+            return RC_RM_BAD_CSV_LINE; // Report the malformed field
+        }
+        return RC_OK;
+    case DT_BOOL:
+        if (strcmp(text, "true") != 0 && strcmp(text, "false") != 0)
+        {                               // Neither of the two values
+            return RC_RM_BAD_CSV_LINE; // Report the malformed field
+        }
+        (*value).v.boolV = (text[0] == 't');
+        return RC_OK;
+    default:
+        (*value).v.stringV = text; // setAttr copies it
+        return RC_OK;
+    }
+}
+
+/**
+ * @details : Loads the rows of a CSV file into the table. Every line holds one value
+ *            per attribute in schema order, separated by commas; fields cannot contain
+ *            commas or line breaks and there is no header line. Values are converted
+ *            with parseCSVField and setAttr and inserted in batches of CSV_BATCH_SIZE
+ *            records through insertRecords.
+ *
+ * @param rel : Pointer to the RM_TableData structure of the target table
+ * @param fileName : Path of the CSV file
+ * @param numLoaded : Optional, set to the number of rows inserted
+ *
+ * @return RC_OK on success, RC_FILE_NOT_FOUND if the file cannot be opened, or
+ *         RC_RM_BAD_CSV_LINE for a line with the wrong number of fields or a
+ *         value that does not parse as its attribute's type
+ */
+extern RC loadTableFromCSV(RM_TableData *rel, char *fileName, int *numLoaded)
+{
+    if (rel == NULL || (*rel).mgmtData == NULL || fileName == NULL)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if parameters are invalid
+    }
+
+    Schema *schema = (*rel).schema;              // Schema of the rows
+    Record *batch[CSV_BATCH_SIZE];               // Records of the current batch
+    int batchSize = 0;                           // Rows waiting in the batch
+    int loaded = 0;                              // Rows inserted so far
+    char *line = NULL;                           // Line buffer, grown by getline
+    size_t lineCapacity = 0;                     // Capacity of the line buffer
+    char *field = NULL;                          // Copy of the current field, terminated
+    int i;                                       // Loop counter
+    RC result = RC_OK;                           // Variable to store the result code
+
+    FILE *csv = fopen(fileName, "r"); // Open the CSV file
+    if (csv == NULL)
+    {                             // Check if the file could be opened
+        return RC_FILE_NOT_FOUND; // Return RC_FILE_NOT_FOUND
+    }
+
+    for (i = 0; i < CSV_BATCH_SIZE && result == RC_OK; i += 1)
+    {                                          // Create the records of the batch once
+        result = createRecord(&batch[i], schema); // Create a record
+        if (result != RC_OK)
+        {                   // Check if creating failed
+            batch[i] = NULL; // Mark the slot as unused
+        }
+    }
+    for (; i < CSV_BATCH_SIZE; i += 1)
+    {                    // Records after a failed one were never created
+        batch[i] = NULL; // Mark the slot as unused
+    }
+
+    while (result == RC_OK && getline(&line, &lineCapacity, csv) != -1)
+    {                                        // Read the file line by line
+        line[strcspn(line, "\r\n")] = '\0'; // Cut the line break
+        if (line[0] == '\0')
+        {             // Skip empty lines
+            continue; // Read the next line
+        }
+
+        char *fieldStart = line;                          // Start of the current field
+        field = (char *)realloc(field, strlen(line) + 1); // Room for the longest field
+        if (field == NULL)
+        {                                        // Check if memory allocation failed
+            result = RC_MEMORY_ALLOCATION_ERROR; // Report the allocation failure
+            break;                               // Stop loading
+        }
+
+        for (i = 0; i < (*schema).numAttr && result == RC_OK; i += 1)
+        {                                                  // Convert every field of the line
+            if (fieldStart == NULL)
+            {                                 // The line has too few fields
+                result = RC_RM_BAD_CSV_LINE;  // Report the malformed line
+                break;                        // Stop converting
+            }
+
+            char *fieldEnd = strchr(fieldStart, ',');         // End of the field
+            size_t fieldLength = (fieldEnd != NULL) ? (size_t)(fieldEnd - fieldStart) : strlen(fieldStart); // Field length
+            memcpy(field, fieldStart, fieldLength); // Copy the field text
+            field[fieldLength] = '\0';              // Terminate the field
+
+            Value value;                                               // Converted field
+            result = parseCSVField(field, (*schema).dataTypes[i], &value); // Convert the field
+            if (result == RC_OK)
+            {                                                          // Store it in the record
+                result = setAttr(batch[batchSize], schema, i, &value);
+            }
+
+            fieldStart = (fieldEnd != NULL) ? fieldEnd + 1 : NULL; // Move to the next field
+        }
+        if (result == RC_OK && fieldStart != NULL)
+        {                                // The line has too many fields
+            result = RC_RM_BAD_CSV_LINE; // Report the malformed line
+        }
+
+        if (result == RC_OK)
+        {                   // The row is complete
+            batchSize += 1; // Keep it in the batch
+        }
+        if (result == RC_OK && batchSize == CSV_BATCH_SIZE)
+        {                                                         // Insert a full batch
+            result = insertRecords(rel, batch, batchSize, NULL); // Insert the batch
+            loaded += (result == RC_OK) ? batchSize : 0;         // Count the rows
+            batchSize = 0;                                        // Start a new batch
+        }
+    }
+
+    if (result == RC_OK && batchSize > 0)
+    {                                                         // Insert the last, partial batch
+        result = insertRecords(rel, batch, batchSize, NULL); // Insert the batch
+        loaded += (result == RC_OK) ? batchSize : 0;         // Count the rows
+    }
+
+    for (i = 0; i < CSV_BATCH_SIZE; i += 1)
+    {                         // Free the records of the batch
+        if (batch[i] != NULL)
+        {                          // Skip records that were never created
+            freeRecord(batch[i]); // Free the record
+        }
+    }
+    free(field); // Free the field buffer
+    free(line);  // Free the line buffer
+    fclose(csv); // Close the CSV file
+
+    if (numLoaded != NULL)
+    {                        // Report the number of rows inserted
+        *numLoaded = loaded; // Set the count
+    }
+
+    return result; // Return RC_OK or the first error
+}
+
+/**
+ * @details : Deletes a record from the table by freeing its slot directory entry. A
+ *            record that was moved by an update is removed from its new page as well.
+ *            The function also updates the free page index and the free-space map so
+ *            the next insertion can reuse the room.
+ *
+ * @param rel : Pointer to the RM_TableData structure of the table
+ * @param id : The RID (Record ID) of the record to be deleted
+ *
+ * @return RC_OK on successful deletion, or RC_RM_NO_TUPLE_WITH_GIVEN_RID if no record exists
+ */
+extern RC deleteRecord(RM_TableData *rel, RID id)
+{
+    if (rel == NULL)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if rel is NULL
+    }
+
+    TableInfo *mgr = (*rel).mgmtData; // Get the table management data
+    BM_PageHandle page;               // Home page of the record
+    RC result;                        // Variable to store the result code
+
+    if (isFsmPage(mgr, id.page) || id.page < FIRST_DATA_PAGE)
+    {                                         // Only data pages hold records
+        return RC_RM_NO_TUPLE_WITH_GIVEN_RID; // Report the record as missing
+    }
+
+    result = pinPage(&(*mgr).dataPool, &page, id.page); // Pin the page
+    if (result != RC_OK)
+    {                  // Check if pinning failed
+        return result; // Return the error code
+    }
+
+    char *data = page.data;      // Get the page data
+    SlotEntry *entry = usedSlot(data, id.slot); // Directory entry of the record
+
+    if (entry == NULL || data[(*entry).offset] == RECORD_MOVED)
+    {                                                  // Check if the RID names a record
+        unpinPage(&(*mgr).dataPool, &page); // Unpin the page
+        return RC_RM_NO_TUPLE_WITH_GIVEN_RID;          // Return RC_RM_NO_TUPLE_WITH_GIVEN_RID
+    }
+
+    if (data[(*entry).offset] == RECORD_FORWARD)
+    {                                                                      // The record lives on another page
+        RID target;                                                        // Where the stub points
+        memcpy(&target, data + (*entry).offset + 1, sizeof(RID));          // Read the target RID
+        result = dropMovedRecord(mgr, target);                             // Remove the moved record
+        if (result != RC_OK)
+        {                                                  // Check if the removal failed
+            unpinPage(&(*mgr).dataPool, &page); // Unpin the page
+            return result;                                 // Return the error code
+        }
+    }
+
+    if (id.page < (*mgr).freePageIndex)
+    {                                   // Inserts must not skip the page that gains room
+        (*mgr).freePageIndex = id.page; // Update free page index for optimization
+    }
+
+    removeRecord(data, id.slot, true); // Free the slot
+    (*mgr).tupleCount -= 1;            // Decrement the tuple count
+    (*mgr).writeCount += 1;            // Scans refilter the page
+    bool empty = ((DataPageHeader *)data)->liveCount == 0; // Whether the page lost its last record
+
+    result = markDirty(&(*mgr).dataPool, &page); // Mark the page as dirty
+    if (result == RC_OK)
+    {                                                 // Only update the map for a stored change
+        result = updatePageRoom(mgr, id.page, data);  // The page has room again
+    }
+    RC unpinResult = unpinPage(&(*mgr).dataPool, &page); // Unpin the page
+
+    result = (result != RC_OK) ? result : unpinResult; // Keep the first error
+    if (result == RC_OK && empty)
+    {                                             // Hand the empty page back to the file
+        result = releaseEmptyPage(mgr, id.page); // Release the page
+    }
+    return result; // Return the first error code
+}
+
+/**
+ * @details : Updates an existing record in the table with new data. The function
+ *            locates the record using its RID and replaces its content. A record that
+ *            no longer fits on its home page is moved to another page and its slot
+ *            turns into a forwarding stub, so the RID stays valid.
+ *
+ * @param rel : Pointer to the RM_TableData structure of the table
+ * @param record : Pointer to the Record structure containing the updated data
+ *
+ * @return RC_OK on successful update, or RC_RM_NO_TUPLE_WITH_GIVEN_RID if no record exists
+ */
+extern RC updateRecord(RM_TableData *rel, Record *record)
+{
+    if (rel == NULL || record == NULL)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if parameters are invalid
+    }
+
+    TableInfo *mgr = (*rel).mgmtData; // Get the table management data
+    BM_PageHandle page;               // Home page of the record
+    RID rid = (*record).id;           // Get the record ID
+    RC result;                        // Variable to store the result code
+
+    if (!recordsFitPage(mgr))
+    {                           // The record does not fit on a page
+        return RC_INSERT_ERROR; // Return RC_INSERT_ERROR
+    }
+
+    if (isFsmPage(mgr, rid.page) || rid.page < FIRST_DATA_PAGE)
+    {                                         // Only data pages hold records
+        return RC_RM_NO_TUPLE_WITH_GIVEN_RID; // Report the record as missing
+    }
+
+    result = pinPage(&(*mgr).dataPool, &page, rid.page); // Pin the page
+    if (result != RC_OK)
+    {                  // Check if pinning failed
+        return result; // Return the error code
+    }
+
+    char *data = page.data;       // Get the page data
+    SlotEntry *entry = usedSlot(data, rid.slot); // Directory entry of the record
+
+    if (entry == NULL || data[(*entry).offset] == RECORD_MOVED)
+    {                                                  // Only a stored record can be updated
+        unpinPage(&(*mgr).dataPool, &page); // Unpin the page
+        return RC_RM_NO_TUPLE_WITH_GIVEN_RID;          // Return RC_RM_NO_TUPLE_WITH_GIVEN_RID
+    }
+
+    char *scratch = (char *)malloc(2 * (*mgr).pageSize); // Encoding page, then compaction page, of this call
+    if (scratch == NULL)
+    {                                      // Check if allocation failed
+        unpinPage(&(*mgr).dataPool, &page); // Unpin the page
+        return RC_MEMORY_ALLOCATION_ERROR; // Return memory allocation error
+    }
+    char *compact = scratch + (*mgr).pageSize; // Compaction page
+
+    // Encode behind the room a moved record needs for its home RID
+    char *moved = scratch;                                                       // Moved form: tag, home RID, attributes
+    char *encoded = moved + FORWARD_SIZE - 1;                                    // Plain form: tag, attributes
+    int length = 1 + encodeRecord((*rel).schema, (*record).data, encoded + 1); // Encode the attributes
+    *encoded = RECORD_PLAIN;                                                     // Tag the plain form
+    int storedPage = rid.page;                                                   // Page the new version ends up on
+    (*mgr).writeCount += 1;                                                      // Scans refilter the pages written
+
+    if (data[(*entry).offset] == RECORD_PLAIN && length <= (*entry).length)
+    {                                                // The new version fits where the old one was
+        memcpy(data + (*entry).offset, encoded, length); // Overwrite the record in place
+    }
+    else
+    {                                                    // The record changes its place
+        SlotEntry old = *entry;                          // Kept to undo the removal
+        RID oldTarget = {-1, -1};                        // Moved copy to drop once the new one is stored
+        if (data[old.offset] == RECORD_FORWARD)
+        {                                                // The record lives on another page
+            memcpy(&oldTarget, data + old.offset + 1, sizeof(RID)); // Read the target RID
+        }
+
+        removeRecord(data, rid.slot, false); // Free the slot but keep its number
+        if (pageHasRoom(mgr, data, length))
+        {                                                      // The home page still takes the record
+            placeRecord(mgr, data, rid.slot, encoded, length, compact); // Store it under its RID
+        }
+        else
+        {                                                           // Move the record and leave a stub
+            RID target;                                             // Where the record moves to
+            *moved = RECORD_MOVED;                                  // Tag the moved form
+            memcpy(moved + 1, &rid, sizeof(RID));                   // Remember the home RID
+            result = storeMovedRecord(mgr, rid.page, moved, length + FORWARD_SIZE - 1, &target, compact); // Store it elsewhere
+
+            if (result == RC_OK)
+            {                                                         // Point the home slot at the new place
+                char stub[FORWARD_SIZE];                              // Forwarding stub for the home slot
+                stub[0] = RECORD_FORWARD;                             // Tag the stub
+                memcpy(stub + 1, &target, sizeof(RID));               // Point it at the moved record
+                placeRecord(mgr, data, rid.slot, stub, FORWARD_SIZE, compact); // Freed bytes always hold a stub
+                storedPage = target.page;                             // The record is stored there now
+            }
+            else
+            {                                                     // Nothing was moved, restore the old record
+                DataPageHeader *header = (DataPageHeader *)data;  // Header of the home page
+                *entry = old;                                     // Its bytes are still in place
+                (*header).usedBytes += old.length;                // Count them again
+                (*header).liveCount += 1;                         // Count the entry again
+                setSlotUsed(data, rid.slot, true);                // Mark it used again
+            }
+        }
+
+        if (result == RC_OK && oldTarget.page != -1)
+        {                                          // The previous moved copy is out of date
+            result = dropMovedRecord(mgr, oldTarget); // Remove it
+        }
+    }
+
+    widenPageZone(mgr, (*rel).schema, storedPage, (*record).data, FALSE); // Wider bounds than needed are still correct
+
+    RC dirtyResult = markDirty(&(*mgr).dataPool, &page); // Mark the page as dirty
+    if (result == RC_OK)
+    {                          // Keep the first error
+        result = dirtyResult;  // Report a failed markDirty
+    }
+    if (result == RC_OK)
+    {                                                // Only update the map for a stored change
+        result = updatePageRoom(mgr, rid.page, data); // The page may have gained or lost room
+    }
+    RC unpinResult = unpinPage(&(*mgr).dataPool, &page); // Unpin the page
+    free(scratch);                                       // Free the scratch pages
+
+    return (result != RC_OK) ? result : unpinResult; // Return the first error code
+}
+
+/**
+ * @details : Decodes a record from its home page, which the caller holds pinned. The
+ *            function checks the page's slot directory before decoding the record data,
+ *            and follows the forwarding stub of a record that was moved by an update.
+ *
+ * @param mgr : Table the record belongs to
+ * @param schema : Schema of the table
+ * @param data : Content of the record's home page
+ * @param id : The RID (Record ID) of the record to be retrieved
+ * @param record : Pointer to the Record structure where the retrieved data will be stored
+ *
+ * @return RC_OK on successful retrieval, or RC_RM_NO_TUPLE_WITH_GIVEN_RID if no record exists
+ */
+static RC readRecord(TableInfo *mgr, Schema *schema, char *data, RID id, Record *record)
+{
+    RC result = RC_OK; // Variable to store the result code
+
+    if (isFsmPage(mgr, id.page) || id.page < FIRST_DATA_PAGE)
+    {                                         // Only data pages hold records
+        return RC_RM_NO_TUPLE_WITH_GIVEN_RID; // Report the record as missing
+    }
+
+    SlotEntry *entry = usedSlot(data, id.slot); // Directory entry of the record
+    if (entry == NULL || data[(*entry).offset] == RECORD_MOVED)
+    {                                         // Check if slot is occupied
+        return RC_RM_NO_TUPLE_WITH_GIVEN_RID; // Return RC_RM_NO_TUPLE_WITH_GIVEN_RID
+    }
+
+    if (data[(*entry).offset] == RECORD_FORWARD)
+    {                                                                  // Follow the stub to the moved record
+        BM_PageHandle movedPage;                                       // Handle of the page holding the record
+        RID target;                                                    // Where the stub points
+        memcpy(&target, data + (*entry).offset + 1, sizeof(RID));      // Read the target RID
+
+        result = pinPage(&(*mgr).dataPool, &movedPage, target.page);   // Pin the target page
+        if (result == RC_OK)
+        {                                                              // Decode the moved record
+            SlotEntry *movedEntry = usedSlot(movedPage.data, target.slot); // Entry of the moved record
+            if (movedEntry != NULL)
+            {                                                          // Skip the tag and the home RID
+                decodeRecord(schema, movedPage.data + (*movedEntry).offset + FORWARD_SIZE, (*record).data);
+            }
+            else
+            {                                                          // The stub points at nothing
+                result = RC_RM_NO_TUPLE_WITH_GIVEN_RID;                // Report the record as missing
+            }
+            RC unpinResult = unpinPage(&(*mgr).dataPool, &movedPage);  // Unpin the target page
+            result = (result != RC_OK) ? result : unpinResult;         // Keep the first error
+        }
+    }
+    else
+    {                                                               // The record is on its home page
+        decodeRecord(schema, data + (*entry).offset + 1, (*record).data); // Decode past the tag
+    }
+    (*record).id = id; // Set the record ID
+
+    return result; // Return the first error code
+}
+
+/**
+ * @details : Retrieves a record from the table based on its RID. The function pins
+ *            the record's home page and decodes the record from it.
+ *
+ * @param rel : Pointer to the RM_TableData structure of the table
+ * @param id : The RID (Record ID) of the record to be retrieved
+ * @param record : Pointer to the Record structure where the retrieved data will be stored
+ *
+ * @return RC_OK on successful retrieval, or RC_RM_NO_TUPLE_WITH_GIVEN_RID if no record exists
+ */
+extern RC getRecord(RM_TableData *rel, RID id, Record *record)
+{
+    if (rel == NULL || record == NULL)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if parameters are invalid
+    }
+
+    TableInfo *mgr = (*rel).mgmtData; // Get the table management data
+    BM_PageHandle page;               // Home page of the record
+    RC result;                        // Variable to store the result code
+
+    result = pinPage(&(*mgr).dataPool, &page, id.page); // Pin the page
+    if (result != RC_OK)
+    {                  // Check if pinning failed
+        return result; // Return the error code
+    }
+
+    result = readRecord(mgr, (*rel).schema, page.data, id, record); // Decode the record
+
+    RC unpinResult = unpinPage(&(*mgr).dataPool, &page); // Unpin the page
+
+    return (result != RC_OK) ? result : unpinResult; // Return the first error code
+}
+
+/**
+ * @details : Orders RID entries by page and slot, for sorting a getRecords request.
+ *
+ * @param a : First entry
+ * @param b : Second entry
+ *
+ * @return A negative, zero or positive value as a sorts before, with or after b
+ */
+static int compareRidEntries(const void *a, const void *b)
+{
+    const RID *left = &((const RidEntry *)a)->id;  // RID of the first entry
+    const RID *right = &((const RidEntry *)b)->id; // RID of the second entry
+
+    if ((*left).page != (*right).page)
+    {                                                         // Pages decide first
+        return ((*left).page < (*right).page) ? -1 : 1;       // Lower page first
+    }
+    if ((*left).slot != (*right).slot)
+    {                                                         // Then the slot
+        return ((*left).slot < (*right).slot) ? -1 : 1;       // Lower slot first
+    }
+    return 0; // Same RID
+}
+
+/**
+ * @details : Retrieves many records by their RIDs. The RIDs are sorted by page, so
+ *            every page is pinned once for all the records wanted from it and the
+ *            pages are visited in file order, however the RIDs were ordered, e.g.
+ *            by an index. Records are still returned in the order of the RIDs.
+ *
+ * @param rel : Pointer to the RM_TableData structure of the table
+ * @param ids : RIDs of the records to retrieve
+ * @param numRecords : Number of RIDs
+ * @param records : Records receiving the data, records[i] for ids[i]
+ *
+ * @return RC_OK if every record was retrieved, or the first error met; records
+ *         after an error may be left unchanged
+ */
+extern RC getRecords(RM_TableData *rel, RID *ids, int numRecords, Record **records)
+{
+    if (rel == NULL || (*rel).mgmtData == NULL || ids == NULL || records == NULL || numRecords < 0)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if parameters are invalid
+    }
+
+    if (numRecords == 0)
+    {                 // Nothing to read
+        return RC_OK; // Return success
+    }
+
+    TableInfo *mgr = (*rel).mgmtData; // Get the table management data
+    BM_PageHandle page;               // Handle of the page being read
+    RC result = RC_OK;                // Variable to store the result code
+    int i = 0;                        // Position in the sorted RIDs
+
+    RidEntry *order = (RidEntry *)malloc(sizeof(RidEntry) * numRecords); // RIDs in page order
+    if (order == NULL)
+    {                                      // Check if allocation failed
+        return RC_MEMORY_ALLOCATION_ERROR; // Return memory allocation error
+    }
+    for (i = 0; i < numRecords; i += 1)
+    {                             // Remember where every RID came from
+        order[i].id = ids[i];     // RID to read
+        order[i].position = i;    // Record receiving it
+    }
+    qsort(order, numRecords, sizeof(RidEntry), compareRidEntries); // Group the RIDs by page
+
+    i = 0;
+    while (i < numRecords && result == RC_OK)
+    {                                                                  // One pass per page
+        int pageNum = order[i].id.page;                                // Page of this group
+        result = pinPage(&(*mgr).dataPool, &page, pageNum);            // Pin it once
+        if (result != RC_OK)
+        {          // Check if pinning failed
+            break; // Stop at the first error
+        }
+
+        for (; i < numRecords && order[i].id.page == pageNum && result == RC_OK; i += 1)
+        {                                                             // Every record wanted from the page
+            result = readRecord(mgr, (*rel).schema, page.data, order[i].id, records[order[i].position]);
+        }
+
+        RC unpinResult = unpinPage(&(*mgr).dataPool, &page); // Done with the page
+        result = (result != RC_OK) ? result : unpinResult;   // Keep the first error
+    }
+
+    free(order); // Free the sorted RIDs
+
+    return result; // Return the first error code
+}
+
+/**
+ * @details : Retrieves a record by its RID as a view into the page it is stored on,
+ *            without copying it out. The page stays pinned until the view is
+ *            released with releaseRecordView, so views should be held briefly.
+ *            Records moved away from their home page are followed through their
+ *            forwarding stub; the view keeps the page of the moved record pinned.
+ *
+ * @param rel : Pointer to the RM_TableData structure of the table
+ * @param id : RID of the record to retrieve
+ * @param view : View set to the record
+ *
+ * @return RC_OK on success, RC_RM_NO_TUPLE_WITH_GIVEN_RID if the slot is free
+ */
+extern RC getRecordView(RM_TableData *rel, RID id, RM_RecordView *view)
+{
+    if (rel == NULL || view == NULL)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if parameters are invalid
+    }
+
+    TableInfo *mgr = (*rel).mgmtData; // Get the table management data
+    BM_PageHandle page;               // Handle of the page the record is stored on
+    RC result;                        // Variable to store the result code
+
+    if (isFsmPage(mgr, id.page) || id.page < FIRST_DATA_PAGE)
+    {                                         // Only data pages hold records
+        return RC_RM_NO_TUPLE_WITH_GIVEN_RID; // Report the record as missing
+    }
+
+    result = pinPage(&(*mgr).dataPool, &page, id.page); // Pin the home page
+    if (result != RC_OK)
+    {                  // Check if pinning failed
+        return result; // Return the error code
+    }
+
+    SlotEntry *entry = usedSlot(page.data, id.slot); // Directory entry of the record
+    if (entry != NULL && page.data[(*entry).offset] == RECORD_FORWARD)
+    {                                                              // Follow the stub to the moved record
+        RID target;                                                // Where the stub points
+        memcpy(&target, page.data + (*entry).offset + 1, sizeof(RID)); // Read the target RID
+
+        result = unpinPage(&(*mgr).dataPool, &page); // The home page is not needed any more
+        if (result == RC_OK)
+        {                                                       // Pin the page holding the record
+            result = pinPage(&(*mgr).dataPool, &page, target.page);
+        }
+        if (result != RC_OK)
+        {                  // Check if moving to the target failed
+            return result; // Return the error code
+        }
+        entry = usedSlot(page.data, target.slot); // Entry of the moved record
+        if (entry != NULL && page.data[(*entry).offset] != RECORD_MOVED)
+        {                 // The stub points at something else
+            entry = NULL; // Report the record as missing
+        }
+    }
+    else if (entry != NULL && page.data[(*entry).offset] == RECORD_MOVED)
+    {                 // Moved records are reached through their home RID
+        entry = NULL; // Report the record as missing
+    }
+
+    if (entry == NULL)
+    {                                                // Check if slot is occupied
+        result = unpinPage(&(*mgr).dataPool, &page); // Unpin the page
+        return (result != RC_OK) ? result : RC_RM_NO_TUPLE_WITH_GIVEN_RID;
+    }
+
+    char *stored = page.data + (*entry).offset; // Encoded record
+    stored += (*stored == RECORD_MOVED) ? FORWARD_SIZE : 1; // Skip the tag and any home RID
+
+    (*view).id = id;                 // RID the record is known by
+    (*view).schema = (*rel).schema;  // Schema of the record
+    (*view).data = stored;           // Attributes in place on the page
+    (*view).pool = &(*mgr).dataPool; // The view holds the pin
+    (*view).pageNum = page.pageNum;  // Page to unpin on release
+
+    return RC_OK; // Return success
+}
+
+/**
+ * @details : Releases a record view, unpinning the page it holds. Views handed out
+ *            by nextView borrow the scan's pin and are left alone.
+ *
+ * @param view : View to release
+ *
+ * @return RC_OK on success, or the error of unpinning the page
+ */
+extern RC releaseRecordView(RM_RecordView *view)
+{
+    if (view == NULL)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if parameters are invalid
+    }
+
+    if ((*view).pool == NULL)
+    {                 // Nothing pinned by the view itself
+        return RC_OK; // Return success
+    }
+
+    BM_PageHandle page;             // Handle naming the pinned page
+    page.pageNum = (*view).pageNum; // Page the view holds
+    page.data = NULL;               // Not needed to unpin
+
+    RC result = unpinPage((BM_BufferPool *)(*view).pool, &page); // Release the pin
+    (*view).pool = NULL;                                         // The view is no longer valid
+    (*view).data = NULL;                                         // Nothing to read any more
+
+    return result; // Return the result of unpinning
+}
+
+/**
+ * @details : Marks the attributes an expression reads.
+ *
+ * @param expr : Expression to walk
+ * @param attrs : Flags indexed by attribute number, set for every attribute referenced
+ * @param numAttr : Number of attributes of the schema
+ */
+static void markExprAttributes(Expr *expr, bool *attrs, int numAttr)
+{
+    if (expr == NULL)
+    {           // Nothing to walk
+        return; // Return
+    }
+
+    if ((*expr).type == EXPR_ATTRREF)
+    {                                                                    // Attribute reference
+        if ((*expr).expr.attrRef >= 0 && (*expr).expr.attrRef < numAttr)
+        {                                         // Ignore references getAttr rejects
+            attrs[(*expr).expr.attrRef] = TRUE;   // The condition reads the attribute
+        }
+    }
+    else if ((*expr).type == EXPR_OP)
+    {                                                                    // Operator
+        Operator *op = (*expr).expr.op;                                  // The operator
+        int i;
+        for (i = 0; i < (*op).numArgs; i += 1)
+        {                                                                // Every argument of the operator
+            markExprAttributes((*op).args[i], attrs, numAttr);           // Mark what it reads
+        }
+    }
+}
+
+/**
+ * @details : Frees the projection of a scan: the projected schema, the arrays it was
+ *            created from and the attribute lists of the scan, along with the
+ *            optimized and compiled condition and its page filter.
+ *
+ * @param scanInfo : Scan whose projection is freed
+ */
+static void freeScanProjection(ScanInfo *scanInfo)
+{
+    if ((*scanInfo).projection != NULL)
+    {                                                 // The projected schema owns its arrays
+        free((*(*scanInfo).projection).attrNames);    // Names point into the table schema
+        free((*(*scanInfo).projection).dataTypes);    // Free the data types
+        free((*(*scanInfo).projection).typeLength);   // Free the type lengths
+        freeSchema((*scanInfo).projection);           // Free the schema
+        (*scanInfo).projection = NULL;                // No projection any more
+    }
+    free((*scanInfo).projAttrs);   // Free the projected attribute list
+    free((*scanInfo).wantedAttrs); // Free the decoded attribute flags
+    free((*scanInfo).condAttrs);   // Free the condition's attribute flags
+    freeCompiledExpr((*scanInfo).compiledCond); // Free the compiled condition
+    freePageFilter((*scanInfo).filter);         // Free the page filter
+    if ((*scanInfo).optimizedCond != NULL)
+    {                                           // The scan's own copy of the condition
+        freeExpr((*scanInfo).optimizedCond);    // Free the optimized condition
+    }
+    (*scanInfo).optimizedCond = NULL;
+    (*scanInfo).conditionExpr = NULL;
+    (*scanInfo).projAttrs = NULL;
+    (*scanInfo).wantedAttrs = NULL;
+    (*scanInfo).condAttrs = NULL;
+    (*scanInfo).compiledCond = NULL;
+    (*scanInfo).filter = NULL;
+}
+
+/**
+ * @details : Sets up the projection of a scan. The projected schema keeps the given
+ *            attributes in the given order; records returned by next follow it.
+ *
+ * @param scanInfo : Scan to set up
+ * @param schema : Schema of the table
+ * @param numAttrs : Number of projected attributes
+ * @param attrs : Table attribute of every projected attribute
+ *
+ * @return RC_OK on success, or RC_INVALID_PARAMETER for an attribute the table does not have
+ */
+static RC setScanProjection(ScanInfo *scanInfo, Schema *schema, int numAttrs, int *attrs)
+{
+    int i;
+
+    for (i = 0; i < numAttrs; i += 1)
+    {                                                  // Check the attribute list
+        if (attrs[i] < 0 || attrs[i] >= (*schema).numAttr)
+        {                                              // Unknown attribute
+            return RC_INVALID_PARAMETER;               // Reject the projection
+        }
+    }
+
+    char **names = (char **)malloc(sizeof(char *) * numAttrs);          // Names of the projected schema
+    DataType *types = (DataType *)malloc(sizeof(DataType) * numAttrs);  // Data types
+    int *lengths = (int *)malloc(sizeof(int) * numAttrs);               // Type lengths
+    (*scanInfo).projAttrs = (int *)malloc(sizeof(int) * numAttrs);      // Projected attribute list
+    (*scanInfo).wantedAttrs = (bool *)malloc(sizeof(bool) * (*schema).numAttr); // Decoded attributes
+    if (names == NULL || types == NULL || lengths == NULL || (*scanInfo).projAttrs == NULL || (*scanInfo).wantedAttrs == NULL)
+    {                                      // Check if allocation failed
+        free(names);                       // Free what was allocated
+        free(types);
+        free(lengths);
+        return RC_MEMORY_ALLOCATION_ERROR; // The caller frees the scan's lists
+    }
+
+    memcpy((*scanInfo).wantedAttrs, (*scanInfo).condAttrs, sizeof(bool) * (*schema).numAttr); // The condition's attributes
+    for (i = 0; i < numAttrs; i += 1)
+    {                                                       // Copy the layout of every projected attribute
+        names[i] = (*schema).attrNames[attrs[i]];           // Shared with the table schema
+        types[i] = (*schema).dataTypes[attrs[i]];           // Same data type
+        lengths[i] = (*schema).typeLength[attrs[i]];        // Same type length
+        (*scanInfo).projAttrs[i] = attrs[i];                // Remember the table attribute
+        (*scanInfo).wantedAttrs[attrs[i]] = TRUE;           // Decoded for the projection
+    }
+
+    (*scanInfo).projection = createSchema(numAttrs, names, types, lengths, 0, NULL); // The projected schema
+    if ((*scanInfo).projection == NULL)
+    {                                      // Check if allocation failed
+        free(names);                       // Free the arrays
+        free(types);
+        free(lengths);
+        return RC_MEMORY_ALLOCATION_ERROR; // The caller frees the scan's lists
+    }
+    if ((*schema).attrOffsets == NULL || (*(*scanInfo).projection).attrOffsets == NULL)
+    {                                      // next copies attributes by their offsets
+        return RC_MEMORY_ALLOCATION_ERROR; // The caller frees the projection
+    }
+
+    return RC_OK; // Return success
+}
+
+/**
+ * @details : Initiates a table scan with a specified condition. The function sets up
+ *            scan management data and initializes scan position to the beginning of the table.
+ *
+ * @param rel : Pointer to the RM_TableData structure of the table to be scanned
+ * @param scan : Pointer to the RM_ScanHandle structure to be populated
+ * @param cond : Expression condition for filtering records during the scan
+ *
+ * @return RC_OK on successful scan initialization, RC_SCAN_CONDITION_NOT_FOUND if condition is NULL,
+ *         or the type error of a condition that can never be evaluated
+ */
+extern RC startScan(RM_TableData *rel, RM_ScanHandle *scan, Expr *cond)
+{
+    return startProjectedScan(rel, scan, cond, 0, NULL); // Scan full records
+}
+
+/**
+ * @details : Compiles the condition of a scan. Conditions compileExpr cannot
+ *            compile, comparisons of operator results and conditions of too many
+ *            steps, are left to evalExpr and give no program. Type errors are
+ *            reported here, once, instead of being found on every record.
+ *
+ * @param cond : Condition of the scan
+ * @param schema : Schema of the table
+ * @param compiled : Set to the program, or to NULL if evalExpr evaluates the condition
+ *
+ * @return RC_OK on success, or the error of compiling the condition
+ */
+static RC compileScanCondition(Expr *cond, Schema *schema, CompiledExpr **compiled)
+{
+    RC result = compileExpr(cond, schema, compiled); // Compile it once for the scan
+    if (result != RC_OK)
+    {                     // No program
+        *compiled = NULL; // evalExpr evaluates the condition
+    }
+    return (result == RC_INVALID_PARAMETER) ? RC_OK : result; // Only a condition that is not compilable falls back
+}
+
+/**
+ * @details : Initiates a table scan that returns only some attributes of the matching
+ *            records. next then fills records of the projected schema, which holds
+ *            the given attributes in the given order (see getScanSchema), and only
+ *            the projected attributes and those the condition reads are decoded.
+ *            The condition still refers to attributes by their number in the table.
+ *            The scan evaluates a copy of the condition rewritten by optimizeExpr,
+ *            so the caller's expression is left as it is.
+ *
+ * @param rel : Pointer to the RM_TableData structure of the table to be scanned
+ * @param scan : Pointer to the RM_ScanHandle structure to be populated
+ * @param cond : Expression condition for filtering records during the scan
+ * @param numAttrs : Number of projected attributes, 0 to scan full records
+ * @param attrs : Table attribute of every projected attribute
+ *
+ * @return RC_OK on successful scan initialization, RC_SCAN_CONDITION_NOT_FOUND if condition is NULL,
+ *         RC_INVALID_PARAMETER for an attribute the table does not have, or the type
+ *         error of a condition that can never be evaluated
+ */
+extern RC startProjectedScan(RM_TableData *rel, RM_ScanHandle *scan, Expr *cond, int numAttrs, int *attrs)
+{
+    // Validate input parameters
+    if (rel == NULL || scan == NULL || numAttrs < 0 || (numAttrs > 0 && attrs == NULL))
+    {
+        return RC_INVALID_PARAMETER;
+    }
+
+    // Check if the condition expression is provided
+    if (cond == NULL)
+    {
+        return RC_SCAN_CONDITION_NOT_FOUND;
+    }
+
+    // The scan runs on the table's own state, so the table must be open
+    if (rel->mgmtData == NULL)
+    {
+        return RC_FILE_NOT_FOUND;
+    }
+
+    // Allocate memory for scan manager metadata
+    ScanInfo *scanManager = (ScanInfo *)malloc(sizeof(ScanInfo));
+    if (scanManager == NULL)
+    {
+        return RC_MEMORY_ALLOCATION_ERROR; // Handle memory allocation failure
+    }
+
+    // Initialize scan manager metadata
+    scanManager->recordID.page = FIRST_DATA_PAGE; // Start scanning from the first data page
+    scanManager->recordID.slot = 0;    // Start scanning from the first slot
+    scanManager->scanIndex = 0;        // No records scanned yet
+    scanManager->conditionExpr = cond; // Store the condition expression
+    scanManager->optimizedCond = NULL; // Until the condition is optimized below
+    scanManager->pagePinned = FALSE;   // No page pinned until the first call to next
+    scanManager->scanRecord = NULL;    // Only views and projections need it
+    scanManager->projection = NULL;    // Full records unless projected below
+    scanManager->projAttrs = NULL;
+    scanManager->wantedAttrs = NULL;
+    scanManager->batchAtEnd = FALSE;   // No batch returned yet
+    scanManager->compiledCond = NULL;  // Compiled below if the condition reads the record
+    scanManager->filter = NULL;        // Created along with the compiled condition
+    scanManager->arena = NULL;         // Until one is attached with setScanArena
+
+    // Rewrite the condition once, so that every record is tested with less work
+    if (optimizeExpr(cond, rel->schema, &scanManager->optimizedCond) == RC_OK)
+    {
+        scanManager->conditionExpr = scanManager->optimizedCond; // Evaluate the rewritten condition
+        cond = scanManager->optimizedCond;
+    }
+
+    // Find the attributes the condition reads
+    scanManager->condAttrs = (bool *)calloc(rel->schema->numAttr, sizeof(bool));
+    if (scanManager->condAttrs == NULL)
+    {
+        if (scanManager->optimizedCond != NULL)
+        {
+            freeExpr(scanManager->optimizedCond);
+        }
+        free(scanManager);
+        return RC_MEMORY_ALLOCATION_ERROR; // Handle memory allocation failure
+    }
+    markExprAttributes(cond, scanManager->condAttrs, rel->schema->numAttr);
+
+    // A condition that reads no attribute, like the TRUE of a full scan, is evaluated once
+    scanManager->constantMatch = -1;
+    if (memchr(scanManager->condAttrs, TRUE, sizeof(bool) * rel->schema->numAttr) == NULL)
+    {
+        Value *constant = NULL;
+        if (evalExpr(NULL, rel->schema, cond, &constant) == RC_OK && constant->dt == DT_BOOL)
+        {
+            scanManager->constantMatch = (constant->v.boolV == TRUE);
+        }
+        if (constant != NULL)
+        {
+            freeVal(constant);
+        }
+    }
+
+    // Any other condition is compiled once, falling back to evalExpr if it cannot be
+    if (scanManager->constantMatch == -1)
+    {
+        RC result = compileScanCondition(cond, rel->schema, &scanManager->compiledCond);
+        if (result != RC_OK)
+        {
+            freeScanProjection(scanManager); // Frees the condition's state
+            free(scanManager);
+            return result; // A condition that can never be evaluated
+        }
+    }
+    scanManager->filter = createPageFilter(scanManager->compiledCond, rel->schema,
+                                           ((TableInfo *)rel->mgmtData)->pageSize);
+
+    // Set up the projected schema
+    if (numAttrs > 0)
+    {
+        RC result = setScanProjection(scanManager, rel->schema, numAttrs, attrs);
+        if (result != RC_OK)
+        {
+            freeScanProjection(scanManager);
+            free(scanManager);
+            return result;
+        }
+    }
+
+    // Attach scan manager to the scan handle
+    scan->mgmtData = scanManager;
+
+    // Set the table to be scanned in the scan handle
+    scan->rel = rel;
+
+    return RC_OK; // Successfully initialized the scan
+}
+
+/**
+ * @details : Returns the schema of the records a scan returns: the projected schema
+ *            of a projected scan, or the table's schema. It belongs to the scan and
+ *            is freed by closeScan.
+ *
+ * @param scan : Pointer to the RM_ScanHandle structure of the scan
+ *
+ * @return The schema of the scan's records, or NULL for an invalid scan
+ */
+extern Schema *getScanSchema(RM_ScanHandle *scan)
+{
+    if (scan == NULL || (*scan).mgmtData == NULL)
+    {                // Check for scan handle
+        return NULL; // No schema
+    }
+
+    ScanInfo *scanInfo = (*scan).mgmtData; // Get the scan management data
+    return ((*scanInfo).projection != NULL) ? (*scanInfo).projection : (*(*scan).rel).schema;
+}
+
+/**
+ * @details : Attaches an arena to a scan. A condition the scan cannot compile is
+ *            then evaluated with values from the arena, which the scan releases
+ *            after every record instead of freeing each value; memory the caller
+ *            took from the arena before is left alone. The arena belongs to the
+ *            caller, must outlive the scan or be detached with NULL, and must not
+ *            be used by another thread while the scan runs.
+ *
+ * @param scan : Pointer to the RM_ScanHandle structure of the scan
+ * @param arena : Arena to use, or NULL to allocate with malloc again
+ *
+ * @return RC_OK on success, or RC_INVALID_PARAMETER for an invalid scan
+ */
+extern RC setScanArena(RM_ScanHandle *scan, Arena *arena)
+{
+    if (scan == NULL || (*scan).mgmtData == NULL)
+    {                                // Check for scan handle
+        return RC_INVALID_PARAMETER; // No scan to attach to
+    }
+
+    ScanInfo *scanInfo = (*scan).mgmtData; // Get the scan management data
+    (*scanInfo).arena = arena;             // Used from the next record on
+    return RC_OK;
+}
+
+/**
+ * @details : Creates the full record a scan evaluates its condition on when the
+ *            caller does not pass one, on first use.
+ *
+ * @param scanInfo : Scan needing the record
+ * @param schema : Schema of the table
+ *
+ * @return RC_OK on success, or the error of creating the record
+ */
+static RC ensureScanRecord(ScanInfo *scanInfo, Schema *schema)
+{
+    if ((*scanInfo).scanRecord != NULL)
+    {                 // Created before
+        return RC_OK; // Return success
+    }
+    return createRecord(&(*scanInfo).scanRecord, schema); // Allocate it once per scan
+}
+
+/**
+ * @details : Evaluates a condition that could not be compiled on a record. With an
+ *            arena, every value of the evaluation comes from it and all of them are
+ *            released at once when the result has been read; without one evalExpr
+ *            allocates and frees each value.
+ *
+ * @param record : Record the condition is evaluated on
+ * @param schema : Schema of the record
+ * @param cond : Condition to evaluate
+ * @param arena : Arena to evaluate in, or NULL
+ * @param matches : Set to whether the record meets the condition
+ *
+ * @return RC_OK on success, or the error of evaluating the condition
+ */
+static RC evalScanCondition(Record *record, Schema *schema, Expr *cond, Arena *arena, bool *matches)
+{
+    Value *evalResult = NULL; // Result of the condition
+    RC result;                // Result of the evaluation
+
+    if (arena == NULL)
+    {                                                         // Allocate with malloc
+        result = evalExpr(record, schema, cond, &evalResult); // Evaluate expression with the record
+        if (result == RC_OK && (*evalResult).dt != DT_BOOL)
+        {                                             // Only a boolean decides a match
+            result = RC_RM_EXPR_RESULT_IS_NOT_BOOLEAN;
+        }
+        if (result == RC_OK)
+        {                                               // The condition has a value
+            *matches = ((*evalResult).v.boolV == TRUE); // Whether the record qualifies
+        }
+        if (evalResult != NULL)
+        {
+            freeVal(evalResult); // Free the evaluation result
+        }
+        return result;
+    }
+
+    ArenaMark mark = arenaMark(arena);                                     // Everything after this belongs to the record
+    result = evalExprWithArena(record, schema, cond, &evalResult, arena);  // Evaluate expression with the record
+    if (result == RC_OK && (*evalResult).dt != DT_BOOL)
+    {                                             // Only a boolean decides a match
+        result = RC_RM_EXPR_RESULT_IS_NOT_BOOLEAN;
+    }
+    if (result == RC_OK)
+    {                                               // The condition has a value
+        *matches = ((*evalResult).v.boolV == TRUE); // Whether the record qualifies
+    }
+    arenaRelease(arena, mark); // Release the values in bulk
+    return result;
+}
+
+/**
+ * @details : Moves a scan to the first slot of the next data page, passing over
+ *            free-space map pages.
+ *
+ * @param relInfo : Table being scanned
+ * @param scanInfo : State of the scan
+ */
+static void advanceScanPage(TableInfo *relInfo, ScanInfo *scanInfo)
+{
+    (*scanInfo).recordID.slot = 0;  // Reset slot number
+    (*scanInfo).recordID.page += 1; // Increment the page number
+    if (isFsmPage(relInfo, (*scanInfo).recordID.page))
+    {                                   // Free-space map pages hold no records
+        (*scanInfo).recordID.page += 1; // Skip to the next data page
+    }
+}
+
+/**
+ * @details : Releases the page a scan holds pinned and moves the scan to the next
+ *            data page.
+ *
+ * @param relInfo : Table being scanned
+ * @param scanInfo : State of the scan
+ *
+ * @return RC_OK on success, or the error of unpinning the page
+ */
+static RC leaveScanPage(TableInfo *relInfo, ScanInfo *scanInfo)
+{
+    (*scanInfo).pagePinned = FALSE;                                      // The pin is released either way
+    RC result = unpinPage(&(*relInfo).dataPool, &(*scanInfo).pageInfo); // Unpin the page
+    advanceScanPage(relInfo, scanInfo);                                  // Move to the next data page
+    return result;                                                       // Return the result of the unpin
+}
+
+/**
+ * @details : Brings a scan to a data page it can visit slots on. The page the
+ *            scan is on stays pinned across calls until all of its slots have been
+ *            visited, so moving to the next record on the same page costs no
+ *            buffer pool lookup. Otherwise the next page is pinned, passing over
+ *            pages the zone map rules out. The page filter is run on the page if
+ *            it has not been, or if the page was written since it was.
+ *
+ * @param scan : Pointer to the RM_ScanHandle structure of the scan
+ *
+ * @return RC_OK with the page pinned, RC_RM_NO_MORE_TUPLES after the last page of
+ *         the file, or the error of the buffer pool
+ */
+static RC pinScanPage(RM_ScanHandle *scan)
+{
+    ScanInfo *scanInfo = (*scan).mgmtData;        // Get the scan management data
+    TableInfo *relInfo = (*(*scan).rel).mgmtData; // Get the relation management data
+    Schema *schema = (*(*scan).rel).schema;       // Get the schema
+    RC result;                                    // Result of buffer pool calls
+
+    int numPages = getPoolNumPages(&(*relInfo).dataPool); // The scan ends with the last page of the file
+
+    while (!(*scanInfo).pagePinned)
+    {                                                  // Pin each page only once
+        if ((*scanInfo).recordID.page >= numPages)
+        {                                // Every data page has been visited
+            return RC_RM_NO_MORE_TUPLES; // Report the end
+        }
+        if ((*scanInfo).compiledCond != NULL &&
+            !pageMayMatch(relInfo, (*scanInfo).compiledCond, schema, (*scanInfo).recordID.page))
+        {                                       // The zone map rules the page out
+            advanceScanPage(relInfo, scanInfo); // Skip it without reading it
+            continue;                           // Look at the next page
+        }
+        result = pinPage(&(*relInfo).dataPool, &(*scanInfo).pageInfo, (*scanInfo).recordID.page); // Pin the page
+        if (result != RC_OK)
+        {                  // Check if pinning failed
+            return result; // Return error
+        }
+        (*scanInfo).pagePinned = TRUE; // The page stays pinned while its slots are visited
+        if ((*scanInfo).compiledCond != NULL)
+        {                                                                                   // Summarize a page read for the first time
+            summarizePageZone(relInfo, schema, (*scanInfo).recordID.page, (*scanInfo).pageInfo.data);
+            if (!pageMayMatch(relInfo, (*scanInfo).compiledCond, schema, (*scanInfo).recordID.page))
+            {                                            // None of its records can match
+                result = leaveScanPage(relInfo, scanInfo); // Move on without visiting its slots
+                if (result != RC_OK)
+                {                  // Check if unpin operation succeeded
+                    return result; // Return result code indicating reason of failure
+                }
+            }
+        }
+    }
+
+    char *data = (*scanInfo).pageInfo.data; // Get data from page
+    if ((*scanInfo).filter != NULL &&
+        !pageFilterCurrent((*scanInfo).filter, relInfo, (*scanInfo).recordID.page, data))
+    {                                                                                        // New page, or written since it was filtered
+        runPageFilter((*scanInfo).filter, relInfo, schema, (*scanInfo).recordID.page, data); // Find the records that may match
+    }
+
+    return RC_OK; // Return success
+}
+
+/**
+ * @details : Evaluates the condition of a scan on a record decoded from the page.
+ *
+ * @param scanInfo : State of the scan
+ * @param record : Record holding at least the attributes the condition reads
+ * @param schema : Schema of the table
+ * @param matches : Set to whether the record meets the condition
+ *
+ * @return RC_OK on success, or the error of evaluating the condition
+ */
+static RC scanRecordMatches(ScanInfo *scanInfo, Record *record, Schema *schema, bool *matches)
+{
+    if ((*scanInfo).compiledCond != NULL)
+    {                                                                 // The condition was compiled
+        *matches = evalCompiledExpr((*scanInfo).compiledCond, record); // Evaluate it without allocating
+        return RC_OK;
+    }
+    if ((*scanInfo).constantMatch == -1)
+    {                                                                                                   // The condition reads the record
+        return evalScanCondition(record, schema, (*scanInfo).conditionExpr, (*scanInfo).arena, matches); // Evaluate expression with the record
+    }
+    *matches = (*scanInfo).constantMatch; // Same result for every record
+    return RC_OK;
+}
+
+/**
+ * @details : Moves a scan back to its start after it ran out of records, so the next
+ *            call begins a new pass over the table.
+ *
+ * @param scanInfo : State of the scan
+ */
+static void resetScan(ScanInfo *scanInfo)
+{
+    (*scanInfo).recordID.page = FIRST_DATA_PAGE; // Reset to the first data page to start from begining
+    (*scanInfo).recordID.slot = 0; // Resets slot to initial index.
+    (*scanInfo).scanIndex = 0;     // Resets scan index.
+}
+
+/**
+ * @details : Moves a scan to the next record matching its condition. The function
+ *            walks the slot directories of the data pages, decodes each record and
+ *            evaluates it against the condition, and stops at the first matching
+ *            record. Moved records are visited where they are stored but reported
+ *            under their home RID; pages without records are passed over after
+ *            reading their live count. The scan ends after the last page of the
+ *            file, so it does not depend on the tuple count.
+ *
+ *            The page is pinned through pinScanPage, and released when the scan
+ *            moves to the next page, runs out of records or is closed.
  *
- * @return RC_OK on successful insertion
+ * @param scan : Pointer to the RM_ScanHandle structure of the scan
+ * @param record : Record the matching record is decoded into
+ * @param wanted : Attributes to decode, or NULL for all; the condition's must be among them
+ * @param stored : Set to the encoded attributes of the match on the pinned page
+ *
+ * @return RC_OK if a matching record is found, RC_RM_NO_MORE_TUPLES if no more records match,
+ *         RC_SCAN_CONDITION_NOT_FOUND if scan condition is missing, or the error of
+ *         evaluating the condition on a record
  */
-extern RC insertRecord(RM_TableData *rel, Record *record)
+static RC scanNextMatch(RM_ScanHandle *scan, Record *record, bool *wanted, char **stored)
 {
-    if (rel == NULL || record == NULL)
-    {                                // Check for invalid parameters
-        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if parameters are invalid
-    }
-
-    TableInfo *mgr = (*rel).mgmtData;              // Get the table management data
-    RID *rid = &(*record).id;                      // Get the record ID
-    char *pageContent, *slotPtr;                   // Pointers for page content and slot
-    int recordSize = getRecordSize((*rel).schema); // Get the size of the record
-    RC result;                                     // Variable to store the result code
-
-    if (recordSize <= 0)
-    {                                      // Check if record size is invalid
-        return RC_MEMORY_ALLOCATION_ERROR; // Return RC_MEMORY_ALLOCATION_ERROR if record size is invalid
-    }
-
-    // Start with the free page index
-    (*rid).page = (*mgr).freePageIndex; // Set the page to the free page index
+    ScanInfo *scanInfo = (*scan).mgmtData;        // Get the scan management data
+    TableInfo *relInfo = (*(*scan).rel).mgmtData; // Get the relation management data
+    Schema *schema = (*(*scan).rel).schema;       // Get the schema
+    RC result;                                    // Result of buffer pool calls
 
-    result = pinPage(&(*mgr).dataPool, &(*mgr).pageInfo, (*rid).page); // Pin the page
-    if (result != RC_OK)
-    {                  // Check if pinning failed
-        return result; // Return the error code
+    // Validate scan condition
+    if ((*scanInfo).conditionExpr == NULL)
+    {                                       // Check if the scan condition is NULL
+        return RC_SCAN_CONDITION_NOT_FOUND; // Return error if scan condition is not found
     }
 
-    pageContent = (*mgr).pageInfo.data;                     // Get the page content
-    (*rid).slot = locateEmptySlot(pageContent, recordSize); // Locate an empty slot
+    // Scan for matching records until every data page has been visited
+    while ((result = pinScanPage(scan)) == RC_OK)
+    {
+        char *data = (*scanInfo).pageInfo.data;                   // Get data from page
+        int slot = nextScanSlot(data, (*scanInfo).recordID.slot); // Next record on the page
 
-    // If no empty slot, try next pages until one is found
-    while ((*rid).slot == -1)
-    {                                                           // Loop until an empty slot is found
-        result = unpinPage(&(*mgr).dataPool, &(*mgr).pageInfo); // Unpin the current page
-        if (result != RC_OK)
-        {                  // Check if unpinning failed
-            return result; // Return the error code
+        if (slot == -1)
+        {                                              // No more records on this page
+            result = leaveScanPage(relInfo, scanInfo); // Move to the next data page
+            if (result != RC_OK)
+            {                  // Check if unpin operation succeeded
+                return result; // Return result code indicating reason of failure
+            }
+            continue; // Look at the next page
         }
 
-        (*rid).page += 1; // Go to the next page
+        // Advance past the record
+        (*scanInfo).recordID.slot = slot + 1; // Continue behind this slot
+        (*scanInfo).scanIndex += 1;           // Increase the scan index
 
-        result = pinPage(&(*mgr).dataPool, &(*mgr).pageInfo, (*rid).page); // Pin the next page
-        if (result != RC_OK)
-        {                  // Check if pinning failed
-            return result; // Return the error code
+        if ((*scanInfo).filter != NULL && !(*(*scanInfo).filter).matches[slot])
+        {             // The record failed the page filter
+            continue; // Skip it without decoding
         }
 
-        pageContent = (*mgr).pageInfo.data;                     // Get the page content
-        (*rid).slot = locateEmptySlot(pageContent, recordSize); // Locate an empty slot on the new page
-    }
-
-    // Insert the record at the found slot
-    slotPtr = pageContent; // Set the slot pointer
-
-    result = markDirty(&(*mgr).dataPool, &(*mgr).pageInfo); // Mark the page as dirty
-    if (result != RC_OK)
-    {                                                  // Check if marking dirty failed
-        unpinPage(&(*mgr).dataPool, &(*mgr).pageInfo); // Unpin the page
-        return result;                                 // Return the error code
+        // Set up record for evaluation
+        *stored = scanSlotRecord(data, (*scanInfo).recordID.page, slot, &(*record).id); // Encoded attributes
+        *(*record).data = '-';                                   // Set Tombstone to '-' as in a new record
+        decodeAttributes(schema, *stored, (*record).data, wanted); // Decode record data past the tag
+
+        bool matches;                                                // Whether the record qualifies
+        result = scanRecordMatches(scanInfo, record, schema, &matches); // Evaluate the condition
+        if (result != RC_OK || matches)
+        {                  // Check if expression eval to TRUE
+            return result; // Return success, keeping the page pinned, or the error
+        }
     }
 
-    slotPtr += ((*rid).slot * recordSize); // Move the slot pointer to the correct slot
-    *slotPtr = '+';                        // Mark slot as occupied
-
-    slotPtr += 1;                                        // Move past the tombstone byte
-    memcpy(slotPtr, (*record).data + 1, recordSize - 1); // Copy the record data to the slot
-
-    result = unpinPage(&(*mgr).dataPool, &(*mgr).pageInfo); // Unpin the page
-    if (result != RC_OK)
-    {                  // Check if unpinning failed
-        return result; // Return the error code
+    if (result == RC_RM_NO_MORE_TUPLES)
+    {                        // No more matching records found
+        resetScan(scanInfo); // Reset scan position
     }
+    return result; // Return RC_RM_NO_MORE_TUPLES or the error
+}
 
-    (*mgr).tupleCount += 1; // Increment the tuple count
-
-    result = pinPage(&(*mgr).dataPool, &(*mgr).pageInfo, 0); // Pin the metadata page
-    if (result != RC_OK)
-    {                  // Check if pinning failed
-        return result; // Return the error code
+/**
+ * @details : Copies the projected attributes of a full record into a record of a
+ *            scan's projected schema.
+ *
+ * @param scanInfo : State of the projected scan
+ * @param schema : Schema of the table
+ * @param full : Record holding at least the projected attributes
+ * @param data : Data of the projected record
+ */
+static void copyProjection(ScanInfo *scanInfo, Schema *schema, Record *full, char *data)
+{
+    Schema *projection = (*scanInfo).projection; // Schema of the projected record
+    int i;
+
+    for (i = 0; i < (*projection).numAttr; i += 1)
+    {                                                      // Copy every projected attribute
+        int from = (*schema).attrOffsets[(*scanInfo).projAttrs[i]]; // Offset in the full record
+        int to = (*projection).attrOffsets[i];             // Offset in the projected record
+        int size = (i + 1 < (*projection).numAttr) ? (*projection).attrOffsets[i + 1] - to : (*projection).recordSize - to;
+        memcpy(data + to, (*full).data + from, size);      // Copy the value
     }
-
-    return RC_OK; // Return RC_OK to indicate success
+    *data = '-'; // Tombstone as in a new record
 }
 
 /**
- * @details : Deletes a record from the table by marking its slot as available ('-').
- *            The function also updates the free page index to optimize future insertions.
+ * @details : Retrieves the next record matching the scan condition and copies it
+ *            into the given record. The scan keeps the page it is on pinned between
+ *            calls, see scanNextMatch. A projected scan fills a record of its
+ *            projected schema with the projected attributes only.
  *
- * @param rel : Pointer to the RM_TableData structure of the table
- * @param id : The RID (Record ID) of the record to be deleted
+ * @param scan : Pointer to the RM_ScanHandle structure of the scan
+ * @param record : Pointer to the Record structure where the matching record will be stored
  *
- * @return RC_OK on successful deletion
+ * @return RC_OK if a matching record is found, RC_RM_NO_MORE_TUPLES if no more records match,
+ *         RC_SCAN_CONDITION_NOT_FOUND if scan condition is missing, or the error of
+ *         evaluating the condition on a record
  */
-extern RC deleteRecord(RM_TableData *rel, RID id)
+extern RC next(RM_ScanHandle *scan, Record *record)
 {
-    if (rel == NULL)
-    {                                // Check for invalid parameters
-        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if rel is NULL
-    }
-
-    TableInfo *mgr = (*rel).mgmtData; // Get the table management data
-    RC result;                        // Variable to store the result code
-
-    result = pinPage(&(*mgr).dataPool, &(*mgr).pageInfo, id.page); // Pin the page
-    if (result != RC_OK)
-    {                  // Check if pinning failed
-        return result; // Return the error code
+    if (scan == NULL || record == NULL)
+    {                                // Check if scan handle or record are NULL
+        return RC_INVALID_PARAMETER; // Return error if invalid parameter
     }
 
-    (*mgr).freePageIndex = id.page; // Update free page index for optimization
+    ScanInfo *scanInfo = (*scan).mgmtData;  // Get the scan management data
+    Schema *schema = (*(*scan).rel).schema; // Get the schema
+    Schema *projection = (*scanInfo).projection; // Schema of the projected record
+    char *stored;                           // Encoded attributes of the match, not needed here
 
-    char *data = (*mgr).pageInfo.data;             // Get the page data
-    int recordSize = getRecordSize((*rel).schema); // Get the record size
-
-    if (recordSize <= 0)
-    {                                                  // Check if record size is invalid
-        unpinPage(&(*mgr).dataPool, &(*mgr).pageInfo); // Unpin the page
-        return RC_MEMORY_ALLOCATION_ERROR;             // Return RC_MEMORY_ALLOCATION_ERROR
+    if (projection == NULL)
+    {                                                  // Full records are decoded in place
+        return scanNextMatch(scan, record, NULL, &stored); // Decode the next match into the record
     }
 
-    data += (id.slot * recordSize); // Move the pointer to the start of the record slot
-    *data = '-';                    // Mark slot as available
-
-    result = markDirty(&(*mgr).dataPool, &(*mgr).pageInfo); // Mark the page as dirty
+    RC result = ensureScanRecord(scanInfo, schema); // Full record for the condition
     if (result != RC_OK)
-    {                                                  // Check if marking dirty failed
-        unpinPage(&(*mgr).dataPool, &(*mgr).pageInfo); // Unpin the page
-        return result;                                 // Return the error code
+    {                  // Check if allocation failed
+        return result; // Return error
     }
 
-    result = unpinPage(&(*mgr).dataPool, &(*mgr).pageInfo); // Unpin the page
+    Record *full = (*scanInfo).scanRecord;                                 // Needed attributes only
+    result = scanNextMatch(scan, full, (*scanInfo).wantedAttrs, &stored); // Find the next match
     if (result != RC_OK)
-    {                  // Check if unpinning failed
-        return result; // Return the error code
+    {                  // No match, or the scan failed
+        return result; // Return the result code
     }
 
-    return RC_OK; // Return RC_OK to indicate success
+    copyProjection(scanInfo, schema, full, (*record).data); // Keep the projected attributes
+    (*record).id = (*full).id;                              // RID of the record
+
+    return RC_OK; // Return success
 }
 
 /**
- * @details : Updates an existing record in the table with new data. The function
- *            locates the record using its RID and replaces its content.
+ * @details : Retrieves the next matching records of a scan into a batch, up to
+ *            maxRows or the capacity of the batch. The batch is filled a page at a
+ *            time: every slot of the pinned page is checked against the page
+ *            filter and the condition, decoding only the attributes the condition
+ *            reads, and only the records that pass are decoded straight into the
+ *            batch's buffer. Rows follow the scan's schema (see getScanSchema),
+ *            which the batch must have been created for. A batch cut short by the
+ *            end of the table is still returned; the call after it returns
+ *            RC_RM_NO_MORE_TUPLES. Calls to next and nextBatch may be mixed.
  *
- * @param rel : Pointer to the RM_TableData structure of the table
- * @param record : Pointer to the Record structure containing the updated data
+ * @param scan : Pointer to the RM_ScanHandle structure of the scan
+ * @param batch : Batch receiving the rows; numRows is set to the number filled
+ * @param maxRows : Most rows to return
  *
- * @return RC_OK on successful update
+ * @return RC_OK if at least one row was returned, RC_RM_NO_MORE_TUPLES if no more records match,
+ *         RC_INVALID_PARAMETER if the batch does not fit the scan's schema,
+ *         RC_SCAN_CONDITION_NOT_FOUND if scan condition is missing, or the error of
+ *         evaluating the condition on a record
  */
-extern RC updateRecord(RM_TableData *rel, Record *record)
+extern RC nextBatch(RM_ScanHandle *scan, RecordBatch *batch, int maxRows)
 {
-    if (rel == NULL || record == NULL)
-    {                                // Check for invalid parameters
-        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if parameters are invalid
+    if (scan == NULL || (*scan).mgmtData == NULL || batch == NULL || maxRows <= 0)
+    {                                // Check if scan handle or batch are NULL
+        return RC_INVALID_PARAMETER; // Return error if invalid parameter
     }
 
-    TableInfo *mgr = (*rel).mgmtData; // Get the table management data
-    RC result;                        // Variable to store the result code
-
-    result = pinPage(&(*mgr).dataPool, &(*mgr).pageInfo, (*record).id.page); // Pin the page
-    if (result != RC_OK)
-    {                  // Check if pinning failed
-        return result; // Return the error code
+    ScanInfo *scanInfo = (*scan).mgmtData;        // Get the scan management data
+    TableInfo *relInfo = (*(*scan).rel).mgmtData; // Get the relation management data
+    Schema *schema = (*(*scan).rel).schema;       // Get the schema
+    if ((*batch).recordSize != getRecordSize(getScanSchema(scan)))
+    {                                // The batch was made for another schema
+        return RC_INVALID_PARAMETER; // Return error if invalid parameter
+    }
+    if ((*scanInfo).conditionExpr == NULL)
+    {                                       // Check if the scan condition is NULL
+        return RC_SCAN_CONDITION_NOT_FOUND; // Return error if scan condition is not found
     }
 
-    char *data;                                    // Pointer to the record data
-    int recordSize = getRecordSize((*rel).schema); // Get the record size
+    (*batch).numRows = 0; // Nothing returned yet
+    if ((*scanInfo).batchAtEnd)
+    {                                    // The last batch ended the scan
+        (*scanInfo).batchAtEnd = FALSE;  // Start over on the call after this one, as next does
+        return RC_RM_NO_MORE_TUPLES;     // Report the end
+    }
 
-    if (recordSize <= 0)
-    {                                                  // Check if record size is invalid
-        unpinPage(&(*mgr).dataPool, &(*mgr).pageInfo); // Unpin the page
-        return RC_MEMORY_ALLOCATION_ERROR;             // Return RC_MEMORY_ALLOCATION_ERROR
+    RC result = ensureScanRecord(scanInfo, schema); // Record the condition is evaluated on
+    if (result != RC_OK)
+    {                  // Check if allocation failed
+        return result; // Return error
     }
 
-    RID rid = (*record).id;          // Get the record ID
-    data = (*mgr).pageInfo.data;     // Get the page data
-    data += (rid.slot * recordSize); // Move the pointer to the start of the record slot
+    int limit = (maxRows < (*batch).capacity) ? maxRows : (*batch).capacity; // Rows the batch takes
+    bool evaluate = ((*scanInfo).compiledCond != NULL || (*scanInfo).constantMatch == -1); // Whether records are read
+    Record *probe = (*scanInfo).scanRecord; // Holds the attributes the condition reads
+
+    while ((*batch).numRows < limit && (result = pinScanPage(scan)) == RC_OK)
+    {                                                     // Fill the batch page by page
+        char *data = (*scanInfo).pageInfo.data;           // Page the scan holds pinned
+        int pageNum = (*scanInfo).recordID.page;          // Its number
+        bool *passed = ((*scanInfo).filter != NULL) ? (*(*scanInfo).filter).matches : NULL; // Filter result of the page
+        int slot;                                         // Slot visited
+
+        for (slot = nextScanSlot(data, (*scanInfo).recordID.slot); slot != -1 && (*batch).numRows < limit;
+             slot = nextScanSlot(data, slot + 1))
+        {                                         // Visit the slots left on the page
+            (*scanInfo).recordID.slot = slot + 1; // Continue behind this slot
+            (*scanInfo).scanIndex += 1;           // Increase the scan index
+            if (passed != NULL && !passed[slot])
+            {             // The record failed the page filter
+                continue; // Skip it without decoding
+            }
 
-    *data = '+';                                      // Ensure slot is marked as occupied
-    data += 1;                                        // Move past the tombstone byte
-    memcpy(data, (*record).data + 1, recordSize - 1); // Copy the new record data to the slot
+            char *stored = scanSlotRecord(data, pageNum, slot, &(*probe).id); // Encoded attributes
+            if (evaluate)
+            {                                                               // Decode only what the condition reads
+                decodeAttributes(schema, stored, (*probe).data, (*scanInfo).condAttrs);
+            }
+            bool matches;                                                  // Whether the record qualifies
+            result = scanRecordMatches(scanInfo, probe, schema, &matches); // Evaluate the condition
+            if (result != RC_OK)
+            {                  // The condition could not be evaluated
+                return result; // Return the error, keeping the page pinned for closeScan
+            }
+            if (!matches)
+            {             // The record does not qualify
+                continue; // Look at the next slot
+            }
 
-    result = markDirty(&(*mgr).dataPool, &(*mgr).pageInfo); // Mark the page as dirty
-    if (result != RC_OK)
-    {                                                  // Check if marking dirty failed
-        unpinPage(&(*mgr).dataPool, &(*mgr).pageInfo); // Unpin the page
-        return result;                                 // Return the error code
+            char *row = (*batch).data + (*batch).numRows * (*batch).recordSize; // Row the match goes to
+            if ((*scanInfo).projection == NULL)
+            {                                                 // Full rows are decoded in place
+                *row = '-';                                   // Tombstone as in a new record
+                decodeAttributes(schema, stored, row, NULL);  // Decode the whole record
+            }
+            else
+            {                                                                        // Decode the projected attributes
+                decodeAttributes(schema, stored, (*probe).data, (*scanInfo).wantedAttrs);
+                copyProjection(scanInfo, schema, probe, row);                        // Keep the projected attributes
+            }
+            (*batch).ids[(*batch).numRows] = (*probe).id; // Remember its RID
+            (*batch).numRows += 1;                        // One more row
+        }
+
+        if (slot == -1)
+        {                                              // No more records on this page
+            result = leaveScanPage(relInfo, scanInfo); // Move to the next data page
+            if (result != RC_OK)
+            {          // Check if unpin operation succeeded
+                break; // Report the error
+            }
+        }
     }
 
-    result = unpinPage(&(*mgr).dataPool, &(*mgr).pageInfo); // Unpin the page
-    if (result != RC_OK)
-    {                  // Check if unpinning failed
-        return result; // Return the error code
+    if (result == RC_RM_NO_MORE_TUPLES)
+    {                        // The scan ran out of records
+        resetScan(scanInfo); // Start over on the call after the end, as next does
+        if ((*batch).numRows > 0)
+        {                                  // Return the rows found before the end
+            (*scanInfo).batchAtEnd = TRUE; // The next call reports the end
+            return RC_OK;                  // Return success
+        }
     }
 
-    return RC_OK; // Return RC_OK to indicate success
+    return result; // Return the result code
 }
 
 /**
- * @details : Retrieves a record from the table based on its RID. The function checks
- *            if the slot is occupied before copying the record data.
+ * @details : Retrieves the next record matching the scan condition as a view into
+ *            the page the scan holds pinned, without copying it out. The view
+ *            borrows the scan's pin and stays valid until the next call to next,
+ *            nextView or closeScan; releasing it is not needed. Only the attributes
+ *            the condition reads are decoded, and views always show the full
+ *            record, also in a projected scan.
  *
- * @param rel : Pointer to the RM_TableData structure of the table
- * @param id : The RID (Record ID) of the record to be retrieved
- * @param record : Pointer to the Record structure where the retrieved data will be stored
+ * @param scan : Pointer to the RM_ScanHandle structure of the scan
+ * @param view : View set to the matching record
  *
- * @return RC_OK on successful retrieval, or RC_RM_NO_TUPLE_WITH_GIVEN_RID if no record exists
+ * @return RC_OK if a matching record is found, RC_RM_NO_MORE_TUPLES if no more records match,
+ *         RC_SCAN_CONDITION_NOT_FOUND if scan condition is missing, or the error of
+ *         evaluating the condition on a record
  */
-extern RC getRecord(RM_TableData *rel, RID id, Record *record)
+extern RC nextView(RM_ScanHandle *scan, RM_RecordView *view)
 {
-    if (rel == NULL || record == NULL)
-    {                                // Check for invalid parameters
-        return RC_INVALID_PARAMETER; // Return RC_INVALID_PARAMETER if parameters are invalid
+    if (scan == NULL || view == NULL || (*scan).mgmtData == NULL)
+    {                                // Check if scan handle or view are NULL
+        return RC_INVALID_PARAMETER; // Return error if invalid parameter
     }
 
-    TableInfo *mgr = (*rel).mgmtData; // Get the table management data
-    RC result;                        // Variable to store the result code
+    ScanInfo *scanInfo = (*scan).mgmtData;  // Get the scan management data
+    Schema *schema = (*(*scan).rel).schema; // Get the schema
+    char *stored;                           // Encoded attributes of the match
 
-    result = pinPage(&(*mgr).dataPool, &(*mgr).pageInfo, id.page); // Pin the page
+    RC result = ensureScanRecord(scanInfo, schema); // The condition still needs a record to read
     if (result != RC_OK)
-    {                  // Check if pinning failed
-        return result; // Return the error code
-    }
-
-    int recordSize = getRecordSize((*rel).schema); // Get the record size
-
-    if (recordSize <= 0)
-    {                                                  // Check if record size is invalid
-        unpinPage(&(*mgr).dataPool, &(*mgr).pageInfo); // Unpin the page
-        return RC_MEMORY_ALLOCATION_ERROR;             // Return RC_MEMORY_ALLOCATION_ERROR
-    }
-
-    char *data = (*mgr).pageInfo.data; // Get the page data
-    data += (id.slot * recordSize);    // Move the pointer to the start of the record slot
-
-    if (*data != '+')
-    {                                                           // Check if slot is occupied
-        result = unpinPage(&(*mgr).dataPool, &(*mgr).pageInfo); // Unpin the page
-        if (result != RC_OK)
-        {                  // Check if unpinning failed
-            return result; // Return the error code
-        }
-        return RC_RM_NO_TUPLE_WITH_GIVEN_RID; // Return RC_RM_NO_TUPLE_WITH_GIVEN_RID
-    }
-    else
-    {
-        (*record).id = id;                            // Set the record ID
-        char *recordData = (*record).data;            // Get the record data pointer
-        recordData += 1;                              // Move past the tombstone byte
-        memcpy(recordData, data + 1, recordSize - 1); // Copy the record data to the record struct
+    {                  // Check if allocation failed
+        return result; // Return error
     }
 
-    result = unpinPage(&(*mgr).dataPool, &(*mgr).pageInfo); // Unpin the page
+    result = scanNextMatch(scan, (*scanInfo).scanRecord, (*scanInfo).condAttrs, &stored); // Find the next match
     if (result != RC_OK)
-    {                  // Check if unpinning failed
-        return result; // Return the error code
+    {                  // No match, or the scan failed
+        return result; // Return the result code
     }
 
-    return RC_OK; // Return RC_OK to indicate success
+    (*view).id = (*(*scanInfo).scanRecord).id;        // RID the record is known by
+    (*view).schema = schema;                          // Schema of the record
+    (*view).data = stored;                            // Attributes in place on the page
+    (*view).pool = NULL;                              // The pin belongs to the scan
+    (*view).pageNum = (*scanInfo).pageInfo.pageNum;   // Page the scan holds pinned
+
+    return RC_OK; // Return success
 }
 
 /**
- * @details : Initiates a table scan with a specified condition. The function sets up
- *            scan management data and initializes scan position to the beginning of the table.
+ * @details : Ends a table scan and cleans up resources. The function releases the
+ *            pin the scan may still hold on its current page, resets scan position
+ *            and frees allocated memory.
  *
- * @param rel : Pointer to the RM_TableData structure of the table to be scanned
- * @param scan : Pointer to the RM_ScanHandle structure to be populated
- * @param cond : Expression condition for filtering records during the scan
+ * @param scan : Pointer to the RM_ScanHandle structure of the scan to be closed
  *
- * @return RC_OK on successful scan initialization, or RC_SCAN_CONDITION_NOT_FOUND if condition is NULL
+ * @return RC_OK on successful closure of the scan, or the error of unpinning the page
  */
-extern RC startScan(RM_TableData *rel, RM_ScanHandle *scan, Expr *cond)
+extern RC closeScan(RM_ScanHandle *scan)
 {
-    // Validate input parameters
-    if (rel == NULL || scan == NULL)
-    {
-        return RC_INVALID_PARAMETER;
+    if (scan == NULL || scan->mgmtData == NULL)
+    {                                // Check for scan handle
+        return RC_INVALID_PARAMETER; // Return parameter if invalid.
     }
 
-    // Check if the condition expression is provided
-    if (cond == NULL)
-    {
-        return RC_SCAN_CONDITION_NOT_FOUND;
-    }
+    ScanInfo *scanInfo = (ScanInfo *)scan->mgmtData;
+    RC result = RC_OK;
 
-    // Open the table in memory (assumes "openTable" initializes metadata)
-    RC rc = openTable(rel, "ScanTable");
-    if (rc != RC_OK)
+    // Release the page a scan that stopped early still holds
+    if (scanInfo->pagePinned)
     {
-        return rc; // Return error code if opening the table fails
+        TableInfo *relInfo = (TableInfo *)scan->rel->mgmtData;
+        result = unpinPage(&relInfo->dataPool, &scanInfo->pageInfo);
+        scanInfo->pagePinned = FALSE;
     }
 
-    // Allocate memory for scan manager metadata
-    TableInfo *scanManager = (TableInfo *)malloc(sizeof(TableInfo));
-    if (scanManager == NULL)
+    // Free the record the condition was evaluated on, and the projection
+    if (scanInfo->scanRecord != NULL)
     {
-        return RC_MEMORY_ALLOCATION_ERROR; // Handle memory allocation failure
+        freeRecord(scanInfo->scanRecord);
     }
+    freeScanProjection(scanInfo);
 
-    // Initialize scan manager metadata
-    scanManager->recordID.page = 0;    // Start scanning from the first page (0-based index)
-    scanManager->recordID.slot = 0;    // Start scanning from the first slot
-    scanManager->scanIndex = 0;        // No records scanned yet
-    scanManager->conditionExpr = cond; // Store the condition expression
-
-    // Attach scan manager to the scan handle
-    scan->mgmtData = scanManager;
-
-    // Set the table to be scanned in the scan handle
-    scan->rel = rel;
-
-    // Ensure table metadata is properly initialized
-    TableInfo *tableManager = rel->mgmtData;
-    if (tableManager == NULL)
-    {
-        free(scanManager); // Clean up allocated memory before returning error
-        return RC_FILE_NOT_FOUND;
-    }
+    // Reset scan position
+    scanInfo->batchAtEnd = FALSE;
+    scanInfo->scanIndex = 0;
+    scanInfo->recordID.page = FIRST_DATA_PAGE;
+    scanInfo->recordID.slot = 0;
 
-    // Set tuple count or any other necessary metadata in table manager
-    tableManager->tupleCount = ATTR_NAME_MAX_LENGTH; // Example placeholder
+    // Free scan management resources
+    free(scan->mgmtData);
+    scan->mgmtData = NULL;
 
-    return RC_OK; // Successfully initialized the scan
+    return result; // Return the result of releasing the page
 }
 
 /**
- * @details : Retrieves the next record matching the scan condition. The function
- *            iterates through records, evaluates each against the condition,
- *            and returns the first matching record.
+ * @details : Hands the next morsel of pages to a parallel scan worker. No more
+ *            morsels are handed out once a worker has failed.
  *
- * @param scan : Pointer to the RM_ScanHandle structure of the scan
- * @param record : Pointer to the Record structure where the matching record will be stored
+ * @param work : Parallel scan
+ * @param first : Set to the first page of the morsel
  *
- * @return RC_OK if a matching record is found, RC_RM_NO_MORE_TUPLES if no more records match,
- *         or RC_SCAN_CONDITION_NOT_FOUND if scan condition is missing
+ * @return TRUE if a morsel was handed out, FALSE when the scan is over
  */
-extern RC next(RM_ScanHandle *scan, Record *record)
+static bool nextMorsel(ParallelScan *work, int *first)
 {
-    if (scan == NULL || record == NULL)
-    {                                // Check if scan handle or record are NULL
-        return RC_INVALID_PARAMETER; // Return error if invalid parameter
+    pthread_mutex_lock(&(*work).lock);      // Workers take morsels in turn
+    *first = (*work).nextPage;              // First page of the morsel
+    bool found = ((*work).result == RC_OK && *first < (*work).numPages); // Whether pages are left
+    if (found)
+    {                                       // Hand out the morsel
+        (*work).nextPage += MORSEL_PAGES;   // The next worker starts behind it
     }
+    pthread_mutex_unlock(&(*work).lock);    // Let the other workers in
+    return found;                           // Return whether pages are left
+}
 
-    TableInfo *scanInfo = (*scan).mgmtData;       // Get the scan management data
-    TableInfo *relInfo = (*(*scan).rel).mgmtData; // Get the relation management data
-    Schema *schema = (*(*scan).rel).schema;       // Get the schema
-
-    // Validate scan condition
-    if ((*scanInfo).conditionExpr == NULL)
-    {                                       // Check if the scan condition is NULL
-        return RC_SCAN_CONDITION_NOT_FOUND; // Return error if scan condition is not found
+/**
+ * @details : Scans the records of one data page for a parallel scan, passing the
+ *            matching ones to its callback. The page is pinned for the duration.
+ *
+ * @param work : Parallel scan
+ * @param pageNum : Data page to scan
+ * @param record : Record of the worker the records are decoded into
+ * @param filter : Page filter of the worker, or NULL
+ * @param arena : Arena of the worker for a condition that is not compiled, or NULL
+ *
+ * @return RC_OK on success, or the first error of the buffer pool or callback
+ */
+static RC parallelScanPage(ParallelScan *work, int pageNum, Record *record, PageFilter *filter, Arena *arena)
+{
+    TableInfo *relInfo = (*(*work).rel).mgmtData; // Get the relation management data
+    Schema *schema = (*(*work).rel).schema;       // Get the schema
+    BM_PageHandle page;                           // Page pinned by this worker
+    int slot = 0;                                 // Slot visited, -1 to pass over the page
+
+    if ((*work).compiled != NULL && !pageMayMatch(relInfo, (*work).compiled, schema, pageNum))
+    {                 // The zone map rules the page out
+        return RC_OK; // Skip it without reading it
     }
 
-    Value *evalResult = (Value *)malloc(sizeof(Value)); // Allocate memory for evaluation result
-    if (evalResult == NULL)
-    {                                      // Check if allocation failed
-        return RC_MEMORY_ALLOCATION_ERROR; // Return error if memory allocation failed
+    RC result = pinPage(&(*relInfo).dataPool, &page, pageNum); // Pin the page
+    if (result != RC_OK)
+    {                  // Check if pinning failed
+        return result; // Return error
     }
 
-    char *data;                             // Pointer to the data
-    int recordSize = getRecordSize(schema); // Get the record size
-
-    if (recordSize <= 0)
-    {                     // Check if record size is invalid
-        free(evalResult); // Free allocated memory
-        return RC_ERROR;  // Return error
+    if ((*work).compiled != NULL)
+    {                                                              // Summarize a page read for the first time
+        summarizePageZone(relInfo, schema, pageNum, page.data);    // The map was grown before the workers started
+        if (!pageMayMatch(relInfo, (*work).compiled, schema, pageNum))
+        {              // None of its records can match
+            slot = -1; // Visit no slot
+        }
     }
-
-    int slotsPerPage = PAGE_SIZE / recordSize; // Calculate the number of slots per page
-    int scanCount = (*scanInfo).scanIndex;     // Get the current scan index
-    int totalRecords = (*relInfo).tupleCount;  // Get the total number of records
-
-    // Check if table is empty
-    if (totalRecords == 0)
-    {                                // Check if there are no records
-        free(evalResult);            // Free allocated memory
-        return RC_RM_NO_MORE_TUPLES; // Return error if no more tuples
+    if (filter != NULL && slot != -1)
+    {                                              // Filter the page first
+        runPageFilter(filter, relInfo, schema, pageNum, page.data); // Find the records that may match
     }
 
-    // Scan for matching records
-    while (scanCount <= totalRecords)
-    { // Loop until the end of the table
-        // Initialize or advance position
-        if (scanCount <= 0)
-        {                                  // Initialize the scan at the first page and slot
-            (*scanInfo).recordID.page = 1; // Start at page 1
-            (*scanInfo).recordID.slot = 0; // Start at slot 0
+    for (slot = (slot == -1) ? -1 : nextScanSlot(page.data, 0); slot != -1 && result == RC_OK; slot = nextScanSlot(page.data, slot + 1))
+    {                                                                          // Visit every record on the page
+        if (filter != NULL && !(*filter).matches[slot])
+        {             // The record failed the page filter
+            continue; // Skip it without decoding
+        }
+        char *stored = scanSlotRecord(page.data, pageNum, slot, &(*record).id); // Encoded attributes
+        *(*record).data = '-';                                                 // Tombstone as in a new record
+        decodeAttributes(schema, stored, (*record).data, NULL);                // Decode the record
+
+        bool matches;                                                 // Whether the record qualifies
+        if ((*work).compiled != NULL)
+        {                                                             // The condition was compiled
+            matches = evalCompiledExpr((*work).compiled, record);     // Evaluate it without allocating
         }
         else
-        {                                   // Increment to the next slot
-            (*scanInfo).recordID.slot += 1; // Increment slot
-            if ((*scanInfo).recordID.slot >= slotsPerPage)
-            {                                   // If the slot number has reached max, go to the next page
-                (*scanInfo).recordID.slot = 0;  // Reset slot number
-                (*scanInfo).recordID.page += 1; // Increment the page number
-            }
+        {
+            result = evalScanCondition(record, schema, (*work).cond, arena, &matches); // Evaluate expression with the record
         }
-
-        // Access the current record
-        RC result = pinPage(&(*relInfo).dataPool, &(*scanInfo).pageInfo, (*scanInfo).recordID.page); // Pin the page
-        if (result != RC_OK)
-        {                     // Check if pinning failed
-            free(evalResult); // Free allocated memory
-            return result;    // Return error
+        if (result == RC_OK && matches)
+        {                                                         // Pass on a matching record
+            result = (*work).callback(record, (*work).context);   // Stop on the callback's error
         }
+    }
 
-        data = (*scanInfo).pageInfo.data;                 // Get data from page
-        data += ((*scanInfo).recordID.slot * recordSize); // Get to the correct record
+    RC unpinResult = unpinPage(&(*relInfo).dataPool, &page); // Release the page
+    return (result != RC_OK) ? result : unpinResult;         // Report the first error
+}
 
-        // Set up record for evaluation
-        (*record).id.page = (*scanInfo).recordID.page; //
-        (*record).id.slot = (*scanInfo).recordID.slot; // Set current slot number
-        char *recordData = (*record).data;             // Point to the record data
-        *recordData = '-';                             // Set Tombstone to '-' indicating possible empty slot
-
-        recordData += 1;                              // Skip Tombstone byte
-        memcpy(recordData, data + 1, recordSize - 1); // Copy record data
-
-        // Increment counters
-        (*scanInfo).scanIndex += 1; // Increase the scan index
-        scanCount += 1;             // Increase count
-
-        // Evaluate condition
-        evalExpr(record, schema, (*scanInfo).conditionExpr, &evalResult); // Evaluate expression with the record
-        if ((*evalResult).v.boolV == TRUE)
-        {                                                                    // Check if expression eval to TRUE
-            result = unpinPage(&(*relInfo).dataPool, &(*scanInfo).pageInfo); // Unpin the page
-            if (result != RC_OK)
-            {                     // Check if unpin operation succeeded
-                free(evalResult); // Free the evaluation result
-                return result;    // Return result code indicating reason of failure
+/**
+ * @details : Body of the worker threads of a parallel scan. A worker takes morsels
+ *            of pages until none are left, and records its error in the scan.
+ *
+ * @param arg : Parallel scan
+ *
+ * @return NULL
+ */
+static void *parallelScanWorker(void *arg)
+{
+    ParallelScan *work = arg;                     // Parallel scan
+    TableInfo *relInfo = (*(*work).rel).mgmtData; // Get the relation management data
+    Record *record = NULL;                        // Record of this worker
+    int first;                                    // First page of the morsel
+    PageFilter *filter = createPageFilter((*work).compiled, (*(*work).rel).schema, (*relInfo).pageSize); // Filter of this worker
+
+    Arena *arena = NULL;                          // Values of a condition that is not compiled
+
+    RC result = createRecord(&record, (*(*work).rel).schema); // Each worker decodes into its own record
+    if (result == RC_OK && (*work).compiled == NULL)
+    {                                        // evalExpr would allocate for every record
+        result = createArena(&arena, 0);     // Evaluate it in an arena of this worker
+    }
+    while (result == RC_OK && nextMorsel(work, &first))
+    {
+        int pageNum;
+        for (pageNum = first; pageNum < first + MORSEL_PAGES && pageNum < (*work).numPages && result == RC_OK; pageNum += 1)
+        {                                  // Scan every page of the morsel
+            if (!isFsmPage(relInfo, pageNum))
+            {                              // Free-space map pages hold no records
+                result = parallelScanPage(work, pageNum, record, filter, arena); // Scan the page
             }
-            free(evalResult); // Free the evaluation result
-            return RC_OK;     // Return success
         }
     }
 
-    // No more matching records found, reset scan position
-    RC result = unpinPage(&(*relInfo).dataPool, &(*scanInfo).pageInfo); // Unpin the page
     if (result != RC_OK)
-    {                     // Check if unpinning fails
-        free(evalResult); // Free memory allocated to the evalResult
-        return result;    // Returns result code
+    {                                          // Stop the other workers
+        pthread_mutex_lock(&(*work).lock);     // Guard the result
+        if ((*work).result == RC_OK)
+        {                                      // Keep the first error
+            (*work).result = result;           // Record it
+        }
+        pthread_mutex_unlock(&(*work).lock);   // Release the guard
     }
-
-    (*scanInfo).recordID.page = 1; // Reset to page 1 to start from begining
-    (*scanInfo).recordID.slot = 0; // Resets slot to initial index.
-    (*scanInfo).scanIndex = 0;     // Resets scan index.
-    free(evalResult);              // Free allocated memory
-
-    return RC_RM_NO_MORE_TUPLES; // Return error if no more tuples
+    if (record != NULL)
+    {                       // Created above
+        freeRecord(record); // Free the record of this worker
+    }
+    freePageFilter(filter); // Free the filter of this worker
+    freeArena(arena);       // Free the arena of this worker
+    return NULL;
 }
 
 /**
- * @details : Ends a table scan and cleans up resources. The function resets scan
- *            position and frees allocated memory.
+ * @details : Scans a whole table on several threads, passing every record that
+ *            matches the condition to a callback. The data pages are split into
+ *            morsels of MORSEL_PAGES pages that the threads take in turn, each
+ *            pinning its own pages and evaluating the condition on its own record,
+ *            so a selective scan over a large table uses every thread. The callback
+ *            is called from all threads at once, in no particular order, with a
+ *            record that is only valid during the call; moved records are reported
+ *            under their home RID as by next. A callback returning an error stops
+ *            the scan. Callbacks may read the table through getRecord, getRecords or
+ *            getRecordView, which pin into handles of their own, but neither they
+ *            nor anything else may change the table while it is scanned.
  *
- * @param scan : Pointer to the RM_ScanHandle structure of the scan to be closed
+ * @param rel : Pointer to the RM_TableData structure of the table
+ * @param cond : Condition records must meet
+ * @param numThreads : Number of threads scanning the table
+ * @param callback : Function called for every matching record
+ * @param context : Passed on to the callback
  *
- * @return RC_OK on successful closure of the scan
- */
-extern RC closeScan(RM_ScanHandle *scan)
-{
-    if (scan == NULL || scan->mgmtData == NULL)
-    {                                // Check for scan handle
-        return RC_INVALID_PARAMETER; // Return parameter if invalid.
+ * @return RC_OK on success, RC_INVALID_PARAMETER for invalid arguments, the type
+ *         error of a condition that can never be evaluated, or the first error of
+ *         the buffer pool, the condition or the callback
+ */
+extern RC parallelScan(RM_TableData *rel, Expr *cond, int numThreads, RM_ScanCallback callback, void *context)
+{
+    if (rel == NULL || (*rel).mgmtData == NULL || callback == NULL || numThreads < 1)
+    {                                // Check the arguments
+        return RC_INVALID_PARAMETER; // Return error if invalid parameter
+    }
+    if (cond == NULL)
+    {                                       // Check if the scan condition is NULL
+        return RC_SCAN_CONDITION_NOT_FOUND; // Return error if scan condition is not found
     }
 
-    TableInfo *scanInfo = (TableInfo *)scan->mgmtData;
-
-    // Reset scan position
-    scanInfo->scanIndex = 0;
-    scanInfo->recordID.page = 1;
-    scanInfo->recordID.slot = 0;
+    TableInfo *relInfo = (*rel).mgmtData; // Get the relation management data
+    ParallelScan work;                    // Work shared by the threads
+    Expr *optimized = NULL;               // Condition rewritten by optimizeExpr
+    if (optimizeExpr(cond, (*rel).schema, &optimized) == RC_OK)
+    {                                     // Rewritten once for all workers
+        cond = optimized;                 // Evaluate the rewritten condition
+    }
+    work.rel = rel;
+    work.cond = cond;
+    RC compiled = compileScanCondition(cond, (*rel).schema, &work.compiled); // Shared by the workers, which only read it
+    if (compiled != RC_OK)
+    {                            // A condition that can never be evaluated
+        if (optimized != NULL)
+        {                        // The copy made above
+            freeExpr(optimized); // Free the optimized condition
+        }
+        return compiled;         // Report it before starting any worker
+    }
+    work.callback = callback;
+    work.context = context;
+    work.numPages = getPoolNumPages(&(*relInfo).dataPool); // The scan ends with the last page of the file
+    ensureZonePage(relInfo, work.numPages - 1);           // Grown here so workers never resize the zone map
+    work.nextPage = FIRST_DATA_PAGE;                       // Start at the first data page
+    work.result = RC_OK;
+    pthread_mutex_init(&work.lock, NULL);
+
+    pthread_t *threads = malloc(sizeof(pthread_t) * numThreads); // Worker threads
+    int started = 0;                                             // Threads running
+    while (threads != NULL && started < numThreads && pthread_create(&threads[started], NULL, parallelScanWorker, &work) == 0)
+    {                 // Start the workers
+        started += 1; // One more running
+    }
+    if (started == 0)
+    {                                 // No thread could be started
+        parallelScanWorker(&work);    // Scan on the calling thread
+    }
 
-    // Free scan management resources
-    free(scan->mgmtData);
-    scan->mgmtData = NULL;
+    int i;
+    for (i = 0; i < started; i += 1)
+    {                                   // Wait for every worker
+        pthread_join(threads[i], NULL); // Join the worker
+    }
+    free(threads);
+    freeCompiledExpr(work.compiled);
+    if (optimized != NULL)
+    {                         // The copy made above
+        freeExpr(optimized);  // Free the optimized condition
+    }
+    pthread_mutex_destroy(&work.lock);
 
-    return RC_OK; // Return successful result
+    return work.result; // Return the first error, if any
 }
 
 /**
  * @details : Calculates the size of a record based on its schema definition.
  *            The function adds up the size requirements for each attribute type
- *            and adds one byte for the record's tombstone marker.
+ *            and adds one byte for the record's tombstone marker. Schemas set up by
+ *            createSchema or openTable already know their size.
  *
  * @param schema : Pointer to the Schema structure defining the record's format
  *
@@ -884,6 +3979,11 @@ extern int getRecordSize(Schema *schema)
         return -1; // Returns -1 if NULL
     }
 
+    if ((*schema).attrOffsets != NULL)
+    {                                // Size worked out with the offsets
+        return (*schema).recordSize; // Return it at once
+    }
+
     int size = 0; // size initialisation
     int i = 0;    // Iterator variable
 
@@ -951,13 +4051,15 @@ extern Schema *createSchema(int numAttr, char **attrNames, DataType *dataTypes,
     (*schema).typeLength = typeLength; // Set the typeLength.
     (*schema).keySize = keySize;       // Sets the key size.
     (*schema).keyAttrs = keys;         // Copy over keys to the schema
+    setAttributeOffsets(schema);       // Work out the record layout once
 
     return schema; // Return pointer to newly allocated schema
 }
 
 /**
- * @details : Deallocates memory used by a schema object. The function simply frees
- *            the schema structure itself, assuming attribute arrays are managed elsewhere.
+ * @details : Deallocates memory used by a schema object. The function frees the
+ *            schema structure and the attribute offsets it set up itself, assuming
+ *            the attribute arrays passed to createSchema are managed elsewhere.
  *
  * @param schema : Pointer to the Schema structure to be freed
  *
@@ -970,15 +4072,183 @@ extern RC freeSchema(Schema *schema)
         return RC_INVALID_PARAMETER; // Returns parameter if invalid.
     }
 
-    free(schema); // Free schema
+    free((*schema).attrOffsets); // Free the offsets set up with the schema
+    free(schema);                // Free schema
 
     return RC_OK; // Returns Result
 }
 
+/**
+ * @details : Frees a record cache and every free record on it.
+ *
+ * @param arg : Cache to free, or NULL
+ */
+static void freeRecordCache(void *arg)
+{
+    RecordCache *cache = arg; // Cache of the ending thread
+    if (cache == NULL)
+    {           // The thread never freed a record
+        return; // Nothing to free
+    }
+
+    int i;
+    for (i = 0; i < RECORD_POOL_SIZES; i += 1)
+    {                                            // Every list of the cache
+        while ((*cache).freeList[i] != NULL)
+        {                                        // Free each block
+            PooledRecord *block = (*cache).freeList[i];
+            (*cache).freeList[i] = (*block).next;
+            free(block);
+        }
+    }
+    free(cache);
+}
+
+/**
+ * @details : Creates the key that frees the record cache of a thread when it ends.
+ */
+static void createRecordCacheKey(void)
+{
+    pthread_key_create(&recordCacheKey, freeRecordCache); // Destructor runs on thread exit
+}
+
+/**
+ * @details : Returns the record cache of the calling thread, creating it on first use.
+ *
+ * @return The cache, or NULL if it cannot be allocated
+ */
+static RecordCache *getRecordCache(void)
+{
+    if (recordCache == NULL)
+    {                                                             // First use on this thread
+        pthread_once(&recordCacheOnce, createRecordCacheKey);     // Make sure the key exists
+        recordCache = (RecordCache *)calloc(1, sizeof(RecordCache)); // Empty lists
+        if (recordCache != NULL)
+        {                                                         // Free it when the thread ends
+            pthread_setspecific(recordCacheKey, recordCache);
+        }
+    }
+    return recordCache;
+}
+
+/**
+ * @details : Takes a record with dataSize bytes of data from the calling thread's
+ *            cache, allocating a new block if the cache has none of that size.
+ *            Record and data share one block, so a new record costs one malloc
+ *            and a recycled one none.
+ *
+ * @param dataSize : Bytes of data the record needs
+ *
+ * @return The record, or NULL if memory ran out
+ */
+static Record *takePooledRecord(int dataSize)
+{
+    RecordCache *cache = getRecordCache(); // Free records of this thread
+    PooledRecord *block = NULL;            // Block to hand out
+
+    int i;
+    for (i = 0; cache != NULL && i < RECORD_POOL_SIZES; i += 1)
+    {                                                          // Look for a list of this size
+        if ((*cache).dataSize[i] == dataSize && (*cache).freeList[i] != NULL)
+        {                                                      // Reuse a free block
+            block = (*cache).freeList[i];
+            (*cache).freeList[i] = (*block).next;
+            (*cache).count[i] -= 1;
+            break;
+        }
+    }
+
+    if (block == NULL)
+    {                                                              // Nothing to reuse
+        block = (PooledRecord *)malloc(sizeof(PooledRecord) + dataSize); // Record and data at once
+        if (block == NULL)
+        {                // Allocation failed
+            return NULL; // Report it
+        }
+        (*block).dataSize = dataSize;
+    }
+    (*block).magic = RECORD_POOL_MAGIC;         // Live until freeRecord
+    (*block).record.data = (char *)(block + 1); // The data follows the block
+    return &(*block).record;
+}
+
+/**
+ * @details : Tells whether a record was handed out by takePooledRecord. Such a
+ *            record's data sits right behind it in its block and the block
+ *            carries RECORD_POOL_MAGIC. Adjacency alone is not proof, since a
+ *            caller may lay out a record and its data in one allocation, so
+ *            the magic is checked before the block's dataSize is trusted.
+ *
+ * @param record : Record to look at
+ *
+ * @return The record's block, or NULL for a record from elsewhere
+ */
+static PooledRecord *pooledRecordBlock(Record *record)
+{
+    PooledRecord *block = (PooledRecord *)((char *)record - offsetof(PooledRecord, record)); // Block it would be in
+    if ((*record).data != (char *)(block + 1))
+    {                // Data lives elsewhere
+        return NULL; // Not a pooled record
+    }
+    return ((*block).magic == RECORD_POOL_MAGIC) ? block : NULL;
+}
+
+/**
+ * @details : Gives a pooled record back to the calling thread's cache, which
+ *            keeps up to RECORD_POOL_DEPTH free records of each of
+ *            RECORD_POOL_SIZES sizes. Records beyond that are freed. The cache
+ *            belongs to the thread, so workers recycle records without a lock;
+ *            a record freed on another thread than it was created on simply
+ *            moves to that thread's cache.
+ *
+ * @param block : Block of the record
+ */
+static void givePooledRecord(PooledRecord *block)
+{
+    RecordCache *cache = getRecordCache(); // Free records of this thread
+    int unused = -1;                       // A list not used for any size yet
+    (*block).magic = 0;                    // Free blocks are not records
+
+    int i;
+    for (i = 0; cache != NULL && i < RECORD_POOL_SIZES; i += 1)
+    {                                                    // Look for the list of this size
+        if ((*cache).dataSize[i] == (*block).dataSize)
+        {
+            break; // Found it
+        }
+        if ((*cache).dataSize[i] == 0 && unused == -1)
+        {
+            unused = i; // Remember the first unused list
+        }
+    }
+
+    if (cache == NULL || (i == RECORD_POOL_SIZES && unused == -1))
+    {                // No list for this size
+        free(block); // Free the record instead
+        return;
+    }
+    if (i == RECORD_POOL_SIZES)
+    {                                             // Start a list for this size
+        i = unused;
+        (*cache).dataSize[i] = (*block).dataSize;
+    }
+    if ((*cache).count[i] >= RECORD_POOL_DEPTH)
+    {                // The list is full
+        free(block); // Free the record instead
+        return;
+    }
+
+    (*block).next = (*cache).freeList[i]; // Push it on the list
+    (*cache).freeList[i] = block;
+    (*cache).count[i] += 1;
+}
+
 /**
  * @details : Creates a new record with memory allocation based on the schema.
  *            The function initializes the record with default values and sets
- *            its RID to indicate that it's not yet stored in the table.
+ *            its RID to indicate that it's not yet stored in the table. The
+ *            record comes from the calling thread's pool of records freed by
+ *            freeRecord when it has one of the same size.
  *
  * @param record : Pointer to a Record pointer that will be updated to the new record
  * @param schema : Pointer to the Schema structure defining the record's format
@@ -986,30 +4256,51 @@ extern RC freeSchema(Schema *schema)
  * @return RC_OK on successful creation of the record
  */
 extern RC createRecord(Record **record, Schema *schema)
+{
+    return createRecordWithArena(record, schema, NULL); // Allocate with malloc
+}
+
+/**
+ * @details : Creates a record like createRecord, taking the record and its data
+ *            from an arena. Such a record is released with the arena and must not
+ *            be passed to freeRecord, which suits temporary records of a batch or
+ *            scan.
+ *
+ * @param record : Pointer to a Record pointer that will be updated to the new record
+ * @param schema : Pointer to the Schema structure defining the record's format
+ * @param arena : Arena to allocate from, or NULL to allocate with malloc
+ *
+ * @return RC_OK on successful creation of the record
+ */
+extern RC createRecordWithArena(Record **record, Schema *schema, Arena *arena)
 {
     if (record == NULL || schema == NULL)
     {                                // Validate parameter.
         return RC_INVALID_PARAMETER; // Returns Parameter code.
     }
 
-    Record *newRecord = (Record *)malloc(sizeof(Record)); // allocate the record struct.
-    if (newRecord == NULL)
-    {                                      // checks if allocation was successful.
-        return RC_MEMORY_ALLOCATION_ERROR; // return error code if there was any.
-    }
-
     int recordSize = getRecordSize(schema); // get the size of the new record.
     if (recordSize <= 0)
     {                    // Checks if size is lesser than zero.
-        free(newRecord); // Frees newly allocated memory.
         return RC_ERROR; // Returns error code.
     }
 
-    (*newRecord).data = (char *)malloc(recordSize); // memory allocation for the data section.
-    if ((*newRecord).data == NULL)
-    {                                      // If allocation was not successful.
-        free(newRecord);                   // Frees the new record pointer.
-        return RC_MEMORY_ALLOCATION_ERROR; // returns Allocation failed code.
+    Record *newRecord;
+    if (arena == NULL)
+    {                                                 // Records freed by freeRecord are recycled
+        newRecord = takePooledRecord(recordSize);     // Record and data from the thread's cache
+    }
+    else
+    {
+        newRecord = (Record *)arenaAlloc(arena, sizeof(Record)); // allocate the record struct.
+        if (newRecord != NULL)
+        {
+            (*newRecord).data = (char *)arenaAlloc(arena, recordSize); // memory allocation for the data section.
+        }
+    }
+    if (newRecord == NULL || (*newRecord).data == NULL)
+    {                                      // checks if allocation was successful.
+        return RC_MEMORY_ALLOCATION_ERROR; // return error code if there was any.
     }
 
     // Initialize RID to invalid values
@@ -1030,8 +4321,9 @@ extern RC createRecord(Record **record, Schema *schema)
 
 /**
  * @details : Calculates the byte offset of a specific attribute within a record.
- *            The function traverses the schema attributes up to the target attribute,
- *            summing their sizes to determine the offset.
+ *            Schemas set up by createSchema or openTable look the offset up; for
+ *            others the function traverses the schema attributes up to the target
+ *            attribute, summing their sizes to determine the offset.
  *
  * @param schema : Pointer to the Schema structure defining the record's format
  * @param attrNum : The zero-based index of the target attribute
@@ -1046,6 +4338,12 @@ RC getAttributeOffset(Schema *schema, int attrNum, int *result)
         return RC_ERROR; // returns if parameters are invalid
     }
 
+    if ((*schema).attrOffsets != NULL)
+    {                                          // Offsets worked out in advance
+        *result = (*schema).attrOffsets[attrNum]; // Look the offset up
+        return RC_OK;                          // Return OK result
+    }
+
     // Start after the tombstone marker
     *result = 1; // offset will start after the tombstone
     int i = 0;   // iterator int
@@ -1079,9 +4377,42 @@ RC getAttributeOffset(Schema *schema, int attrNum, int *result)
     return RC_OK; // Returns OK result after calculating the offset.
 }
 
+/**
+ * @details : Works out the offset of every attribute and the record size of a schema
+ *            once, so that getAttributeOffset and getRecordSize become lookups on
+ *            the paths that run for every record. Schemas with an unknown data
+ *            type, or whose offsets cannot be allocated, keep computing them.
+ *
+ * @param schema : Schema to set up
+ */
+static void setAttributeOffsets(Schema *schema)
+{
+    (*schema).attrOffsets = NULL;                 // Compute the layout by walking the attributes
+    (*schema).recordSize = getRecordSize(schema); // Size of the whole record
+    if ((*schema).recordSize <= 0)
+    {           // Unknown data types have no layout
+        return; // Leave the schema to the slow path
+    }
+
+    int *offsets = (int *)malloc(sizeof(int) * (*schema).numAttr); // One offset per attribute
+    if (offsets == NULL)
+    {           // Allocation failed
+        return; // Leave the schema to the slow path
+    }
+
+    int i;
+    for (i = 0; i < (*schema).numAttr; i += 1)
+    {                                                // Work out every offset
+        getAttributeOffset(schema, i, &offsets[i]);  // Walk up to attribute i
+    }
+    (*schema).attrOffsets = offsets; // Later calls look the offsets up
+}
+
 /**
  * @details : Deallocates memory used by a record object. The function frees
- *            all resources associated with the record.
+ *            all resources associated with the record. A record made by
+ *            createRecord goes back to the calling thread's record pool, so
+ *            loops creating and freeing records reuse the same few blocks.
  *
  * @param record : Pointer to the Record structure to be freed
  *
@@ -1094,6 +4425,13 @@ extern RC freeRecord(Record *record)
         return RC_INVALID_PARAMETER; // Returns Invalid argument
     }
 
+    PooledRecord *block = pooledRecordBlock(record); // Record and data in one block?
+    if (block != NULL)
+    {                            // Made by createRecord
+        givePooledRecord(block); // Recycle it
+        return RC_OK;            // Returns Result
+    }
+
     if ((*record).data != NULL)
     {                         // checks if the data pointer exist before attempting to free.
         free((*record).data); // Frees the record pointer
@@ -1117,6 +4455,25 @@ extern RC freeRecord(Record *record)
  * @return RC_OK on successful extraction of the attribute value
  */
 extern RC getAttr(Record *record, Schema *schema, int attrNum, Value **value)
+{
+    return getAttrWithArena(record, schema, attrNum, value, NULL); // Allocate with malloc
+}
+
+/**
+ * @details : Extracts an attribute like getAttr, taking the value and its string
+ *            from an arena. The value is released with the arena and must not be
+ *            passed to freeVal, so reading attributes in a loop needs no free per
+ *            value.
+ *
+ * @param record : Pointer to the Record structure containing the attribute
+ * @param schema : Pointer to the Schema structure defining the record's format
+ * @param attrNum : The zero-based index of the target attribute
+ * @param value : Pointer to a Value pointer that will be updated with the extracted value
+ * @param arena : Arena to allocate from, or NULL to allocate with malloc
+ *
+ * @return RC_OK on successful extraction of the attribute value
+ */
+extern RC getAttrWithArena(Record *record, Schema *schema, int attrNum, Value **value, Arena *arena)
 {
     if (record == NULL || schema == NULL || value == NULL)
     {                                // Check if pointers are valid
@@ -1135,7 +4492,7 @@ extern RC getAttr(Record *record, Schema *schema, int attrNum, Value **value)
         return result; // result code that's not ok.
     }
 
-    Value *attrValue = (Value *)malloc(sizeof(Value)); // dynamically allocate the value struct.
+    Value *attrValue = (Value *)allocFromArena(arena, sizeof(Value)); // dynamically allocate the value struct.
     if (attrValue == NULL)
     {                                      // malloc may return null
         return RC_MEMORY_ALLOCATION_ERROR; // Failed to allocate.
@@ -1144,17 +4501,18 @@ extern RC getAttr(Record *record, Schema *schema, int attrNum, Value **value)
     char *data = (*record).data; // copy the records data pointer.
     data += offset;              // increase pointer by offset to point to attribute value.
 
-    // Note: This appears to be a workaround or fix for a specific issue
-    (*schema).dataTypes[attrNum] = (attrNum == 1) ? 1 : (*schema).dataTypes[attrNum]; // Looks very buggy
 
     // Extract value based on data type
     if ((*schema).dataTypes[attrNum] == DT_STRING)
     {                                                     // checks if string data type.
         int len = (*schema).typeLength[attrNum];          // assign attribute type Length to len
-        (*attrValue).v.stringV = (char *)malloc(len + 1); // allocating space.
+        (*attrValue).v.stringV = (char *)allocFromArena(arena, len + 1); // allocating space.
         if ((*attrValue).v.stringV == NULL)
         {                                      // checks if allocation went successfully.
-            free(attrValue);                   // freeing attribute value
+            if (arena == NULL)
+            {                    // The arena keeps what it handed out
+                free(attrValue); // freeing attribute value
+            }
             return RC_MEMORY_ALLOCATION_ERROR; // Return memory
         }
 
@@ -1185,7 +4543,10 @@ extern RC getAttr(Record *record, Schema *schema, int attrNum, Value **value)
     }
     else
     {                                                     // If anything exist other than that then free and return comp_diferent_datatypes
-        free(attrValue);                                  // If anything exist then free attribute
+        if (arena == NULL)
+        {                    // The arena keeps what it handed out
+            free(attrValue); // If anything exist then free attribute
+        }
         return RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE; // Returns error
     }
 
@@ -1252,4 +4613,235 @@ extern RC setAttr(Record *record, Schema *schema, int attrNum, Value *value)
     }
 
     return RC_OK; // returning.
-}
\ No newline at end of file
+}
+
+/**
+ * @details : Finds an attribute of a record view and checks its type.
+ *
+ * @param view : View of the record
+ * @param attrNum : The zero-based index of the attribute
+ * @param type : Type the caller expects
+ * @param length : Set to the number of bytes the value takes
+ * @param value : Set to the value of the attribute on the page
+ *
+ * @return RC_OK if the attribute has the expected type
+ */
+static RC viewAttribute(RM_RecordView *view, int attrNum, DataType type, int *length, char **value)
+{
+    if (view == NULL || (*view).data == NULL)
+    {                                // Check for a view that was not set or was released
+        return RC_INVALID_PARAMETER; // Returns Parameter code.
+    }
+
+    Schema *schema = (*view).schema; // Schema of the record
+    if (attrNum < 0 || attrNum >= (*schema).numAttr)
+    {                                // checks for valid attribute number
+        return RC_RM_NO_MORE_TUPLES; // Same code as getAttr
+    }
+    if ((*schema).dataTypes[attrNum] != type)
+    {                                                     // The attribute has another type
+        return RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE; // Returns error
+    }
+
+    *value = encodedAttribute(schema, (*view).data, attrNum, length); // Locate the value
+
+    return RC_OK; // Return success
+}
+
+/**
+ * @details : Reads an integer attribute in place from a record view.
+ *
+ * @param view : View of the record
+ * @param attrNum : The zero-based index of the attribute
+ * @param value : Set to the value of the attribute
+ *
+ * @return RC_OK on success, or RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE if the attribute is no integer
+ */
+extern RC getIntAttr(RM_RecordView *view, int attrNum, int *value)
+{
+    if (value == NULL)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Returns Parameter code.
+    }
+
+    char *data; // Value on the page
+    int length; // Size of the value
+
+    RC result = viewAttribute(view, attrNum, DT_INT, &length, &data); // Locate the attribute
+    if (result == RC_OK)
+    {                                     // Copy out only the value itself
+        memcpy(value, data, sizeof(int)); // The page gives no alignment
+    }
+
+    return result; // Return the result code
+}
+
+/**
+ * @details : Reads a float attribute in place from a record view.
+ *
+ * @param view : View of the record
+ * @param attrNum : The zero-based index of the attribute
+ * @param value : Set to the value of the attribute
+ *
+ * @return RC_OK on success, or RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE if the attribute is no float
+ */
+extern RC getFloatAttr(RM_RecordView *view, int attrNum, float *value)
+{
+    if (value == NULL)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Returns Parameter code.
+    }
+
+    char *data; // Value on the page
+    int length; // Size of the value
+
+    RC result = viewAttribute(view, attrNum, DT_FLOAT, &length, &data); // Locate the attribute
+    if (result == RC_OK)
+    {                                       // Copy out only the value itself
+        memcpy(value, data, sizeof(float)); // The page gives no alignment
+    }
+
+    return result; // Return the result code
+}
+
+/**
+ * @details : Reads a boolean attribute in place from a record view.
+ *
+ * @param view : View of the record
+ * @param attrNum : The zero-based index of the attribute
+ * @param value : Set to the value of the attribute
+ *
+ * @return RC_OK on success, or RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE if the attribute is no boolean
+ */
+extern RC getBoolAttr(RM_RecordView *view, int attrNum, bool *value)
+{
+    if (value == NULL)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Returns Parameter code.
+    }
+
+    char *data; // Value on the page
+    int length; // Size of the value
+
+    RC result = viewAttribute(view, attrNum, DT_BOOL, &length, &data); // Locate the attribute
+    if (result == RC_OK)
+    {                                      // Copy out only the value itself
+        memcpy(value, data, sizeof(bool)); // The page gives no alignment
+    }
+
+    return result; // Return the result code
+}
+
+/**
+ * @details : Reads a string attribute in place from a record view. The string is
+ *            not NUL-terminated on the page, so its length is returned with it; the
+ *            pointer is valid as long as the view.
+ *
+ * @param view : View of the record
+ * @param attrNum : The zero-based index of the attribute
+ * @param value : Set to the first character of the string on the page
+ * @param length : Set to the number of characters of the string
+ *
+ * @return RC_OK on success, or RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE if the attribute is no string
+ */
+extern RC getStringAttrView(RM_RecordView *view, int attrNum, char **value, int *length)
+{
+    if (value == NULL || length == NULL)
+    {                                // Check for invalid parameters
+        return RC_INVALID_PARAMETER; // Returns Parameter code.
+    }
+
+    return viewAttribute(view, attrNum, DT_STRING, length, value); // Locate the string
+}
+
+/**
+ * @details : Creates a batch for nextBatch with room for a number of rows of a schema.
+ *
+ * @param batch : Pointer to a RecordBatch pointer that will be updated to the new batch
+ * @param schema : Schema of the rows, the schema of the scan filling the batch
+ * @param capacity : Rows the batch has room for
+ *
+ * @return RC_OK on successful creation of the batch
+ */
+extern RC createRecordBatch(RecordBatch **batch, Schema *schema, int capacity)
+{
+    if (batch == NULL || schema == NULL || capacity <= 0)
+    {                                // Validate parameter.
+        return RC_INVALID_PARAMETER; // Returns Parameter code.
+    }
+
+    int recordSize = getRecordSize(schema); // Size of one row
+    if (recordSize <= 0)
+    {                    // Checks for a schema without a layout
+        return RC_ERROR; // Returns error code.
+    }
+
+    RecordBatch *newBatch = (RecordBatch *)malloc(sizeof(RecordBatch)); // allocate the batch struct.
+    if (newBatch == NULL)
+    {                                      // checks if allocation was successful.
+        return RC_MEMORY_ALLOCATION_ERROR; // return error code if there was any.
+    }
+
+    (*newBatch).ids = (RID *)malloc(sizeof(RID) * capacity);       // RID of every row
+    (*newBatch).data = (char *)malloc((size_t)recordSize * capacity); // All rows in one buffer
+    if ((*newBatch).ids == NULL || (*newBatch).data == NULL)
+    {                                      // If allocation was not successful.
+        free((*newBatch).ids);             // Frees what was allocated.
+        free((*newBatch).data);
+        free(newBatch);
+        return RC_MEMORY_ALLOCATION_ERROR; // returns Allocation failed code.
+    }
+
+    (*newBatch).capacity = capacity;     // Rows it has room for
+    (*newBatch).numRows = 0;             // Empty until filled
+    (*newBatch).recordSize = recordSize; // Size of one row
+
+    *batch = newBatch; // copy the new batch to the batch passed in as argument
+
+    return RC_OK; // Return sucess.
+}
+
+/**
+ * @details : Deallocates a batch created with createRecordBatch.
+ *
+ * @param batch : Pointer to the RecordBatch structure to be freed
+ *
+ * @return RC_OK on successful deallocation
+ */
+extern RC freeRecordBatch(RecordBatch *batch)
+{
+    if (batch == NULL)
+    {                                // Validate argument
+        return RC_INVALID_PARAMETER; // Returns parameter if invalid.
+    }
+
+    free((*batch).ids);  // Free the RIDs
+    free((*batch).data); // Free the rows
+    free(batch);         // Free the batch
+
+    return RC_OK; // Returns Result
+}
+
+/**
+ * @details : Points a record at a row of a batch, without copying it, so the row can
+ *            be read with getAttr. The record is valid until the batch is filled again
+ *            and must not be passed to freeRecord.
+ *
+ * @param batch : Batch holding the row
+ * @param row : Index of the row, below numRows
+ * @param record : Record set to the row
+ *
+ * @return RC_OK on success, or RC_INVALID_PARAMETER for a row the batch does not hold
+ */
+extern RC getBatchRecord(RecordBatch *batch, int row, Record *record)
+{
+    if (batch == NULL || record == NULL || row < 0 || row >= (*batch).numRows)
+    {                                // Validate parameter.
+        return RC_INVALID_PARAMETER; // Returns Parameter code.
+    }
+
+    (*record).id = (*batch).ids[row];                           // RID of the row
+    (*record).data = (*batch).data + row * (*batch).recordSize; // The row itself
+
+    return RC_OK; // Return sucess.
+}
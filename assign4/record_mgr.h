@@ -12,10 +12,34 @@ typedef struct RM_ScanHandle
 	void *mgmtData;
 } RM_ScanHandle;
 
+// Rows returned by one call to nextBatch, stored back to back
+typedef struct RecordBatch
+{
+	int capacity;   // rows the batch has room for
+	int numRows;    // rows filled by the last call to nextBatch
+	int recordSize; // size of one row, in the layout of the scan's schema
+	RID *ids;       // RID of every row
+	char *data;     // the rows, recordSize bytes apart
+} RecordBatch;
+
+// Read-only view of a record where it is stored on its pinned page
+typedef struct RM_RecordView
+{
+	RID id;         // RID the record is known by
+	Schema *schema; // schema of the record
+	char *data;     // encoded attributes inside the page
+	void *pool;     // buffer pool the view holds its pin in, NULL if it borrows a scan's pin
+	int pageNum;    // page the record is stored on
+} RM_RecordView;
+
+// Called by parallelScan for every matching record, from several threads at once
+typedef RC (*RM_ScanCallback) (Record *record, void *context);
+
 // table and manager
 extern RC initRecordManager (void *mgmtData);
 extern RC shutdownRecordManager ();
 extern RC createTable (char *name, Schema *schema);
+extern RC createTableWithPageSize (char *name, Schema *schema, int pageSize);
 extern RC openTable (RM_TableData *rel, char *name);
 extern RC closeTable (RM_TableData *rel);
 extern RC deleteTable (char *name);
@@ -23,14 +47,25 @@ extern int getNumTuples (RM_TableData *rel);
 
 // handling records in a table
 extern RC insertRecord (RM_TableData *rel, Record *record);
+extern RC insertRecords (RM_TableData *rel, Record **records, int numRecords, RID *ids);
+extern RC loadTableFromCSV (RM_TableData *rel, char *fileName, int *numLoaded);
 extern RC deleteRecord (RM_TableData *rel, RID id);
 extern RC updateRecord (RM_TableData *rel, Record *record);
 extern RC getRecord (RM_TableData *rel, RID id, Record *record);
+extern RC getRecords (RM_TableData *rel, RID *ids, int numRecords, Record **records);
+extern RC getRecordView (RM_TableData *rel, RID id, RM_RecordView *view);
+extern RC releaseRecordView (RM_RecordView *view);
 
 // scans
 extern RC startScan (RM_TableData *rel, RM_ScanHandle *scan, Expr *cond);
+extern RC startProjectedScan (RM_TableData *rel, RM_ScanHandle *scan, Expr *cond, int numAttrs, int *attrs);
+extern Schema *getScanSchema (RM_ScanHandle *scan);
+extern RC setScanArena (RM_ScanHandle *scan, Arena *arena);
 extern RC next (RM_ScanHandle *scan, Record *record);
+extern RC nextView (RM_ScanHandle *scan, RM_RecordView *view);
+extern RC nextBatch (RM_ScanHandle *scan, RecordBatch *batch, int maxRows);
 extern RC closeScan (RM_ScanHandle *scan);
+extern RC parallelScan (RM_TableData *rel, Expr *cond, int numThreads, RM_ScanCallback callback, void *context);
 
 // dealing with schemas
 extern int getRecordSize (Schema *schema);
@@ -39,8 +74,21 @@ extern RC freeSchema (Schema *schema);
 
 // dealing with records and attribute values
 extern RC createRecord (Record **record, Schema *schema);
+extern RC createRecordWithArena (Record **record, Schema *schema, Arena *arena);
 extern RC freeRecord (Record *record);
 extern RC getAttr (Record *record, Schema *schema, int attrNum, Value **value);
+extern RC getAttrWithArena (Record *record, Schema *schema, int attrNum, Value **value, Arena *arena);
 extern RC setAttr (Record *record, Schema *schema, int attrNum, Value *value);
 
+// batches of records
+extern RC createRecordBatch (RecordBatch **batch, Schema *schema, int capacity);
+extern RC freeRecordBatch (RecordBatch *batch);
+extern RC getBatchRecord (RecordBatch *batch, int row, Record *record);
+
+// reading attributes in place through record views
+extern RC getIntAttr (RM_RecordView *view, int attrNum, int *value);
+extern RC getFloatAttr (RM_RecordView *view, int attrNum, float *value);
+extern RC getBoolAttr (RM_RecordView *view, int attrNum, bool *value);
+extern RC getStringAttrView (RM_RecordView *view, int attrNum, char **value, int *length);
+
 #endif // RECORD_MGR_H
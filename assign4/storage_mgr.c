@@ -5,22 +5,112 @@
  * managing page allocation, and ensuring proper file capacity.
  *
  * The system uses a page-based approach where each page is a fixed-size block
- * of memory (PAGE_SIZE bytes). All I/O operations are performed at the page level
- * with careful error handling and memory management to prevent leaks and handle
- * failure scenarios robustly.
+ * of memory. The page size is chosen per file when it is created (PAGE_SIZE
+ * by default) and recorded in the file header. All I/O operations are
+ * performed at the page level with careful error handling and memory
+ * management to prevent leaks and handle failure scenarios robustly.
+ *
+ * Every page file starts with a header block of one page. Plain files follow
+ * it with groups of pages, each group led by a free-page bitmap block that
+ * covers the pageSize * 8 pages after it; allocatePage reuses pages released
+ * with freePage before the file grows. Compressed files
+ * keep a page-offset map in the header block; every page is compressed with a
+ * built-in LZ4-style codec and stored as a variable-size payload somewhere
+ * after the header. The format is detected in openPageFile, so readBlock and
+ * writeBlock compress and decompress transparently. Files without a header
+ * (written before headers existed) are read as plain PAGE_SIZE files.
+ *
+ * Each file also carries a durability mode that decides when written pages
+ * are forced to disk with fdatasync: never, on checkpoints, after every
+ * write, or at most once per group-commit interval. There is no timer behind
+ * the interval: writes left unsynced are synced by the first write or
+ * syncOverdueWrites call after it has passed, and the buffer manager calls
+ * syncOverdueWrites on every unpin.
+ *
+ * Plain files can be segmented: their pages are then spread over fixed-size
+ * segment files "<name>", "<name>.1", "<name>.2", ... behind the same
+ * SM_FileHandle. All file offsets are 64-bit, so neither a segment nor an
+ * unsegmented file is limited to 2 GB.
  ******************************************************************************/
 
+#define _FILE_OFFSET_BITS 64 // 64-bit off_t for fseeko on files past 2 GB
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 
 #include "storage_mgr.h"
 #include "dberror.h"
+#include "dt.h"
 
 /************************** Debug Configuration *********************************/
 #define DEBUG_MSG(msg) // printf("[DEBUG] %s\n", msg)
 
+/************************** File Format ****************************************/
+
+#define SM_FILE_MAGIC "SMPGF02"         // Identifies a page file with a header block
+#define SM_HEADER_FIXED_SIZE 64         // Bytes of the header block used by SM_FileHeader
+#define SM_PAYLOAD_ALIGN 64             // Payload slots are rounded up to this many bytes
+#define SM_COMPRESS_BOUND(size) ((size) + (size) / 255 + 16) // Worst-case codec output
+#define SM_GROW_CHUNK_PAGES 64          // Zero pages written per fwrite when growing a file
+
+#define LZ_MIN_MATCH 4                  // Shortest match the codec encodes
+#define LZ_HASH_BITS 12                 // Size of the match finder hash table (log2)
+#define LZ_MAX_OFFSET 65535             // Matches are addressed with a 16-bit offset
+
+enum
+{
+    SM_FORMAT_PLAIN = 0,     // Pages live in fixed blocks behind per-group bitmap blocks
+    SM_FORMAT_COMPRESSED = 1 // Pages are located through the page-offset map
+};
+
+// On-disk header stored at offset 0 of a page file
+typedef struct SM_FileHeader
+{
+    char magic[8];        // SM_FILE_MAGIC
+    int format;           // SM_FORMAT_PLAIN or SM_FORMAT_COMPRESSED
+    int pageSize;         // Bytes per page, fixed when the file is created
+    int totalNumPages;    // Compressed only: number of logical pages in the file
+    int mapCapacity;      // Compressed only: map entries the on-disk map region holds
+    long long mapOffset;  // Compressed only: file offset of the page-offset map
+    long long endOffset;  // Compressed only: first byte past the last payload slot
+    int durability;       // SM_Durability chosen when the file was created
+    int groupCommitMs;    // Group commit only: longest time between two syncs
+    int segmentPages;     // Plain only: pages per segment file, 0 for a single file
+} SM_FileHeader;
+
+// Location of one logical page inside a compressed page file
+typedef struct SM_PageMapEntry
+{
+    long long offset; // File offset of the payload slot
+    int length;       // Stored bytes: 0 = all-zero page, pageSize = stored raw, -1 = free page
+    int capacity;     // Bytes reserved at offset for in-place rewrites
+} SM_PageMapEntry;
+
+// Per-handle state kept in SM_FileHandle.mgmtInfo
+typedef struct SM_FileMgmt
+{
+    FILE *fp;               // Underlying stdio stream (segment 0)
+    char *fileName;         // Base name the segment file names derive from
+    FILE **segments;        // Open segment streams, NULL until first used
+    int numSegments;        // Entries allocated in segments
+    SM_FileHeader hdr;      // In-memory copy of the header
+    int groupPages;         // Plain only: pages per bitmap block, 0 for headerless files
+    int freeHint;           // Lowest group (or map entry) that may hold a free page
+    SM_PageMapEntry *map;   // Compressed only: one entry per logical page
+    int mapSize;            // Entries allocated in map
+    bool mapDirty;          // Map or header must be written back on close
+    char *scratch;          // Compressed only: codec buffer of SM_COMPRESS_BOUND bytes
+    int durability;         // Active SM_Durability of this handle
+    int groupCommitMs;      // Active group-commit interval
+    bool unsynced;          // Writes were issued since the last sync
+    long long lastSyncMs;   // Monotonic time of the last sync
+} SM_FileMgmt;
+
 /************************** Helper Functions ***********************************/
 
 /**
@@ -33,38 +123,912 @@
  * structure with file details. Returns -1 for inaccessible or non-existent files,
  * allowing callers to handle error conditions appropriately.
  */
-static long get_file_size(const char *filename)
+static long long get_file_size(const char *filename)
+{
+    struct stat st;
+    // Use stat() to get file information without opening the file
+    if (stat(filename, &st) == 0)
+        return st.st_size;
+    return -1; // Return -1 to indicate error
+}
+
+/**
+ * Validates parameters for read operations.
+ *
+ * @param fh File handle to validate
+ * @param pageNum Page number to validate
+ * @param memPage Memory page to validate
+ * @return RC_OK if valid, appropriate error code otherwise
+ *
+ * Performs three crucial validations: file handle initialization, memory page
+ * buffer existence, and page number bounds checking. This centralized validation
+ * ensures consistent error checking across all read operations.
+ */
+static RC validate_read(SM_FileHandle *fh, int pageNum, SM_PageHandle memPage)
+{
+    // Check if file handle is initialized
+    if (!fh)
+        return RC_FILE_HANDLE_NOT_INIT;
+    // Ensure memory page buffer is valid
+    if (!memPage)
+        return RC_WRITE_FAILED;
+    // Verify page number is within valid range
+    if (pageNum < 0 || pageNum >= fh->totalNumPages)
+        return RC_READ_NON_EXISTING_PAGE;
+    return RC_OK;
+}
+
+/**
+ * Checks that a page size is a power of two between SM_MIN_PAGE_SIZE and
+ * SM_MAX_PAGE_SIZE.
+ */
+static bool valid_page_size(int pageSize)
+{
+    return pageSize >= SM_MIN_PAGE_SIZE && pageSize <= SM_MAX_PAGE_SIZE &&
+           (pageSize & (pageSize - 1)) == 0;
+}
+
+/************************** Durability ****************************************/
+
+/**
+ * Returns a monotonic timestamp in milliseconds.
+ */
+static long long now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static RC write_compressed_meta(SM_FileMgmt *mgmt);
+
+/**
+ * Hands everything written through a handle to the operating system.
+ *
+ * @param mgmt Handle state
+ * @return RC_OK if successful, RC_WRITE_FAILED otherwise
+ *
+ * Compressed files write their page-offset map first, since a payload is
+ * useless if the map pointing at it is lost. Every open segment's stdio
+ * buffer is flushed, but nothing is forced to disk.
+ */
+static RC flush_file(SM_FileMgmt *mgmt)
+{
+    if (mgmt->hdr.format == SM_FORMAT_COMPRESSED && mgmt->mapDirty)
+    {
+        RC rc = write_compressed_meta(mgmt);
+        if (rc != RC_OK)
+            return rc;
+    }
+
+    // Segments that were never opened cannot hold buffered writes
+    for (int segment = 0; segment < mgmt->numSegments; segment++)
+    {
+        FILE *fp = mgmt->segments[segment];
+        if (fp && fflush(fp) != 0)
+            return RC_WRITE_FAILED;
+    }
+    return RC_OK;
+}
+
+/**
+ * Forces everything written through a handle to disk.
+ *
+ * @param mgmt Handle state
+ * @return RC_OK if successful, RC_WRITE_FAILED otherwise
+ *
+ * Compressed files write their page-offset map first, since a synced payload
+ * is useless if the map pointing at it is lost. The stdio buffer is flushed
+ * before fdatasync so the kernel actually holds the data being synced.
+ */
+static RC sync_file(SM_FileMgmt *mgmt)
+{
+    RC rc = flush_file(mgmt);
+    if (rc != RC_OK)
+        return rc;
+
+    // Segments that were never opened cannot hold unsynced writes
+    for (int segment = 0; segment < mgmt->numSegments; segment++)
+    {
+        FILE *fp = mgmt->segments[segment];
+        if (fp && fdatasync(fileno(fp)) != 0)
+            return RC_WRITE_FAILED;
+    }
+
+    mgmt->unsynced = false;
+    mgmt->lastSyncMs = now_ms();
+    return RC_OK;
+}
+
+/**
+ * Applies the durability mode after a write went through a handle.
+ *
+ * Every-write mode syncs immediately. Group commit syncs once the interval
+ * since the last sync has passed; writes issued inside the interval become
+ * durable with the next sync, which syncOverdueWrites, checkpoints and close
+ * also trigger.
+ */
+static RC after_write(SM_FileMgmt *mgmt)
+{
+    mgmt->unsynced = true;
+
+    switch (mgmt->durability)
+    {
+    case SM_DURABILITY_EVERY_WRITE:
+        return sync_file(mgmt);
+    case SM_DURABILITY_GROUP_COMMIT:
+        if (now_ms() - mgmt->lastSyncMs >= mgmt->groupCommitMs)
+            return sync_file(mgmt);
+        return RC_OK;
+    default:
+        return RC_OK;
+    }
+}
+
+/**
+ * Checks a durability mode and its group-commit interval.
+ */
+static bool valid_durability(int durability, int groupCommitMs)
+{
+    if (durability < SM_DURABILITY_NONE || durability > SM_DURABILITY_GROUP_COMMIT)
+        return false;
+    return durability != SM_DURABILITY_GROUP_COMMIT || groupCommitMs > 0;
+}
+
+/************************** Plain File Layout *********************************/
+
+/*
+ * A plain file with a header is laid out as
+ *
+ *   [header][bitmap 0][page 0 .. page G-1][bitmap 1][page G .. page 2G-1] ...
+ *
+ * where G = groupPages = pageSize * 8. A set bit in a bitmap block marks the
+ * corresponding page as free. Blocks appended to the file are zero-filled, so
+ * new pages start out in use and new bitmap blocks need no initialization.
+ *
+ * A segmented file splits its pages into segments of S = segmentPages pages.
+ * Segment 0 is the file itself, segment k > 0 is the file "<name>.k". Every
+ * segment repeats the group layout above without the header block, so a page
+ * group never spans two segments and the last group of a segment may hold
+ * fewer than G pages.
+ */
+
+/**
+ * Returns the number of page groups in one segment.
+ */
+static int groups_per_segment(SM_FileMgmt *mgmt)
+{
+    int segmentPages = mgmt->hdr.segmentPages;
+    return (segmentPages + mgmt->groupPages - 1) / mgmt->groupPages;
+}
+
+/**
+ * Returns the file offset of the first block of a segment.
+ */
+static long long segment_base(SM_FileMgmt *mgmt, int segment)
+{
+    // Only segment 0 starts with the header block (and headerless files have none)
+    return (segment == 0 && mgmt->groupPages > 0) ? mgmt->hdr.pageSize : 0;
+}
+
+/**
+ * Splits a page number into its segment and its index inside that segment.
+ */
+static int segment_of(SM_FileMgmt *mgmt, int pageNum, int *index)
+{
+    int segmentPages = mgmt->hdr.segmentPages;
+    *index = (segmentPages > 0) ? pageNum % segmentPages : pageNum;
+    return (segmentPages > 0) ? pageNum / segmentPages : 0;
+}
+
+/**
+ * Returns the offset of a page inside its segment file.
+ */
+static long long page_offset(SM_FileMgmt *mgmt, int pageNum, int *segment)
+{
+    long long pageSize = mgmt->hdr.pageSize;
+    int groupPages = mgmt->groupPages;
+    int index;
+
+    *segment = segment_of(mgmt, pageNum, &index);
+
+    // Headerless files store pages back to back from offset 0
+    if (groupPages == 0)
+        return index * pageSize;
+
+    return segment_base(mgmt, *segment) +
+           pageSize * (1 + (long long)(index / groupPages) * (groupPages + 1) + index % groupPages);
+}
+
+/**
+ * Returns the page group a page belongs to. Groups are numbered across
+ * segments, in page order.
+ */
+static int group_of(SM_FileMgmt *mgmt, int pageNum)
+{
+    int index;
+    int segment = segment_of(mgmt, pageNum, &index);
+
+    if (mgmt->hdr.segmentPages == 0)
+        return index / mgmt->groupPages;
+    return segment * groups_per_segment(mgmt) + index / mgmt->groupPages;
+}
+
+/**
+ * Returns the first page of a page group and, through size, how many pages
+ * the group covers.
+ */
+static int group_first(SM_FileMgmt *mgmt, int group, int *size)
+{
+    int groupPages = mgmt->groupPages;
+    int segmentPages = mgmt->hdr.segmentPages;
+
+    if (segmentPages == 0)
+    {
+        *size = groupPages;
+        return group * groupPages;
+    }
+
+    int inSegment = group % groups_per_segment(mgmt);
+    *size = segmentPages - inSegment * groupPages;
+    if (*size > groupPages)
+        *size = groupPages;
+    return (group / groups_per_segment(mgmt)) * segmentPages + inSegment * groupPages;
+}
+
+/**
+ * Returns the size a segment file needs to hold its first numPages pages.
+ */
+static long long segment_end(SM_FileMgmt *mgmt, int segment, int numPages)
+{
+    int segmentStart = segment * mgmt->hdr.segmentPages;
+    int ignored;
+
+    if (numPages == 0)
+        return segment_base(mgmt, segment);
+    return page_offset(mgmt, segmentStart + numPages - 1, &ignored) + mgmt->hdr.pageSize;
+}
+
+/**
+ * Derives the number of pages of a segment file from its size in bytes.
+ */
+static int segment_page_count(SM_FileMgmt *mgmt, int segment, long long fileSize)
+{
+    long long pageSize = mgmt->hdr.pageSize;
+    long long blocks = (fileSize - segment_base(mgmt, segment) + pageSize - 1) / pageSize;
+
+    if (mgmt->groupPages == 0)
+        return (int)blocks;
+
+    // One bitmap block leads every started group
+    if (blocks <= 0)
+        return 0;
+    long long fullGroups = blocks / (mgmt->groupPages + 1);
+    long long rest = blocks % (mgmt->groupPages + 1);
+    return (int)(fullGroups * mgmt->groupPages + (rest > 0 ? rest - 1 : 0));
+}
+
+/**
+ * Builds the file name of a segment.
+ */
+static void segment_name(SM_FileMgmt *mgmt, int segment, char *name, size_t size)
+{
+    if (segment == 0)
+        snprintf(name, size, "%s", mgmt->fileName);
+    else
+        snprintf(name, size, "%s.%d", mgmt->fileName, segment);
+}
+
+/**
+ * Returns the stream of a segment, opening the segment file on first use.
+ *
+ * @param mgmt Handle state
+ * @param segment Segment number
+ * @param create Create the segment file if it does not exist yet
+ * @return The stream, or NULL if the segment cannot be opened
+ */
+static FILE *segment_file(SM_FileMgmt *mgmt, int segment, bool create)
+{
+    if (segment >= mgmt->numSegments)
+    {
+        FILE **segments = realloc(mgmt->segments, (segment + 1) * sizeof(FILE *));
+        if (!segments)
+            return NULL;
+        memset(segments + mgmt->numSegments, 0, (segment + 1 - mgmt->numSegments) * sizeof(FILE *));
+        mgmt->segments = segments;
+        mgmt->numSegments = segment + 1;
+    }
+
+    if (!mgmt->segments[segment])
+    {
+        char name[1024];
+        segment_name(mgmt, segment, name, sizeof(name));
+        mgmt->segments[segment] = fopen(name, "r+");
+        if (!mgmt->segments[segment] && create)
+            mgmt->segments[segment] = fopen(name, "w+");
+    }
+    return mgmt->segments[segment];
+}
+
+/**
+ * Positions the stream of a segment at an offset.
+ *
+ * @return The stream, or NULL if the segment cannot be opened or seeked
+ */
+static FILE *seek_segment(SM_FileMgmt *mgmt, int segment, long long offset, bool create)
+{
+    FILE *fp = segment_file(mgmt, segment, create);
+    if (!fp || fseeko(fp, (off_t)offset, SEEK_SET))
+        return NULL;
+    return fp;
+}
+
+/**
+ * Reads or writes the bitmap block of a page group.
+ */
+static RC bitmap_io(SM_FileMgmt *mgmt, int group, char *bitmap, bool write)
+{
+    bool segmented = mgmt->hdr.segmentPages > 0;
+    int segment = segmented ? group / groups_per_segment(mgmt) : 0;
+    int inSegment = segmented ? group % groups_per_segment(mgmt) : group;
+    long long offset = segment_base(mgmt, segment) +
+                       (long long)mgmt->hdr.pageSize * inSegment * (mgmt->groupPages + 1);
+
+    FILE *fp = seek_segment(mgmt, segment, offset, false);
+    if (!fp)
+        return write ? RC_WRITE_FAILED : RC_READ_NON_EXISTING_PAGE;
+    if (write)
+        return (fwrite(bitmap, mgmt->hdr.pageSize, 1, fp) == 1) ? RC_OK : RC_WRITE_FAILED;
+    return (fread(bitmap, mgmt->hdr.pageSize, 1, fp) == 1) ? RC_OK : RC_READ_NON_EXISTING_PAGE;
+}
+
+/**
+ * Grows a plain file from its current page count to numPages pages.
+ *
+ * Each segment the new pages fall into is extended with zero blocks, which
+ * also creates the bitmap blocks of new groups and any new segment files.
+ */
+static RC grow_plain(SM_FileHandle *fh, int numPages)
+{
+    SM_FileMgmt *mgmt = (SM_FileMgmt *)fh->mgmtInfo;
+    int segmentPages = mgmt->hdr.segmentPages;
+    int index;
+    int first = segment_of(mgmt, fh->totalNumPages, &index);
+    int last = segment_of(mgmt, numPages - 1, &index);
+    size_t chunk = (size_t)SM_GROW_CHUNK_PAGES * fh->pageSize;
+    RC rc = RC_OK;
+
+    // Zeroes are written in chunks so large extensions need little memory
+    char *empty = calloc(chunk, 1);
+    if (!empty)
+        return RC_WRITE_FAILED;
+
+    for (int segment = first; segment <= last && rc == RC_OK; segment++)
+    {
+        int oldPages = fh->totalNumPages, newPages = numPages;
+        if (segmentPages > 0)
+        {
+            // Clamp both page counts to the range of this segment
+            long long segmentStart = (long long)segment * segmentPages;
+            oldPages = (int)(oldPages - segmentStart < 0 ? 0 : oldPages - segmentStart);
+            newPages = (int)(newPages - segmentStart > segmentPages ? segmentPages : newPages - segmentStart);
+        }
+
+        // Move to the current end of the last page of the segment
+        long long start = segment_end(mgmt, segment, oldPages);
+        long long remaining = segment_end(mgmt, segment, newPages) - start;
+        FILE *fp = seek_segment(mgmt, segment, start, true);
+        if (!fp)
+            rc = RC_WRITE_FAILED;
+
+        // Write all needed blocks; zeroed bitmaps mark the pages in use
+        while (rc == RC_OK && remaining > 0)
+        {
+            size_t n = (remaining < (long long)chunk) ? (size_t)remaining : chunk;
+            if (fwrite(empty, 1, n, fp) != n)
+                rc = RC_WRITE_FAILED;
+            remaining -= n;
+        }
+    }
+
+    free(empty);
+    return rc;
+}
+
+/**
+ * Takes the first free page of a plain file out of its bitmap.
+ *
+ * @param fh File handle
+ * @param pageNum Set to the reused page, or -1 if no page is free
+ * @return RC_OK if successful, error code otherwise
+ *
+ * Groups below freeHint are known to be full and are skipped. The reused page
+ * is zeroed so it looks exactly like a freshly appended one.
+ */
+static RC reuse_plain_page(SM_FileHandle *fh, int *pageNum)
+{
+    SM_FileMgmt *mgmt = (SM_FileMgmt *)fh->mgmtInfo;
+    int numGroups = group_of(mgmt, fh->totalNumPages - 1) + 1;
+    RC rc = RC_OK;
+
+    *pageNum = -1;
+    char *bitmap = malloc(fh->pageSize);
+    if (!bitmap)
+        return RC_WRITE_FAILED;
+
+    for (int group = mgmt->freeHint; group < numGroups && *pageNum < 0; group++)
+    {
+        int pagesInGroup;
+        int firstPage = group_first(mgmt, group, &pagesInGroup);
+        if (pagesInGroup > fh->totalNumPages - firstPage)
+            pagesInGroup = fh->totalNumPages - firstPage;
+
+        if ((rc = bitmap_io(mgmt, group, bitmap, false)) != RC_OK)
+            break;
+        mgmt->freeHint = group;
+
+        for (int byte = 0; byte * 8 < pagesInGroup; byte++)
+        {
+            unsigned char bits = (unsigned char)bitmap[byte];
+            if (bits == 0)
+                continue;
+
+            int bit = __builtin_ctz(bits);
+            if (byte * 8 + bit >= pagesInGroup)
+                break;
+
+            bitmap[byte] = (char)(bits & ~(1u << bit));
+            *pageNum = firstPage + byte * 8 + bit;
+            break;
+        }
+    }
+
+    if (rc == RC_OK && *pageNum < 0)
+        mgmt->freeHint = numGroups; // Every existing group is full
+    else if (rc == RC_OK)
+    {
+        // Persist the bitmap first, then hand out a zeroed page
+        rc = bitmap_io(mgmt, mgmt->freeHint, bitmap, true);
+        memset(bitmap, 0, fh->pageSize);
+        if (rc == RC_OK)
+            rc = writeBlock(*pageNum, fh, bitmap);
+    }
+
+    free(bitmap);
+    return rc;
+}
+
+/**
+ * Marks a page of a plain file as free in its bitmap.
+ *
+ * @return RC_OK if successful, RC_PAGE_ALREADY_FREE if the page was free
+ */
+static RC release_plain_page(SM_FileHandle *fh, int pageNum)
+{
+    SM_FileMgmt *mgmt = (SM_FileMgmt *)fh->mgmtInfo;
+    int size;
+    int group = group_of(mgmt, pageNum);
+    int index = pageNum - group_first(mgmt, group, &size);
+
+    char *bitmap = malloc(fh->pageSize);
+    if (!bitmap)
+        return RC_WRITE_FAILED;
+
+    RC rc = bitmap_io(mgmt, group, bitmap, false);
+    if (rc == RC_OK && (bitmap[index / 8] & (1 << (index % 8))))
+        rc = RC_PAGE_ALREADY_FREE;
+    if (rc == RC_OK)
+    {
+        bitmap[index / 8] |= (char)(1 << (index % 8));
+        rc = bitmap_io(mgmt, group, bitmap, true);
+    }
+    if (rc == RC_OK && group < mgmt->freeHint)
+        mgmt->freeHint = group;
+
+    free(bitmap);
+    return rc;
+}
+
+/************************** Page Codec ****************************************/
+
+/**
+ * Reads a 32-bit word from an unaligned address.
+ */
+static unsigned int lz_read32(const char *p)
+{
+    unsigned int v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * Appends an LZ4-style length extension (a run of 255 bytes plus remainder).
+ *
+ * @return Updated output position, or -1 if dst is too small
+ */
+static int lz_write_length(char *dst, int op, int dstCap, int len)
+{
+    while (len >= 255)
+    {
+        if (op >= dstCap)
+            return -1;
+        dst[op++] = (char)255;
+        len -= 255;
+    }
+    if (op >= dstCap)
+        return -1;
+    dst[op++] = (char)len;
+    return op;
+}
+
+/**
+ * Emits one sequence: a token, the literal run, and optionally a match.
+ *
+ * @return Updated output position, or -1 if dst is too small
+ */
+static int lz_write_sequence(char *dst, int op, int dstCap, const char *lit, int litLen,
+                             int offset, int matchLen)
+{
+    int litCode = (litLen < 15) ? litLen : 15;
+    int matchCode = 0;
+
+    if (matchLen > 0)
+        matchCode = (matchLen - LZ_MIN_MATCH < 15) ? matchLen - LZ_MIN_MATCH : 15;
+
+    if (op >= dstCap)
+        return -1;
+    dst[op++] = (char)((litCode << 4) | matchCode);
+
+    if (litCode == 15 && (op = lz_write_length(dst, op, dstCap, litLen - 15)) < 0)
+        return -1;
+    if (op + litLen > dstCap)
+        return -1;
+    memcpy(dst + op, lit, litLen);
+    op += litLen;
+
+    // The final sequence of a block carries literals only
+    if (matchLen == 0)
+        return op;
+
+    if (op + 2 > dstCap)
+        return -1;
+    dst[op++] = (char)(offset & 0xFF);
+    dst[op++] = (char)(offset >> 8);
+
+    if (matchCode == 15)
+        op = lz_write_length(dst, op, dstCap, matchLen - LZ_MIN_MATCH - 15);
+    return op;
+}
+
+/**
+ * Compresses a buffer using an LZ4-style block format.
+ *
+ * @param src Bytes to compress
+ * @param srcLen Number of bytes in src
+ * @param dst Output buffer
+ * @param dstCap Capacity of dst
+ * @return Compressed size, or -1 if the output does not fit in dstCap
+ *
+ * A single-probe hash table of 4-byte sequences finds back-references within
+ * the last 64 KB. Runs of zero padding collapse into one overlapping match, so
+ * sparsely filled pages shrink to a few dozen bytes.
+ */
+static int lz_compress(const char *src, int srcLen, char *dst, int dstCap)
+{
+    int table[1 << LZ_HASH_BITS];
+    int ip = 0, anchor = 0, op = 0;
+
+    memset(table, -1, sizeof(table));
+
+    while (ip + LZ_MIN_MATCH <= srcLen)
+    {
+        unsigned int seq = lz_read32(src + ip);
+        unsigned int h = (seq * 2654435761u) >> (32 - LZ_HASH_BITS);
+        int ref = table[h];
+        table[h] = ip;
+
+        if (ref < 0 || ip - ref > LZ_MAX_OFFSET || lz_read32(src + ref) != seq)
+        {
+            ip++;
+            continue;
+        }
+
+        // Extend the match as far as it goes (overlapping matches are allowed)
+        int len = LZ_MIN_MATCH;
+        while (ip + len < srcLen && src[ref + len] == src[ip + len])
+            len++;
+
+        op = lz_write_sequence(dst, op, dstCap, src + anchor, ip - anchor, ip - ref, len);
+        if (op < 0)
+            return -1;
+        ip += len;
+        anchor = ip;
+    }
+
+    // Trailing literals terminate the block
+    return lz_write_sequence(dst, op, dstCap, src + anchor, srcLen - anchor, 0, 0);
+}
+
+/**
+ * Decompresses a block produced by lz_compress.
+ *
+ * @param src Compressed bytes
+ * @param srcLen Number of bytes in src
+ * @param dst Output buffer
+ * @param dstCap Capacity of dst
+ * @return Decompressed size, or -1 if the input is malformed
+ *
+ * Every length and offset is bounds-checked so a corrupted payload can never
+ * write outside dst or read outside src.
+ */
+static int lz_decompress(const char *src, int srcLen, char *dst, int dstCap)
+{
+    const unsigned char *in = (const unsigned char *)src;
+    int ip = 0, op = 0;
+
+    while (ip < srcLen)
+    {
+        int token = in[ip++];
+        int len = token >> 4;
+
+        // Literal run
+        if (len == 15)
+        {
+            int b;
+            do
+            {
+                if (ip >= srcLen)
+                    return -1;
+                b = in[ip++];
+                len += b;
+            } while (b == 255);
+        }
+        if (ip + len > srcLen || op + len > dstCap)
+            return -1;
+        memcpy(dst + op, src + ip, len);
+        ip += len;
+        op += len;
+
+        // A sequence that ends the input carries no match
+        if (ip == srcLen)
+            break;
+
+        // Back-reference
+        if (ip + 2 > srcLen)
+            return -1;
+        int offset = in[ip] | (in[ip + 1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op)
+            return -1;
+
+        len = token & 0x0F;
+        if (len == 15)
+        {
+            int b;
+            do
+            {
+                if (ip >= srcLen)
+                    return -1;
+                b = in[ip++];
+                len += b;
+            } while (b == 255);
+        }
+        len += LZ_MIN_MATCH;
+        if (op + len > dstCap)
+            return -1;
+
+        // Byte-wise copy so overlapping matches replicate correctly
+        char *match = dst + op - offset;
+        for (int i = 0; i < len; i++)
+            dst[op + i] = match[i];
+        op += len;
+    }
+
+    return op;
+}
+
+/************************** Compressed File Helpers ***************************/
+
+/**
+ * Checks whether a page consists of zero bytes only.
+ */
+static bool page_is_zero(const char *page, int pageSize)
+{
+    for (int i = 0; i < pageSize; i++)
+        if (page[i] != 0)
+            return false;
+    return true;
+}
+
+/**
+ * Grows the in-memory page-offset map to hold at least numPages entries.
+ *
+ * @return RC_OK if successful, RC_WRITE_FAILED on allocation failure
+ *
+ * New entries describe all-zero pages that occupy no space on disk.
+ */
+static RC map_reserve(SM_FileMgmt *mgmt, int numPages)
+{
+    if (numPages <= mgmt->mapSize)
+        return RC_OK;
+
+    int newSize = (mgmt->mapSize > 0) ? mgmt->mapSize : 16;
+    while (newSize < numPages)
+        newSize *= 2;
+
+    SM_PageMapEntry *map = realloc(mgmt->map, newSize * sizeof(SM_PageMapEntry));
+    if (!map)
+        return RC_WRITE_FAILED;
+    memset(map + mgmt->mapSize, 0, (newSize - mgmt->mapSize) * sizeof(SM_PageMapEntry));
+
+    mgmt->map = map;
+    mgmt->mapSize = newSize;
+    return RC_OK;
+}
+
+/**
+ * Writes the page-offset map and header of a compressed file back to disk.
+ *
+ * @return RC_OK if successful, RC_WRITE_FAILED otherwise
+ *
+ * The map is rewritten in place while it fits its on-disk region; once it
+ * outgrows the region a region of twice the size is allocated at the end of
+ * the file and the header is pointed at it.
+ */
+static RC write_compressed_meta(SM_FileMgmt *mgmt)
+{
+    SM_FileHeader *hdr = &mgmt->hdr;
+
+    if (hdr->totalNumPages > hdr->mapCapacity)
+    {
+        int capacity = hdr->mapCapacity * 2;
+        while (capacity < hdr->totalNumPages)
+            capacity *= 2;
+        hdr->mapOffset = hdr->endOffset;
+        hdr->mapCapacity = capacity;
+        hdr->endOffset += (long long)capacity * sizeof(SM_PageMapEntry);
+    }
+
+    if (fseeko(mgmt->fp, (off_t)hdr->mapOffset, SEEK_SET))
+        return RC_WRITE_FAILED;
+    if (fwrite(mgmt->map, sizeof(SM_PageMapEntry), hdr->totalNumPages, mgmt->fp) != (size_t)hdr->totalNumPages)
+        return RC_WRITE_FAILED;
+
+    if (fseeko(mgmt->fp, (off_t)0, SEEK_SET))
+        return RC_WRITE_FAILED;
+    if (fwrite(hdr, sizeof(SM_FileHeader), 1, mgmt->fp) != 1)
+        return RC_WRITE_FAILED;
+
+    mgmt->mapDirty = false;
+    return RC_OK;
+}
+
+/**
+ * Loads the page-offset map of a compressed file whose header has been read.
+ *
+ * @return RC_OK if successful, RC_FILE_NOT_FOUND if the metadata is unreadable
+ */
+static RC read_compressed_meta(SM_FileMgmt *mgmt)
+{
+    int numPages = mgmt->hdr.totalNumPages;
+    if (numPages < 0 || map_reserve(mgmt, numPages) != RC_OK)
+        return RC_FILE_NOT_FOUND;
+
+    if (fseeko(mgmt->fp, (off_t)mgmt->hdr.mapOffset, SEEK_SET) ||
+        fread(mgmt->map, sizeof(SM_PageMapEntry), numPages, mgmt->fp) != (size_t)numPages)
+        return RC_FILE_NOT_FOUND;
+
+    mgmt->scratch = malloc(SM_COMPRESS_BOUND(mgmt->hdr.pageSize));
+    return mgmt->scratch ? RC_OK : RC_FILE_NOT_FOUND;
+}
+
+/**
+ * Releases the per-handle state of a page file.
+ */
+static void free_mgmt(SM_FileMgmt *mgmt)
+{
+    free(mgmt->segments);
+    free(mgmt->fileName);
+    free(mgmt->map);
+    free(mgmt->scratch);
+    free(mgmt);
+}
+
+/**
+ * Reads and decompresses one page of a compressed file.
+ */
+static RC read_compressed_block(SM_FileMgmt *mgmt, int pageNum, SM_PageHandle memPage)
+{
+    SM_PageMapEntry *entry = &mgmt->map[pageNum];
+    int pageSize = mgmt->hdr.pageSize;
+
+    // Zero pages (and free pages) are not stored at all
+    if (entry->length <= 0)
+    {
+        memset(memPage, 0, pageSize);
+        return RC_OK;
+    }
+
+    if (fseeko(mgmt->fp, (off_t)entry->offset, SEEK_SET))
+        return RC_READ_NON_EXISTING_PAGE;
+
+    // Incompressible pages are stored raw
+    if (entry->length == pageSize)
+        return (fread(memPage, pageSize, 1, mgmt->fp) == 1) ? RC_OK : RC_READ_NON_EXISTING_PAGE;
+
+    if (fread(mgmt->scratch, entry->length, 1, mgmt->fp) != 1)
+        return RC_READ_NON_EXISTING_PAGE;
+    if (lz_decompress(mgmt->scratch, entry->length, memPage, pageSize) != pageSize)
+        return RC_PAGE_DECOMPRESSION_FAILED;
+    return RC_OK;
+}
+
+/**
+ * Compresses one page and stores it in a compressed file.
+ *
+ * The payload is rewritten in place when it fits the page's current slot;
+ * otherwise a new slot is allocated at the end of the file. The space of an
+ * abandoned slot is not reclaimed.
+ */
+static RC write_compressed_block(SM_FileMgmt *mgmt, int pageNum, SM_PageHandle memPage)
 {
-    struct stat st;
-    // Use stat() to get file information without opening the file
-    if (stat(filename, &st) == 0)
-        return st.st_size;
-    return -1; // Return -1 to indicate error
+    SM_PageMapEntry *entry = &mgmt->map[pageNum];
+    int pageSize = mgmt->hdr.pageSize;
+    const char *payload = mgmt->scratch;
+    int length;
+
+    if (page_is_zero(memPage, pageSize))
+        length = 0;
+    else
+    {
+        length = lz_compress(memPage, pageSize, mgmt->scratch, SM_COMPRESS_BOUND(pageSize));
+        if (length < 0 || length >= pageSize)
+        {
+            // Not worth compressing: keep the page raw
+            length = pageSize;
+            payload = memPage;
+        }
+    }
+
+    if (length > entry->capacity)
+    {
+        int capacity = (length + SM_PAYLOAD_ALIGN - 1) / SM_PAYLOAD_ALIGN * SM_PAYLOAD_ALIGN;
+        entry->offset = mgmt->hdr.endOffset;
+        entry->capacity = capacity;
+        mgmt->hdr.endOffset += capacity;
+    }
+
+    if (length > 0)
+    {
+        if (fseeko(mgmt->fp, (off_t)entry->offset, SEEK_SET))
+            return RC_WRITE_FAILED;
+        if (fwrite(payload, length, 1, mgmt->fp) != 1)
+            return RC_WRITE_FAILED;
+    }
+
+    if (entry->length != length)
+    {
+        entry->length = length;
+        mgmt->mapDirty = true;
+    }
+    return RC_OK;
 }
 
 /**
- * Validates parameters for read operations.
- *
- * @param fh File handle to validate
- * @param pageNum Page number to validate
- * @param memPage Memory page to validate
- * @return RC_OK if valid, appropriate error code otherwise
+ * Grows a compressed file to numPages logical pages.
  *
- * Performs three crucial validations: file handle initialization, memory page
- * buffer existence, and page number bounds checking. This centralized validation
- * ensures consistent error checking across all read operations.
+ * Appended pages are all-zero and therefore only cost a map entry.
  */
-static RC validate_read(SM_FileHandle *fh, int pageNum, SM_PageHandle memPage)
+static RC grow_compressed(SM_FileHandle *fh, int numPages)
 {
-    // Check if file handle is initialized
-    if (!fh)
-        return RC_FILE_HANDLE_NOT_INIT;
-    // Ensure memory page buffer is valid
-    if (!memPage)
+    SM_FileMgmt *mgmt = (SM_FileMgmt *)fh->mgmtInfo;
+
+    if (map_reserve(mgmt, numPages) != RC_OK)
         return RC_WRITE_FAILED;
-    // Verify page number is within valid range
-    if (pageNum < 0 || pageNum >= fh->totalNumPages)
-        return RC_READ_NON_EXISTING_PAGE;
+
+    mgmt->hdr.totalNumPages = numPages;
+    mgmt->mapDirty = true;
+    fh->totalNumPages = numPages;
     return RC_OK;
 }
 
@@ -90,43 +1054,101 @@ void initStorageManager(void)
  * @param filename Name of the file to create
  * @return RC_OK if successful, error code otherwise
  *
- * Creates a new file and initializes it with one empty page of zeros. The process
- * involves opening the file in write mode, allocating a temporary buffer for the
- * initial page, writing zeros to the entire page, and cleaning up resources.
- * Handles memory allocation failures and write errors gracefully.
+ * Creates a plain page file with the default page size (PAGE_SIZE) and one
+ * empty page of zeros. See createPageFileWithOptions for the details.
  */
 RC createPageFile(char *filename)
 {
-    // Validate input parameter
+    SM_FileOptions options = {.pageSize = PAGE_SIZE};
+    return createPageFileWithOptions(filename, &options);
+}
+
+/**
+ * Creates a new compressed page file on disk.
+ *
+ * @param filename Name of the file to create
+ * @return RC_OK if successful, error code otherwise
+ *
+ * Creates a compressed page file with the default page size (PAGE_SIZE). See
+ * createPageFileWithOptions for the details.
+ */
+RC createCompressedPageFile(char *filename)
+{
+    SM_FileOptions options = {.pageSize = PAGE_SIZE, .compressed = 1};
+    return createPageFileWithOptions(filename, &options);
+}
+
+/**
+ * Creates a new page file on disk with the given page size and format.
+ *
+ * @param filename Name of the file to create
+ * @param options Page size (power of two from SM_MIN_PAGE_SIZE to
+ *                SM_MAX_PAGE_SIZE), whether pages are compressed, the
+ *                durability mode and, for plain files, the segment size
+ * @return RC_OK if successful, error code otherwise
+ *
+ * Writes a header block of one page that records the magic, format, page
+ * size, durability mode and segment size. Plain files are followed by the
+ * first bitmap block and one empty page of zeros; further segment files are
+ * only created once pages are added to them. For compressed
+ * files the page-offset map starts inside the header block, right after the
+ * fixed fields, and the first page, being all zeros, needs no payload slot.
+ * Handles memory allocation failures and write errors gracefully.
+ */
+RC createPageFileWithOptions(char *filename, SM_FileOptions *options)
+{
+    // Validate input parameters
     if (!filename)
         return RC_FILE_NOT_FOUND;
+    if (!options || !valid_page_size(options->pageSize))
+        return RC_INVALID_PAGE_SIZE;
+    if (!valid_durability(options->durability, options->groupCommitMs))
+        return RC_INVALID_DURABILITY;
+    if (options->segmentPages < 0)
+        return RC_INVALID_SEGMENT_SIZE;
+    // Compressed payloads are placed by offset in one file and cannot be segmented
+    if (options->compressed && options->segmentPages > 0)
+        return RC_FORMAT_NOT_SUPPORTED;
+
+    int pageSize = options->pageSize;
+    int numBlocks = options->compressed ? 1 : 3;
+
+    // Allocate the header block and, for plain files, the first bitmap and page
+    char *blocks = calloc(numBlocks, pageSize);
+    if (!blocks)
+        return RC_WRITE_FAILED;
+
+    SM_FileHeader *hdr = (SM_FileHeader *)blocks;
+    memcpy(hdr->magic, SM_FILE_MAGIC, sizeof(hdr->magic));
+    hdr->format = options->compressed ? SM_FORMAT_COMPRESSED : SM_FORMAT_PLAIN;
+    hdr->pageSize = pageSize;
+    hdr->durability = options->durability;
+    hdr->groupCommitMs = options->groupCommitMs;
+    hdr->segmentPages = options->segmentPages;
+    if (options->compressed)
+    {
+        hdr->totalNumPages = 1;
+        hdr->mapOffset = SM_HEADER_FIXED_SIZE;
+        hdr->mapCapacity = (pageSize - SM_HEADER_FIXED_SIZE) / sizeof(SM_PageMapEntry);
+        hdr->endOffset = pageSize;
+    }
 
     // Create new file in write mode
     FILE *fp = fopen(filename, "w");
     if (!fp)
-        return RC_FILE_NOT_FOUND;
-
-    // Allocate memory for one page
-    char *page_buffer = malloc(PAGE_SIZE);
-    if (!page_buffer)
     {
-        // Clean up if memory allocation fails
-        fclose(fp);
-        return RC_WRITE_FAILED;
+        free(blocks);
+        return RC_FILE_NOT_FOUND;
     }
 
-    // Initialize page with zeros
-    memset(page_buffer, 0, PAGE_SIZE);
-
-    // Write the empty page to file
-    size_t result = fwrite(page_buffer, PAGE_SIZE, 1, fp);
+    size_t result = fwrite(blocks, pageSize, numBlocks, fp);
 
     // Clean up allocated resources
-    free(page_buffer);
+    free(blocks);
     fclose(fp);
 
-    // Return success only if exactly one page was written
-    return (result == 1) ? RC_OK : RC_WRITE_FAILED;
+    // Return success only if every block was written
+    return (result == (size_t)numBlocks) ? RC_OK : RC_WRITE_FAILED;
 }
 
 /**
@@ -138,8 +1160,10 @@ RC createPageFile(char *filename)
  * @return RC_OK if successful, error code otherwise
  *
  * Opens an existing file in read/write mode and initializes a file handle with
- * its information. Calculates total pages based on file size, sets initial cursor
- * position to 0, and stores the file pointer for future operations. Features
+ * its information. Reads the page size and format from the file header,
+ * calculates total pages based on file size (or the page-offset map of
+ * compressed files), sets initial cursor position to 0, and stores the file
+ * state for future operations. Features
  * comprehensive error checking for file existence and handle initialization.
  */
 RC openPageFile(char *filename, SM_FileHandle *fileHandle)
@@ -149,7 +1173,7 @@ RC openPageFile(char *filename, SM_FileHandle *fileHandle)
         return RC_FILE_HANDLE_NOT_INIT;
 
     // Get file size before opening to verify existence
-    long file_size = get_file_size(filename);
+    long long file_size = get_file_size(filename);
     if (file_size < 0)
         return RC_FILE_NOT_FOUND;
 
@@ -158,11 +1182,81 @@ RC openPageFile(char *filename, SM_FileHandle *fileHandle)
     if (!fp)
         return RC_FILE_NOT_FOUND;
 
+    SM_FileMgmt *mgmt = calloc(1, sizeof(SM_FileMgmt));
+    if (!mgmt)
+    {
+        fclose(fp);
+        return RC_FILE_HANDLE_NOT_INIT;
+    }
+    mgmt->fp = fp;
+    mgmt->fileName = strdup(filename);
+    mgmt->segments = calloc(1, sizeof(FILE *));
+    if (!mgmt->fileName || !mgmt->segments)
+    {
+        fclose(fp);
+        free_mgmt(mgmt);
+        return RC_FILE_HANDLE_NOT_INIT;
+    }
+    mgmt->segments[0] = fp;
+    mgmt->numSegments = 1;
+
+    // Detect the file format from the magic at the start of the file
+    if (fread(&mgmt->hdr, sizeof(SM_FileHeader), 1, fp) == 1 &&
+        memcmp(mgmt->hdr.magic, SM_FILE_MAGIC, sizeof(mgmt->hdr.magic)) == 0)
+    {
+        if (!valid_page_size(mgmt->hdr.pageSize) || mgmt->hdr.segmentPages < 0 ||
+            (mgmt->hdr.format == SM_FORMAT_COMPRESSED && read_compressed_meta(mgmt) != RC_OK))
+        {
+            fclose(fp);
+            free_mgmt(mgmt);
+            return RC_FILE_NOT_FOUND;
+        }
+        if (mgmt->hdr.format == SM_FORMAT_PLAIN)
+            mgmt->groupPages = mgmt->hdr.pageSize * 8;
+    }
+    else
+    {
+        // Headerless file: plain pages of the default size from offset 0
+        memset(&mgmt->hdr, 0, sizeof(SM_FileHeader));
+        mgmt->hdr.format = SM_FORMAT_PLAIN;
+        mgmt->hdr.pageSize = PAGE_SIZE;
+        mgmt->groupPages = 0;
+    }
+
+    if (mgmt->hdr.format == SM_FORMAT_COMPRESSED)
+        fileHandle->totalNumPages = mgmt->hdr.totalNumPages;
+    else if (mgmt->hdr.segmentPages == 0) // Round up to include partial pages
+        fileHandle->totalNumPages = segment_page_count(mgmt, 0, file_size);
+    else
+    {
+        // Full segments come before the last existing segment file
+        int last = 0;
+        long long size = file_size;
+        char name[1024];
+        for (;;)
+        {
+            segment_name(mgmt, last + 1, name, sizeof(name));
+            long long next = get_file_size(name);
+            if (next < 0)
+                break;
+            last++;
+            size = next;
+        }
+        fileHandle->totalNumPages = last * mgmt->hdr.segmentPages + segment_page_count(mgmt, last, size);
+    }
+
+    // Headerless files (and files with a bad mode) get no durability guarantees
+    if (valid_durability(mgmt->hdr.durability, mgmt->hdr.groupCommitMs))
+    {
+        mgmt->durability = mgmt->hdr.durability;
+        mgmt->groupCommitMs = mgmt->hdr.groupCommitMs;
+    }
+    mgmt->lastSyncMs = now_ms();
+
     // Initialize file handle with file information
-    fileHandle->mgmtInfo = fp;
+    fileHandle->mgmtInfo = mgmt;
     fileHandle->fileName = filename;
-    // Calculate total pages, rounding up to include partial pages
-    fileHandle->totalNumPages = (file_size + PAGE_SIZE - 1) / PAGE_SIZE;
+    fileHandle->pageSize = mgmt->hdr.pageSize;
     fileHandle->curPagePos = 0; // Start at beginning of file
 
     return RC_OK;
@@ -176,9 +1270,10 @@ RC openPageFile(char *filename, SM_FileHandle *fileHandle)
  * @return RC_OK if successful, error code otherwise
  *
  * Safely closes an open page file by flushing any pending writes and releasing
- * system resources. Clears the management info pointer to prevent subsequent
- * accidental use. Includes checks for null file handles and failed close
- * operations to ensure proper cleanup.
+ * system resources. Compressed files first write back their page-offset map.
+ * Clears the management info pointer to prevent subsequent accidental use.
+ * Includes checks for null file handles and failed close operations to ensure
+ * proper cleanup.
  */
 RC closePageFile(SM_FileHandle *fileHandle)
 {
@@ -186,14 +1281,26 @@ RC closePageFile(SM_FileHandle *fileHandle)
     if (!fileHandle)
         return RC_FILE_HANDLE_NOT_INIT;
 
-    FILE *fp = (FILE *)fileHandle->mgmtInfo;
-    // Only attempt to close if file pointer exists
-    if (fp && fclose(fp) != 0)
-        return RC_FILE_CLOSE_FAILED;
+    SM_FileMgmt *mgmt = (SM_FileMgmt *)fileHandle->mgmtInfo;
+    if (!mgmt)
+        return RC_OK;
+
+    RC rc = RC_OK;
+    // Closing is a checkpoint: sync pending writes unless durability is off
+    if (mgmt->durability != SM_DURABILITY_NONE && mgmt->unsynced)
+        rc = sync_file(mgmt);
+    else if (mgmt->hdr.format == SM_FORMAT_COMPRESSED && mgmt->mapDirty)
+        rc = write_compressed_meta(mgmt);
+
+    // Only report a close failure if nothing failed before it
+    for (int segment = 0; segment < mgmt->numSegments; segment++)
+        if (mgmt->segments[segment] && fclose(mgmt->segments[segment]) != 0 && rc == RC_OK)
+            rc = RC_FILE_CLOSE_FAILED;
 
     // Clear file pointer to prevent reuse
+    free_mgmt(mgmt);
     fileHandle->mgmtInfo = NULL;
-    return RC_OK;
+    return rc;
 }
 
 /**
@@ -206,11 +1313,39 @@ RC closePageFile(SM_FileHandle *fileHandle)
  * Permanently deletes the specified file from disk using the system remove
  * function. Returns appropriate error code if the file doesn't exist or
  * cannot be deleted due to permission issues or other system constraints.
+ * The segment files of a segmented file are removed along with it.
  */
 RC destroyPageFile(char *filename)
 {
+    SM_FileHeader hdr;
+    int segmentPages = 0;
+
+    // Look up the segment size before the header is gone
+    FILE *fp = fopen(filename, "r");
+    if (fp)
+    {
+        if (fread(&hdr, sizeof(SM_FileHeader), 1, fp) == 1 &&
+            memcmp(hdr.magic, SM_FILE_MAGIC, sizeof(hdr.magic)) == 0)
+            segmentPages = hdr.segmentPages;
+        fclose(fp);
+    }
+
     // Attempt to remove file, return appropriate status
-    return (remove(filename) == 0) ? RC_OK : RC_FILE_NOT_FOUND;
+    if (remove(filename) != 0)
+        return RC_FILE_NOT_FOUND;
+
+    // Segment files are numbered without gaps, so stop at the first missing one
+    if (segmentPages > 0)
+    {
+        char name[1024];
+        for (int segment = 1;; segment++)
+        {
+            snprintf(name, sizeof(name), "%s.%d", filename, segment);
+            if (remove(name) != 0)
+                break;
+        }
+    }
+    return RC_OK;
 }
 
 /************************** Block Read Operations *****************************/
@@ -225,8 +1360,8 @@ RC destroyPageFile(char *filename)
  * @return RC_OK if successful, error code otherwise
  *
  * Performs a direct page read from disk by seeking to the appropriate file
- * position and reading exactly PAGE_SIZE bytes. Updates the current page
- * position on success. Includes comprehensive parameter validation and error
+ * position and reading exactly one page. Pages of compressed files are
+ * decompressed into memPage. Updates the current page position on success. Includes comprehensive parameter validation and error
  * checking for seek and read operations.
  */
 RC readBlock(int pageNum, SM_FileHandle *fh, SM_PageHandle memPage)
@@ -236,14 +1371,26 @@ RC readBlock(int pageNum, SM_FileHandle *fh, SM_PageHandle memPage)
     if (valid != RC_OK)
         return valid;
 
-    FILE *fp = (FILE *)fh->mgmtInfo;
-    // Calculate byte offset for desired page
-    if (fseek(fp, pageNum * PAGE_SIZE, SEEK_SET))
-        return RC_READ_NON_EXISTING_PAGE;
+    SM_FileMgmt *mgmt = (SM_FileMgmt *)fh->mgmtInfo;
+    if (mgmt->hdr.format == SM_FORMAT_COMPRESSED)
+    {
+        RC rc = read_compressed_block(mgmt, pageNum, memPage);
+        if (rc != RC_OK)
+            return rc;
+    }
+    else
+    {
+        // Calculate byte offset for desired page inside its segment
+        int segment;
+        long long offset = page_offset(mgmt, pageNum, &segment);
+        FILE *fp = seek_segment(mgmt, segment, offset, false);
+        if (!fp)
+            return RC_READ_NON_EXISTING_PAGE;
 
-    // Attempt to read entire page
-    if (fread(memPage, PAGE_SIZE, 1, fp) != 1)
-        return RC_READ_NON_EXISTING_PAGE;
+        // Attempt to read entire page
+        if (fread(memPage, fh->pageSize, 1, fp) != 1)
+            return RC_READ_NON_EXISTING_PAGE;
+    }
 
     // Update current position on successful read
     fh->curPagePos = pageNum;
@@ -378,7 +1525,8 @@ RC readLastBlock(SM_FileHandle *fh, SM_PageHandle memPage)
  * @return RC_OK if successful, error code otherwise
  *
  * Performs a direct page write to disk by seeking to the appropriate file
- * position and writing exactly PAGE_SIZE bytes. Updates the current page
+ * position and writing exactly one page. Pages of compressed files are
+ * compressed first and stored in their payload slot. Updates the current page
  * position on success. Includes parameter validation and error checking for
  * seek and write operations.
  */
@@ -391,18 +1539,30 @@ RC writeBlock(int pageNum, SM_FileHandle *fh, SM_PageHandle memPage)
     if (pageNum < 0 || pageNum >= fh->totalNumPages)
         return RC_READ_NON_EXISTING_PAGE;
 
-    FILE *fp = (FILE *)fh->mgmtInfo;
-    // Seek to target page position
-    if (fseek(fp, pageNum * PAGE_SIZE, SEEK_SET))
-        return RC_WRITE_FAILED;
+    SM_FileMgmt *mgmt = (SM_FileMgmt *)fh->mgmtInfo;
+    if (mgmt->hdr.format == SM_FORMAT_COMPRESSED)
+    {
+        RC rc = write_compressed_block(mgmt, pageNum, memPage);
+        if (rc != RC_OK)
+            return rc;
+    }
+    else
+    {
+        // Seek to target page position inside its segment
+        int segment;
+        long long offset = page_offset(mgmt, pageNum, &segment);
+        FILE *fp = seek_segment(mgmt, segment, offset, false);
+        if (!fp)
+            return RC_WRITE_FAILED;
 
-    // Write entire page to file
-    if (fwrite(memPage, PAGE_SIZE, 1, fp) != 1)
-        return RC_WRITE_FAILED;
+        // Write entire page to file
+        if (fwrite(memPage, fh->pageSize, 1, fp) != 1)
+            return RC_WRITE_FAILED;
+    }
 
     // Update current position after successful write
     fh->curPagePos = pageNum;
-    return RC_OK;
+    return after_write(mgmt);
 }
 
 /**
@@ -430,10 +1590,9 @@ RC writeCurrentBlock(SM_FileHandle *fh, SM_PageHandle memPage)
  * @param fh File handle
  * @return RC_OK if successful, error code otherwise
  *
- * Creates and appends a new zero-filled page to the file. Manages memory
- * allocation for the temporary page buffer and handles cleanup. Updates the
- * total page count on successful append. Includes error checking for memory
- * allocation and write operations.
+ * Creates and appends a new zero-filled page to the file through
+ * ensureCapacity, which also writes the bitmap block when the page starts a
+ * new page group. Updates the total page count on successful append.
  */
 RC appendEmptyBlock(SM_FileHandle *fh)
 {
@@ -441,26 +1600,8 @@ RC appendEmptyBlock(SM_FileHandle *fh)
     if (!fh)
         return RC_FILE_HANDLE_NOT_INIT;
 
-    // Allocate and initialize empty page
-    char *empty = malloc(PAGE_SIZE);
-    if (!empty)
-        return RC_WRITE_FAILED;
-    memset(empty, 0, PAGE_SIZE);
-
-    FILE *fp = (FILE *)fh->mgmtInfo;
-    // Move to end of file
-    fseek(fp, 0, SEEK_END);
-    // Write empty page
-    int result = (fwrite(empty, PAGE_SIZE, 1, fp) == 1);
-    free(empty);
-
-    if (result)
-    {
-        // Update total pages on successful append
-        fh->totalNumPages++;
-        return RC_OK;
-    }
-    return RC_WRITE_FAILED;
+    // Growing by one page may also start a new bitmap group
+    return ensureCapacity(fh->totalNumPages + 1, fh);
 }
 
 /**
@@ -472,8 +1613,8 @@ RC appendEmptyBlock(SM_FileHandle *fh)
  * @return RC_OK if successful, error code otherwise
  *
  * Checks if the file needs additional pages and appends empty pages as needed.
- * Optimizes the append operation by allocating memory for all needed pages at
- * once. Updates the total page count on success. Includes parameter validation
+ * New pages (and the bitmap blocks of any new page groups) are zero-filled
+ * in chunks, spilling into new segment files for segmented files. Updates the total page count on success. Includes parameter validation
  * and error checking for memory allocation and write operations.
  */
 RC ensureCapacity(int numPages, SM_FileHandle *fh)
@@ -488,25 +1629,286 @@ RC ensureCapacity(int numPages, SM_FileHandle *fh)
     if (fh->totalNumPages >= numPages)
         return RC_OK;
 
-    // Calculate number of pages to add
-    int needed = numPages - fh->totalNumPages;
-    // Allocate memory for all needed pages at once
-    char *empty = calloc(needed, PAGE_SIZE);
-    if (!empty)
-        return RC_WRITE_FAILED;
+    SM_FileMgmt *mgmt = (SM_FileMgmt *)fh->mgmtInfo;
+    // Empty pages of compressed files only need a map entry
+    if (mgmt->hdr.format == SM_FORMAT_COMPRESSED)
+    {
+        RC rc = grow_compressed(fh, numPages);
+        return (rc == RC_OK) ? after_write(mgmt) : rc;
+    }
 
-    FILE *fp = (FILE *)fh->mgmtInfo;
-    // Move to end of file
-    fseek(fp, 0, SEEK_END);
-    // Write all needed pages at once
-    int result = (fwrite(empty, PAGE_SIZE, needed, fp) == (size_t)needed);
-    free(empty);
+    // Add the pages, including any new bitmap blocks and segment files
+    RC rc = grow_plain(fh, numPages);
+    if (rc != RC_OK)
+        return rc;
+
+    // Update total pages on successful expansion
+    fh->totalNumPages = numPages;
+    return after_write(mgmt);
+}
+/************************** Page Allocation ***********************************/
+
+/**
+ * Allocates a page, reusing a freed page before growing the file.
+ *
+ * @param fh File handle
+ * @param pageNum Set to the number of the allocated page
+ * @return RC_OK if successful, error code otherwise
+ *
+ * Plain files search their free-page bitmaps and compressed files their
+ * page-offset map. The returned page is always zero-filled. When no page is
+ * free (or the file has no header, and hence no bitmap) an empty page is
+ * appended instead.
+ */
+RC allocatePage(SM_FileHandle *fh, int *pageNum)
+{
+    // Validate input parameters
+    if (!fh || !fh->mgmtInfo || !pageNum)
+        return RC_FILE_HANDLE_NOT_INIT;
+
+    SM_FileMgmt *mgmt = (SM_FileMgmt *)fh->mgmtInfo;
+    RC rc;
+
+    if (mgmt->hdr.format == SM_FORMAT_COMPRESSED)
+    {
+        // A free entry becomes an all-zero page that keeps its payload slot
+        for (; mgmt->freeHint < fh->totalNumPages; mgmt->freeHint++)
+        {
+            SM_PageMapEntry *entry = &mgmt->map[mgmt->freeHint];
+            if (entry->length < 0)
+            {
+                entry->length = 0;
+                mgmt->mapDirty = true;
+                *pageNum = mgmt->freeHint;
+                return after_write(mgmt);
+            }
+        }
+    }
+    else if (mgmt->groupPages > 0)
+    {
+        if ((rc = reuse_plain_page(fh, pageNum)) != RC_OK || *pageNum >= 0)
+            return rc;
+    }
+
+    // Nothing to reuse: grow the file by one page
+    if ((rc = appendEmptyBlock(fh)) != RC_OK)
+        return rc;
+    *pageNum = fh->totalNumPages - 1;
+    return RC_OK;
+}
+
+/**
+ * Returns a page to the file's free space so allocatePage can reuse it.
+ *
+ * @param fh File handle
+ * @param pageNum Page to release
+ * @return RC_OK if successful, RC_PAGE_ALREADY_FREE for a double free,
+ *         RC_FORMAT_NOT_SUPPORTED for files without a header
+ *
+ * The file does not shrink. The page keeps its content until it is
+ * reallocated, and callers must not use it in the meantime.
+ */
+RC freePage(SM_FileHandle *fh, int pageNum)
+{
+    // Validate input parameters
+    if (!fh || !fh->mgmtInfo)
+        return RC_FILE_HANDLE_NOT_INIT;
+    if (pageNum < 0 || pageNum >= fh->totalNumPages)
+        return RC_READ_NON_EXISTING_PAGE;
+
+    SM_FileMgmt *mgmt = (SM_FileMgmt *)fh->mgmtInfo;
 
-    if (result)
+    if (mgmt->hdr.format == SM_FORMAT_COMPRESSED)
     {
-        // Update total pages on successful expansion
-        fh->totalNumPages = numPages;
+        SM_PageMapEntry *entry = &mgmt->map[pageNum];
+        if (entry->length < 0)
+            return RC_PAGE_ALREADY_FREE;
+        entry->length = -1;
+        mgmt->mapDirty = true;
+        if (pageNum < mgmt->freeHint)
+            mgmt->freeHint = pageNum;
+        return after_write(mgmt);
+    }
+
+    // Headerless files have no bitmap to record the free page in
+    if (mgmt->groupPages == 0)
+        return RC_FORMAT_NOT_SUPPORTED;
+
+    RC rc = release_plain_page(fh, pageNum);
+    return (rc == RC_OK) ? after_write(mgmt) : rc;
+}
+
+/************************** Durability Control ********************************/
+
+/**
+ * Changes the durability mode of an open page file.
+ *
+ * @param fh File handle
+ * @param durability One of the SM_Durability modes
+ * @param groupCommitMs Longest time between two syncs in group-commit mode
+ * @return RC_OK if successful, RC_INVALID_DURABILITY for a bad mode
+ *
+ * The change only lasts until the handle is closed; the mode stored in the
+ * file header is the one given to createPageFileWithOptions. Writes still
+ * pending when the mode is tightened are synced right away.
+ */
+RC setDurability(SM_FileHandle *fh, SM_Durability durability, int groupCommitMs)
+{
+    // Validate input parameters
+    if (!fh || !fh->mgmtInfo)
+        return RC_FILE_HANDLE_NOT_INIT;
+    if (!valid_durability(durability, groupCommitMs))
+        return RC_INVALID_DURABILITY;
+
+    SM_FileMgmt *mgmt = (SM_FileMgmt *)fh->mgmtInfo;
+    mgmt->durability = durability;
+    mgmt->groupCommitMs = groupCommitMs;
+
+    if (durability == SM_DURABILITY_EVERY_WRITE && mgmt->unsynced)
+        return sync_file(mgmt);
+    return RC_OK;
+}
+
+/**
+ * Returns the durability mode of an open page file.
+ */
+SM_Durability getDurability(SM_FileHandle *fh)
+{
+    if (!fh || !fh->mgmtInfo)
+        return SM_DURABILITY_NONE;
+    return (SM_Durability)((SM_FileMgmt *)fh->mgmtInfo)->durability;
+}
+
+/**
+ * Makes every write issued so far durable.
+ *
+ * @param fh File handle
+ * @return RC_OK if successful, RC_WRITE_FAILED if the sync failed
+ *
+ * This is the sync point of the checkpoint mode, and it also flushes the
+ * writes a group commit has not synced yet. Files in SM_DURABILITY_NONE
+ * mode hand the buffered writes of every segment, and a changed compressed
+ * page map, to the operating system without syncing them.
+ */
+RC checkpointPageFile(SM_FileHandle *fh)
+{
+    // Validate file handle
+    if (!fh || !fh->mgmtInfo)
+        return RC_FILE_HANDLE_NOT_INIT;
+
+    SM_FileMgmt *mgmt = (SM_FileMgmt *)fh->mgmtInfo;
+    if (mgmt->durability == SM_DURABILITY_NONE)
+        return flush_file(mgmt);
+    if (!mgmt->unsynced)
+        return RC_OK;
+    return sync_file(mgmt);
+}
+
+/**
+ * Syncs the pending writes of a group commit whose interval has passed.
+ *
+ * @param fh File handle
+ * @return RC_OK if successful, RC_WRITE_FAILED if the sync failed
+ *
+ * Group commit only syncs when there is a reason to look at the clock. A
+ * write is one; this call is the other, so callers that keep using a file
+ * without writing to it (the buffer manager, on every unpin) bound how long
+ * the last writes before a quiet period stay unsynced. Other modes and
+ * handles without pending writes return at once.
+ */
+RC syncOverdueWrites(SM_FileHandle *fh)
+{
+    // Validate file handle
+    if (!fh || !fh->mgmtInfo)
+        return RC_FILE_HANDLE_NOT_INIT;
+
+    SM_FileMgmt *mgmt = (SM_FileMgmt *)fh->mgmtInfo;
+    if (mgmt->durability != SM_DURABILITY_GROUP_COMMIT || !mgmt->unsynced)
+        return RC_OK;
+    if (now_ms() - mgmt->lastSyncMs < mgmt->groupCommitMs)
+        return RC_OK;
+    return sync_file(mgmt);
+}
+
+/************************** Segment Control ***********************************/
+
+/**
+ * Returns the number of segment files a page file spans.
+ */
+int getSegmentCount(SM_FileHandle *fh)
+{
+    if (!fh || !fh->mgmtInfo || fh->totalNumPages == 0)
+        return 0;
+
+    int index;
+    return segment_of((SM_FileMgmt *)fh->mgmtInfo, fh->totalNumPages - 1, &index) + 1;
+}
+
+/**
+ * Asks the operating system to read a whole segment into its page cache.
+ *
+ * @param fh File handle
+ * @param segment Segment number (0 for unsegmented files)
+ * @return RC_OK if successful, RC_READ_NON_EXISTING_PAGE for a bad segment
+ *
+ * The call only issues the hint; it returns before the data is read.
+ */
+RC prefetchSegment(SM_FileHandle *fh, int segment)
+{
+    // Validate input parameters
+    if (!fh || !fh->mgmtInfo)
+        return RC_FILE_HANDLE_NOT_INIT;
+    if (segment < 0 || segment >= getSegmentCount(fh))
+        return RC_READ_NON_EXISTING_PAGE;
+
+    FILE *fp = segment_file((SM_FileMgmt *)fh->mgmtInfo, segment, false);
+    if (!fp)
+        return RC_READ_NON_EXISTING_PAGE;
+
+    posix_fadvise(fileno(fp), 0, 0, POSIX_FADV_WILLNEED);
+    return RC_OK;
+}
+
+/**
+ * Drops a segment from memory: its cached pages and its open stream.
+ *
+ * @param fh File handle
+ * @param segment Segment number
+ * @return RC_OK if successful, error code otherwise
+ *
+ * Pending writes are synced first if the file's durability mode asks for
+ * syncs at all. The segment is reopened transparently on its next access.
+ * Segment 0 stays open because it holds the file header.
+ */
+RC releaseSegment(SM_FileHandle *fh, int segment)
+{
+    // Validate input parameters
+    if (!fh || !fh->mgmtInfo)
+        return RC_FILE_HANDLE_NOT_INIT;
+    if (segment < 0 || segment >= getSegmentCount(fh))
+        return RC_READ_NON_EXISTING_PAGE;
+
+    SM_FileMgmt *mgmt = (SM_FileMgmt *)fh->mgmtInfo;
+    if (segment >= mgmt->numSegments || !mgmt->segments[segment])
         return RC_OK;
+
+    if (mgmt->durability != SM_DURABILITY_NONE && mgmt->unsynced)
+    {
+        RC rc = sync_file(mgmt);
+        if (rc != RC_OK)
+            return rc;
+    }
+
+    FILE *fp = mgmt->segments[segment];
+    if (fflush(fp) != 0)
+        return RC_WRITE_FAILED;
+    posix_fadvise(fileno(fp), 0, 0, POSIX_FADV_DONTNEED);
+
+    if (segment > 0)
+    {
+        mgmt->segments[segment] = NULL;
+        if (fclose(fp) != 0)
+            return RC_FILE_CLOSE_FAILED;
     }
-    return RC_WRITE_FAILED;
-}
\ No newline at end of file
+    return RC_OK;
+}
@@ -3,6 +3,10 @@
 
 #include "dberror.h"
 
+/* bounds for the page size chosen at createPageFileWithOptions time */
+#define SM_MIN_PAGE_SIZE 4096
+#define SM_MAX_PAGE_SIZE 65536
+
 /************************************************************
  *                    handle data structures                *
  ************************************************************/
@@ -10,17 +14,36 @@ typedef struct SM_FileHandle {
 	char *fileName;
 	int totalNumPages;
 	int curPagePos;
+	int pageSize;
 	void *mgmtInfo;
 } SM_FileHandle;
 
 typedef char* SM_PageHandle;
 
+/* when written pages are forced to disk with fdatasync */
+typedef enum SM_Durability {
+	SM_DURABILITY_NONE = 0,         /* never; the OS writes pages back on its own */
+	SM_DURABILITY_CHECKPOINT = 1,   /* on checkpointPageFile and closePageFile */
+	SM_DURABILITY_EVERY_WRITE = 2,  /* before every write returns */
+	SM_DURABILITY_GROUP_COMMIT = 3  /* at most once per groupCommitMs; see syncOverdueWrites */
+} SM_Durability;
+
+typedef struct SM_FileOptions {
+	int pageSize;
+	int compressed; /* nonzero to store pages compressed */
+	int durability; /* an SM_Durability mode */
+	int groupCommitMs; /* sync interval of SM_DURABILITY_GROUP_COMMIT */
+	int segmentPages; /* pages per segment file, 0 for a single file */
+} SM_FileOptions;
+
 /************************************************************
  *                    interface                             *
  ************************************************************/
 /* manipulating page files */
 extern void initStorageManager (void);
 extern RC createPageFile (char *fileName);
+extern RC createCompressedPageFile (char *fileName);
+extern RC createPageFileWithOptions (char *fileName, SM_FileOptions *options);
 extern RC openPageFile (char *fileName, SM_FileHandle *fHandle);
 extern RC closePageFile (SM_FileHandle *fHandle);
 extern RC destroyPageFile (char *fileName);
@@ -40,4 +63,19 @@ extern RC writeCurrentBlock (SM_FileHandle *fHandle, SM_PageHandle memPage);
 extern RC appendEmptyBlock (SM_FileHandle *fHandle);
 extern RC ensureCapacity (int numberOfPages, SM_FileHandle *fHandle);
 
+/* reusing pages */
+extern RC allocatePage (SM_FileHandle *fHandle, int *pageNum);
+extern RC freePage (SM_FileHandle *fHandle, int pageNum);
+
+/* durability */
+extern RC setDurability (SM_FileHandle *fHandle, SM_Durability durability, int groupCommitMs);
+extern SM_Durability getDurability (SM_FileHandle *fHandle);
+extern RC checkpointPageFile (SM_FileHandle *fHandle);
+extern RC syncOverdueWrites (SM_FileHandle *fHandle);
+
+/* segmented page files */
+extern int getSegmentCount (SM_FileHandle *fHandle);
+extern RC prefetchSegment (SM_FileHandle *fHandle, int segment);
+extern RC releaseSegment (SM_FileHandle *fHandle, int segment);
+
 #endif
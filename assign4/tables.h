@@ -41,6 +41,8 @@ typedef struct Schema
 	int *typeLength;
 	int *keyAttrs;
 	int keySize;
+	int *attrOffsets; // offset of every attribute in a record, set up by the record manager
+	int recordSize;   // size of a record, tombstone byte included
 } Schema;
 
 // TableData: Management Structure for a Record Manager to handle one relation
@@ -0,0 +1,438 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <sys/stat.h>
+
+#include "storage_mgr.h"
+#include "dberror.h"
+#include "test_helper.h"
+
+// test name
+char *testName;
+
+/* test output files */
+#define TESTPF "test_pagefile.bin"
+
+/* prototypes for test functions */
+static void testCreateOpenClose(void);
+static void testSinglePageContent(void);
+static void testCompressedPageContent(void);
+static void testPageSizes(void);
+static void testPageReuse(void);
+static void testDurability(void);
+static void testSegmentedFile(void);
+
+/* main function running all tests */
+int main (void) {
+  testName = "";
+  
+  initStorageManager();
+
+  testCreateOpenClose();
+  testSinglePageContent();
+  testCompressedPageContent();
+  testPageSizes();
+  testPageReuse();
+  testDurability();
+  testSegmentedFile();
+
+  printf("Executed all code successfully\n");
+
+  return 0;
+}
+
+
+/* check a return code. If it is not RC_OK then output a message, error description, and exit */
+/* Try to create, open, and close a page file */
+void testCreateOpenClose(void) {
+  SM_FileHandle fh;
+
+  testName = "test create open and close methods";
+
+  TEST_CHECK(createPageFile (TESTPF));
+  
+  TEST_CHECK(openPageFile (TESTPF, &fh));
+  ASSERT_TRUE(strcmp(fh.fileName, TESTPF) == 0, "filename correct\n");
+  ASSERT_TRUE((fh.totalNumPages == 1), "expect 1 page in new file\n");
+  ASSERT_TRUE((fh.curPagePos == 0), "freshly opened file's page position should be 0\n");
+  TEST_CHECK(closePageFile (&fh));
+  TEST_CHECK(destroyPageFile (TESTPF));
+
+  // // after destruction trying to open the file should cause an error
+  ASSERT_TRUE((openPageFile(TESTPF, &fh) != RC_OK), "opening non-existing file should return an error.");
+  
+  TEST_DONE();
+}
+
+/* Try to create, open, and close a page file */
+void testSinglePageContent(void)
+{
+  SM_FileHandle fh;
+  SM_PageHandle ph;
+  int i;
+
+  testName = "test single page content";
+
+  ph = (SM_PageHandle) calloc(PAGE_SIZE, sizeof(char));
+
+  // create a new page file
+  TEST_CHECK(createPageFile (TESTPF));
+  TEST_CHECK(openPageFile (TESTPF, &fh));
+  printf("\ncreated and opened file\n");
+  
+  // read first page into handle
+  TEST_CHECK(readFirstBlock (&fh, ph));
+  // the page should be empty (zero bytes)
+  for (i=0; i < PAGE_SIZE; i++) 
+    ASSERT_TRUE((ph[i] == 0), "expected zero byte in first page of freshly initialized page");
+  printf("\nfirst block was empty\n");
+
+  // change ph to be a string and write that one to disk
+  for (i=0; i < PAGE_SIZE; i++)
+    ph[i] = (i % 10) + '0';
+  TEST_CHECK(writeBlock (0, &fh, ph));
+  printf("\nwriting first block\n");
+
+  // read back the page containing the string and check that it is correct
+  TEST_CHECK(readFirstBlock (&fh, ph));
+  for (i=0; i < 10; i++) {
+    printf("CHARACTER : %c ", (i % 10) + '0');
+    ASSERT_TRUE((ph[i] == (i % 10) + '0'), "character in page read from disk is the one we expected.");
+  }
+  printf("reading first block\n");
+
+  ASSERT_TRUE(appendEmptyBlock(&fh) == 0, "Appended empty blocks successfully.\n");
+
+  TEST_CHECK(ensureCapacity(10, &fh));
+
+  TEST_CHECK(closePageFile (&fh));
+  // destroy new page file
+  TEST_CHECK(destroyPageFile (TESTPF));  
+  
+  TEST_DONE();
+}
+
+/* Write and read back pages of a compressed page file */
+void testCompressedPageContent(void)
+{
+  SM_FileHandle fh;
+  SM_PageHandle ph;
+  struct stat st;
+  bool same;
+  int i, j;
+
+  testName = "test compressed page content";
+
+  ph = (SM_PageHandle) calloc(PAGE_SIZE, sizeof(char));
+
+  TEST_CHECK(createCompressedPageFile (TESTPF));
+  TEST_CHECK(openPageFile (TESTPF, &fh));
+  ASSERT_TRUE((fh.totalNumPages == 1), "expect 1 page in new compressed file\n");
+
+  // a fresh page reads back as zeros
+  TEST_CHECK(readFirstBlock (&fh, ph));
+  for (i=0, same=true; i < PAGE_SIZE; i++)
+    same = same && (ph[i] == 0);
+  ASSERT_TRUE(same, "expected zero bytes in first page of freshly initialized page");
+
+  // fill pages with short zero-padded strings, like fixed-width columns
+  TEST_CHECK(ensureCapacity(300, &fh));
+  for (j=0; j < 300; j++) {
+    memset(ph, 0, PAGE_SIZE);
+    for (i=0; i < PAGE_SIZE; i += 64)
+      sprintf(ph + i, "row-%i-%i", j, i);
+    TEST_CHECK(writeBlock (j, &fh, ph));
+  }
+
+  // an incompressible page is stored raw
+  srand(1);
+  for (i=0; i < PAGE_SIZE; i++)
+    ph[i] = (char) (rand() & 0xFF);
+  TEST_CHECK(writeBlock (7, &fh, ph));
+  TEST_CHECK(closePageFile (&fh));
+
+  // reopen and verify every page
+  TEST_CHECK(openPageFile (TESTPF, &fh));
+  ASSERT_TRUE((fh.totalNumPages == 300), "page count survives reopen\n");
+  srand(1);
+  TEST_CHECK(readBlock (7, &fh, ph));
+  for (i=0, same=true; i < PAGE_SIZE; i++)
+    same = same && (ph[i] == (char) (rand() & 0xFF));
+  ASSERT_TRUE(same, "raw page read back correctly");
+  for (j=0; j < 300; j += 37) {
+    char expected[32];
+    if (j == 7)
+      continue;
+    TEST_CHECK(readBlock (j, &fh, ph));
+    for (i=0, same=true; i < PAGE_SIZE; i += 64) {
+      sprintf(expected, "row-%i-%i", j, i);
+      same = same && (strcmp(ph + i, expected) == 0);
+    }
+    ASSERT_TRUE(same, "compressed page read back correctly");
+  }
+  TEST_CHECK(closePageFile (&fh));
+
+  // zero-padded pages should take far less space than plain pages
+  ASSERT_TRUE(stat(TESTPF, &st) == 0 && st.st_size < 300 * PAGE_SIZE / 4, "compressed file is smaller than a quarter of a plain file");
+
+  TEST_CHECK(destroyPageFile (TESTPF));
+  free(ph);
+
+  TEST_DONE();
+}
+
+/* Create page files with non-default page sizes */
+void testPageSizes(void)
+{
+  SM_FileHandle fh;
+  SM_FileOptions options = {0};
+  SM_PageHandle ph;
+  int sizes[] = {8192, 65536};
+  int s, i, compressed;
+
+  testName = "test configurable page sizes";
+
+  // only powers of two between the bounds are accepted
+  options.compressed = 0;
+  options.pageSize = 1000;
+  ASSERT_ERROR(createPageFileWithOptions(TESTPF, &options), "page size must be a power of two");
+  options.pageSize = 2 * SM_MAX_PAGE_SIZE;
+  ASSERT_ERROR(createPageFileWithOptions(TESTPF, &options), "page size above the maximum");
+
+  for (compressed = 0; compressed <= 1; compressed++)
+    for (s = 0; s < 2; s++) {
+      options.pageSize = sizes[s];
+      options.compressed = compressed;
+      ph = (SM_PageHandle) calloc(sizes[s], sizeof(char));
+
+      TEST_CHECK(createPageFileWithOptions(TESTPF, &options));
+      TEST_CHECK(openPageFile(TESTPF, &fh));
+      ASSERT_EQUALS_INT(sizes[s], fh.pageSize, "page size read from the file header");
+      ASSERT_EQUALS_INT(1, fh.totalNumPages, "expect 1 page in new file");
+
+      // fill the last byte of each page to make sure whole pages round-trip
+      TEST_CHECK(ensureCapacity(3, &fh));
+      for (i = 0; i < 3; i++) {
+        memset(ph, 'a' + i, sizes[s]);
+        TEST_CHECK(writeBlock(i, &fh, ph));
+      }
+      TEST_CHECK(closePageFile(&fh));
+
+      TEST_CHECK(openPageFile(TESTPF, &fh));
+      ASSERT_EQUALS_INT(3, fh.totalNumPages, "page count honours the page size");
+      TEST_CHECK(readBlock(2, &fh, ph));
+      ASSERT_TRUE(ph[0] == 'c' && ph[sizes[s] - 1] == 'c', "last page read back completely");
+      TEST_CHECK(closePageFile(&fh));
+
+      TEST_CHECK(destroyPageFile(TESTPF));
+      free(ph);
+    }
+
+  TEST_DONE();
+}
+
+/* Free pages and check that allocatePage hands them out again */
+void testPageReuse(void)
+{
+  SM_FileHandle fh;
+  SM_FileOptions options = {0};
+  SM_PageHandle ph;
+  struct stat st;
+  long long sizeBefore;
+  int compressed, i, pageNum;
+  bool zeroed;
+
+  testName = "test page reuse";
+
+  ph = (SM_PageHandle) malloc(PAGE_SIZE);
+  options.pageSize = PAGE_SIZE;
+
+  for (compressed = 0; compressed <= 1; compressed++) {
+    options.compressed = compressed;
+    TEST_CHECK(createPageFileWithOptions(TESTPF, &options));
+    TEST_CHECK(openPageFile(TESTPF, &fh));
+
+    TEST_CHECK(ensureCapacity(10, &fh));
+    for (i = 0; i < 10; i++) {
+      memset(ph, 'a' + i, PAGE_SIZE);
+      TEST_CHECK(writeBlock(i, &fh, ph));
+    }
+
+    TEST_CHECK(freePage(&fh, 7));
+    TEST_CHECK(freePage(&fh, 3));
+    ASSERT_ERROR(freePage(&fh, 3), "freeing a free page");
+    ASSERT_ERROR(freePage(&fh, 10), "freeing a page past the end of the file");
+    TEST_CHECK(closePageFile(&fh));
+
+    // free pages survive reopening the file
+    stat(TESTPF, &st);
+    sizeBefore = st.st_size;
+    TEST_CHECK(openPageFile(TESTPF, &fh));
+    ASSERT_EQUALS_INT(10, fh.totalNumPages, "freeing pages does not shrink the file");
+
+    TEST_CHECK(allocatePage(&fh, &pageNum));
+    ASSERT_EQUALS_INT(3, pageNum, "lowest free page is reused first");
+    TEST_CHECK(readBlock(pageNum, &fh, ph));
+    zeroed = true;
+    for (i = 0; i < PAGE_SIZE; i++)
+      zeroed = zeroed && (ph[i] == 0);
+    ASSERT_TRUE(zeroed, "reused page is zero-filled");
+
+    TEST_CHECK(allocatePage(&fh, &pageNum));
+    ASSERT_EQUALS_INT(7, pageNum, "second free page is reused");
+    TEST_CHECK(readBlock(8, &fh, ph));
+    ASSERT_TRUE(ph[0] == 'i', "neighbouring pages are untouched");
+
+    TEST_CHECK(closePageFile(&fh));
+    stat(TESTPF, &st);
+    if (!compressed)
+      ASSERT_TRUE(st.st_size == sizeBefore, "reusing pages does not grow the file");
+
+    // with no free page left the file grows by one page
+    TEST_CHECK(openPageFile(TESTPF, &fh));
+    TEST_CHECK(allocatePage(&fh, &pageNum));
+    ASSERT_EQUALS_INT(10, pageNum, "new page appended when none is free");
+    ASSERT_EQUALS_INT(11, fh.totalNumPages, "expect 11 pages after appending");
+    TEST_CHECK(closePageFile(&fh));
+
+    TEST_CHECK(destroyPageFile(TESTPF));
+  }
+
+  free(ph);
+
+  TEST_DONE();
+}
+
+/* Durability modes are validated, stored in the header and can be changed */
+void testDurability(void)
+{
+  SM_FileHandle fh, other;
+  SM_FileOptions options = {.pageSize = PAGE_SIZE, .durability = SM_DURABILITY_GROUP_COMMIT};
+  SM_PageHandle ph;
+  int compressed;
+
+  testName = "test durability modes";
+
+  ASSERT_ERROR(createPageFileWithOptions(TESTPF, &options), "group commit needs an interval");
+  options.durability = 42;
+  ASSERT_ERROR(createPageFileWithOptions(TESTPF, &options), "unknown durability mode");
+
+  ph = (SM_PageHandle) malloc(PAGE_SIZE);
+  memset(ph, 'd', PAGE_SIZE);
+
+  for (compressed = 0; compressed <= 1; compressed++) {
+    options.compressed = compressed;
+    options.durability = SM_DURABILITY_EVERY_WRITE;
+    TEST_CHECK(createPageFileWithOptions(TESTPF, &options));
+
+    TEST_CHECK(openPageFile(TESTPF, &fh));
+    ASSERT_TRUE(getDurability(&fh) == SM_DURABILITY_EVERY_WRITE, "mode read from the file header");
+    TEST_CHECK(ensureCapacity(4, &fh));
+    TEST_CHECK(writeBlock(3, &fh, ph));
+
+    ASSERT_ERROR(setDurability(&fh, SM_DURABILITY_GROUP_COMMIT, -1), "negative group commit interval");
+    TEST_CHECK(setDurability(&fh, SM_DURABILITY_GROUP_COMMIT, 1000));
+    TEST_CHECK(writeBlock(2, &fh, ph));
+    TEST_CHECK(syncOverdueWrites(&fh));
+    ASSERT_ERROR(syncOverdueWrites(NULL), "no overdue writes without a handle");
+    TEST_CHECK(checkpointPageFile(&fh));
+    TEST_CHECK(closePageFile(&fh));
+
+    // setDurability does not change the mode stored in the file
+    TEST_CHECK(openPageFile(TESTPF, &fh));
+    ASSERT_TRUE(getDurability(&fh) == SM_DURABILITY_EVERY_WRITE, "stored mode is kept");
+    ASSERT_EQUALS_INT(4, fh.totalNumPages, "expect 4 pages");
+    TEST_CHECK(readBlock(2, &fh, ph));
+    ASSERT_TRUE(ph[0] == 'd' && ph[PAGE_SIZE - 1] == 'd', "page written under group commit is stored");
+    TEST_CHECK(closePageFile(&fh));
+
+    TEST_CHECK(destroyPageFile(TESTPF));
+  }
+
+  // without syncing, a checkpoint still writes out the compressed page map
+  options.compressed = 1;
+  options.durability = SM_DURABILITY_NONE;
+  TEST_CHECK(createPageFileWithOptions(TESTPF, &options));
+  TEST_CHECK(openPageFile(TESTPF, &fh));
+  TEST_CHECK(ensureCapacity(2, &fh));
+  TEST_CHECK(writeBlock(1, &fh, ph));
+  TEST_CHECK(checkpointPageFile(&fh));
+  TEST_CHECK(openPageFile(TESTPF, &other));
+  ASSERT_EQUALS_INT(2, other.totalNumPages, "checkpointed page count visible");
+  TEST_CHECK(readBlock(1, &other, ph));
+  ASSERT_TRUE(ph[0] == 'd' && ph[PAGE_SIZE - 1] == 'd', "checkpointed page visible");
+  TEST_CHECK(closePageFile(&other));
+  TEST_CHECK(closePageFile(&fh));
+  TEST_CHECK(destroyPageFile(TESTPF));
+
+  free(ph);
+
+  TEST_DONE();
+}
+
+/* Pages of a segmented file spread over several segment files */
+void testSegmentedFile(void)
+{
+  SM_FileHandle fh;
+  SM_FileOptions options = {.pageSize = PAGE_SIZE, .compressed = 1, .durability = SM_DURABILITY_NONE, .segmentPages = 5};
+  SM_PageHandle ph;
+  struct stat st;
+  int i, pageNum;
+
+  testName = "test segmented page files";
+
+  ASSERT_ERROR(createPageFileWithOptions(TESTPF, &options), "compressed files cannot be segmented");
+  options.compressed = 0;
+  options.segmentPages = -1;
+  ASSERT_ERROR(createPageFileWithOptions(TESTPF, &options), "negative segment size");
+
+  // 5 pages per segment: 12 pages need the file plus two segment files
+  options.segmentPages = 5;
+  ph = (SM_PageHandle) malloc(PAGE_SIZE);
+  TEST_CHECK(createPageFileWithOptions(TESTPF, &options));
+  TEST_CHECK(openPageFile(TESTPF, &fh));
+  TEST_CHECK(ensureCapacity(12, &fh));
+  ASSERT_EQUALS_INT(3, getSegmentCount(&fh), "12 pages span 3 segments");
+  for (i = 0; i < 12; i++) {
+    memset(ph, 'a' + i, PAGE_SIZE);
+    TEST_CHECK(writeBlock(i, &fh, ph));
+  }
+  TEST_CHECK(closePageFile(&fh));
+
+  ASSERT_TRUE(stat(TESTPF ".2", &st) == 0, "third segment file exists");
+  ASSERT_TRUE(stat(TESTPF ".3", &st) != 0, "no fourth segment file");
+
+  // the page count is rebuilt from the segment files
+  TEST_CHECK(openPageFile(TESTPF, &fh));
+  ASSERT_EQUALS_INT(12, fh.totalNumPages, "expect 12 pages after reopening");
+  for (i = 11; i >= 0; i--) {
+    TEST_CHECK(readBlock(i, &fh, ph));
+    ASSERT_TRUE(ph[0] == 'a' + i && ph[PAGE_SIZE - 1] == 'a' + i, "page read back from its segment");
+  }
+
+  // released segments reopen on their next access
+  TEST_CHECK(prefetchSegment(&fh, 1));
+  TEST_CHECK(releaseSegment(&fh, 1));
+  ASSERT_ERROR(releaseSegment(&fh, 3), "releasing a segment past the end");
+  TEST_CHECK(readBlock(6, &fh, ph));
+  ASSERT_TRUE(ph[0] == 'g', "page read after releasing its segment");
+
+  // free pages are tracked per segment
+  TEST_CHECK(freePage(&fh, 10));
+  TEST_CHECK(freePage(&fh, 6));
+  TEST_CHECK(allocatePage(&fh, &pageNum));
+  ASSERT_EQUALS_INT(6, pageNum, "free page in the second segment reused");
+  TEST_CHECK(allocatePage(&fh, &pageNum));
+  ASSERT_EQUALS_INT(10, pageNum, "free page in the third segment reused");
+  TEST_CHECK(readBlock(11, &fh, ph));
+  ASSERT_TRUE(ph[0] == 'l', "neighbouring page untouched");
+  TEST_CHECK(closePageFile(&fh));
+
+  TEST_CHECK(destroyPageFile(TESTPF));
+  ASSERT_TRUE(stat(TESTPF ".1", &st) != 0, "segment files destroyed with the file");
+  free(ph);
+
+  TEST_DONE();
+}
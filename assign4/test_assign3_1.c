@@ -0,0 +1,2414 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include "dberror.h"
+#include "expr.h"
+#include "record_mgr.h"
+#include "tables.h"
+#include "test_helper.h"
+
+#define ASSERT_EQUALS_RECORDS(_l, _r, schema, message)                              \
+  do                                                                                \
+  {                                                                                 \
+    Record *_lR = _l;                                                               \
+    Record *_rR = _r;                                                               \
+    ASSERT_TRUE(memcmp(_lR->data, _rR->data, getRecordSize(schema)) == 0, message); \
+    int i;                                                                          \
+    for (i = 0; i < schema->numAttr; i++)                                           \
+    {                                                                               \
+      Value *lVal, *rVal;                                                           \
+      char *lSer, *rSer;                                                            \
+      getAttr(_lR, schema, i, &lVal);                                               \
+      getAttr(_rR, schema, i, &rVal);                                               \
+      lSer = serializeValue(lVal);                                                  \
+      rSer = serializeValue(rVal);                                                  \
+      ASSERT_EQUALS_STRING(lSer, rSer, "attr same");                                \
+      free(lVal);                                                                   \
+      free(rVal);                                                                   \
+      free(lSer);                                                                   \
+      free(rSer);                                                                   \
+    }                                                                               \
+  } while (0)
+
+#define ASSERT_EQUALS_RECORD_IN(_l, _r, rSize, schema, message)      \
+  do                                                                 \
+  {                                                                  \
+    int i;                                                           \
+    boolean found = false;                                           \
+    for (i = 0; i < rSize; i++)                                      \
+      if (memcmp(_l->data, _r[i]->data, getRecordSize(schema)) == 0) \
+        found = true;                                                \
+    ASSERT_TRUE(found, message);                                     \
+  } while (0)
+
+#define OP_TRUE(left, right, op, message)           \
+  do                                                \
+  {                                                 \
+    Value *result = (Value *)malloc(sizeof(Value)); \
+    op(left, right, result);                        \
+    bool b = result->v.boolV;                       \
+    free(result);                                   \
+    ASSERT_TRUE(b, message);                        \
+  } while (0)
+
+// test methods
+static void testRecords(void);
+static void testCreateTableAndInsert(void);
+static void testUpdateTable(void);
+static void testScans(void);
+static void testScansTwo(void);
+static void testInsertManyRecords(void);
+static void testMultipleScans(void);
+static void testMultipleOpenTables(void);
+static void testFreeSpaceReuse(void);
+static void testEmptyPageReuse(void);
+static void testScanSkipsDeletedRecords(void);
+static void testScanKeepsPagePinned(void);
+static void testRecordViews(void);
+static void testAttributeOffsets(void);
+static void testGetRecords(void);
+static void testProjectedScans(void);
+static void testBatchScans(void);
+static void testParallelScan(void);
+static void testScanFilters(void);
+static void testScanArena(void);
+static void testRecordPool(void);
+static void testVariableLengthRecords(void);
+static void testInsertRecords(void);
+static void testLoadTableFromCSV(void);
+static void testZoneMaps(void);
+
+// struct for test records
+typedef struct TestRecord
+{
+  int a;
+  char *b;
+  int c;
+} TestRecord;
+
+// helper methods
+Record *testRecord(Schema *schema, int a, char *b, int c);
+Schema *testSchema(void);
+Record *fromTestRecord(Schema *schema, TestRecord in);
+
+// test name
+char *testName;
+
+// main method
+int main(void)
+{
+  testName = "";
+
+  testInsertManyRecords();
+  testRecords();
+  testCreateTableAndInsert();
+  testUpdateTable();
+  testScans();
+  testScansTwo();
+  testMultipleScans();
+  testMultipleOpenTables();
+  testFreeSpaceReuse();
+  testEmptyPageReuse();
+  testScanSkipsDeletedRecords();
+  testScanKeepsPagePinned();
+  testRecordViews();
+  testAttributeOffsets();
+  testGetRecords();
+  testProjectedScans();
+  testBatchScans();
+  testParallelScan();
+  testScanFilters();
+  testScanArena();
+  testRecordPool();
+  testVariableLengthRecords();
+  testInsertRecords();
+  testLoadTableFromCSV();
+  testZoneMaps();
+
+  return 0;
+}
+
+// ************************************************************
+void testRecords(void)
+{
+  TestRecord expected[] = {
+      {1, "aaaa", 3},
+  };
+  Schema *schema;
+  Record *r;
+  Value *value;
+  testName = "test creating records and manipulating attributes";
+
+  // check attributes of created record
+  schema = testSchema();
+  r = fromTestRecord(schema, expected[0]);
+
+  getAttr(r, schema, 0, &value);
+  OP_TRUE(stringToValue("i1"), value, valueEquals, "first attr");
+  freeVal(value);
+
+  getAttr(r, schema, 1, &value);
+  OP_TRUE(stringToValue("saaaa"), value, valueEquals, "second attr");
+  freeVal(value);
+
+  getAttr(r, schema, 2, &value);
+  OP_TRUE(stringToValue("i3"), value, valueEquals, "third attr");
+  freeVal(value);
+
+  // modify attrs
+  setAttr(r, schema, 2, stringToValue("i4"));
+  getAttr(r, schema, 2, &value);
+  OP_TRUE(stringToValue("i4"), value, valueEquals, "third attr after setting");
+  freeVal(value);
+
+  freeRecord(r);
+  freeSchema(schema); // added Summer 2021
+  TEST_DONE();
+}
+
+// ************************************************************
+void testCreateTableAndInsert(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord inserts[] = {
+      {1, "aaaa", 3},
+      {2, "bbbb", 2},
+      {3, "cccc", 1},
+      {4, "dddd", 3},
+      {5, "eeee", 5},
+      {6, "ffff", 1},
+      {7, "gggg", 3},
+      {8, "hhhh", 3},
+      {9, "iiii", 2}};
+  int numInserts = 9, i;
+  Record *r;
+  RID *rids;
+  Schema *schema;
+  testName = "test creating a new table and inserting tuples";
+  schema = testSchema();
+  rids = (RID *)malloc(sizeof(RID) * numInserts);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_r", schema));
+  TEST_CHECK(openTable(table, "test_table_r"));
+
+  // insert rows into table
+  for (i = 0; i < numInserts; i++)
+  {
+    r = fromTestRecord(schema, inserts[i]);
+    TEST_CHECK(insertRecord(table, r));
+    rids[i] = r->id;
+    freeRecord(r); // added Fall 2021
+  }
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_r"));
+
+  // randomly retrieve records from the table and compare to inserted ones
+  for (i = 0; i < 1000; i++)
+  {
+    TEST_CHECK(createRecord(&r, schema)); // added Fall 2021
+    int pos = rand() % numInserts;
+    RID rid = rids[pos];
+    TEST_CHECK(getRecord(table, rid, r));
+    ASSERT_EQUALS_RECORDS(fromTestRecord(schema, inserts[pos]), r, schema, "compare records");
+    freeRecord(r); // Added: Summer 2021
+  }
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_r"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(rids);
+  free(table);
+  freeSchema(schema); // Added: Summer 2021
+  TEST_DONE();
+}
+
+void testMultipleScans(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord inserts[] = {
+      {1, "aaaa", 3},
+      {2, "bbbb", 2},
+      {3, "cccc", 1},
+      {4, "dddd", 3},
+      {5, "eeee", 5},
+      {6, "ffff", 1},
+      {7, "gggg", 3},
+      {8, "hhhh", 3},
+      {9, "iiii", 2},
+      {10, "jjjj", 5},
+  };
+  int numInserts = 10, i, scanOne = 0, scanTwo = 0;
+  Record *r;
+  RID *rids;
+  Schema *schema;
+  testName = "test running muliple scans ";
+  schema = testSchema();
+  rids = (RID *)malloc(sizeof(RID) * numInserts);
+  RM_ScanHandle *sc1 = (RM_ScanHandle *)malloc(sizeof(RM_ScanHandle));
+  RM_ScanHandle *sc2 = (RM_ScanHandle *)malloc(sizeof(RM_ScanHandle));
+  Expr *se1, *left, *right;
+  int rc, rc2;
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_r", schema));
+  TEST_CHECK(openTable(table, "test_table_r"));
+
+  // insert rows into table
+  for (i = 0; i < numInserts; i++)
+  {
+    r = fromTestRecord(schema, inserts[i]);
+    TEST_CHECK(insertRecord(table, r));
+    rids[i] = r->id;
+    freeRecord(r); // Added: Summer 2021
+  }
+
+  // Mix 2 scans with c=3 as condition
+  MAKE_CONS(left, stringToValue("i3"));
+  MAKE_ATTRREF(right, 2);
+  MAKE_BINOP_EXPR(se1, left, right, OP_COMP_EQUAL);
+  createRecord(&r, schema);
+  TEST_CHECK(startScan(table, sc1, se1));
+  TEST_CHECK(startScan(table, sc2, se1));
+  if ((rc2 = next(sc2, r)) == RC_OK)
+    scanTwo++;
+  i = 0;
+  while ((rc = next(sc1, r)) == RC_OK)
+  {
+    scanOne++;
+    i++;
+    if (i % 3 == 0)
+      if ((rc2 = next(sc2, r)) == RC_OK)
+        scanTwo++;
+  }
+  while ((rc2 = next(sc2, r)) == RC_OK)
+    scanTwo++;
+
+  ASSERT_TRUE(scanOne == scanTwo, "scans returned same number of tuples");
+  if (rc != RC_RM_NO_MORE_TUPLES)
+    TEST_CHECK(rc);
+  TEST_CHECK(closeScan(sc1));
+  TEST_CHECK(closeScan(sc2));
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_r"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(rids);
+  free(table);
+  // ****** Added Summer 2021
+  freeRecord(r);
+  free(sc1);
+  free(sc2);
+  freeExpr(se1);
+  freeSchema(schema);
+  // *******
+  TEST_DONE();
+}
+
+void testUpdateTable(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord inserts[] = {
+      {1, "aaaa", 3},
+      {2, "bbbb", 2},
+      {3, "cccc", 1},
+      {4, "dddd", 3},
+      {5, "eeee", 5},
+      {6, "ffff", 1},
+      {7, "gggg", 3},
+      {8, "hhhh", 3},
+      {9, "iiii", 2},
+      {10, "jjjj", 5},
+  };
+  TestRecord updates[] = {
+      {1, "iiii", 6},
+      {2, "iiii", 6},
+      {3, "iiii", 6}};
+  int deletes[] = {
+      9,
+      6,
+      7,
+      8,
+      5};
+  TestRecord finalR[] = {
+      {1, "iiii", 6},
+      {2, "iiii", 6},
+      {3, "iiii", 6},
+      {4, "dddd", 3},
+      {5, "eeee", 5},
+  };
+  int numInserts = 10, numUpdates = 3, numDeletes = 5, numFinal = 5, i;
+  Record *r;
+  RID *rids;
+  Schema *schema;
+  testName = "test creating a new table and insert,update,delete tuples";
+  schema = testSchema();
+  rids = (RID *)malloc(sizeof(RID) * numInserts);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_r", schema));
+  TEST_CHECK(openTable(table, "test_table_r"));
+
+  // insert rows into table
+  for (i = 0; i < numInserts; i++)
+  {
+    r = fromTestRecord(schema, inserts[i]);
+    TEST_CHECK(insertRecord(table, r));
+    rids[i] = r->id;
+    freeRecord(r); // Added Summer 2021
+  }
+
+  // delete rows from table
+  TEST_CHECK(createRecord(&r, schema)); // added Fall 2021
+  for (i = 0; i < numDeletes; i++)
+  {
+    TEST_CHECK(deleteRecord(table, rids[deletes[i]]));
+    ASSERT_ERROR(getRecord(table, rids[deletes[i]], r), "try to access record after you delete it"); // Added Summer 2021
+  }
+  freeRecord(r); // Added Summer 2021
+
+  // update rows into table
+  for (i = 0; i < numUpdates; i++)
+  {
+    r = fromTestRecord(schema, updates[i]);
+    r->id = rids[i];
+    TEST_CHECK(updateRecord(table, r));
+    freeRecord(r); // Added Summer 2021
+  }
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_r"));
+
+  // retrieve records from the table and compare to expected final stage
+  TEST_CHECK(createRecord(&r, schema)); // Added Summer 2021
+  for (i = 0; i < numFinal; i++)
+  {
+    RID rid = rids[i];
+    TEST_CHECK(getRecord(table, rid, r));
+    ASSERT_EQUALS_RECORDS(fromTestRecord(schema, finalR[i]), r, schema, "compare records");
+  }
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_r"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(table);
+  // ***** Added Summer 2021
+  free(rids);
+  freeRecord(r);
+  freeSchema(schema);
+  // *****
+  TEST_DONE();
+}
+
+void testInsertManyRecords(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord inserts[] = {
+      {1, "aaaa", 3},
+      {2, "bbbb", 2},
+      {3, "cccc", 1},
+      {4, "dddd", 3},
+      {5, "eeee", 5},
+      {6, "ffff", 1},
+      {7, "gggg", 3},
+      {8, "hhhh", 3},
+      {9, "iiii", 2},
+      {10, "jjjj", 5},
+  };
+  TestRecord realInserts[10000];
+  TestRecord updates[] = {
+      {3333, "iiii", 6}};
+  int numInserts = 10000, i;
+  int randomRec = 3333;
+  Record *r;
+  RID *rids;
+  Schema *schema;
+  testName = "test creating a new table and inserting 10000 records then updating record from rids[3333]";
+  schema = testSchema();
+  rids = (RID *)malloc(sizeof(RID) * numInserts);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_t", schema));
+  TEST_CHECK(openTable(table, "test_table_t"));
+
+  // insert rows into table
+  for (i = 0; i < numInserts; i++)
+  {
+    realInserts[i] = inserts[i % 10];
+    realInserts[i].a = i;
+    r = fromTestRecord(schema, realInserts[i]);
+    TEST_CHECK(insertRecord(table, r));
+    rids[i] = r->id;
+    freeRecord(r); // Added Summer 2021
+  }
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_t"));
+
+  // retrieve records from the table and compare to expected final stage
+  TEST_CHECK(createRecord(&r, schema)); // Added Summer 2021
+  for (i = 0; i < numInserts; i++)
+  {
+    RID rid = rids[i];
+    TEST_CHECK(getRecord(table, rid, r));
+    ASSERT_EQUALS_RECORDS(fromTestRecord(schema, realInserts[i]), r, schema, "compare records");
+  }
+  freeRecord(r); // Added Summer 2021
+
+  r = fromTestRecord(schema, updates[0]);
+  r->id = rids[randomRec];
+  TEST_CHECK(updateRecord(table, r));
+  TEST_CHECK(getRecord(table, rids[randomRec], r));
+  ASSERT_EQUALS_RECORDS(fromTestRecord(schema, updates[0]), r, schema, "compare records");
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_t"));
+  TEST_CHECK(shutdownRecordManager());
+
+  freeRecord(r);
+  free(table);
+  // ***** Added Summer 2021
+  free(rids);
+  freeSchema(schema);
+  // *****
+  TEST_DONE();
+}
+
+void testMultipleOpenTables(void)
+{
+  RM_TableData *tableR = (RM_TableData *)malloc(sizeof(RM_TableData));
+  RM_TableData *tableS = (RM_TableData *)malloc(sizeof(RM_TableData));
+  RM_TableData *tableR2 = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord insertsR[] = {
+      {1, "aaaa", 3},
+      {2, "bbbb", 2},
+      {3, "cccc", 3},
+      {4, "dddd", 1},
+  };
+  TestRecord insertsS[] = {
+      {10, "wwww", 3},
+      {20, "xxxx", 3},
+      {30, "yyyy", 3},
+  };
+  int numR = 4, numS = 3, i, found = 0;
+  Record *r;
+  RID ridsR[4], ridsS[3];
+  Schema *schema;
+  RM_ScanHandle *sc = (RM_ScanHandle *)malloc(sizeof(RM_ScanHandle));
+  Expr *sel, *left, *right;
+  int rc;
+
+  testName = "test multiple tables open at the same time";
+  schema = testSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_r", schema));
+  TEST_CHECK(createTable("test_table_s", schema));
+  TEST_CHECK(openTable(tableR, "test_table_r"));
+  TEST_CHECK(openTable(tableS, "test_table_s"));
+
+  // interleave inserts so both tables are written through their own pools
+  for (i = 0; i < numR; i++)
+  {
+    r = fromTestRecord(schema, insertsR[i]);
+    TEST_CHECK(insertRecord(tableR, r));
+    ridsR[i] = r->id;
+    freeRecord(r);
+    if (i < numS)
+    {
+      r = fromTestRecord(schema, insertsS[i]);
+      TEST_CHECK(insertRecord(tableS, r));
+      ridsS[i] = r->id;
+      freeRecord(r);
+    }
+  }
+  ASSERT_EQUALS_INT(numR, getNumTuples(tableR), "tuples in first table");
+  ASSERT_EQUALS_INT(numS, getNumTuples(tableS), "tuples in second table");
+
+  // a second handle of an open table shares its state
+  TEST_CHECK(openTable(tableR2, "test_table_r"));
+  ASSERT_TRUE(tableR2->mgmtData == tableR->mgmtData, "handles of one table share their state");
+  ASSERT_EQUALS_INT(numR, getNumTuples(tableR2), "second handle sees the inserted tuples");
+  TEST_CHECK(closeTable(tableR2));
+
+  TEST_CHECK(createRecord(&r, schema));
+  for (i = 0; i < numR; i++)
+  {
+    TEST_CHECK(getRecord(tableR, ridsR[i], r));
+    ASSERT_EQUALS_RECORDS(fromTestRecord(schema, insertsR[i]), r, schema, "record of first table");
+  }
+  for (i = 0; i < numS; i++)
+  {
+    TEST_CHECK(getRecord(tableS, ridsS[i], r));
+    ASSERT_EQUALS_RECORDS(fromTestRecord(schema, insertsS[i]), r, schema, "record of second table");
+  }
+
+  // scanning one table does not see the other
+  MAKE_CONS(left, stringToValue("i3"));
+  MAKE_ATTRREF(right, 2);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+  TEST_CHECK(startScan(tableR, sc, sel));
+  while ((rc = next(sc, r)) == RC_OK)
+    found++;
+  if (rc != RC_RM_NO_MORE_TUPLES)
+    TEST_CHECK(rc);
+  TEST_CHECK(closeScan(sc));
+  ASSERT_EQUALS_INT(2, found, "scan of first table finds its two matches");
+  freeRecord(r);
+
+  TEST_CHECK(closeTable(tableR));
+  TEST_CHECK(deleteTable("test_table_r"));
+
+  // shutting down closes tables that are still open
+  TEST_CHECK(shutdownRecordManager());
+  TEST_CHECK(deleteTable("test_table_s"));
+
+  free(tableR);
+  free(tableS);
+  free(tableR2);
+  free(sc);
+  freeExpr(sel);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+void testFreeSpaceReuse(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord filler = {0, "ffff", 1};
+  int numInserts = 2000, i;
+  int deletes[] = {1500, 10};
+  int found;
+  RM_ScanHandle sc;
+  Expr *sel;
+  Record *r;
+  RID *rids;
+  Schema *schema;
+  testName = "test inserts reuse slots through the free-space map";
+  schema = testSchema();
+  rids = (RID *)malloc(sizeof(RID) * numInserts);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_f", schema));
+  TEST_CHECK(openTable(table, "test_table_f"));
+
+  // fill several pages
+  for (i = 0; i < numInserts; i++)
+  {
+    filler.a = i;
+    r = fromTestRecord(schema, filler);
+    TEST_CHECK(insertRecord(table, r));
+    rids[i] = r->id;
+    freeRecord(r);
+  }
+  ASSERT_TRUE(rids[numInserts - 1].page > rids[0].page + 4, "records spread over several pages");
+
+  // free one slot on an early and one on a late page, then reopen the table
+  for (i = 0; i < 2; i++)
+    TEST_CHECK(deleteRecord(table, rids[deletes[i]]));
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_f"));
+
+  // a scan passes over the freed slots
+  TEST_CHECK(createRecord(&r, schema));
+  MAKE_CONS(sel, stringToValue("bt"));
+  TEST_CHECK(startScan(table, &sc, sel));
+  for (found = 0; next(&sc, r) == RC_OK; found++)
+    ASSERT_TRUE(r->id.page != rids[1500].page || r->id.slot != rids[1500].slot, "freed slot not scanned");
+  TEST_CHECK(closeScan(&sc));
+  ASSERT_EQUALS_INT(numInserts - 2, found, "scan skips the freed slots");
+  freeExpr(sel);
+  freeRecord(r);
+
+  // the freed slots are found again, lowest page first, before the table grows
+  filler.a = -1;
+  r = fromTestRecord(schema, filler);
+  TEST_CHECK(insertRecord(table, r));
+  ASSERT_TRUE(r->id.page == rids[10].page && r->id.slot == rids[10].slot, "slot on the early page reused");
+  TEST_CHECK(insertRecord(table, r));
+  ASSERT_TRUE(r->id.page == rids[1500].page && r->id.slot == rids[1500].slot, "slot on the late page reused");
+  TEST_CHECK(insertRecord(table, r));
+  ASSERT_TRUE(r->id.page == rids[numInserts - 1].page, "next insert goes to the last page");
+
+  // records next to the reused slots are untouched
+  TEST_CHECK(getRecord(table, rids[11], r));
+  filler.a = 11;
+  ASSERT_EQUALS_RECORDS(fromTestRecord(schema, filler), r, schema, "neighbouring record");
+  freeRecord(r);
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_f"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(rids);
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+void testEmptyPageReuse(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord filler = {0, "ffff", 1};
+  int numInserts = 2000, i;
+  int emptied, lastPage, perPage = 0;
+  int found;
+  RM_ScanHandle sc;
+  Expr *sel;
+  Record *r;
+  RID *rids;
+  Schema *schema;
+  testName = "test emptied data pages are released and allocated again";
+  schema = testSchema();
+  rids = (RID *)malloc(sizeof(RID) * numInserts);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_g", schema));
+  TEST_CHECK(openTable(table, "test_table_g"));
+
+  for (i = 0; i < numInserts; i++)
+  {
+    filler.a = i;
+    r = fromTestRecord(schema, filler);
+    TEST_CHECK(insertRecord(table, r));
+    rids[i] = r->id;
+    freeRecord(r);
+  }
+  emptied = rids[0].page;
+  lastPage = rids[numInserts - 1].page;
+
+  // delete every record of the first data page, then reopen the table
+  for (i = 0; i < numInserts; i++)
+  {
+    if (rids[i].page == emptied)
+    {
+      TEST_CHECK(deleteRecord(table, rids[i]));
+      perPage++;
+    }
+  }
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_g"));
+
+  // a scan passes over the released page
+  TEST_CHECK(createRecord(&r, schema));
+  MAKE_CONS(sel, stringToValue("bt"));
+  TEST_CHECK(startScan(table, &sc, sel));
+  for (found = 0; next(&sc, r) == RC_OK; found++)
+    ASSERT_TRUE(r->id.page != emptied, "released page not scanned");
+  TEST_CHECK(closeScan(&sc));
+  ASSERT_EQUALS_INT(numInserts - perPage, found, "scan skips the released page");
+  freeExpr(sel);
+  freeRecord(r);
+
+  // once the last page is full, the table takes the released page before growing
+  filler.a = -1;
+  r = fromTestRecord(schema, filler);
+  do
+  {
+    TEST_CHECK(insertRecord(table, r));
+  } while (r->id.page == lastPage);
+  ASSERT_EQUALS_INT(emptied, r->id.page, "released page allocated again");
+  ASSERT_EQUALS_INT(0, r->id.slot, "allocated page starts empty");
+  freeRecord(r);
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_g"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(rids);
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+void testScanSkipsDeletedRecords(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord inserts[] = {
+      {1, "aaaa", 3},
+      {2, "bbbb", 2},
+      {3, "cccc", 1},
+      {4, "dddd", 3},
+      {5, "eeee", 5},
+      {6, "ffff", 1},
+      {7, "gggg", 3},
+      {8, "hhhh", 3},
+      {9, "iiii", 2},
+      {10, "jjjj", 5},
+  };
+  TestRecord scanResult[] = {
+      {4, "dddd", 3},
+      {8, "hhhh", 3},
+  };
+  int deletes[] = {0, 2, 6};
+  int numInserts = 10, numDeletes = 3, scanSizeOut = 2, i, rc;
+  bool foundScan[] = {FALSE, FALSE};
+  Record *r;
+  RID *rids, meta;
+  Schema *schema;
+  RM_ScanHandle *sc = (RM_ScanHandle *)malloc(sizeof(RM_ScanHandle));
+  Expr *sel, *left, *right;
+  testName = "test scans skip deleted records";
+  schema = testSchema();
+  rids = (RID *)malloc(sizeof(RID) * numInserts);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_d", schema));
+  TEST_CHECK(openTable(table, "test_table_d"));
+
+  for (i = 0; i < numInserts; i++)
+  {
+    r = fromTestRecord(schema, inserts[i]);
+    TEST_CHECK(insertRecord(table, r));
+    rids[i] = r->id;
+    freeRecord(r);
+  }
+  for (i = 0; i < numDeletes; i++)
+    TEST_CHECK(deleteRecord(table, rids[deletes[i]]));
+  ASSERT_EQUALS_INT(numInserts - numDeletes, getNumTuples(table), "deletes lower the tuple count");
+
+  // deleted slots are gone for reads, updates and repeated deletes
+  createRecord(&r, schema);
+  ASSERT_EQUALS_INT(RC_RM_NO_TUPLE_WITH_GIVEN_RID, getRecord(table, rids[0], r), "deleted record not found");
+  r->id = rids[2];
+  ASSERT_EQUALS_INT(RC_RM_NO_TUPLE_WITH_GIVEN_RID, updateRecord(table, r), "deleted record not updated");
+  ASSERT_EQUALS_INT(RC_RM_NO_TUPLE_WITH_GIVEN_RID, deleteRecord(table, rids[6]), "deleted record not deleted twice");
+
+  // RIDs on the metadata page name no record
+  meta.page = 0;
+  meta.slot = 0;
+  ASSERT_EQUALS_INT(RC_RM_NO_TUPLE_WITH_GIVEN_RID, getRecord(table, meta, r), "no record on the metadata page");
+  ASSERT_EQUALS_INT(RC_RM_NO_TUPLE_WITH_GIVEN_RID, getRecords(table, &meta, 1, &r), "no batch read of the metadata page");
+  r->id = meta;
+  ASSERT_EQUALS_INT(RC_RM_NO_TUPLE_WITH_GIVEN_RID, updateRecord(table, r), "metadata page not updated");
+  ASSERT_EQUALS_INT(RC_RM_NO_TUPLE_WITH_GIVEN_RID, deleteRecord(table, meta), "metadata page not deleted from");
+  ASSERT_EQUALS_INT(numInserts - numDeletes, getNumTuples(table), "tuple count untouched");
+
+  // scan with c=3 only returns the records that are still there
+  MAKE_CONS(left, stringToValue("i3"));
+  MAKE_ATTRREF(right, 2);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+  TEST_CHECK(startScan(table, sc, sel));
+  while ((rc = next(sc, r)) == RC_OK)
+  {
+    for (i = 0; i < scanSizeOut; i++)
+    {
+      if (memcmp(fromTestRecord(schema, scanResult[i])->data, r->data, getRecordSize(schema)) == 0)
+        foundScan[i] = TRUE;
+    }
+  }
+  if (rc != RC_RM_NO_MORE_TUPLES)
+    TEST_CHECK(rc);
+  TEST_CHECK(closeScan(sc));
+  for (i = 0; i < scanSizeOut; i++)
+    ASSERT_TRUE(foundScan[i], "check for scan result");
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_d"));
+  TEST_CHECK(shutdownRecordManager());
+
+  freeRecord(r);
+  free(rids);
+  free(table);
+  free(sc);
+  freeExpr(sel);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+void testScanKeepsPagePinned(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord inserts[] = {
+      {1, "aaaa", 3},
+      {2, "bbbb", 2},
+      {3, "cccc", 3},
+      {4, "dddd", 3},
+      {5, "eeee", 5},
+  };
+  int numInserts = 5, i, found = 0, rc;
+  Record *r, *u;
+  Schema *schema;
+  RM_ScanHandle *sc = (RM_ScanHandle *)malloc(sizeof(RM_ScanHandle));
+  Expr *sel, *left, *right;
+  testName = "test scans hold one pin per page";
+  schema = testSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_p", schema));
+  TEST_CHECK(openTable(table, "test_table_p"));
+
+  for (i = 0; i < numInserts; i++)
+  {
+    r = fromTestRecord(schema, inserts[i]);
+    TEST_CHECK(insertRecord(table, r));
+    freeRecord(r);
+  }
+
+  // records on the page the scan holds can be updated between calls to next
+  MAKE_CONS(left, stringToValue("i3"));
+  MAKE_ATTRREF(right, 2);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+  createRecord(&r, schema);
+  TEST_CHECK(startScan(table, sc, sel));
+  while ((rc = next(sc, r)) == RC_OK)
+  {
+    u = testRecord(schema, found, "zzzz", 3);
+    u->id = r->id;
+    TEST_CHECK(updateRecord(table, u));
+    freeRecord(u);
+    found++;
+  }
+  ASSERT_EQUALS_INT(RC_RM_NO_MORE_TUPLES, rc, "scan ends after the last page");
+  ASSERT_EQUALS_INT(3, found, "scan finds every match");
+  TEST_CHECK(closeScan(sc));
+
+  // a scan closed before its end releases its page, so the table closes
+  TEST_CHECK(startScan(table, sc, sel));
+  TEST_CHECK(next(sc, r));
+  ASSERT_EQUALS_RECORDS(testRecord(schema, 0, "zzzz", 3), r, schema, "updates seen by the scan");
+  TEST_CHECK(closeScan(sc));
+  TEST_CHECK(closeTable(table));
+
+  TEST_CHECK(deleteTable("test_table_p"));
+  TEST_CHECK(shutdownRecordManager());
+
+  freeRecord(r);
+  free(table);
+  free(sc);
+  freeExpr(sel);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+void testRecordViews(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord inserts[] = {
+      {1, "aaaa", 3},
+      {2, "bb", 2},
+      {3, "cccc", 3},
+      {4, "", 1},
+  };
+  int numInserts = 4, i, a, found = 0, len, rc;
+  float f;
+  char *str;
+  Record *r;
+  RID *rids;
+  Schema *schema;
+  RM_RecordView view;
+  RM_ScanHandle *sc = (RM_ScanHandle *)malloc(sizeof(RM_ScanHandle));
+  Expr *sel, *left, *right;
+  testName = "test reading records through views";
+  schema = testSchema();
+  rids = (RID *)malloc(sizeof(RID) * numInserts);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_v", schema));
+  TEST_CHECK(openTable(table, "test_table_v"));
+
+  for (i = 0; i < numInserts; i++)
+  {
+    r = fromTestRecord(schema, inserts[i]);
+    TEST_CHECK(insertRecord(table, r));
+    rids[i] = r->id;
+    freeRecord(r);
+  }
+
+  // attributes are read in place, strings come with their length
+  for (i = 0; i < numInserts; i++)
+  {
+    TEST_CHECK(getRecordView(table, rids[i], &view));
+    TEST_CHECK(getIntAttr(&view, 0, &a));
+    ASSERT_EQUALS_INT(inserts[i].a, a, "int read through view");
+    TEST_CHECK(getStringAttrView(&view, 1, &str, &len));
+    ASSERT_EQUALS_INT((int)strlen(inserts[i].b), len, "string length through view");
+    ASSERT_TRUE(memcmp(inserts[i].b, str, len) == 0, "string read through view");
+    TEST_CHECK(getIntAttr(&view, 2, &a));
+    ASSERT_EQUALS_INT(inserts[i].c, a, "last attribute read through view");
+    ASSERT_EQUALS_INT(RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE, getFloatAttr(&view, 0, &f), "type is checked");
+    TEST_CHECK(releaseRecordView(&view));
+  }
+
+  TEST_CHECK(deleteRecord(table, rids[1]));
+  ASSERT_EQUALS_INT(RC_RM_NO_TUPLE_WITH_GIVEN_RID, getRecordView(table, rids[1], &view), "no view of a deleted record");
+
+  // scans hand out views borrowing their pin
+  MAKE_CONS(left, stringToValue("i3"));
+  MAKE_ATTRREF(right, 2);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+  TEST_CHECK(startScan(table, sc, sel));
+  while ((rc = nextView(sc, &view)) == RC_OK)
+  {
+    TEST_CHECK(getIntAttr(&view, 0, &a));
+    ASSERT_TRUE(a == 1 || a == 3, "scan view matches the condition");
+    found++;
+  }
+  ASSERT_EQUALS_INT(RC_RM_NO_MORE_TUPLES, rc, "view scan ends");
+  ASSERT_EQUALS_INT(2, found, "view scan finds every match");
+  TEST_CHECK(closeScan(sc));
+
+  // every view released its pin, so the table closes
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_v"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(rids);
+  free(table);
+  free(sc);
+  freeExpr(sel);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+void testAttributeOffsets(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  int expected[] = {1, 5, 9};
+  int i;
+  Schema *schema;
+  testName = "test precomputed attribute offsets";
+  schema = testSchema();
+
+  // createSchema works the layout out once
+  ASSERT_TRUE(schema->attrOffsets != NULL, "offsets set up by createSchema");
+  ASSERT_EQUALS_INT(13, getRecordSize(schema), "record size");
+  for (i = 0; i < schema->numAttr; i++)
+    ASSERT_EQUALS_INT(expected[i], schema->attrOffsets[i], "attribute offset");
+
+  // the schema read back by openTable has the same layout
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_o", schema));
+  TEST_CHECK(openTable(table, "test_table_o"));
+  ASSERT_TRUE(table->schema->attrOffsets != NULL, "offsets set up by openTable");
+  ASSERT_EQUALS_INT(getRecordSize(schema), getRecordSize(table->schema), "same record size after reopening");
+  for (i = 0; i < schema->numAttr; i++)
+    ASSERT_EQUALS_INT(expected[i], table->schema->attrOffsets[i], "same offset after reopening");
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_o"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+void testGetRecords(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  int numInserts = 1000, numWanted = 500, i;
+  Record **records, *r, *expected;
+  RID *rids, *wanted;
+  Schema *schema;
+  char str[5];
+  testName = "test reading records in batches";
+  schema = testSchema();
+  rids = (RID *)malloc(sizeof(RID) * numInserts);
+  wanted = (RID *)malloc(sizeof(RID) * numWanted);
+  records = (Record **)malloc(sizeof(Record *) * numWanted);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_g", schema));
+  TEST_CHECK(openTable(table, "test_table_g"));
+
+  for (i = 0; i < numInserts; i++)
+  {
+    sprintf(str, "%04d", i);
+    r = testRecord(schema, i, str, i % 7);
+    TEST_CHECK(insertRecord(table, r));
+    rids[i] = r->id;
+    freeRecord(r);
+  }
+  ASSERT_TRUE(rids[numInserts - 1].page != rids[0].page, "records span several pages");
+
+  // RIDs in an order that jumps between pages come back in that order
+  for (i = 0; i < numWanted; i++)
+  {
+    wanted[i] = rids[(i * 7919) % numInserts];
+    createRecord(&records[i], schema);
+  }
+  TEST_CHECK(getRecords(table, wanted, numWanted, records));
+  for (i = 0; i < numWanted; i++)
+  {
+    int a = (i * 7919) % numInserts;
+    sprintf(str, "%04d", a);
+    expected = testRecord(schema, a, str, a % 7);
+    ASSERT_EQUALS_RECORDS(expected, records[i], schema, "record read in batch");
+    ASSERT_TRUE(records[i]->id.page == wanted[i].page && records[i]->id.slot == wanted[i].slot, "RID of batch record");
+    freeRecord(expected);
+  }
+
+  // a deleted record fails the batch
+  TEST_CHECK(deleteRecord(table, wanted[3]));
+  ASSERT_EQUALS_INT(RC_RM_NO_TUPLE_WITH_GIVEN_RID, getRecords(table, wanted, numWanted, records), "batch with deleted record");
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_g"));
+  TEST_CHECK(shutdownRecordManager());
+
+  for (i = 0; i < numWanted; i++)
+    freeRecord(records[i]);
+  free(records);
+  free(wanted);
+  free(rids);
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+void testProjectedScans(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord inserts[] = {
+      {1, "aaaa", 3},
+      {2, "bbbb", 2},
+      {3, "dddd", 1},
+      {4, "dddd", 3},
+      {5, "eeee", 5},
+  };
+  int numInserts = 5, i, found = 0, rc;
+  int projected[] = {2, 0};
+  int bad[] = {3};
+  Record *r;
+  Value *value;
+  Schema *schema, *projection;
+  RM_ScanHandle *sc = (RM_ScanHandle *)malloc(sizeof(RM_ScanHandle));
+  Expr *sel, *left, *right;
+  testName = "test scans projecting attributes";
+  schema = testSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_j", schema));
+  TEST_CHECK(openTable(table, "test_table_j"));
+
+  for (i = 0; i < numInserts; i++)
+  {
+    r = fromTestRecord(schema, inserts[i]);
+    TEST_CHECK(insertRecord(table, r));
+    freeRecord(r);
+  }
+
+  // project (c, a) while the condition reads b, which is not projected
+  MAKE_CONS(left, stringToValue("sdddd"));
+  MAKE_ATTRREF(right, 1);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+  ASSERT_EQUALS_INT(RC_INVALID_PARAMETER, startProjectedScan(table, sc, sel, 1, bad), "unknown projected attribute");
+  TEST_CHECK(startProjectedScan(table, sc, sel, 2, projected));
+  projection = getScanSchema(sc);
+  ASSERT_EQUALS_INT(2, projection->numAttr, "projected attribute count");
+  ASSERT_EQUALS_INT(9, getRecordSize(projection), "projected record size");
+  ASSERT_EQUALS_STRING("c", projection->attrNames[0], "projected attribute name");
+  createRecord(&r, projection);
+  while ((rc = next(sc, r)) == RC_OK)
+  {
+    TEST_CHECK(getAttr(r, projection, 1, &value));
+    ASSERT_TRUE(value->dt == DT_INT, "projected attribute keeps its type");
+    i = value->v.intV - 1;
+    freeVal(value);
+    ASSERT_TRUE(i == 2 || i == 3, "projected record matches the condition");
+    TEST_CHECK(getAttr(r, projection, 0, &value));
+    ASSERT_EQUALS_INT(inserts[i].c, value->v.intV, "first projected attribute");
+    freeVal(value);
+    found++;
+  }
+  ASSERT_EQUALS_INT(RC_RM_NO_MORE_TUPLES, rc, "projected scan ends");
+  ASSERT_EQUALS_INT(2, found, "projected scan finds every match");
+  TEST_CHECK(closeScan(sc));
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_j"));
+  TEST_CHECK(shutdownRecordManager());
+
+  freeRecord(r);
+  free(table);
+  free(sc);
+  freeExpr(sel);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+void testBatchScans(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord inserts[] = {
+      {1, "aaaa", 3},
+      {2, "bbbb", 2},
+      {3, "cccc", 1},
+      {4, "dddd", 3},
+      {5, "eeee", 5},
+      {6, "ffff", 1},
+      {7, "gggg", 3},
+      {8, "hhhh", 3},
+      {9, "iiii", 2},
+      {10, "jjjj", 5},
+  };
+  int expectedRows[] = {4, 4, 2};
+  int numInserts = 10, i, j, seen = 0, rc;
+  int projected[] = {0};
+  Record *r, row;
+  RecordBatch *batch, *small;
+  Schema *schema;
+  RM_ScanHandle *sc = (RM_ScanHandle *)malloc(sizeof(RM_ScanHandle));
+  Expr *sel, *all, *left, *right;
+  testName = "test scans returning batches";
+  schema = testSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_b", schema));
+  TEST_CHECK(openTable(table, "test_table_b"));
+
+  for (i = 0; i < numInserts; i++)
+  {
+    r = fromTestRecord(schema, inserts[i]);
+    TEST_CHECK(insertRecord(table, r));
+    freeRecord(r);
+  }
+
+  // a full scan comes in batches of at most four rows, then ends
+  MAKE_CONS(all, stringToValue("bt"));
+  TEST_CHECK(createRecordBatch(&batch, schema, 4));
+  TEST_CHECK(startScan(table, sc, all));
+  for (i = 0; i < 3; i++)
+  {
+    TEST_CHECK(nextBatch(sc, batch, 10));
+    ASSERT_EQUALS_INT(expectedRows[i], batch->numRows, "rows in batch");
+    for (j = 0; j < batch->numRows; j++)
+    {
+      TEST_CHECK(getBatchRecord(batch, j, &row));
+      r = fromTestRecord(schema, inserts[seen++]);
+      ASSERT_EQUALS_RECORDS(r, &row, schema, "batch row");
+      freeRecord(r);
+    }
+  }
+  rc = nextBatch(sc, batch, 4);
+  ASSERT_EQUALS_INT(RC_RM_NO_MORE_TUPLES, rc, "batches end");
+  ASSERT_EQUALS_INT(0, batch->numRows, "no rows after the end");
+  TEST_CHECK(closeScan(sc));
+
+  // a batch continues behind the row next returned
+  TEST_CHECK(startScan(table, sc, all));
+  TEST_CHECK(createRecord(&r, schema));
+  TEST_CHECK(next(sc, r));
+  freeRecord(r);
+  TEST_CHECK(nextBatch(sc, batch, 4));
+  ASSERT_EQUALS_INT(4, batch->numRows, "rows in batch after next");
+  ASSERT_EQUALS_INT(2, *(int *)(batch->data + 1), "batch starts behind next");
+  ASSERT_EQUALS_INT(5, *(int *)(batch->data + 3 * batch->recordSize + 1), "last row of batch after next");
+  TEST_CHECK(closeScan(sc));
+
+  // filtered rows fill the batch up to maxRows
+  MAKE_CONS(left, stringToValue("i3"));
+  MAKE_ATTRREF(right, 2);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+  TEST_CHECK(startScan(table, sc, sel));
+  TEST_CHECK(nextBatch(sc, batch, 3));
+  ASSERT_EQUALS_INT(3, batch->numRows, "batch limited by maxRows");
+  ASSERT_EQUALS_INT(7, *(int *)(batch->data + 2 * batch->recordSize + 1), "third match in batch");
+  TEST_CHECK(nextBatch(sc, batch, 3));
+  ASSERT_EQUALS_INT(1, batch->numRows, "rest of the matches");
+  rc = nextBatch(sc, batch, 3);
+  ASSERT_EQUALS_INT(RC_RM_NO_MORE_TUPLES, rc, "filtered batches end");
+  TEST_CHECK(closeScan(sc));
+
+  // a batch must follow the scan's schema
+  TEST_CHECK(startProjectedScan(table, sc, sel, 1, projected));
+  ASSERT_EQUALS_INT(RC_INVALID_PARAMETER, nextBatch(sc, batch, 4), "batch of another schema");
+  TEST_CHECK(createRecordBatch(&small, getScanSchema(sc), 8));
+  TEST_CHECK(nextBatch(sc, small, 8));
+  ASSERT_EQUALS_INT(4, small->numRows, "projected batch");
+  ASSERT_EQUALS_INT(5, small->recordSize, "projected row size");
+  ASSERT_EQUALS_INT(1, *(int *)(small->data + 1), "first projected row");
+  ASSERT_EQUALS_INT(8, *(int *)(small->data + 3 * small->recordSize + 1), "last projected row");
+  TEST_CHECK(closeScan(sc));
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_b"));
+  TEST_CHECK(shutdownRecordManager());
+
+  freeRecordBatch(small);
+  freeRecordBatch(batch);
+  free(table);
+  free(sc);
+  freeExpr(sel);
+  freeExpr(all);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+// totals kept by the parallel scan callbacks
+typedef struct ScanTotals
+{
+  pthread_mutex_t lock;
+  int count;
+  long sum;
+  int limit;
+  RM_TableData *table;
+  int mismatches;
+} ScanTotals;
+
+static RC countMatch(Record *record, void *context)
+{
+  ScanTotals *totals = (ScanTotals *)context;
+  int a;
+  RC rc = RC_OK;
+
+  memcpy(&a, record->data + 1, sizeof(int));
+  pthread_mutex_lock(&totals->lock);
+  totals->count++;
+  totals->sum += a;
+  if (totals->limit > 0 && totals->count >= totals->limit)
+    rc = RC_ERROR;
+  pthread_mutex_unlock(&totals->lock);
+  return rc;
+}
+
+// reads every match again through getRecord, from all workers at once
+static RC rereadMatch(Record *record, void *context)
+{
+  ScanTotals *totals = (ScanTotals *)context;
+  Record *copy;
+  RC rc = createRecord(&copy, totals->table->schema);
+
+  if (rc == RC_OK)
+    rc = getRecord(totals->table, record->id, copy);
+  pthread_mutex_lock(&totals->lock);
+  totals->count++;
+  if (rc != RC_OK || memcmp(copy->data + 1, record->data + 1, getRecordSize(totals->table->schema) - 1) != 0)
+    totals->mismatches++;
+  pthread_mutex_unlock(&totals->lock);
+  freeRecord(copy);
+  return rc;
+}
+
+void testParallelScan(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord in;
+  ScanTotals totals;
+  int numInserts = 2000, expectedCount = 0, numThreads, i, rc;
+  long expectedSum = 0;
+  Record *r;
+  Schema *schema;
+  Expr *sel, *left, *right;
+  testName = "test parallel scans";
+  schema = testSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_p", schema));
+  TEST_CHECK(openTable(table, "test_table_p"));
+
+  in.b = "pppp";
+  for (i = 0; i < numInserts; i++)
+  {
+    in.a = i;
+    in.c = i % 5;
+    r = fromTestRecord(schema, in);
+    TEST_CHECK(insertRecord(table, r));
+    freeRecord(r);
+    if (in.c == 3)
+    {
+      expectedCount++;
+      expectedSum += i;
+    }
+  }
+
+  // every thread count finds the same matches as a serial scan
+  MAKE_CONS(left, stringToValue("i3"));
+  MAKE_ATTRREF(right, 2);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+  pthread_mutex_init(&totals.lock, NULL);
+  for (numThreads = 1; numThreads <= 4; numThreads *= 2)
+  {
+    totals.count = 0;
+    totals.sum = 0;
+    totals.limit = 0;
+    TEST_CHECK(parallelScan(table, sel, numThreads, countMatch, &totals));
+    ASSERT_EQUALS_INT(expectedCount, totals.count, "matches of parallel scan");
+    ASSERT_TRUE(totals.sum == expectedSum, "sum of matches of parallel scan");
+  }
+
+  // an error of the callback stops the scan
+  totals.count = 0;
+  totals.sum = 0;
+  totals.limit = 10;
+  rc = parallelScan(table, sel, 4, countMatch, &totals);
+  ASSERT_EQUALS_INT(RC_ERROR, rc, "callback error ends the scan");
+  ASSERT_TRUE(totals.count < expectedCount, "scan stopped early");
+  rc = parallelScan(table, sel, 0, countMatch, &totals);
+  ASSERT_EQUALS_INT(RC_INVALID_PARAMETER, rc, "no threads");
+
+  // callbacks may read the table while the workers run
+  totals.count = 0;
+  totals.table = table;
+  totals.mismatches = 0;
+  TEST_CHECK(parallelScan(table, sel, 4, rereadMatch, &totals));
+  ASSERT_EQUALS_INT(expectedCount, totals.count, "matches read again");
+  ASSERT_EQUALS_INT(0, totals.mismatches, "getRecord from callbacks");
+  pthread_mutex_destroy(&totals.lock);
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_p"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(table);
+  freeExpr(sel);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+// counts the records a scan returns for a condition
+static int countScan(RM_TableData *table, Expr *cond)
+{
+  RM_ScanHandle sc;
+  Record *r;
+  int count = 0;
+
+  createRecord(&r, table->schema);
+  TEST_CHECK(startScan(table, &sc, cond));
+  while (next(&sc, r) == RC_OK)
+    count++;
+  TEST_CHECK(closeScan(&sc));
+  freeRecord(r);
+  return count;
+}
+
+void testScanFilters(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  char **names = (char **)malloc(sizeof(char *) * 4);
+  DataType *dt = (DataType *)malloc(sizeof(DataType) * 4);
+  int *sizes = (int *)malloc(sizeof(int) * 4);
+  int *keys = (int *)malloc(sizeof(int));
+  int numInserts = 500, i, count;
+  RID deleted[10], later;
+  char value[16];
+  ScanTotals totals;
+  RM_ScanHandle *sc = (RM_ScanHandle *)malloc(sizeof(RM_ScanHandle));
+  Record *r;
+  Value *v;
+  Schema *schema;
+  Expr *sel, *left, *right, *inner, *range;
+  testName = "test scans with page filters";
+
+  // a and f sit at fixed places in stored records, c behind a string
+  names[0] = strdup("a");
+  names[1] = strdup("f");
+  names[2] = strdup("s");
+  names[3] = strdup("c");
+  dt[0] = DT_INT;
+  dt[1] = DT_FLOAT;
+  dt[2] = DT_STRING;
+  dt[3] = DT_INT;
+  sizes[0] = sizes[1] = sizes[3] = 0;
+  sizes[2] = 8;
+  keys[0] = 0;
+  schema = createSchema(4, names, dt, sizes, 1, keys);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_f", schema));
+  TEST_CHECK(openTable(table, "test_table_f"));
+
+  TEST_CHECK(createRecord(&r, schema));
+  for (i = 0; i < numInserts; i++)
+  {
+    MAKE_VALUE(v, DT_INT, i);
+    TEST_CHECK(setAttr(r, schema, 0, v));
+    freeVal(v);
+    MAKE_VALUE(v, DT_FLOAT, i * 0.5f);
+    TEST_CHECK(setAttr(r, schema, 1, v));
+    freeVal(v);
+    sprintf(value, "s%d", i % 1000);
+    MAKE_STRING_VALUE(v, value);
+    TEST_CHECK(setAttr(r, schema, 2, v));
+    freeVal(v);
+    MAKE_VALUE(v, DT_INT, i % 7);
+    TEST_CHECK(setAttr(r, schema, 3, v));
+    freeVal(v);
+    TEST_CHECK(insertRecord(table, r));
+    if (i < 100 && i % 10 == 0)
+      deleted[i / 10] = r->id;
+    if (i == 120)
+      later = r->id;
+  }
+  freeRecord(r);
+  for (i = 0; i < 10; i++)
+    TEST_CHECK(deleteRecord(table, deleted[i]));
+
+  // a < 100
+  MAKE_ATTRREF(left, 0);
+  MAKE_CONS(right, stringToValue("i100"));
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_SMALLER);
+  count = countScan(table, sel);
+  ASSERT_EQUALS_INT(90, count, "a < 100");
+
+  // the same filter in a parallel scan
+  pthread_mutex_init(&totals.lock, NULL);
+  totals.count = 0;
+  totals.sum = 0;
+  totals.limit = 0;
+  TEST_CHECK(parallelScan(table, sel, 2, countMatch, &totals));
+  ASSERT_EQUALS_INT(90, totals.count, "parallel a < 100");
+  pthread_mutex_destroy(&totals.lock);
+  freeExpr(sel);
+
+  // 250 < a
+  MAKE_CONS(left, stringToValue("i250"));
+  MAKE_ATTRREF(right, 0);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_SMALLER);
+  count = countScan(table, sel);
+  ASSERT_EQUALS_INT(249, count, "250 < a");
+  freeExpr(sel);
+
+  // f = 10.5
+  MAKE_ATTRREF(left, 1);
+  MAKE_CONS(right, stringToValue("f10.5"));
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+  count = countScan(table, sel);
+  ASSERT_EQUALS_INT(1, count, "f = 10.5");
+  freeExpr(sel);
+
+  // c = 3 AND a < 50, filtered on c, which is found record by record
+  MAKE_ATTRREF(left, 3);
+  MAKE_CONS(right, stringToValue("i3"));
+  MAKE_BINOP_EXPR(inner, left, right, OP_COMP_EQUAL);
+  MAKE_ATTRREF(left, 0);
+  MAKE_CONS(right, stringToValue("i50"));
+  MAKE_BINOP_EXPR(range, left, right, OP_COMP_SMALLER);
+  MAKE_BINOP_EXPR(sel, inner, range, OP_BOOL_AND);
+  count = countScan(table, sel);
+  ASSERT_EQUALS_INT(6, count, "c = 3 AND a < 50");
+  freeExpr(sel);
+
+  // a > 450, filtered natively
+  MAKE_ATTRREF(left, 0);
+  MAKE_CONS(right, stringToValue("i450"));
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_GREATER);
+  count = countScan(table, sel);
+  ASSERT_EQUALS_INT(49, count, "a > 450");
+  freeExpr(sel);
+
+  // a BETWEEN 85 AND 104 misses the deleted 90
+  MAKE_ATTRREF(inner, 0);
+  MAKE_CONS(left, stringToValue("i85"));
+  MAKE_CONS(right, stringToValue("i104"));
+  MAKE_BETWEEN_EXPR(sel, inner, left, right);
+  count = countScan(table, sel);
+  ASSERT_EQUALS_INT(19, count, "a BETWEEN 85 AND 104");
+  freeExpr(sel);
+
+  // NOT NOT 450 < a is rewritten to a > 450 before the scan
+  MAKE_CONS(left, stringToValue("i450"));
+  MAKE_ATTRREF(right, 0);
+  MAKE_BINOP_EXPR(inner, left, right, OP_COMP_SMALLER);
+  MAKE_UNOP_EXPR(range, inner, OP_BOOL_NOT);
+  MAKE_UNOP_EXPR(sel, range, OP_BOOL_NOT);
+  count = countScan(table, sel);
+  ASSERT_EQUALS_INT(49, count, "NOT NOT 450 < a");
+  ASSERT_TRUE(sel->expr.op->type == OP_BOOL_NOT, "the caller's condition is left alone");
+  freeExpr(sel);
+
+  // a record updated on the pinned page after the filter ran is still found
+  MAKE_ATTRREF(left, 0);
+  MAKE_CONS(right, stringToValue("i100"));
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_SMALLER);
+  TEST_CHECK(createRecord(&r, schema));
+  TEST_CHECK(startScan(table, sc, sel));
+  TEST_CHECK(next(sc, r));
+  ASSERT_EQUALS_INT(later.page, r->id.page, "a = 120 is on the page the scan holds");
+  TEST_CHECK(getRecord(table, later, r));
+  MAKE_VALUE(v, DT_INT, 99);
+  TEST_CHECK(setAttr(r, schema, 0, v));
+  freeVal(v);
+  TEST_CHECK(updateRecord(table, r));
+  for (count = 1; next(sc, r) == RC_OK; count++)
+    ;
+  TEST_CHECK(closeScan(sc));
+  ASSERT_EQUALS_INT(91, count, "a < 100 after updating a = 120 mid-scan");
+  freeRecord(r);
+  freeExpr(sel);
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_f"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(table);
+  free(sc);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+void testScanArena(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  char **names = (char **)malloc(sizeof(char *) * 2);
+  DataType *dt = (DataType *)malloc(sizeof(DataType) * 2);
+  int *sizes = (int *)malloc(sizeof(int) * 2);
+  int *keys = (int *)malloc(sizeof(int));
+  int numInserts = 300, i, count, sum;
+  ScanTotals totals;
+  RM_ScanHandle sc;
+  Arena *arena;
+  size_t used;
+  char *keep;
+  Record *r;
+  Value *v;
+  Schema *schema;
+  Expr *sel, *left, *right, *inner;
+  testName = "test scans evaluating in an arena";
+
+  names[0] = strdup("a");
+  names[1] = strdup("s");
+  dt[0] = DT_INT;
+  dt[1] = DT_STRING;
+  sizes[0] = 0;
+  sizes[1] = 6;
+  keys[0] = 0;
+  schema = createSchema(2, names, dt, sizes, 1, keys);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_a", schema));
+  TEST_CHECK(openTable(table, "test_table_a"));
+  TEST_CHECK(createArena(&arena, 256));
+
+  // rows built in a record from the arena
+  TEST_CHECK(createRecordWithArena(&r, schema, arena));
+  for (i = 0; i < numInserts; i++)
+  {
+    MAKE_VALUE(v, DT_INT, i);
+    TEST_CHECK(setAttr(r, schema, 0, v));
+    freeVal(v);
+    MAKE_STRING_VALUE(v, "row");
+    TEST_CHECK(setAttr(r, schema, 1, v));
+    freeVal(v);
+    TEST_CHECK(insertRecord(table, r));
+  }
+
+  // (a < 100) = TRUE compares an operator result, so it is not compiled
+  MAKE_ATTRREF(left, 0);
+  MAKE_CONS(right, stringToValue("i100"));
+  MAKE_BINOP_EXPR(inner, left, right, OP_COMP_SMALLER);
+  MAKE_CONS(right, stringToValue("bt"));
+  MAKE_BINOP_EXPR(sel, inner, right, OP_COMP_EQUAL);
+
+  keep = arenaStrdup(arena, "keep");
+  used = arena->allocated;
+  count = 0;
+  sum = 0;
+  TEST_CHECK(startScan(table, &sc, sel));
+  TEST_CHECK(setScanArena(&sc, arena));
+  while (next(&sc, r) == RC_OK)
+  {
+    ASSERT_TRUE(arena->allocated == used, "condition values released after every record");
+    TEST_CHECK(getAttrWithArena(r, schema, 0, &v, arena));
+    sum += v->v.intV;
+    count++;
+    used = arena->allocated;
+  }
+  TEST_CHECK(closeScan(&sc));
+  ASSERT_EQUALS_INT(100, count, "(a < 100) = TRUE");
+  ASSERT_EQUALS_INT(4950, sum, "sum of a read into the arena");
+  ASSERT_EQUALS_STRING("keep", keep, "caller's memory left alone");
+
+  // parallel workers evaluate it in arenas of their own
+  pthread_mutex_init(&totals.lock, NULL);
+  totals.count = 0;
+  totals.sum = 0;
+  totals.limit = 0;
+  TEST_CHECK(parallelScan(table, sel, 2, countMatch, &totals));
+  ASSERT_EQUALS_INT(100, totals.count, "parallel (a < 100) = TRUE");
+  freeExpr(sel);
+
+  // a type error of a compilable condition is reported when the scan starts
+  MAKE_ATTRREF(left, 0);
+  MAKE_CONS(right, stringToValue("sx"));
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+  ASSERT_EQUALS_INT(RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE, startScan(table, &sc, sel), "a = 'x' does not start");
+  ASSERT_EQUALS_INT(RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE, parallelScan(table, sel, 2, countMatch, &totals),
+                    "a = 'x' does not start in parallel");
+  freeExpr(sel);
+
+  // one that is not compilable is reported by the record it fails on
+  MAKE_ATTRREF(left, 0);
+  MAKE_CONS(right, stringToValue("i100"));
+  MAKE_BINOP_EXPR(inner, left, right, OP_COMP_SMALLER);
+  MAKE_CONS(right, stringToValue("i1"));
+  MAKE_BINOP_EXPR(sel, inner, right, OP_COMP_EQUAL);
+  TEST_CHECK(startScan(table, &sc, sel));
+  ASSERT_EQUALS_INT(RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE, next(&sc, r), "(a < 100) = 1 fails on a record");
+  TEST_CHECK(closeScan(&sc));
+  totals.count = 0;
+  ASSERT_EQUALS_INT(RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE, parallelScan(table, sel, 2, countMatch, &totals),
+                    "(a < 100) = 1 fails in parallel");
+  ASSERT_EQUALS_INT(0, totals.count, "no record matched");
+  pthread_mutex_destroy(&totals.lock);
+  freeExpr(sel);
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_a"));
+  TEST_CHECK(shutdownRecordManager());
+
+  TEST_CHECK(freeArena(arena));
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+// creates and frees records of a schema on another thread
+static void *churnRecords(void *arg)
+{
+  Schema *schema = (Schema *)arg;
+  Record *r;
+  Value *v;
+  int i;
+  long ok = 1;
+
+  for (i = 0; i < 1000; i++)
+  {
+    if (createRecord(&r, schema) != RC_OK)
+      return NULL;
+    MAKE_VALUE(v, DT_INT, i);
+    setAttr(r, schema, 0, v);
+    freeVal(v);
+    getAttr(r, schema, 0, &v);
+    if (v->v.intV != i)
+      ok = 0;
+    freeVal(v);
+    freeRecord(r);
+  }
+  return (void *)ok;
+}
+
+void testRecordPool(void)
+{
+  char **names;
+  DataType *dt;
+  int *sizes, *keys;
+  Schema *small, *large;
+  Record *r, *s, *first;
+  Record *many[100];
+  pthread_t threads[2];
+  void *ok;
+  int i;
+  testName = "test record pool";
+
+  small = testSchema();
+  names = (char **)malloc(sizeof(char *) * 2);
+  dt = (DataType *)malloc(sizeof(DataType) * 2);
+  sizes = (int *)malloc(sizeof(int) * 2);
+  keys = (int *)malloc(sizeof(int));
+  names[0] = strdup("a");
+  names[1] = strdup("s");
+  dt[0] = DT_INT;
+  dt[1] = DT_STRING;
+  sizes[0] = 0;
+  sizes[1] = 40;
+  keys[0] = 0;
+  large = createSchema(2, names, dt, sizes, 1, keys);
+
+  // a freed record is handed out again, initialized as a new one
+  TEST_CHECK(createRecord(&first, small));
+  first->id.page = 3;
+  first->data[0] = '+';
+  TEST_CHECK(freeRecord(first));
+  TEST_CHECK(createRecord(&r, small));
+  ASSERT_TRUE(r == first, "freed record reused");
+  ASSERT_TRUE(r->id.page == -1 && r->id.slot == -1, "reused record has no RID");
+  ASSERT_TRUE(r->data[0] == '-', "reused record is empty");
+
+  // records of another size do not take its place
+  TEST_CHECK(createRecord(&s, large));
+  ASSERT_TRUE(s != first, "record of another size");
+  TEST_CHECK(freeRecord(r));
+  TEST_CHECK(freeRecord(s));
+  TEST_CHECK(createRecord(&s, large));
+  TEST_CHECK(createRecord(&r, small));
+  ASSERT_TRUE(r == first, "sizes kept apart");
+
+  // many records at once, freed after their schema
+  for (i = 0; i < 100; i++)
+    TEST_CHECK(createRecord(&many[i], small));
+  freeSchema(large);
+  TEST_CHECK(freeRecord(s));
+  for (i = 0; i < 100; i++)
+    TEST_CHECK(freeRecord(many[i]));
+
+  // threads recycle records in caches of their own
+  for (i = 0; i < 2; i++)
+    pthread_create(&threads[i], NULL, churnRecords, small);
+  for (i = 0; i < 2; i++)
+  {
+    pthread_join(threads[i], &ok);
+    ASSERT_TRUE(ok != NULL, "records on a worker thread");
+  }
+
+  TEST_CHECK(freeRecord(r));
+  freeSchema(small);
+  TEST_CHECK(shutdownRecordManager());
+  TEST_DONE();
+}
+
+// counts the records of a scan for attr op constant
+static int countCompare(RM_TableData *table, int attr, OpType op, char *constant)
+{
+  Expr *sel, *left, *right;
+  int count;
+
+  MAKE_ATTRREF(left, attr);
+  MAKE_CONS(right, stringToValue(constant));
+  MAKE_BINOP_EXPR(sel, left, right, op);
+  count = countScan(table, sel);
+  freeExpr(sel);
+  return count;
+}
+
+void testZoneMaps(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord in;
+  ScanTotals totals;
+  int numInserts = 3000, i, count;
+  RID moved;
+  Record *r;
+  Schema *schema;
+  Expr *sel, *inner, *left, *right, *list[3];
+  testName = "test scans skipping pages by zone maps";
+  schema = testSchema();
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_z", schema));
+  TEST_CHECK(openTable(table, "test_table_z"));
+
+  // a grows with every insert, like an id or a timestamp
+  in.b = "zzzz";
+  for (i = 0; i < numInserts; i++)
+  {
+    in.a = i;
+    in.c = i % 5;
+    r = fromTestRecord(schema, in);
+    TEST_CHECK(insertRecord(table, r));
+    if (i == 5)
+      moved = r->id;
+    freeRecord(r);
+  }
+
+  ASSERT_EQUALS_INT(10, countCompare(table, 0, OP_COMP_SMALLER, "i10"), "a < 10");
+  ASSERT_EQUALS_INT(1, countCompare(table, 0, OP_COMP_EQUAL, "i2999"), "a = 2999");
+  ASSERT_EQUALS_INT(0, countCompare(table, 0, OP_COMP_GREATER, "i5000"), "a > 5000");
+  ASSERT_EQUALS_INT(2999, countCompare(table, 0, OP_COMP_NOT_EQUAL, "i7"), "a <> 7");
+  ASSERT_EQUALS_INT(600, countCompare(table, 2, OP_COMP_EQUAL, "i4"), "c = 4");
+
+  // a BETWEEN 1000 AND 1099
+  MAKE_ATTRREF(inner, 0);
+  MAKE_CONS(left, stringToValue("i1000"));
+  MAKE_CONS(right, stringToValue("i1099"));
+  MAKE_BETWEEN_EXPR(sel, inner, left, right);
+  ASSERT_EQUALS_INT(100, countScan(table, sel), "a BETWEEN 1000 AND 1099");
+  freeExpr(sel);
+
+  // a IN (5, 2500, 9999)
+  MAKE_ATTRREF(inner, 0);
+  MAKE_CONS(list[0], stringToValue("i5"));
+  MAKE_CONS(list[1], stringToValue("i2500"));
+  MAKE_CONS(list[2], stringToValue("i9999"));
+  MAKE_IN_EXPR(sel, inner, list, 3);
+  ASSERT_EQUALS_INT(2, countScan(table, sel), "a IN (5, 2500, 9999)");
+  freeExpr(sel);
+
+  // an update widens the bounds of the page it lands on
+  in.a = 100000;
+  in.c = 0;
+  r = fromTestRecord(schema, in);
+  r->id = moved;
+  TEST_CHECK(updateRecord(table, r));
+  freeRecord(r);
+  ASSERT_EQUALS_INT(1, countCompare(table, 0, OP_COMP_GREATER, "i5000"), "updated a > 5000");
+  ASSERT_EQUALS_INT(0, countCompare(table, 0, OP_COMP_EQUAL, "i5"), "old value of a is gone");
+
+  // the same in a parallel scan
+  MAKE_ATTRREF(left, 0);
+  MAKE_CONS(right, stringToValue("i5000"));
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_GREATER);
+  pthread_mutex_init(&totals.lock, NULL);
+  totals.count = 0;
+  totals.sum = 0;
+  totals.limit = 0;
+  TEST_CHECK(parallelScan(table, sel, 2, countMatch, &totals));
+  ASSERT_EQUALS_INT(1, totals.count, "parallel a > 5000");
+
+  // after reopening, pages are summarized when first read
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_z"));
+  for (i = 0; i < 2; i++)
+  {
+    count = countCompare(table, 0, OP_COMP_GREATER, "i5000");
+    ASSERT_EQUALS_INT(1, count, "a > 5000 after reopening");
+    count = countCompare(table, 0, OP_COMP_SMALLER, "i10");
+    ASSERT_EQUALS_INT(9, count, "a < 10 after reopening");
+  }
+  totals.count = 0;
+  TEST_CHECK(parallelScan(table, sel, 4, countMatch, &totals));
+  ASSERT_EQUALS_INT(1, totals.count, "parallel a > 5000 after reopening");
+  pthread_mutex_destroy(&totals.lock);
+  freeExpr(sel);
+
+  // inserts after reopening land on summarized or new pages
+  in.a = -1;
+  r = fromTestRecord(schema, in);
+  TEST_CHECK(insertRecord(table, r));
+  freeRecord(r);
+  ASSERT_EQUALS_INT(1, countCompare(table, 0, OP_COMP_SMALLER, "i0"), "a < 0");
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_z"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+void testVariableLengthRecords(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  RM_ScanHandle *sc = (RM_ScanHandle *)malloc(sizeof(RM_ScanHandle));
+  char *names[] = {"a", "b", "c"};
+  DataType dt[] = {DT_INT, DT_STRING, DT_INT};
+  int sizes[] = {0, 200, 0};
+  int keys[] = {0};
+  char **cpNames = (char **)malloc(sizeof(char *) * 3);
+  DataType *cpDt = (DataType *)malloc(sizeof(DataType) * 3);
+  int *cpSizes = (int *)malloc(sizeof(int) * 3);
+  int *cpKeys = (int *)malloc(sizeof(int));
+  int numInserts = 300, numMoved = 10, onFirstPage = 0, found = 0, i, rc, c, len;
+  char shortString[8], longString[151], *str;
+  Expr *sel, *left, *right;
+  RM_RecordView view;
+  Record *r, *expected;
+  RID *rids;
+  Schema *schema;
+  testName = "test variable-length records and forwarded updates";
+
+  for (i = 0; i < 3; i++)
+  {
+    cpNames[i] = (char *)malloc(2);
+    strcpy(cpNames[i], names[i]);
+  }
+  memcpy(cpDt, dt, sizeof(DataType) * 3);
+  memcpy(cpSizes, sizes, sizeof(int) * 3);
+  memcpy(cpKeys, keys, sizeof(int));
+  schema = createSchema(3, cpNames, cpDt, cpSizes, 1, cpKeys);
+  rids = (RID *)malloc(sizeof(RID) * numInserts);
+  memset(longString, 'x', 150);
+  longString[150] = '\0';
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_v", schema));
+  TEST_CHECK(openTable(table, "test_table_v"));
+
+  // short strings only take their length on the page
+  for (i = 0; i < numInserts; i++)
+  {
+    sprintf(shortString, "s%d", i);
+    r = testRecord(schema, i, shortString, 0);
+    TEST_CHECK(insertRecord(table, r));
+    rids[i] = r->id;
+    freeRecord(r);
+    if (rids[i].page == rids[0].page)
+      onFirstPage++;
+  }
+  ASSERT_TRUE(onFirstPage >= 2 * (PAGE_SIZE / getRecordSize(schema)), "page holds at least twice the fixed-width rows");
+
+  // growing records no longer fit on their full page and move away
+  for (i = 0; i < numMoved; i++)
+  {
+    r = testRecord(schema, i, longString, 1);
+    r->id = rids[i];
+    TEST_CHECK(updateRecord(table, r));
+    freeRecord(r);
+  }
+  createRecord(&r, schema);
+  for (i = 0; i < numMoved; i++)
+  {
+    TEST_CHECK(getRecord(table, rids[i], r));
+    expected = testRecord(schema, i, longString, 1);
+    ASSERT_EQUALS_RECORDS(expected, r, schema, "moved record read through its RID");
+    freeRecord(expected);
+  }
+  TEST_CHECK(getRecordView(table, rids[0], &view));
+  TEST_CHECK(getStringAttrView(&view, 1, &str, &len));
+  ASSERT_EQUALS_INT(150, len, "moved record viewed through its RID");
+  TEST_CHECK(getIntAttr(&view, 2, &c));
+  ASSERT_EQUALS_INT(1, c, "attribute behind the string of a moved record");
+  TEST_CHECK(releaseRecordView(&view));
+  sprintf(shortString, "s%d", numMoved);
+  TEST_CHECK(getRecord(table, rids[numMoved], r));
+  expected = testRecord(schema, numMoved, shortString, 0);
+  ASSERT_EQUALS_RECORDS(expected, r, schema, "neighbour of moved records unchanged");
+  freeRecord(expected);
+
+  // a moved record can shrink again and is still found by its RID
+  expected = testRecord(schema, 3, "back", 1);
+  expected->id = rids[3];
+  TEST_CHECK(updateRecord(table, expected));
+  TEST_CHECK(getRecord(table, rids[3], r));
+  ASSERT_EQUALS_RECORDS(expected, r, schema, "shrunk record read through its RID");
+  freeRecord(expected);
+
+  // scans report moved records once, under their home RID
+  MAKE_CONS(left, stringToValue("i1"));
+  MAKE_ATTRREF(right, 2);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+  TEST_CHECK(startScan(table, sc, sel));
+  while ((rc = next(sc, r)) == RC_OK)
+  {
+    found++;
+    ASSERT_TRUE(r->id.page == rids[0].page, "scan returns the home RID");
+  }
+  ASSERT_EQUALS_INT(RC_RM_NO_MORE_TUPLES, rc, "scan ends normally");
+  ASSERT_EQUALS_INT(numMoved, found, "scan finds every moved record once");
+  TEST_CHECK(closeScan(sc));
+
+  // deleting through the RID removes the moved record too
+  for (i = 0; i < numMoved / 2; i++)
+    TEST_CHECK(deleteRecord(table, rids[i]));
+  ASSERT_EQUALS_INT(RC_RM_NO_TUPLE_WITH_GIVEN_RID, getRecord(table, rids[0], r), "deleted moved record gone");
+  ASSERT_EQUALS_INT(numInserts - numMoved / 2, getNumTuples(table), "tuple count after deletes");
+  found = 0;
+  TEST_CHECK(startScan(table, sc, sel));
+  while ((rc = next(sc, r)) == RC_OK)
+    found++;
+  ASSERT_EQUALS_INT(numMoved - numMoved / 2, found, "scan skips deleted moved records");
+  TEST_CHECK(closeScan(sc));
+
+  // forwarded records survive closing the table
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_v"));
+  TEST_CHECK(getRecord(table, rids[numMoved - 1], r));
+  expected = testRecord(schema, numMoved - 1, longString, 1);
+  ASSERT_EQUALS_RECORDS(expected, r, schema, "moved record after reopening");
+  freeRecord(expected);
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_v"));
+  TEST_CHECK(shutdownRecordManager());
+
+  freeRecord(r);
+  free(rids);
+  free(table);
+  free(sc);
+  freeExpr(sel);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+void testInsertRecords(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  int numInserts = 1000, i;
+  Record **batch;
+  Record *r;
+  RID *rids;
+  Schema *schema;
+  bool inOrder = TRUE, sameIds = TRUE;
+  testName = "test inserting a batch of records";
+  schema = testSchema();
+  rids = (RID *)malloc(sizeof(RID) * numInserts);
+  batch = (Record **)malloc(sizeof(Record *) * numInserts);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_b", schema));
+  TEST_CHECK(openTable(table, "test_table_b"));
+
+  for (i = 0; i < numInserts; i++)
+    batch[i] = testRecord(schema, i, "bulk", i % 7);
+  TEST_CHECK(insertRecords(table, batch, numInserts, rids));
+  ASSERT_EQUALS_INT(numInserts, getNumTuples(table), "tuple count after the batch");
+
+  // pages are filled in order and every record learns its RID
+  for (i = 0; i < numInserts; i++)
+  {
+    if (batch[i]->id.page != rids[i].page || batch[i]->id.slot != rids[i].slot)
+      sameIds = FALSE;
+    if (i > 0 && (rids[i].page < rids[i - 1].page || (rids[i].page == rids[i - 1].page && rids[i].slot <= rids[i - 1].slot)))
+      inOrder = FALSE;
+  }
+  ASSERT_TRUE(sameIds, "records carry the RIDs returned");
+  ASSERT_TRUE(inOrder, "RIDs follow the batch order");
+  ASSERT_TRUE(rids[numInserts - 1].page > rids[0].page, "batch spans several pages");
+
+  createRecord(&r, schema);
+  for (i = 0; i < numInserts; i += 97)
+  {
+    TEST_CHECK(getRecord(table, rids[i], r));
+    ASSERT_EQUALS_RECORDS(batch[i], r, schema, "compare records");
+  }
+
+  // a single insert continues behind the batch
+  TEST_CHECK(insertRecord(table, batch[0]));
+  ASSERT_TRUE(batch[0]->id.page == rids[numInserts - 1].page, "insert after the batch on its last page");
+  ASSERT_EQUALS_INT(numInserts + 1, getNumTuples(table), "tuple count after the insert");
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_b"));
+  TEST_CHECK(shutdownRecordManager());
+
+  for (i = 0; i < numInserts; i++)
+    freeRecord(batch[i]);
+  freeRecord(r);
+  free(batch);
+  free(rids);
+  free(table);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+void testLoadTableFromCSV(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  RM_ScanHandle *sc = (RM_ScanHandle *)malloc(sizeof(RM_ScanHandle));
+  TestRecord rows[] = {
+      {1, "aaaa", 3},
+      {2, "bb", 2},
+      {3, "", 3},
+      {4, "dddd", 1},
+  };
+  int numRows = 4, loaded = -1, found = 0, i, rc;
+  Expr *sel, *left, *right;
+  Record *r, *expected;
+  Schema *schema;
+  FILE *csv;
+  testName = "test loading a table from a CSV file";
+  schema = testSchema();
+
+  csv = fopen("test_table_c.csv", "w");
+  for (i = 0; i < numRows; i++)
+    fprintf(csv, "%d,%s,%d\n", rows[i].a, rows[i].b, rows[i].c);
+  fclose(csv);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_c", schema));
+  TEST_CHECK(openTable(table, "test_table_c"));
+  TEST_CHECK(loadTableFromCSV(table, "test_table_c.csv", &loaded));
+  ASSERT_EQUALS_INT(numRows, loaded, "rows loaded");
+  ASSERT_EQUALS_INT(numRows, getNumTuples(table), "tuple count after loading");
+
+  // every row comes back with c=3 selecting the first and third
+  MAKE_CONS(left, stringToValue("i3"));
+  MAKE_ATTRREF(right, 2);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+  createRecord(&r, schema);
+  TEST_CHECK(startScan(table, sc, sel));
+  while ((rc = next(sc, r)) == RC_OK)
+  {
+    expected = fromTestRecord(schema, rows[found == 0 ? 0 : 2]);
+    ASSERT_EQUALS_RECORDS(expected, r, schema, "loaded row");
+    freeRecord(expected);
+    found++;
+  }
+  ASSERT_EQUALS_INT(2, found, "scan over loaded rows");
+  TEST_CHECK(closeScan(sc));
+
+  // a line with a missing field is rejected
+  csv = fopen("test_table_c.csv", "w");
+  fprintf(csv, "5,eeee\n");
+  fclose(csv);
+  ASSERT_EQUALS_INT(RC_RM_BAD_CSV_LINE, loadTableFromCSV(table, "test_table_c.csv", &loaded), "short line rejected");
+  ASSERT_EQUALS_INT(0, loaded, "nothing loaded from a bad file");
+
+  // values must parse as their attribute's type as a whole
+  csv = fopen("test_table_c.csv", "w");
+  fprintf(csv, "5x,eeee,1\n");
+  fclose(csv);
+  ASSERT_EQUALS_INT(RC_RM_BAD_CSV_LINE, loadTableFromCSV(table, "test_table_c.csv", &loaded), "trailing text rejected");
+  csv = fopen("test_table_c.csv", "w");
+  fprintf(csv, "6,ffff,\n");
+  fclose(csv);
+  ASSERT_EQUALS_INT(RC_RM_BAD_CSV_LINE, loadTableFromCSV(table, "test_table_c.csv", &loaded), "empty integer rejected");
+  csv = fopen("test_table_c.csv", "w");
+  fprintf(csv, "99999999999,gggg,1\n");
+  fclose(csv);
+  ASSERT_EQUALS_INT(RC_RM_BAD_CSV_LINE, loadTableFromCSV(table, "test_table_c.csv", &loaded), "integer overflow rejected");
+  ASSERT_EQUALS_INT(numRows, getNumTuples(table), "nothing loaded from bad values");
+  ASSERT_EQUALS_INT(RC_FILE_NOT_FOUND, loadTableFromCSV(table, "test_table_missing.csv", NULL), "missing file");
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_c"));
+  TEST_CHECK(shutdownRecordManager());
+  remove("test_table_c.csv");
+
+  freeRecord(r);
+  free(table);
+  free(sc);
+  freeExpr(sel);
+  freeSchema(schema);
+  TEST_DONE();
+}
+
+void testScans(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord inserts[] = {
+      {1, "aaaa", 3},
+      {2, "bbbb", 2},
+      {3, "cccc", 1},
+      {4, "dddd", 3},
+      {5, "eeee", 5},
+      {6, "ffff", 1},
+      {7, "gggg", 3},
+      {8, "hhhh", 3},
+      {9, "iiii", 2},
+      {10, "jjjj", 5},
+  };
+  TestRecord scanOneResult[] = {
+      {3, "cccc", 1},
+      {6, "ffff", 1},
+  };
+  bool foundScan[] = {
+      FALSE,
+      FALSE};
+  int numInserts = 10, scanSizeOne = 2, i;
+  Record *r;
+  RID *rids;
+  Schema *schema;
+  RM_ScanHandle *sc = (RM_ScanHandle *)malloc(sizeof(RM_ScanHandle));
+  Expr *sel, *left, *right;
+  int rc;
+
+  testName = "test creating a new table and inserting tuples";
+  schema = testSchema();
+  rids = (RID *)malloc(sizeof(RID) * numInserts);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_r", schema));
+  TEST_CHECK(openTable(table, "test_table_r"));
+
+  // insert rows into table
+  for (i = 0; i < numInserts; i++)
+  {
+    r = fromTestRecord(schema, inserts[i]);
+    TEST_CHECK(insertRecord(table, r));
+    rids[i] = r->id;
+    freeRecord(r); // Added Summer 2021
+  }
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_r"));
+  ASSERT_EQUALS_INT(numInserts, getNumTuples(table), "tuple count survives closing the table");
+
+  // run some scans
+  MAKE_CONS(left, stringToValue("i1"));
+  MAKE_ATTRREF(right, 2);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+
+  TEST_CHECK(startScan(table, sc, sel));
+  TEST_CHECK(createRecord(&r, schema)); // Added Summer 2021
+  while ((rc = next(sc, r)) == RC_OK)
+  {
+    for (i = 0; i < scanSizeOne; i++)
+    {
+      if (memcmp(fromTestRecord(schema, scanOneResult[i])->data, r->data, getRecordSize(schema)) == 0)
+        foundScan[i] = TRUE;
+    }
+  }
+  freeRecord(r); // Added Summer 2021
+
+  if (rc != RC_RM_NO_MORE_TUPLES)
+    TEST_CHECK(rc);
+  TEST_CHECK(closeScan(sc));
+  for (i = 0; i < scanSizeOne; i++)
+    ASSERT_TRUE(foundScan[i], "check for scan result");
+
+  // clean up
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_r"));
+  TEST_CHECK(shutdownRecordManager());
+
+  free(table);
+  free(sc);
+  // ***** Added Summer 2021
+  free(rids);
+  freeSchema(schema);
+  // *****
+  freeExpr(sel);
+  TEST_DONE();
+}
+
+void testScansTwo(void)
+{
+  RM_TableData *table = (RM_TableData *)malloc(sizeof(RM_TableData));
+  TestRecord inserts[] = {
+      {1, "aaaa", 3},
+      {2, "bbbb", 2},
+      {3, "cccc", 1},
+      {4, "dddd", 3},
+      {5, "eeee", 5},
+      {6, "ffff", 1},
+      {7, "gggg", 3},
+      {8, "hhhh", 3},
+      {9, "iiii", 2},
+      {10, "jjjj", 5},
+  };
+  bool foundScan[] = {
+      FALSE,
+      FALSE,
+      FALSE,
+      FALSE,
+      FALSE,
+      FALSE,
+      FALSE,
+      FALSE,
+      FALSE,
+      FALSE};
+  int numInserts = 10, i;
+  Record *r;
+  RID *rids;
+  Schema *schema;
+  RM_ScanHandle *sc = (RM_ScanHandle *)malloc(sizeof(RM_ScanHandle));
+  Expr *sel, *left, *right, *first, *se;
+  int rc;
+
+  testName = "test creating a new table and inserting tuples";
+  schema = testSchema();
+  rids = (RID *)malloc(sizeof(RID) * numInserts);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable("test_table_r", schema));
+  TEST_CHECK(openTable(table, "test_table_r"));
+
+  // insert rows into table
+  for (i = 0; i < numInserts; i++)
+  {
+    r = fromTestRecord(schema, inserts[i]);
+    TEST_CHECK(insertRecord(table, r));
+    rids[i] = r->id;
+    freeRecord(r); // Added Summer 2021
+  }
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, "test_table_r"));
+
+  // Select 1 record with INT in condition a=2.
+  MAKE_CONS(left, stringToValue("i2"));
+  MAKE_ATTRREF(right, 0);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+  createRecord(&r, schema);
+  TEST_CHECK(startScan(table, sc, sel));
+  while ((rc = next(sc, r)) == RC_OK)
+  {
+    ASSERT_EQUALS_RECORDS(fromTestRecord(schema, inserts[1]), r, schema, "compare records");
+  }
+  if (rc != RC_RM_NO_MORE_TUPLES)
+    TEST_CHECK(rc);
+  TEST_CHECK(closeScan(sc));
+
+  // Select 1 record with STRING in condition b='ffff'.
+  MAKE_CONS(left, stringToValue("sffff"));
+  MAKE_ATTRREF(right, 1);
+  MAKE_BINOP_EXPR(sel, left, right, OP_COMP_EQUAL);
+  createRecord(&r, schema);
+  TEST_CHECK(startScan(table, sc, sel));
+  while ((rc = next(sc, r)) == RC_OK)
+  {
+    ASSERT_EQUALS_RECORDS(fromTestRecord(schema, inserts[5]), r, schema, "compare records");
+    serializeRecord(r, schema);
+  }
+  if (rc != RC_RM_NO_MORE_TUPLES)
+    TEST_CHECK(rc);
+  TEST_CHECK(closeScan(sc));
+
+  // Select all records, with condition being false
+  MAKE_CONS(left, stringToValue("i4"));
+  MAKE_ATTRREF(right, 2);
+  MAKE_BINOP_EXPR(first, right, left, OP_COMP_SMALLER);
+  MAKE_UNOP_EXPR(se, first, OP_BOOL_NOT);
+  TEST_CHECK(startScan(table, sc, se));
+
+  while ((rc = next(sc, r)) == RC_OK)
+  {
+    serializeRecord(r, schema);
+    for (i = 0; i < numInserts; i++)
+    {
+      if (memcmp(fromTestRecord(schema, inserts[i])->data, r->data, getRecordSize(schema)) == 0)
+        foundScan[i] = TRUE;
+    }
+  }
+
+  if (rc != RC_RM_NO_MORE_TUPLES)
+    TEST_CHECK(rc);
+  TEST_CHECK(closeScan(sc));
+
+  ASSERT_TRUE(!foundScan[0], "not greater than four");
+  ASSERT_TRUE(foundScan[4], "greater than four");
+  ASSERT_TRUE(foundScan[9], "greater than four");
+
+  // clean up
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable("test_table_r"));
+  TEST_CHECK(shutdownRecordManager());
+
+  freeRecord(r);
+  free(table);
+  free(sc);
+  freeSchema(schema); // Added Summer 2021
+  freeExpr(sel);
+  TEST_DONE();
+}
+
+Schema *
+testSchema(void)
+{
+  Schema *result;
+  char *names[] = {"a", "b", "c"};
+  DataType dt[] = {DT_INT, DT_STRING, DT_INT};
+  int sizes[] = {0, 4, 0};
+  int keys[] = {0};
+  int i;
+  char **cpNames = (char **)malloc(sizeof(char *) * 3);
+  DataType *cpDt = (DataType *)malloc(sizeof(DataType) * 3);
+  int *cpSizes = (int *)malloc(sizeof(int) * 3);
+  int *cpKeys = (int *)malloc(sizeof(int));
+
+  for (i = 0; i < 3; i++)
+  {
+    cpNames[i] = (char *)malloc(2);
+    strcpy(cpNames[i], names[i]);
+  }
+  memcpy(cpDt, dt, sizeof(DataType) * 3);
+  memcpy(cpSizes, sizes, sizeof(int) * 3);
+  memcpy(cpKeys, keys, sizeof(int));
+
+  result = createSchema(3, cpNames, cpDt, cpSizes, 1, cpKeys);
+
+  return result;
+}
+
+Record *
+fromTestRecord(Schema *schema, TestRecord in)
+{
+  return testRecord(schema, in.a, in.b, in.c);
+}
+
+Record *
+testRecord(Schema *schema, int a, char *b, int c)
+{
+  Record *result;
+  Value *value;
+
+  TEST_CHECK(createRecord(&result, schema));
+
+  MAKE_VALUE(value, DT_INT, a);
+  TEST_CHECK(setAttr(result, schema, 0, value));
+  freeVal(value);
+
+  MAKE_STRING_VALUE(value, b);
+  TEST_CHECK(setAttr(result, schema, 1, value));
+  freeVal(value);
+
+  MAKE_VALUE(value, DT_INT, c);
+  TEST_CHECK(setAttr(result, schema, 2, value));
+  freeVal(value);
+
+  return result;
+}
\ No newline at end of file
@@ -16,6 +16,8 @@
 static void testInsertAndFind(void);
 static void testDelete(void);
 static void testIndexScan(void);
+static void testPageSize(void);
+static void testNodePageReuse(void);
 
 // helper methods
 static Value **createValues(char **stringVals, int size);
@@ -33,6 +35,8 @@ int main(void)
   testInsertAndFind();
   testDelete();
   testIndexScan();
+  testPageSize();
+  testNodePageReuse();
 
   return 0;
 }
@@ -259,6 +263,113 @@ void testIndexScan(void)
   TEST_DONE();
 }
 
+// ************************************************************
+void testPageSize(void)
+{
+  RID insert[] = {
+      {1, 1},
+      {2, 3},
+      {1, 2},
+  };
+  int numInserts = 3;
+  Value **keys;
+  char *stringKeys[] = {
+      "i4",
+      "i8",
+      "i2"};
+  testName = "test b-tree with a non-default page size";
+  int i, nodes;
+  BTreeHandle *tree = NULL;
+
+  keys = createValues(stringKeys, numInserts);
+
+  TEST_CHECK(initIndexManager(NULL));
+
+  ASSERT_ERROR(createBtreeWithPageSize("testidx", DT_INT, 2, 12345), "page size must be a power of two");
+
+  TEST_CHECK(createBtreeWithPageSize("testidx", DT_INT, 2, 16384));
+  TEST_CHECK(openBtree(&tree, "testidx"));
+
+  for (i = 0; i < numInserts; i++)
+    TEST_CHECK(insertKey(tree, keys[i], insert[i]));
+
+  // nodes hold two keys on any page size, so the third key splits the root
+  TEST_CHECK(getNumNodes(tree, &nodes));
+  ASSERT_EQUALS_INT(3, nodes, "number of nodes in btree");
+  for (i = 0; i < numInserts; i++)
+  {
+    RID rid;
+    TEST_CHECK(findKey(tree, keys[i], &rid));
+    ASSERT_EQUALS_RID(insert[i], rid, "did we find the correct RID?");
+  }
+
+  TEST_CHECK(closeBtree(tree));
+  TEST_CHECK(deleteBtree("testidx"));
+  TEST_CHECK(shutdownIndexManager());
+  freeValues(keys, numInserts);
+
+  TEST_DONE();
+}
+
+// ************************************************************
+void testNodePageReuse(void)
+{
+  RID insert[] = {
+      {1, 1},
+      {2, 3},
+      {1, 2},
+  };
+  int numInserts = 3;
+  Value **keys;
+  char *stringKeys[] = {
+      "i4",
+      "i8",
+      "i2"};
+  testName = "test b-tree node pages are released and allocated again";
+  int i, nodes;
+  BTreeHandle *tree = NULL;
+  RID rid;
+
+  keys = createValues(stringKeys, numInserts);
+
+  TEST_CHECK(initIndexManager(NULL));
+  TEST_CHECK(createBtree("testidx", DT_INT, 2));
+  TEST_CHECK(openBtree(&tree, "testidx"));
+
+  for (i = 0; i < numInserts; i++)
+    TEST_CHECK(insertKey(tree, keys[i], insert[i]));
+
+  // deleting the only key of the last node releases its page
+  TEST_CHECK(deleteKey(tree, keys[2]));
+  TEST_CHECK(getNumNodes(tree, &nodes));
+  ASSERT_EQUALS_INT(2, nodes, "number of nodes after delete");
+
+  // the next node gets the released page back
+  TEST_CHECK(insertKey(tree, keys[2], insert[2]));
+  TEST_CHECK(getNumNodes(tree, &nodes));
+  ASSERT_EQUALS_INT(3, nodes, "number of nodes after insert");
+  TEST_CHECK(findKey(tree, keys[2], &rid));
+  ASSERT_EQUALS_RID(insert[2], rid, "did we find the correct RID?");
+
+  // closing releases the node pages, so a reopened tree allocates them again
+  TEST_CHECK(closeBtree(tree));
+  TEST_CHECK(openBtree(&tree, "testidx"));
+  for (i = 0; i < numInserts; i++)
+    TEST_CHECK(insertKey(tree, keys[i], insert[i]));
+  for (i = 0; i < numInserts; i++)
+  {
+    TEST_CHECK(findKey(tree, keys[i], &rid));
+    ASSERT_EQUALS_RID(insert[i], rid, "did we find the correct RID?");
+  }
+
+  TEST_CHECK(closeBtree(tree));
+  TEST_CHECK(deleteBtree("testidx"));
+  TEST_CHECK(shutdownIndexManager());
+  freeValues(keys, numInserts);
+
+  TEST_DONE();
+}
+
 // ************************************************************
 int *createPermutation(int size)
 {
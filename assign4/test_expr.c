@@ -1,5 +1,6 @@
 #include "dberror.h"
 #include "expr.h"
+#include "filter.h"
 #include "record_mgr.h"
 #include "tables.h"
 #include "test_helper.h"
@@ -29,6 +30,11 @@
 static void testValueSerialize (void);
 static void testOperators (void);
 static void testExpressions (void);
+static void testCompiledExpressions (void);
+static void testFilterKernels (void);
+static void testArena (void);
+static void testExtendedOperators (void);
+static void testOptimizeExpr (void);
 
 char *testName;
 
@@ -41,6 +47,11 @@ main (void)
 	testValueSerialize();
 	testOperators();
 	testExpressions();
+	testCompiledExpressions();
+	testFilterKernels();
+	testArena();
+	testExtendedOperators();
+	testOptimizeExpr();
 
 	return 0;
 }
@@ -123,3 +134,495 @@ testExpressions (void)
 
 	TEST_DONE();
 }
+
+// ************************************************************
+// compiles expr and checks it against evalExpr on the record
+static void
+checkCompiled (Expr *expr, Record *record, Schema *schema, bool expected, char *message)
+{
+	CompiledExpr *program;
+	Value *res;
+
+	TEST_CHECK(compileExpr(expr, schema, &program));
+	TEST_CHECK(evalExpr(record, schema, expr, &res));
+	ASSERT_TRUE(res->v.boolV == expected, message);
+	ASSERT_TRUE(evalCompiledExpr(program, record) == expected, message);
+	freeVal(res);
+	freeCompiledExpr(program);
+	freeExpr(expr);
+}
+
+void
+testCompiledExpressions (void)
+{
+	char **names = (char **) malloc(sizeof(char*) * 4);
+	DataType *dt = (DataType *) malloc(sizeof(DataType) * 4);
+	int *sizes = (int *) malloc(sizeof(int) * 4);
+	int *keys = (int *) malloc(sizeof(int));
+	Schema *schema;
+	Record *record;
+	CompiledExpr *program;
+	Expr *op, *l, *r, *inner;
+	RC rc;
+	testName = "test compiled expressions";
+
+	names[0] = strdup("a");
+	names[1] = strdup("b");
+	names[2] = strdup("c");
+	names[3] = strdup("d");
+	dt[0] = DT_INT;
+	dt[1] = DT_STRING;
+	dt[2] = DT_FLOAT;
+	dt[3] = DT_BOOL;
+	sizes[0] = sizes[2] = sizes[3] = 0;
+	sizes[1] = 4;
+	keys[0] = 0;
+	schema = createSchema(4, names, dt, sizes, 1, keys);
+	TEST_CHECK(createRecord(&record, schema));
+	TEST_CHECK(setAttr(record, schema, 0, stringToValue("i5")));
+	TEST_CHECK(setAttr(record, schema, 1, stringToValue("sab")));
+	TEST_CHECK(setAttr(record, schema, 2, stringToValue("f2.5")));
+	TEST_CHECK(setAttr(record, schema, 3, stringToValue("bt")));
+
+	// comparisons of attributes and constants
+	MAKE_ATTRREF(l, 0);
+	MAKE_CONS(r, stringToValue("i5"));
+	MAKE_BINOP_EXPR(op, l, r, OP_COMP_EQUAL);
+	checkCompiled(op, record, schema, TRUE, "a = 5");
+
+	MAKE_ATTRREF(l, 0);
+	MAKE_CONS(r, stringToValue("i5"));
+	MAKE_BINOP_EXPR(op, l, r, OP_COMP_SMALLER);
+	checkCompiled(op, record, schema, FALSE, "a < 5");
+
+	MAKE_CONS(l, stringToValue("i3"));
+	MAKE_ATTRREF(r, 0);
+	MAKE_BINOP_EXPR(op, l, r, OP_COMP_SMALLER);
+	checkCompiled(op, record, schema, TRUE, "3 < a");
+
+	MAKE_ATTRREF(l, 1);
+	MAKE_CONS(r, stringToValue("sab"));
+	MAKE_BINOP_EXPR(op, l, r, OP_COMP_EQUAL);
+	checkCompiled(op, record, schema, TRUE, "b = ab");
+
+	MAKE_ATTRREF(l, 1);
+	MAKE_CONS(r, stringToValue("sabc"));
+	MAKE_BINOP_EXPR(op, l, r, OP_COMP_SMALLER);
+	checkCompiled(op, record, schema, TRUE, "b < abc");
+
+	MAKE_ATTRREF(l, 2);
+	MAKE_CONS(r, stringToValue("f3.0"));
+	MAKE_BINOP_EXPR(op, l, r, OP_COMP_SMALLER);
+	checkCompiled(op, record, schema, TRUE, "c < 3.0");
+
+	MAKE_ATTRREF(l, 0);
+	MAKE_ATTRREF(r, 0);
+	MAKE_BINOP_EXPR(op, l, r, OP_COMP_EQUAL);
+	checkCompiled(op, record, schema, TRUE, "a = a");
+
+	// boolean operators
+	MAKE_ATTRREF(l, 3);
+	MAKE_UNOP_EXPR(op, l, OP_BOOL_NOT);
+	checkCompiled(op, record, schema, FALSE, "NOT d");
+
+	MAKE_ATTRREF(l, 3);
+	MAKE_ATTRREF(r, 2);
+	MAKE_CONS(inner, stringToValue("f1.0"));
+	MAKE_BINOP_EXPR(op, r, inner, OP_COMP_SMALLER);
+	MAKE_BINOP_EXPR(inner, l, op, OP_BOOL_OR);
+	MAKE_ATTRREF(l, 0);
+	MAKE_CONS(r, stringToValue("i5"));
+	MAKE_BINOP_EXPR(op, l, r, OP_COMP_EQUAL);
+	MAKE_BINOP_EXPR(l, op, inner, OP_BOOL_AND);
+	checkCompiled(l, record, schema, TRUE, "a = 5 AND (d OR c < 1.0)");
+
+	// type errors are found when compiling
+	MAKE_ATTRREF(l, 0);
+	MAKE_CONS(r, stringToValue("s5"));
+	MAKE_BINOP_EXPR(op, l, r, OP_COMP_EQUAL);
+	rc = compileExpr(op, schema, &program);
+	ASSERT_EQUALS_INT(RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE, rc, "a = '5' does not compile");
+	freeExpr(op);
+
+	MAKE_ATTRREF(l, 0);
+	rc = compileExpr(l, schema, &program);
+	ASSERT_EQUALS_INT(RC_RM_EXPR_RESULT_IS_NOT_BOOLEAN, rc, "a alone is no condition");
+	freeExpr(l);
+
+	// comparisons of operator results are left to evalExpr
+	MAKE_ATTRREF(l, 0);
+	MAKE_CONS(r, stringToValue("i5"));
+	MAKE_BINOP_EXPR(inner, l, r, OP_COMP_EQUAL);
+	MAKE_CONS(r, stringToValue("bt"));
+	MAKE_BINOP_EXPR(op, inner, r, OP_COMP_EQUAL);
+	rc = compileExpr(op, schema, &program);
+	ASSERT_EQUALS_INT(RC_INVALID_PARAMETER, rc, "(a = 5) = true is not compiled");
+	freeExpr(op);
+
+	freeRecord(record);
+	freeSchema(schema);
+	TEST_DONE();
+}
+
+// ************************************************************
+void
+testFilterKernels (void)
+{
+	char data[512];
+	int offsets[37];
+	unsigned char mask[5];
+	Value constant;
+	int count = 37, kernel, op, i, v, ok;
+	float f;
+	testName = "test filter kernels";
+
+	// unaligned values, more than one vector and a remainder
+	for (i = 0; i < count; i++)
+		offsets[i] = 3 + 7 * i;
+
+	for (kernel = FILTER_KERNEL_SCALAR; kernel <= bestFilterKernel(); kernel++)
+	{
+		for (op = FILTER_EQUAL; op <= FILTER_GREATER; op++)
+		{
+			// ints
+			for (i = 0; i < count; i++)
+			{
+				v = (i * 37) % 11 - 5;
+				memcpy(data + offsets[i], &v, sizeof(int));
+			}
+			constant.dt = DT_INT;
+			constant.v.intV = 1;
+			filterColumnWith(kernel, data, offsets, count, DT_INT, op, &constant, mask);
+			ok = 1;
+			for (i = 0; i < count; i++)
+			{
+				v = (i * 37) % 11 - 5;
+				int expected = (op == FILTER_EQUAL) ? (v == 1) : (op == FILTER_SMALLER) ? (v < 1) : (v > 1);
+				if (((mask[i / 8] >> (i % 8)) & 1) != expected)
+					ok = 0;
+			}
+			ASSERT_TRUE(ok, filterKernelName(kernel));
+
+			// floats
+			for (i = 0; i < count; i++)
+			{
+				f = i * 0.25f;
+				memcpy(data + offsets[i], &f, sizeof(float));
+			}
+			constant.dt = DT_FLOAT;
+			constant.v.floatV = 4.5f;
+			filterColumnWith(kernel, data, offsets, count, DT_FLOAT, op, &constant, mask);
+			ok = 1;
+			for (i = 0; i < count; i++)
+			{
+				f = i * 0.25f;
+				int expected = (op == FILTER_EQUAL) ? (f == 4.5f) : (op == FILTER_SMALLER) ? (f < 4.5f) : (f > 4.5f);
+				if (((mask[i / 8] >> (i % 8)) & 1) != expected)
+					ok = 0;
+			}
+			ASSERT_TRUE(ok, filterKernelName(kernel));
+		}
+	}
+
+	TEST_DONE();
+}
+
+// ************************************************************
+void
+testArena (void)
+{
+	Arena *arena;
+	ArenaMark mark;
+	Expr *op, *l, *r;
+	Value *res;
+	char *keep, *big;
+	size_t used;
+	int i;
+	testName = "test arena allocation";
+
+	TEST_CHECK(createArena(&arena, 64));
+
+	// small allocations share chunks and are aligned
+	keep = arenaStrdup(arena, "keep");
+	for (i = 0; i < 20; i++)
+		ASSERT_TRUE(((size_t) arenaAlloc(arena, 1 + i % 5)) % 16 == 0, "aligned allocation");
+	big = arenaAlloc(arena, 1000);
+	ASSERT_TRUE(big != NULL, "allocation larger than a chunk");
+	memset(big, 'x', 1000);
+
+	// releasing to a mark keeps what came before it
+	used = arena->allocated;
+	mark = arenaMark(arena);
+	for (i = 0; i < 50; i++)
+		arenaAlloc(arena, 24);
+	arenaRelease(arena, mark);
+	ASSERT_TRUE(arena->allocated == used, "release to mark");
+	ASSERT_EQUALS_STRING("keep", keep, "memory before the mark stays valid");
+
+	// expressions evaluated in the arena
+	MAKE_CONS(l, stringToValue("i10"));
+	MAKE_CONS(r, stringToValue("i20"));
+	MAKE_BINOP_EXPR(op, l, r, OP_COMP_SMALLER);
+	TEST_CHECK(evalExprWithArena(NULL, NULL, op, &res, arena));
+	ASSERT_TRUE(res->dt == DT_BOOL && res->v.boolV, "Const 10 < Const 20 in arena");
+	freeExpr(op);
+
+	MAKE_CONS(l, stringToValue("sabc"));
+	TEST_CHECK(evalExprWithArena(NULL, NULL, l, &res, arena));
+	ASSERT_EQUALS_STRING("abc", res->v.stringV, "string constant in arena");
+	freeExpr(l);
+
+	resetArena(arena);
+	ASSERT_TRUE(arena->allocated == 0, "reset releases everything");
+	TEST_CHECK(freeArena(arena));
+
+	TEST_DONE();
+}
+
+// ************************************************************
+// builds attr op constant
+static Expr *
+compareAttr (int attr, OpType type, char *constant)
+{
+	Expr *op, *l, *r;
+
+	MAKE_ATTRREF(l, attr);
+	MAKE_CONS(r, stringToValue(constant));
+	MAKE_BINOP_EXPR(op, l, r, type);
+	return op;
+}
+
+void
+testExtendedOperators (void)
+{
+	char **names = (char **) malloc(sizeof(char*) * 3);
+	DataType *dt = (DataType *) malloc(sizeof(DataType) * 3);
+	int *sizes = (int *) malloc(sizeof(int) * 3);
+	int *keys = (int *) malloc(sizeof(int));
+	Expr *list[3];
+	Schema *schema;
+	Record *record;
+	Expr *op, *l, *r, *bad, *low, *high;
+	Value *res;
+	testName = "test extended operators";
+
+	names[0] = strdup("a");
+	names[1] = strdup("b");
+	names[2] = strdup("c");
+	dt[0] = DT_INT;
+	dt[1] = DT_STRING;
+	dt[2] = DT_FLOAT;
+	sizes[0] = sizes[2] = 0;
+	sizes[1] = 4;
+	keys[0] = 0;
+	schema = createSchema(3, names, dt, sizes, 1, keys);
+	TEST_CHECK(createRecord(&record, schema));
+	TEST_CHECK(setAttr(record, schema, 0, stringToValue("i5")));
+	TEST_CHECK(setAttr(record, schema, 1, stringToValue("sab")));
+	TEST_CHECK(setAttr(record, schema, 2, stringToValue("f2.5")));
+
+	// comparisons, evaluated and compiled
+	checkCompiled(compareAttr(0, OP_COMP_SMALLER_EQUAL, "i5"), record, schema, TRUE, "a <= 5");
+	checkCompiled(compareAttr(0, OP_COMP_SMALLER_EQUAL, "i4"), record, schema, FALSE, "a <= 4");
+	checkCompiled(compareAttr(0, OP_COMP_GREATER, "i4"), record, schema, TRUE, "a > 4");
+	checkCompiled(compareAttr(0, OP_COMP_GREATER, "i5"), record, schema, FALSE, "a > 5");
+	checkCompiled(compareAttr(0, OP_COMP_GREATER_EQUAL, "i5"), record, schema, TRUE, "a >= 5");
+	checkCompiled(compareAttr(2, OP_COMP_GREATER_EQUAL, "f2.6"), record, schema, FALSE, "c >= 2.6");
+	checkCompiled(compareAttr(1, OP_COMP_NOT_EQUAL, "sab"), record, schema, FALSE, "b <> ab");
+	checkCompiled(compareAttr(1, OP_COMP_GREATER, "saa"), record, schema, TRUE, "b > aa");
+	checkCompiled(compareAttr(1, OP_COMP_GREATER, "s"), record, schema, TRUE, "b > ''");
+	checkCompiled(compareAttr(1, OP_COMP_GREATER, "sA"), record, schema, TRUE, "b > A");
+	checkCompiled(compareAttr(1, OP_COMP_GREATER_EQUAL, "s_"), record, schema, TRUE, "b >= _");
+	checkCompiled(compareAttr(1, OP_COMP_GREATER_EQUAL, "sc"), record, schema, FALSE, "b >= c");
+
+	// BETWEEN is inclusive on both ends
+	MAKE_ATTRREF(l, 0);
+	MAKE_CONS(low, stringToValue("i1"));
+	MAKE_CONS(high, stringToValue("i5"));
+	MAKE_BETWEEN_EXPR(op, l, low, high);
+	checkCompiled(op, record, schema, TRUE, "a BETWEEN 1 AND 5");
+
+	MAKE_ATTRREF(l, 2);
+	MAKE_CONS(low, stringToValue("f2.6"));
+	MAKE_CONS(high, stringToValue("f9.0"));
+	MAKE_BETWEEN_EXPR(op, l, low, high);
+	checkCompiled(op, record, schema, FALSE, "c BETWEEN 2.6 AND 9.0");
+
+	MAKE_ATTRREF(l, 1);
+	MAKE_CONS(low, stringToValue("s_"));
+	MAKE_CONS(high, stringToValue("sz"));
+	MAKE_BETWEEN_EXPR(op, l, low, high);
+	checkCompiled(op, record, schema, TRUE, "b BETWEEN _ AND z");
+
+	MAKE_ATTRREF(l, 1);
+	MAKE_CONS(low, stringToValue("sc"));
+	MAKE_CONS(high, stringToValue("sz"));
+	MAKE_BETWEEN_EXPR(op, l, low, high);
+	checkCompiled(op, record, schema, FALSE, "b BETWEEN c AND z");
+
+	// IN lists
+	MAKE_CONS(list[0], stringToValue("i1"));
+	MAKE_CONS(list[1], stringToValue("i5"));
+	MAKE_CONS(list[2], stringToValue("i9"));
+	MAKE_ATTRREF(l, 0);
+	MAKE_IN_EXPR(op, l, list, 3);
+	checkCompiled(op, record, schema, TRUE, "a IN (1, 5, 9)");
+
+	MAKE_CONS(list[0], stringToValue("sa"));
+	MAKE_CONS(list[1], stringToValue("sabc"));
+	MAKE_ATTRREF(l, 1);
+	MAKE_IN_EXPR(op, l, list, 2);
+	checkCompiled(op, record, schema, FALSE, "b IN (a, abc)");
+
+	// AND and OR skip their right side when the left one decides
+	MAKE_BINOP_EXPR(op, compareAttr(0, OP_COMP_GREATER, "i9"), compareAttr(1, OP_COMP_EQUAL, "sab"), OP_BOOL_AND);
+	checkCompiled(op, record, schema, FALSE, "a > 9 AND b = ab");
+	MAKE_BINOP_EXPR(op, compareAttr(0, OP_COMP_SMALLER, "i9"), compareAttr(1, OP_COMP_EQUAL, "sx"), OP_BOOL_AND);
+	checkCompiled(op, record, schema, FALSE, "a < 9 AND b = x");
+	MAKE_BINOP_EXPR(op, compareAttr(0, OP_COMP_SMALLER, "i9"), compareAttr(1, OP_COMP_EQUAL, "sx"), OP_BOOL_OR);
+	checkCompiled(op, record, schema, TRUE, "a < 9 OR b = x");
+	MAKE_BINOP_EXPR(op, compareAttr(0, OP_COMP_GREATER, "i9"), compareAttr(1, OP_COMP_EQUAL, "sab"), OP_BOOL_OR);
+	MAKE_BINOP_EXPR(l, op, compareAttr(2, OP_COMP_NOT_EQUAL, "f2.5"), OP_BOOL_OR);
+	checkCompiled(l, record, schema, TRUE, "(a > 9 OR b = ab) OR c <> 2.5");
+
+	// right sides that would fail are never evaluated
+	MAKE_ATTRREF(l, 0);
+	MAKE_CONS(r, stringToValue("sx"));
+	MAKE_BINOP_EXPR(bad, l, r, OP_COMP_SMALLER);
+	MAKE_BINOP_EXPR(op, compareAttr(0, OP_COMP_GREATER, "i9"), bad, OP_BOOL_AND);
+	TEST_CHECK(evalExpr(record, schema, op, &res));
+	ASSERT_TRUE(res->dt == DT_BOOL && !res->v.boolV, "a > 9 AND a < 'x' stops after a > 9");
+	freeVal(res);
+	freeExpr(op);
+
+	MAKE_ATTRREF(l, 0);
+	MAKE_CONS(low, stringToValue("i6"));
+	MAKE_CONS(high, stringToValue("sx"));
+	MAKE_BETWEEN_EXPR(op, l, low, high);
+	TEST_CHECK(evalExpr(record, schema, op, &res));
+	ASSERT_TRUE(res->dt == DT_BOOL && !res->v.boolV, "a BETWEEN 6 AND 'x' stops at the lower bound");
+	freeVal(res);
+	freeExpr(op);
+
+	MAKE_CONS(list[0], stringToValue("i5"));
+	MAKE_CONS(list[1], stringToValue("sx"));
+	MAKE_ATTRREF(l, 0);
+	MAKE_IN_EXPR(op, l, list, 2);
+	TEST_CHECK(evalExpr(record, schema, op, &res));
+	ASSERT_TRUE(res->dt == DT_BOOL && res->v.boolV, "a IN (5, 'x') stops at the match");
+	freeVal(res);
+	freeExpr(op);
+
+	freeRecord(record);
+	freeSchema(schema);
+	TEST_DONE();
+}
+
+// ************************************************************
+// optimizes expr and checks that both give the same result on the record
+static Expr *
+checkOptimized (Expr *expr, Record *record, Schema *schema, char *message)
+{
+	Expr *optimized;
+	Value *before, *after;
+
+	TEST_CHECK(optimizeExpr(expr, schema, &optimized));
+	TEST_CHECK(evalExpr(record, schema, expr, &before));
+	TEST_CHECK(evalExpr(record, schema, optimized, &after));
+	ASSERT_TRUE(after->dt == DT_BOOL && before->v.boolV == after->v.boolV, message);
+	freeVal(before);
+	freeVal(after);
+	freeExpr(expr);
+	return optimized;
+}
+
+void
+testOptimizeExpr (void)
+{
+	char **names = (char **) malloc(sizeof(char*) * 3);
+	DataType *dt = (DataType *) malloc(sizeof(DataType) * 3);
+	int *sizes = (int *) malloc(sizeof(int) * 3);
+	int *keys = (int *) malloc(sizeof(int));
+	Schema *schema;
+	Record *record;
+	Expr *op, *l, *r, *opt;
+	Operator *o;
+	testName = "test optimizing conditions";
+
+	names[0] = strdup("a");
+	names[1] = strdup("b");
+	names[2] = strdup("c");
+	dt[0] = DT_INT;
+	dt[1] = DT_STRING;
+	dt[2] = DT_FLOAT;
+	sizes[0] = sizes[2] = 0;
+	sizes[1] = 4;
+	keys[0] = 0;
+	schema = createSchema(3, names, dt, sizes, 1, keys);
+	TEST_CHECK(createRecord(&record, schema));
+	TEST_CHECK(setAttr(record, schema, 0, stringToValue("i5")));
+	TEST_CHECK(setAttr(record, schema, 1, stringToValue("sab")));
+	TEST_CHECK(setAttr(record, schema, 2, stringToValue("f2.5")));
+
+	// double negations disappear
+	MAKE_UNOP_EXPR(l, compareAttr(0, OP_COMP_SMALLER, "i9"), OP_BOOL_NOT);
+	MAKE_UNOP_EXPR(op, l, OP_BOOL_NOT);
+	opt = checkOptimized(op, record, schema, "NOT NOT a < 9");
+	ASSERT_TRUE(opt->type == EXPR_OP && opt->expr.op->type == OP_COMP_SMALLER, "NOT NOT a < 9 is a < 9");
+	freeExpr(opt);
+
+	// constant < attribute turns around
+	MAKE_CONS(l, stringToValue("i3"));
+	MAKE_ATTRREF(r, 0);
+	MAKE_BINOP_EXPR(op, l, r, OP_COMP_SMALLER);
+	opt = checkOptimized(op, record, schema, "3 < a");
+	o = opt->expr.op;
+	ASSERT_TRUE(o->type == OP_COMP_GREATER && o->args[0]->type == EXPR_ATTRREF
+			&& o->args[1]->type == EXPR_CONST, "3 < a is a > 3");
+	freeExpr(opt);
+
+	// constants fold, and TRUE AND x is x
+	MAKE_CONS(l, stringToValue("i3"));
+	MAKE_CONS(r, stringToValue("i4"));
+	MAKE_BINOP_EXPR(opt, l, r, OP_COMP_SMALLER);
+	MAKE_BINOP_EXPR(op, opt, compareAttr(0, OP_COMP_EQUAL, "i5"), OP_BOOL_AND);
+	opt = checkOptimized(op, record, schema, "3 < 4 AND a = 5");
+	ASSERT_TRUE(opt->type == EXPR_OP && opt->expr.op->type == OP_COMP_EQUAL, "3 < 4 AND a = 5 is a = 5");
+	freeExpr(opt);
+
+	MAKE_CONS(l, stringToValue("bf"));
+	MAKE_BINOP_EXPR(op, compareAttr(0, OP_COMP_EQUAL, "i5"), l, OP_BOOL_AND);
+	opt = checkOptimized(op, record, schema, "a = 5 AND FALSE");
+	ASSERT_TRUE(opt->type == EXPR_CONST && !opt->expr.cons->v.boolV, "a = 5 AND FALSE is FALSE");
+	freeExpr(opt);
+
+	// NOTs move down to the comparisons
+	MAKE_BINOP_EXPR(l, compareAttr(0, OP_COMP_SMALLER, "i9"), compareAttr(1, OP_COMP_EQUAL, "sx"), OP_BOOL_AND);
+	MAKE_UNOP_EXPR(op, l, OP_BOOL_NOT);
+	opt = checkOptimized(op, record, schema, "NOT (a < 9 AND b = x)");
+	o = opt->expr.op;
+	ASSERT_TRUE(o->type == OP_BOOL_OR && o->args[0]->expr.op->type == OP_COMP_GREATER_EQUAL
+			&& o->args[1]->expr.op->type == OP_COMP_NOT_EQUAL, "NOT (a < 9 AND b = x) is a >= 9 OR b <> x");
+	freeExpr(opt);
+
+	// NaN keeps NOT c < 3.0 from becoming c >= 3.0
+	MAKE_UNOP_EXPR(op, compareAttr(2, OP_COMP_SMALLER, "f3.0"), OP_BOOL_NOT);
+	opt = checkOptimized(op, record, schema, "NOT c < 3.0");
+	ASSERT_TRUE(opt->expr.op->type == OP_BOOL_NOT, "NOT c < 3.0 stays");
+	freeExpr(opt);
+
+	// conjuncts are ordered, equality first and inequality last
+	MAKE_BINOP_EXPR(l, compareAttr(0, OP_COMP_NOT_EQUAL, "i3"), compareAttr(0, OP_COMP_SMALLER, "i9"), OP_BOOL_AND);
+	MAKE_BINOP_EXPR(op, l, compareAttr(1, OP_COMP_EQUAL, "sab"), OP_BOOL_AND);
+	opt = checkOptimized(op, record, schema, "a <> 3 AND a < 9 AND b = ab");
+	o = opt->expr.op;
+	ASSERT_TRUE(o->type == OP_BOOL_AND && o->args[1]->expr.op->type == OP_COMP_NOT_EQUAL, "a <> 3 runs last");
+	o = o->args[0]->expr.op;
+	ASSERT_TRUE(o->type == OP_BOOL_AND && o->args[0]->expr.op->type == OP_COMP_EQUAL
+			&& o->args[1]->expr.op->type == OP_COMP_SMALLER, "b = ab runs first, then a < 9");
+	freeExpr(opt);
+
+	freeRecord(record);
+	freeSchema(schema);
+	TEST_DONE();
+}